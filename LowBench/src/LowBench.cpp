@@ -0,0 +1,72 @@
+#include "LowBench.h"
+
+#include "LowUtilLogger.h"
+
+#include <atomic>
+
+namespace Low {
+  namespace Bench {
+    static std::atomic<float> g_Sink{0.0f};
+
+    bool register_benchmark(const char *p_Name, u32 p_DefaultCount,
+                            BenchmarkFunction p_Function)
+    {
+      get_benchmarks().push_back(
+          {p_Name, p_DefaultCount, p_Function});
+      return true;
+    }
+
+    Util::List<Benchmark> &get_benchmarks()
+    {
+      // Benchmarks register from static initializers of other
+      // translation units, so the list cannot be a global
+      static Util::List<Benchmark> s_Benchmarks;
+      return s_Benchmarks;
+    }
+
+    Timer::Timer()
+    {
+      restart();
+    }
+
+    void Timer::restart()
+    {
+      m_Start = std::chrono::high_resolution_clock::now();
+    }
+
+    double Timer::get_elapsed_ms() const
+    {
+      return std::chrono::duration<double, std::milli>(
+                 std::chrono::high_resolution_clock::now() - m_Start)
+          .count();
+    }
+
+    void report(const char *p_Label, double p_Milliseconds,
+                u32 p_ItemCount)
+    {
+      const double l_NsPerItem =
+          p_ItemCount > 0u
+              ? p_Milliseconds * 1000000.0 / p_ItemCount
+              : 0.0;
+      // The log has no overload for double
+      LOW_LOG_INFO << "  " << p_Label << ": " << (float)p_Milliseconds
+                   << " ms, " << (float)l_NsPerItem << " ns per item"
+                   << LOW_LOG_END;
+    }
+
+    bool check(bool p_Condition, const char *p_Message)
+    {
+      if (!p_Condition) {
+        LOW_LOG_ERROR << "  Check failed: " << p_Message
+                      << LOW_LOG_END;
+      }
+      return p_Condition;
+    }
+
+    void consume(float p_Value)
+    {
+      g_Sink.store(g_Sink.load(std::memory_order_relaxed) + p_Value,
+                   std::memory_order_relaxed);
+    }
+  } // namespace Bench
+} // namespace Low
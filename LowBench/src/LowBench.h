@@ -0,0 +1,55 @@
+#pragma once
+
+#include "LowMath.h"
+#include "LowUtilContainers.h"
+
+#include <chrono>
+
+// Benchmarks register themselves with LOW_BENCHMARK and get run by
+// the lowbench executable. Every benchmark returns false if one of
+// its checks failed so the executable can be used to catch
+// regressions as well.
+#define LOW_BENCHMARK(p_Name, p_DefaultCount)                        \
+  static bool p_Name(u32 p_Count);                                   \
+  static const bool g_Registered_##p_Name =                          \
+      Low::Bench::register_benchmark(#p_Name, p_DefaultCount,        \
+                                     &p_Name);                       \
+  static bool p_Name(u32 p_Count)
+
+namespace Low {
+  namespace Bench {
+    typedef bool (*BenchmarkFunction)(u32);
+
+    struct Benchmark
+    {
+      const char *name;
+      u32 default_count;
+      BenchmarkFunction function;
+    };
+
+    bool register_benchmark(const char *p_Name, u32 p_DefaultCount,
+                            BenchmarkFunction p_Function);
+    Util::List<Benchmark> &get_benchmarks();
+
+    struct Timer
+    {
+      Timer();
+
+      void restart();
+      double get_elapsed_ms() const;
+
+    private:
+      std::chrono::high_resolution_clock::time_point m_Start;
+    };
+
+    // Logs the total time and the time per item
+    void report(const char *p_Label, double p_Milliseconds,
+                u32 p_ItemCount);
+
+    // Logs an error if the condition does not hold
+    bool check(bool p_Condition, const char *p_Message);
+
+    // Keeps the compiler from optimizing away measured work
+    void consume(float p_Value);
+  } // namespace Bench
+} // namespace Low
@@ -0,0 +1,152 @@
+#include "LowBench.h"
+
+#include "LowUtilLogger.h"
+
+#include "LowCoreEntity.h"
+#include "LowCorePhysics.h"
+#include "LowCorePhysicsBody.h"
+#include "LowCorePhysicsBodyMotionType.h"
+#include "LowCorePhysicsShape.h"
+#include "LowCorePhysicsWorld.h"
+
+namespace {
+  struct BodyGrid
+  {
+    Low::Core::Physics::World world;
+    Low::Core::Physics::Shape shape;
+    Low::Util::List<Low::Core::Physics::Body> bodies;
+    Low::Util::List<Low::Core::Entity> owners;
+  };
+
+  Low::Math::Vector3 get_grid_position(u32 p_Index)
+  {
+    return Low::Math::Vector3((float)(p_Index % 256u) * 2.0f, 0.0f,
+                              (float)(p_Index / 256u) * 2.0f);
+  }
+
+  void make_grid(BodyGrid &p_Grid, u32 p_Count)
+  {
+    using namespace Low;
+    using namespace Low::Core;
+
+    p_Grid.world = Physics::World::make(N(BenchBodyLookup));
+
+    Math::Shape l_Box;
+    l_Box.type = Math::ShapeType::BOX;
+    l_Box.box.position = Math::Vector3(0.0f);
+    l_Box.box.rotation = Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f);
+    l_Box.box.halfExtents = Math::Vector3(0.5f);
+    p_Grid.shape = Physics::Shape::make(p_Grid.world, l_Box);
+
+    p_Grid.world.begin_body_batch();
+    for (u32 i = 0u; i < p_Count; ++i) {
+      Physics::Body i_Body = Physics::Body::make(
+          p_Grid.world, p_Grid.shape, get_grid_position(i),
+          Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f),
+          Physics::BodyMotionType::STATIC, 1.0f, false);
+      Entity i_Owner = Entity::make(N(BenchBodyOwner));
+      i_Body.set_owner(i_Owner);
+
+      p_Grid.bodies.push_back(i_Body);
+      p_Grid.owners.push_back(i_Owner);
+    }
+    p_Grid.world.end_body_batch();
+
+    // Lets the world rebuild its broad phase after the bulk add
+    p_Grid.world.simulate(1.0f / 60.0f);
+  }
+
+  void destroy_grid(BodyGrid &p_Grid)
+  {
+    for (Low::Core::Physics::Body i_Body : p_Grid.bodies) {
+      i_Body.destroy();
+    }
+    for (Low::Core::Entity i_Owner : p_Grid.owners) {
+      i_Owner.destroy();
+    }
+    p_Grid.shape.destroy();
+    p_Grid.world.destroy();
+  }
+
+  // One ray straight down onto every body, returns the time per ray
+  double cast_rays(BodyGrid &p_Grid, u32 p_Count, bool &p_Passed)
+  {
+    using namespace Low;
+    using namespace Low::Core;
+
+    Util::List<Physics::RaycastRequest> l_Requests(p_Count);
+    for (u32 i = 0u; i < p_Count; ++i) {
+      l_Requests[i].origin =
+          get_grid_position(i) + Math::Vector3(0.0f, 10.0f, 0.0f);
+      l_Requests[i].direction = Math::Vector3(0.0f, -1.0f, 0.0f);
+      l_Requests[i].max_distance = 20.0f;
+    }
+
+    Util::List<Physics::QueryResult> l_Results;
+    Util::List<Physics::QueryHit> l_Hits;
+
+    Bench::Timer l_Timer;
+    p_Grid.world.raycast_batch(l_Requests,
+                               Physics::QueryMode::Closest, 1u,
+                               l_Results, l_Hits);
+    const double l_Milliseconds = l_Timer.get_elapsed_ms();
+
+    bool l_Mapped = l_Results.size() == p_Count;
+    for (u32 i = 0u; i < p_Count && l_Mapped; ++i) {
+      if (l_Results[i].hit_count != 1u) {
+        l_Mapped = false;
+        break;
+      }
+      const Physics::QueryHit &i_Hit = l_Hits[l_Results[i].first_hit];
+      l_Mapped &= i_Hit.body.get_id() == p_Grid.bodies[i].get_id() &&
+                  i_Hit.owner.get_id() == p_Grid.owners[i].get_id();
+    }
+    p_Passed &= Bench::check(l_Mapped, "Ray hits were mapped to the "
+                                       "wrong bodies or owners");
+
+    return l_Milliseconds * 1000000.0 / p_Count;
+  }
+
+  double get_rays_per_second(double p_NanosecondsPerRay)
+  {
+    return p_NanosecondsPerRay > 0.0
+               ? 1000000000.0 / p_NanosecondsPerRay
+               : 0.0;
+  }
+} // namespace
+
+// Casts one ray onto every body of a grid and checks that every hit
+// resolves to its body and owner. The rays per second are compared
+// with a grid that has 16 times fewer bodies. With a constant time
+// mapping from Jolt bodies to engine bodies both should be close.
+// Worlds hold at most 65536 bodies.
+LOW_BENCHMARK(body_lookup, 50000u)
+{
+  bool l_Passed = true;
+
+  const u32 l_SmallCount = p_Count / 16u > 0u ? p_Count / 16u : 1u;
+
+  BodyGrid l_Small;
+  make_grid(l_Small, l_SmallCount);
+  const double l_SmallNs = cast_rays(l_Small, l_SmallCount, l_Passed);
+  destroy_grid(l_Small);
+
+  Bench::Timer l_Timer;
+  BodyGrid l_Large;
+  make_grid(l_Large, p_Count);
+  Bench::report("Create bodies", l_Timer.get_elapsed_ms(), p_Count);
+
+  const double l_LargeNs = cast_rays(l_Large, p_Count, l_Passed);
+  destroy_grid(l_Large);
+
+  LOW_LOG_INFO << "  Raycast with " << l_SmallCount << " bodies: "
+               << (float)get_rays_per_second(l_SmallNs)
+               << " rays per second, " << (float)l_SmallNs
+               << " ns per ray" << LOW_LOG_END;
+  LOW_LOG_INFO << "  Raycast with " << p_Count << " bodies: "
+               << (float)get_rays_per_second(l_LargeNs)
+               << " rays per second, " << (float)l_LargeNs
+               << " ns per ray" << LOW_LOG_END;
+
+  return l_Passed;
+}
@@ -0,0 +1,199 @@
+#include "LowBench.h"
+
+#include "LowUtilLogger.h"
+
+#include "LowCoreNavigation.h"
+#include "LowCoreNavigationWorld.h"
+
+#include "LowMathVectorUtil.h"
+
+namespace {
+  // Cells of the generated test floor in each direction
+  const u32 g_FloorCells = 32u;
+  const float g_CellSize = 4.0f;
+
+  // Pillar cells are left out of the middle of the floor so the
+  // agents have to path around holes. The edges stay free for the
+  // agents to start and end on.
+  bool is_pillar_cell(u32 p_X, u32 p_Z)
+  {
+    const u32 l_Border = 6u;
+    if (p_X < l_Border || p_Z < l_Border ||
+        p_X >= g_FloorCells - l_Border ||
+        p_Z >= g_FloorCells - l_Border) {
+      return false;
+    }
+    return p_X % 4u == 2u && p_Z % 4u == 2u;
+  }
+
+  void make_floor(Low::Core::Navigation::BuildGeometry &p_Geometry)
+  {
+    using namespace Low;
+
+    for (u32 z = 0u; z < g_FloorCells; ++z) {
+      for (u32 x = 0u; x < g_FloorCells; ++x) {
+        if (is_pillar_cell(x, z)) {
+          continue;
+        }
+        const u32 i_First = (u32)p_Geometry.vertices.size();
+        const float i_X = (float)x * g_CellSize;
+        const float i_Z = (float)z * g_CellSize;
+        p_Geometry.vertices.push_back(Math::Vector3(i_X, 0.0f, i_Z));
+        p_Geometry.vertices.push_back(
+            Math::Vector3(i_X, 0.0f, i_Z + g_CellSize));
+        p_Geometry.vertices.push_back(
+            Math::Vector3(i_X + g_CellSize, 0.0f, i_Z + g_CellSize));
+        p_Geometry.vertices.push_back(
+            Math::Vector3(i_X + g_CellSize, 0.0f, i_Z));
+
+        p_Geometry.indices.push_back(i_First);
+        p_Geometry.indices.push_back(i_First + 1u);
+        p_Geometry.indices.push_back(i_First + 2u);
+        p_Geometry.indices.push_back(i_First);
+        p_Geometry.indices.push_back(i_First + 2u);
+        p_Geometry.indices.push_back(i_First + 3u);
+      }
+    }
+
+    const float l_Size = (float)g_FloorCells * g_CellSize;
+    p_Geometry.bounds.min = Math::Vector3(0.0f, -1.0f, 0.0f);
+    p_Geometry.bounds.max = Math::Vector3(l_Size, 1.0f, l_Size);
+  }
+
+  // Agents start on a grid near one edge of the floor and walk to the
+  // mirrored spot near the opposite edge, so the crowd has to pass
+  // through itself in the middle
+  Low::Math::Vector3 get_start(u32 p_Index)
+  {
+    const u32 l_Columns = 64u;
+    const float l_Size = (float)g_FloorCells * g_CellSize;
+    const float l_Spacing = (l_Size - 8.0f) / (float)l_Columns;
+    const u32 l_Row = p_Index / l_Columns;
+    const bool l_Near = (l_Row % 2u) == 0u;
+    const float l_Depth = 4.0f + (float)(l_Row / 2u) * 1.2f;
+
+    return Low::Math::Vector3(
+        4.0f + (float)(p_Index % l_Columns) * l_Spacing, 0.0f,
+        l_Near ? l_Depth : l_Size - l_Depth);
+  }
+
+  Low::Math::Vector3 get_target(const Low::Math::Vector3 &p_Start)
+  {
+    const float l_Size = (float)g_FloorCells * g_CellSize;
+    return Low::Math::Vector3(l_Size - p_Start.x, 0.0f,
+                              l_Size - p_Start.z);
+  }
+
+  // Returns the time per tick
+  double run_ticks(Low::Core::Navigation::World p_World, u32 p_Ticks)
+  {
+    Low::Bench::Timer l_Timer;
+    for (u32 i = 0u; i < p_Ticks; ++i) {
+      Low::Core::Navigation::update_crowd(p_World, 1.0f / 30.0f, 64u);
+    }
+    return l_Timer.get_elapsed_ms() / p_Ticks;
+  }
+} // namespace
+
+// Simulates a crowd of agents crossing a generated floor with holes
+// in it. Targets are handed over 64 per tick like the navigation
+// system does. The time per tick of full detail agents is compared
+// with the time of reduced agents, and the agents have to get closer
+// to their targets.
+LOW_BENCHMARK(crowd, 2000u)
+{
+  using namespace Low;
+  using namespace Low::Core;
+
+  bool l_Passed = true;
+
+  Navigation::World l_World = Navigation::World::make(N(BenchCrowd));
+
+  Navigation::BuildGeometry l_Geometry;
+  make_floor(l_Geometry);
+
+  Bench::Timer l_Timer;
+  l_Passed &= Bench::check(l_World.build_from_geometry(&l_Geometry),
+                           "Could not build the test navmesh");
+  Bench::report("Build navmesh", l_Timer.get_elapsed_ms(),
+                g_FloorCells * g_FloorCells);
+
+  Util::List<int> l_Agents;
+  Util::List<Math::Vector3> l_Targets;
+  l_Agents.reserve(p_Count);
+  l_Targets.reserve(p_Count);
+
+  l_Timer.restart();
+  for (u32 i = 0u; i < p_Count; ++i) {
+    const Math::Vector3 i_Start = get_start(i);
+    const int i_Agent = Navigation::add_crowd_agent(
+        l_World, i_Start, Navigation::CrowdAgentParams());
+    l_Targets.push_back(get_target(i_Start));
+    Navigation::set_crowd_agent_target(l_World, i_Agent,
+                                       l_Targets.back());
+    l_Agents.push_back(i_Agent);
+  }
+  Bench::report("Add agents", l_Timer.get_elapsed_ms(), p_Count);
+
+  l_Passed &= Bench::check(Navigation::get_crowd_agent_count(
+                               l_World) == p_Count,
+                           "Crowd is missing agents");
+
+  float l_StartDistance = 0.0f;
+  for (u32 i = 0u; i < p_Count; ++i) {
+    l_StartDistance +=
+        Math::VectorUtil::distance(get_start(i), l_Targets[i]);
+  }
+
+  const u32 l_TickCount = 300u;
+  const double l_FullMs = run_ticks(l_World, l_TickCount);
+
+  u32 l_OnNavmesh = 0u;
+  float l_Distance = 0.0f;
+  for (u32 i = 0u; i < p_Count; ++i) {
+    Navigation::CrowdAgentState i_State;
+    if (!Navigation::get_crowd_agent_state(l_World, l_Agents[i],
+                                           &i_State)) {
+      continue;
+    }
+    l_OnNavmesh += i_State.on_navmesh ? 1u : 0u;
+    l_Distance +=
+        Math::VectorUtil::distance(i_State.position, l_Targets[i]);
+  }
+
+  l_Passed &= Bench::check(l_OnNavmesh == p_Count,
+                           "Agents were not placed on the navmesh");
+  // The crowd jams in the middle, so only part of the way is
+  // covered by then
+  l_Passed &=
+      Bench::check(l_Distance < l_StartDistance * 0.8f,
+                   "Agents did not move towards their targets");
+
+  for (int i_Agent : l_Agents) {
+    Navigation::set_crowd_agent_lod(
+        l_World, i_Agent, Navigation::CrowdAgentLod::Reduced);
+  }
+  const double l_ReducedMs = run_ticks(l_World, l_TickCount);
+
+  LOW_LOG_INFO << "  Full detail: " << (float)l_FullMs
+               << " ms per tick" << LOW_LOG_END;
+  LOW_LOG_INFO << "  Reduced: " << (float)l_ReducedMs
+               << " ms per tick" << LOW_LOG_END;
+  LOW_LOG_INFO << "  Average distance to target: "
+               << l_StartDistance / p_Count << " -> "
+               << l_Distance / p_Count << LOW_LOG_END;
+
+  l_Timer.restart();
+  for (int i_Agent : l_Agents) {
+    Navigation::remove_crowd_agent(l_World, i_Agent);
+  }
+  Bench::report("Remove agents", l_Timer.get_elapsed_ms(), p_Count);
+
+  l_Passed &= Bench::check(Navigation::get_crowd_agent_count(
+                               l_World) == 0u,
+                           "Crowd kept removed agents");
+
+  l_World.destroy();
+
+  return l_Passed;
+}
@@ -0,0 +1,392 @@
+#include "LowBench.h"
+
+#include "LowUtilLogger.h"
+
+#include "LowCoreAnimationClip.h"
+#include "LowCoreAnimationKeySearch.h"
+#include "LowCoreAnimationPose.h"
+
+#include "LowMathQuaternionUtil.h"
+#include "LowMathVectorUtil.h"
+
+#include "LowRendererAnimationClip.h"
+#include "LowRendererAnimationClipState.h"
+#include "LowRendererSkeleton.h"
+#include "LowRendererSkeletonState.h"
+#include "LowRendererSkinningPose.h"
+
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtx/matrix_decompose.hpp>
+
+namespace {
+  // Tracks are packed into one time array like the tracks of a clip
+  struct PackedTracks
+  {
+    Low::Util::List<float> times;
+    Low::Util::List<u32> offsets;
+    Low::Util::List<u32> counts;
+  };
+
+  // Tracks get between 30 and 600 keys over a ten second clip. Key
+  // spacing varies a bit within a track like it does in baked
+  // animations with removed redundant keys.
+  void make_tracks(PackedTracks &p_Tracks, u32 p_TrackCount,
+                   float p_Duration)
+  {
+    for (u32 i = 0u; i < p_TrackCount; ++i) {
+      const u32 i_Count = 30u + (i * 37u) % 571u;
+      p_Tracks.offsets.push_back((u32)p_Tracks.times.size());
+      p_Tracks.counts.push_back(i_Count);
+
+      const float i_Step = p_Duration / (float)(i_Count - 1u);
+      for (u32 j = 0u; j < i_Count; ++j) {
+        const float j_Jitter = (j % 3u == 1u) ? i_Step * 0.25f : 0.0f;
+        p_Tracks.times.push_back((float)j * i_Step + j_Jitter);
+      }
+    }
+  }
+
+  // Samples every track at every time with the cursor search and
+  // with a plain binary search. Returns false if both disagree.
+  bool sample(const PackedTracks &p_Tracks,
+              const Low::Util::List<float> &p_Times,
+              double &p_CursorMs, double &p_BinaryMs)
+  {
+    using namespace Low;
+    using namespace Low::Core::Animation;
+
+    const u32 l_TrackCount = (u32)p_Tracks.counts.size();
+    Util::List<u32> l_Cursors(l_TrackCount, 0u);
+    Util::List<u32> l_CursorKeys;
+    Util::List<u32> l_BinaryKeys;
+    l_CursorKeys.reserve(p_Times.size() * l_TrackCount);
+    l_BinaryKeys.reserve(p_Times.size() * l_TrackCount);
+
+    Bench::Timer l_Timer;
+    for (float i_Time : p_Times) {
+      for (u32 j = 0u; j < l_TrackCount; ++j) {
+        l_CursorKeys.push_back(KeySearch::find_key(
+            &p_Tracks.times[p_Tracks.offsets[j]], p_Tracks.counts[j],
+            i_Time, l_Cursors[j]));
+      }
+    }
+    p_CursorMs = l_Timer.get_elapsed_ms();
+
+    l_Timer.restart();
+    for (float i_Time : p_Times) {
+      for (u32 j = 0u; j < l_TrackCount; ++j) {
+        l_BinaryKeys.push_back(KeySearch::find_key_binary(
+            &p_Tracks.times[p_Tracks.offsets[j]], p_Tracks.counts[j],
+            i_Time));
+      }
+    }
+    p_BinaryMs = l_Timer.get_elapsed_ms();
+
+    return l_CursorKeys == l_BinaryKeys;
+  }
+
+  // Bones of the test skeleton. They hang in chains of ten off the
+  // root like the limbs and fingers of a character.
+  const u32 g_BoneCount = 80u;
+  const float g_ClipDuration = 4.0f;
+
+  float get_noise(u32 &p_Seed)
+  {
+    p_Seed = p_Seed * 1664525u + 1013904223u;
+    return (float)(p_Seed >> 8u) / (float)(1u << 24u);
+  }
+
+  // Fills the bones the way the skeleton loader does, the bind
+  // transform gets decomposed once so sampling can start from it
+  Low::Renderer::Skeleton make_skeleton()
+  {
+    using namespace Low;
+
+    Renderer::Skeleton l_Skeleton =
+        Renderer::Skeleton::make(N(BenchPoseSampling));
+    Util::List<Renderer::SkeletonBone> &l_Bones =
+        l_Skeleton.get_bones();
+    l_Bones.resize(g_BoneCount);
+
+    u32 l_Seed = 7u;
+    for (u32 i = 0u; i < g_BoneCount; ++i) {
+      Renderer::SkeletonBone &i_Bone = l_Bones[i];
+      i_Bone.parent_index =
+          i == 0u ? -1 : (i % 10u == 1u ? 0 : (i32)(i - 1u));
+      i_Bone.local_bind_transform =
+          glm::translate(Math::Matrix4x4(1.0f),
+                         Math::Vector3(0.0f, 0.1f, 0.0f)) *
+          glm::mat4_cast(glm::angleAxis(
+              get_noise(l_Seed) * 0.4f,
+              Math::Vector3(0.0f, 0.0f, 1.0f)));
+
+      Math::Vector3 i_Skew;
+      Math::Vector4 i_Perspective;
+      glm::decompose(i_Bone.local_bind_transform,
+                     i_Bone.local_bind_scale,
+                     i_Bone.local_bind_rotation,
+                     i_Bone.local_bind_position, i_Skew,
+                     i_Perspective);
+      i_Bone.local_bind_rotation =
+          Math::QuaternionUtil::normalize(i_Bone.local_bind_rotation);
+
+      i_Bone.global_bind_transform =
+          i_Bone.parent_index < 0
+              ? i_Bone.local_bind_transform
+              : l_Bones[(u32)i_Bone.parent_index]
+                        .global_bind_transform *
+                    i_Bone.local_bind_transform;
+      i_Bone.inverse_bind_matrix =
+          glm::inverse(i_Bone.global_bind_transform);
+    }
+
+    l_Skeleton.set_state(Renderer::SkeletonState::LOADED);
+    return l_Skeleton;
+  }
+
+  // Every bone gets its own rotation track with between 20 and 120
+  // keys and some jitter in the key spacing. Only the root moves,
+  // the other bones keep a single position and scale key.
+  Low::Renderer::AnimationClip
+  make_clip(Low::Renderer::Skeleton p_Skeleton)
+  {
+    using namespace Low;
+
+    Renderer::AnimationClip l_Clip =
+        Renderer::AnimationClip::make(N(BenchPoseSamplingClip));
+    l_Clip.set_skeleton(p_Skeleton);
+    l_Clip.set_duration(g_ClipDuration);
+    l_Clip.set_ticks_per_second(1.0f);
+
+    Renderer::AnimationTracks &l_Tracks = l_Clip.get_tracks();
+    l_Tracks.clear();
+
+    u32 l_Seed = 11u;
+    for (u32 i = 0u; i < g_BoneCount; ++i) {
+      Renderer::AnimationTrack i_Track;
+      i_Track.bone_index = i;
+
+      const u32 i_RotationCount = 20u + (i * 37u) % 101u;
+      i_Track.rotation_offset = (u32)l_Tracks.rotation_times.size();
+      i_Track.rotation_count = i_RotationCount;
+      const float i_Step =
+          g_ClipDuration / (float)(i_RotationCount - 1u);
+      const Math::Vector3 i_Axis = Math::VectorUtil::normalize(
+          Math::Vector3(get_noise(l_Seed) - 0.5f, 1.0f,
+                        get_noise(l_Seed) - 0.5f));
+      for (u32 j = 0u; j < i_RotationCount; ++j) {
+        const float j_Jitter =
+            (j % 3u == 1u) ? i_Step * 0.25f : 0.0f;
+        const float j_Time = (float)j * i_Step + j_Jitter;
+        l_Tracks.rotation_times.push_back(j_Time);
+        l_Tracks.rotation_values.push_back(
+            glm::angleAxis(std::sin(j_Time * 3.0f) * 0.5f, i_Axis));
+      }
+
+      const u32 i_PositionCount = i == 0u ? 60u : 1u;
+      i_Track.position_offset = (u32)l_Tracks.position_times.size();
+      i_Track.position_count = i_PositionCount;
+      for (u32 j = 0u; j < i_PositionCount; ++j) {
+        const float j_Time = i_PositionCount > 1u
+                                 ? (float)j * g_ClipDuration /
+                                       (float)(i_PositionCount - 1u)
+                                 : 0.0f;
+        l_Tracks.position_times.push_back(j_Time);
+        l_Tracks.position_values.push_back(
+            Math::Vector3(j_Time, 0.1f, 0.0f));
+      }
+
+      i_Track.scale_offset = (u32)l_Tracks.scale_times.size();
+      i_Track.scale_count = 1u;
+      l_Tracks.scale_times.push_back(0.0f);
+      l_Tracks.scale_values.push_back(Math::Vector3(1.0f));
+
+      l_Tracks.tracks.push_back(i_Track);
+    }
+
+    l_Clip.set_state(Renderer::AnimationClipState::LOADED);
+    return l_Clip;
+  }
+
+  // Samples every pose once per time step through the pose API.
+  // Returns false if a sample failed.
+  bool
+  sample_poses(Low::Util::List<Low::Core::Animation::Pose> &p_Poses,
+               Low::Core::Animation::Clip p_Clip,
+               const Low::Util::List<float> &p_Times, double &p_Ms)
+  {
+    const u32 l_PoseCount = (u32)p_Poses.size();
+    bool l_Sampled = true;
+
+    Low::Bench::Timer l_Timer;
+    for (float i_Time : p_Times) {
+      for (u32 j = 0u; j < l_PoseCount; ++j) {
+        // Poses are spread over the clip so they do not all hit the
+        // same keys
+        l_Sampled &= p_Poses[j].sample_clip(
+            p_Clip, i_Time + (float)j * 0.137f, true);
+      }
+    }
+    p_Ms = l_Timer.get_elapsed_ms();
+
+    return l_Sampled;
+  }
+} // namespace
+
+// Compares finding the keys of animation tracks with the key cursors
+// of the poses against a binary search on every sample. Playback
+// steps forward by one frame at a time, so the cursor only has to
+// look at the next key or two. Seeking jumps to random times and
+// shows what the fallback to the binary search costs. Both searches
+// have to find the same keys.
+LOW_BENCHMARK(key_search, 4096u)
+{
+  using namespace Low;
+
+  const u32 l_TrackCount = 256u;
+  const float l_Duration = 10.0f;
+
+  PackedTracks l_Tracks;
+  make_tracks(l_Tracks, l_TrackCount, l_Duration);
+
+  // Looping playback at 60 frames per second
+  Util::List<float> l_Playback;
+  l_Playback.reserve(p_Count);
+  for (u32 i = 0u; i < p_Count; ++i) {
+    l_Playback.push_back(std::fmod((float)i / 60.0f, l_Duration));
+  }
+
+  // Seeks to pseudo random times
+  Util::List<float> l_Seeks;
+  l_Seeks.reserve(p_Count);
+  u32 l_Seed = 12345u;
+  for (u32 i = 0u; i < p_Count; ++i) {
+    l_Seed = l_Seed * 1664525u + 1013904223u;
+    l_Seeks.push_back((float)(l_Seed >> 8u) / (float)(1u << 24u) *
+                      l_Duration);
+  }
+
+  const u32 l_SampleCount = p_Count * l_TrackCount;
+  bool l_Passed = true;
+
+  double l_CursorMs = 0.0;
+  double l_BinaryMs = 0.0;
+  l_Passed &= Bench::check(
+      sample(l_Tracks, l_Playback, l_CursorMs, l_BinaryMs),
+      "Cursor found other keys than the binary search during "
+      "playback");
+  Bench::report("Playback cursor", l_CursorMs, l_SampleCount);
+  Bench::report("Playback binary search", l_BinaryMs, l_SampleCount);
+
+  l_Passed &= Bench::check(
+      sample(l_Tracks, l_Seeks, l_CursorMs, l_BinaryMs),
+      "Cursor found other keys than the binary search while "
+      "seeking");
+  Bench::report("Seek cursor", l_CursorMs, l_SampleCount);
+  Bench::report("Seek binary search", l_BinaryMs, l_SampleCount);
+
+  LOW_LOG_INFO << "  " << l_TrackCount << " tracks with "
+               << (u32)l_Tracks.times.size() << " keys"
+               << LOW_LOG_END;
+
+  return l_Passed;
+}
+
+// Samples a clip of a real 80 bone skeleton into p_Count poses
+// through the pose API, which goes over the packed tracks of the clip
+// and starts every sample from the bind pose decomposed at load.
+// Playback steps forward frame by frame and keeps the key cursors of
+// the poses warm, seeking jumps to random times. The cursors have to
+// find the same keys in the tracks of the clip as a binary search.
+LOW_BENCHMARK(pose_sampling, 500u)
+{
+  using namespace Low;
+  using namespace Low::Core;
+
+  const u32 l_FrameCount = 120u;
+  bool l_Passed = true;
+
+  Renderer::Skeleton l_Skeleton = make_skeleton();
+  Renderer::AnimationClip l_RendererClip = make_clip(l_Skeleton);
+  Animation::Clip l_Clip = Animation::Clip::find(
+      l_Skeleton, N(BenchPoseSamplingClip));
+  l_Passed &= Bench::check(l_Clip.is_alive() && l_Clip.is_loaded(),
+                           "Could not find the test clip");
+
+  Util::List<Animation::Pose> l_Poses;
+  l_Poses.reserve(p_Count);
+  for (u32 i = 0u; i < p_Count; ++i) {
+    l_Poses.push_back(Animation::Pose::make(N(BenchPoseSampling)));
+  }
+
+  Util::List<float> l_Playback;
+  Util::List<float> l_Seeks;
+  u32 l_Seed = 12345u;
+  for (u32 i = 0u; i < l_FrameCount; ++i) {
+    l_Playback.push_back((float)i / 60.0f);
+    l_Seeks.push_back(get_noise(l_Seed) * g_ClipDuration);
+  }
+
+  const u32 l_SampleCount = p_Count * l_FrameCount;
+
+  if (l_Clip.is_alive()) {
+    double l_Ms = 0.0;
+    l_Passed &=
+        Bench::check(sample_poses(l_Poses, l_Clip, l_Playback, l_Ms),
+                     "Could not sample the clip during playback");
+    Bench::report("Playback sample", l_Ms, l_SampleCount);
+
+    l_Passed &=
+        Bench::check(sample_poses(l_Poses, l_Clip, l_Seeks, l_Ms),
+                     "Could not sample the clip while seeking");
+    Bench::report("Seek sample", l_Ms, l_SampleCount);
+  }
+
+  bool l_PosesFilled = true;
+  for (Animation::Pose i_Pose : l_Poses) {
+    l_PosesFilled &=
+        i_Pose.get_skinning_pose().get_matrices().size() ==
+        g_BoneCount;
+  }
+  l_Passed &= Bench::check(l_PosesFilled,
+                           "Poses are missing skinning matrices");
+  if (l_PosesFilled && !l_Poses.empty()) {
+    Bench::consume(l_Poses.back()
+                       .get_skinning_pose()
+                       .get_matrices()
+                       .back()[3][0]);
+  }
+
+  // The cursors have to agree with the binary search on the rotation
+  // times of the clip as well
+  const Renderer::AnimationTracks &l_Tracks =
+      l_RendererClip.get_tracks();
+  PackedTracks l_RotationTracks;
+  l_RotationTracks.times = l_Tracks.rotation_times;
+  for (const Renderer::AnimationTrack &i_Track : l_Tracks.tracks) {
+    l_RotationTracks.offsets.push_back(i_Track.rotation_offset);
+    l_RotationTracks.counts.push_back(i_Track.rotation_count);
+  }
+  double l_CursorMs = 0.0;
+  double l_BinaryMs = 0.0;
+  l_Passed &= Bench::check(
+      sample(l_RotationTracks, l_Playback, l_CursorMs, l_BinaryMs) &&
+          sample(l_RotationTracks, l_Seeks, l_CursorMs, l_BinaryMs),
+      "Cursor found other keys than the binary search in the clip");
+
+  LOW_LOG_INFO << "  " << p_Count << " poses of " << g_BoneCount
+               << " bones, " << (u32)l_Tracks.rotation_times.size()
+               << " rotation keys" << LOW_LOG_END;
+
+  for (Animation::Pose i_Pose : l_Poses) {
+    i_Pose.destroy();
+  }
+  if (l_Clip.is_alive()) {
+    l_Clip.destroy();
+  }
+  l_RendererClip.destroy();
+  l_Skeleton.destroy();
+
+  return l_Passed;
+}
@@ -0,0 +1,247 @@
+#include "LowBench.h"
+
+#include "LowUtilLogger.h"
+
+#include "LowCoreAnimationBlender.h"
+#include "LowCoreAnimationLocalPose.h"
+#include "LowCoreAnimationSimd.h"
+
+#include "LowMathQuaternionUtil.h"
+#include "LowMathVectorUtil.h"
+
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+  // Joints of the test skeleton, not a multiple of four so the
+  // padding of the pose gets used as well
+  const u32 g_JointCount = 125u;
+
+  // Joints of the first pose turn by up to half of this angle, the
+  // ones of the second by between half and all of it. Slerp and the
+  // nlerp of the kernels only differ a tiny bit between rotations
+  // that close to each other.
+  const float g_MaxAngle = 0.5f;
+
+  const float g_BlendTolerance = 2e-3f;
+  const float g_MatrixTolerance = 1e-3f;
+
+  // Joints the way poses stored them before the kernels
+  typedef Low::Util::List<Low::Core::Animation::JointPose> JointList;
+
+  float get_noise(u32 &p_Seed)
+  {
+    p_Seed = p_Seed * 1664525u + 1013904223u;
+    return (float)(p_Seed >> 8u) / (float)(1u << 24u);
+  }
+
+  // Every joint hangs off one of the joints before it, which is the
+  // order skeletons are loaded in
+  void
+  make_skeleton(Low::Util::List<Low::Renderer::SkeletonBone> &p_Bones)
+  {
+    p_Bones.resize(g_JointCount);
+    for (u32 i = 0u; i < g_JointCount; ++i) {
+      p_Bones[i].parent_index = i == 0u ? -1 : (i32)((i - 1u) / 2u);
+    }
+  }
+
+  void make_joints(JointList &p_Joints, u32 p_Seed,
+                   float p_AngleOffset)
+  {
+    using namespace Low;
+
+    p_Joints.resize(g_JointCount);
+    for (u32 i = 0u; i < g_JointCount; ++i) {
+      Core::Animation::JointPose &i_Joint = p_Joints[i];
+      i_Joint.position = Math::Vector3(get_noise(p_Seed) - 0.5f,
+                                       get_noise(p_Seed) + 0.1f,
+                                       get_noise(p_Seed) - 0.5f);
+      const Math::Vector3 i_Axis = Math::VectorUtil::normalize(
+          Math::Vector3(get_noise(p_Seed) - 0.5f, 1.0f,
+                        get_noise(p_Seed) - 0.5f));
+      i_Joint.rotation = glm::angleAxis(
+          p_AngleOffset + get_noise(p_Seed) * g_MaxAngle * 0.5f,
+          i_Axis);
+      i_Joint.scale = Math::Vector3(0.9f + get_noise(p_Seed) * 0.2f);
+    }
+  }
+
+  void fill_pose(const JointList &p_Joints,
+                 Low::Core::Animation::LocalPose &p_Pose)
+  {
+    p_Pose.resize((u32)p_Joints.size());
+    for (u32 i = 0u; i < p_Joints.size(); ++i) {
+      p_Pose.set_joint(i, p_Joints[i]);
+    }
+  }
+
+  // The path before the kernels: joint by joint with a slerp
+  void blend_scalar(const JointList &p_A, const JointList &p_B,
+                    float p_Weight, JointList &p_Out)
+  {
+    p_Out.resize(p_A.size());
+    for (u32 i = 0u; i < p_A.size(); ++i) {
+      p_Out[i] = Low::Core::Animation::Blender::blend(p_A[i], p_B[i],
+                                                      p_Weight);
+    }
+  }
+
+  // The path before the kernels: one matrix per joint composed with
+  // glm and multiplied onto its parent
+  void local_to_model_scalar(
+      const JointList &p_Joints,
+      const Low::Util::List<Low::Renderer::SkeletonBone> &p_Bones,
+      Low::Util::List<Low::Math::Matrix4x4> &p_OutMatrices)
+  {
+    using namespace Low;
+
+    p_OutMatrices.resize(p_Joints.size());
+    for (u32 i = 0u; i < p_Joints.size(); ++i) {
+      const Math::Matrix4x4 i_Local =
+          glm::translate(Math::Matrix4x4(1.0f),
+                         p_Joints[i].position) *
+          glm::mat4_cast(p_Joints[i].rotation) *
+          glm::scale(Math::Matrix4x4(1.0f), p_Joints[i].scale);
+
+      const i32 i_Parent = p_Bones[i].parent_index;
+      p_OutMatrices[i] =
+          i_Parent < 0 ? i_Local
+                       : p_OutMatrices[(u32)i_Parent] * i_Local;
+    }
+  }
+
+  bool is_close(float p_A, float p_B, float p_Tolerance)
+  {
+    return std::fabs(p_A - p_B) <= p_Tolerance;
+  }
+
+  bool matches(const Low::Core::Animation::JointPose &p_A,
+               const Low::Core::Animation::JointPose &p_B)
+  {
+    // Both signs of a quaternion are the same rotation
+    const float l_Sign =
+        Low::Math::QuaternionUtil::dot(p_A.rotation, p_B.rotation) <
+                0.0f
+            ? -1.0f
+            : 1.0f;
+    bool l_Match = true;
+    for (u32 i = 0u; i < 3u; ++i) {
+      l_Match &=
+          is_close(p_A.position[i], p_B.position[i],
+                   g_BlendTolerance) &&
+          is_close(p_A.scale[i], p_B.scale[i], g_BlendTolerance);
+    }
+    for (u32 i = 0u; i < 4u; ++i) {
+      l_Match &= is_close(p_A.rotation[i], l_Sign * p_B.rotation[i],
+                          g_BlendTolerance);
+    }
+    return l_Match;
+  }
+
+  bool matches(const Low::Math::Matrix4x4 &p_A,
+               const Low::Math::Matrix4x4 &p_B)
+  {
+    bool l_Match = true;
+    for (u32 c = 0u; c < 4u; ++c) {
+      for (u32 r = 0u; r < 4u; ++r) {
+        l_Match &=
+            is_close(p_A[c][r], p_B[c][r], g_MatrixTolerance);
+      }
+    }
+    return l_Match;
+  }
+} // namespace
+
+// Blends two poses and converts the result to model space matrices,
+// once with the SIMD kernels over the structure of arrays poses and
+// once joint by joint like before the kernels. The results of both
+// have to match. p_Count is the number of times each one runs.
+LOW_BENCHMARK(pose_kernels, 20000u)
+{
+  using namespace Low;
+  using namespace Low::Core::Animation;
+
+  LOW_LOG_INFO << "  SSE kernels: "
+               << (LOW_CORE_ANIMATION_SSE ? "yes" : "no")
+               << LOW_LOG_END;
+
+  Util::List<Renderer::SkeletonBone> l_Bones;
+  make_skeleton(l_Bones);
+
+  JointList l_JointsA;
+  JointList l_JointsB;
+  make_joints(l_JointsA, 1u, 0.0f);
+  make_joints(l_JointsB, 2u, g_MaxAngle * 0.5f);
+
+  LocalPose l_PoseA;
+  LocalPose l_PoseB;
+  fill_pose(l_JointsA, l_PoseA);
+  fill_pose(l_JointsB, l_PoseB);
+
+  const u32 l_JointSamples = p_Count * g_JointCount;
+  bool l_Passed = true;
+
+  // Blend
+  JointList l_ScalarBlend;
+  Bench::Timer l_Timer;
+  for (u32 i = 0u; i < p_Count; ++i) {
+    blend_scalar(l_JointsA, l_JointsB, (float)(i % 8u) / 7.0f,
+                 l_ScalarBlend);
+  }
+  Bench::report("Blend scalar", l_Timer.get_elapsed_ms(),
+                l_JointSamples);
+
+  LocalPose l_SimdBlend;
+  l_Timer.restart();
+  for (u32 i = 0u; i < p_Count; ++i) {
+    Blender::blend(l_PoseA, l_PoseB, (float)(i % 8u) / 7.0f,
+                   l_SimdBlend);
+  }
+  Bench::report("Blend SIMD", l_Timer.get_elapsed_ms(),
+                l_JointSamples);
+
+  for (u32 i = 0u; i < 8u; ++i) {
+    const float i_Weight = (float)i / 7.0f;
+    blend_scalar(l_JointsA, l_JointsB, i_Weight, l_ScalarBlend);
+    Blender::blend(l_PoseA, l_PoseB, i_Weight, l_SimdBlend);
+
+    bool i_Match = l_SimdBlend.joint_count() == g_JointCount;
+    for (u32 j = 0u; j < g_JointCount && i_Match; ++j) {
+      i_Match = matches(l_SimdBlend.get_joint(j), l_ScalarBlend[j]);
+    }
+    l_Passed &= Bench::check(i_Match, "SIMD blend differs from the "
+                                      "scalar blend");
+  }
+
+  // Local to model
+  Util::List<Math::Matrix4x4> l_ScalarMatrices;
+  l_Timer.restart();
+  for (u32 i = 0u; i < p_Count; ++i) {
+    local_to_model_scalar(l_JointsA, l_Bones, l_ScalarMatrices);
+  }
+  Bench::report("Local to model scalar", l_Timer.get_elapsed_ms(),
+                l_JointSamples);
+
+  Util::List<Math::Matrix4x4> l_SimdMatrices;
+  l_Timer.restart();
+  for (u32 i = 0u; i < p_Count; ++i) {
+    local_to_model(l_PoseA, l_Bones, l_SimdMatrices);
+  }
+  Bench::report("Local to model SIMD", l_Timer.get_elapsed_ms(),
+                l_JointSamples);
+
+  bool l_MatricesMatch = l_SimdMatrices.size() == g_JointCount;
+  for (u32 i = 0u; i < g_JointCount && l_MatricesMatch; ++i) {
+    l_MatricesMatch =
+        matches(l_SimdMatrices[i], l_ScalarMatrices[i]);
+  }
+  l_Passed &= Bench::check(l_MatricesMatch,
+                           "SIMD local to model differs from the "
+                           "scalar conversion");
+
+  Bench::consume(l_SimdMatrices[g_JointCount - 1u][3][0] +
+                 l_ScalarMatrices[g_JointCount - 1u][3][0]);
+
+  return l_Passed;
+}
@@ -0,0 +1,113 @@
+#include "LowBench.h"
+
+#include "LowCoreEntity.h"
+#include "LowCoreMeshRenderer.h"
+#include "LowCoreQuery.h"
+#include "LowCoreTransform.h"
+
+// Compares walking the living instances of a component and resolving
+// the related components through the entity with walking the handle
+// table of a query.
+LOW_BENCHMARK(query, 100000u)
+{
+  using namespace Low;
+  using namespace Low::Core;
+
+  Util::List<Entity> l_Entities;
+  l_Entities.reserve(p_Count);
+
+  Bench::Timer l_Timer;
+  float l_ExpectedSum = 0.0f;
+  for (u32 i = 0u; i < p_Count; ++i) {
+    Entity i_Entity = Entity::make(N(BenchEntity));
+    Component::Transform i_Transform =
+        Component::Transform::make(i_Entity);
+    // Small integers keep the float sums exact in any order
+    i_Transform.position(Math::Vector3((float)(i % 16u), 0.0f, 0.0f));
+    Component::MeshRenderer::make(i_Entity);
+
+    l_ExpectedSum += (float)(i % 16u);
+    l_Entities.push_back(i_Entity);
+  }
+  Bench::report("Create entities", l_Timer.get_elapsed_ms(), p_Count);
+
+  l_Timer.restart();
+  float l_HandleSum = 0.0f;
+  for (u32 i = 0u; i < Component::MeshRenderer::living_count(); ++i) {
+    Component::MeshRenderer i_MeshRenderer =
+        Component::MeshRenderer::living_instances()[i];
+    Entity i_Entity = i_MeshRenderer.get_entity();
+    l_HandleSum += i_Entity.get_transform().position().x;
+  }
+  Bench::report("Living instances", l_Timer.get_elapsed_ms(),
+                p_Count);
+
+  l_Timer.restart();
+  const Query::QueryId l_Query =
+      Query::get_query_id<Component::Transform,
+                          Component::MeshRenderer>();
+  Bench::report("Query lookup", l_Timer.get_elapsed_ms(), p_Count);
+
+  l_Timer.restart();
+  float l_QuerySum = 0.0f;
+  Query::for_each<Component::Transform, Component::MeshRenderer>(
+      [&l_QuerySum](Entity p_Entity, Component::Transform p_Transform,
+                    Component::MeshRenderer p_MeshRenderer) {
+        l_QuerySum += p_Transform.position().x;
+      });
+  Bench::report("Query for_each", l_Timer.get_elapsed_ms(), p_Count);
+
+  const u32 l_RowCount = Query::get_row_count(l_Query);
+  Util::List<float> l_ChunkSums(
+      (l_RowCount + LOW_CORE_QUERY_CHUNK_SIZE - 1u) /
+          LOW_CORE_QUERY_CHUNK_SIZE,
+      0.0f);
+
+  l_Timer.restart();
+  Query::parallel_for_each_chunk<Component::Transform,
+                                 Component::MeshRenderer>(
+      [&l_ChunkSums](const Query::Chunk<Component::Transform,
+                                        Component::MeshRenderer>
+                         &p_Chunk) {
+        Component::Transform *l_Transforms =
+            p_Chunk.get<Component::Transform>();
+        float l_Sum = 0.0f;
+        for (u32 i = 0u; i < p_Chunk.count; ++i) {
+          l_Sum += l_Transforms[i].position().x;
+        }
+        l_ChunkSums[p_Chunk.offset / LOW_CORE_QUERY_CHUNK_SIZE] =
+            l_Sum;
+      });
+  Bench::report("Query parallel_for_each_chunk",
+                l_Timer.get_elapsed_ms(), p_Count);
+
+  float l_ParallelSum = 0.0f;
+  for (float i_Sum : l_ChunkSums) {
+    l_ParallelSum += i_Sum;
+  }
+  Bench::consume(l_HandleSum + l_QuerySum + l_ParallelSum);
+
+  // Entities created by the project are part of the query as well,
+  // the benchmark only owns the ones it created
+  bool l_Passed = true;
+  l_Passed &= Bench::check(l_RowCount >= p_Count,
+                           "Query is missing created entities");
+  l_Passed &= Bench::check(l_HandleSum >= l_ExpectedSum &&
+                               l_QuerySum == l_HandleSum &&
+                               l_ParallelSum == l_HandleSum,
+                           "Query iteration visited other rows than "
+                           "the living instances");
+
+  l_Timer.restart();
+  for (Entity i_Entity : l_Entities) {
+    i_Entity.destroy();
+  }
+  Bench::report("Destroy entities", l_Timer.get_elapsed_ms(),
+                p_Count);
+
+  l_Passed &= Bench::check(Query::get_row_count(l_Query) ==
+                               l_RowCount - p_Count,
+                           "Query kept rows of destroyed entities");
+
+  return l_Passed;
+}
@@ -0,0 +1,201 @@
+#include "LowBench.h"
+
+#include "LowUtilLogger.h"
+
+#include "LowCorePhysics.h"
+#include "LowCorePhysicsBody.h"
+#include "LowCorePhysicsBodyMotionType.h"
+#include "LowCorePhysicsShape.h"
+#include "LowCorePhysicsWorld.h"
+
+#include <stdio.h>
+
+#define LOW_BENCH_REPLAY_PATH "lowbench_replay.recording"
+
+namespace {
+  struct BoxPile
+  {
+    Low::Core::Physics::World world;
+    Low::Core::Physics::Shape floorShape;
+    Low::Core::Physics::Shape boxShape;
+    Low::Core::Physics::Body floor;
+    Low::Util::List<Low::Core::Physics::Body> boxes;
+  };
+
+  Low::Core::Physics::Shape
+  make_box_shape(Low::Core::Physics::World p_World,
+                 const Low::Math::Vector3 &p_HalfExtents)
+  {
+    using namespace Low;
+
+    Math::Shape l_Box;
+    l_Box.type = Math::ShapeType::BOX;
+    l_Box.box.position = Math::Vector3(0.0f);
+    l_Box.box.rotation = Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f);
+    l_Box.box.halfExtents = p_HalfExtents;
+    return Core::Physics::Shape::make(p_World, l_Box);
+  }
+
+  // Boxes are dropped in slightly shifted columns so they topple and
+  // keep colliding for the whole recording
+  void make_pile(BoxPile &p_Pile, u32 p_Count)
+  {
+    using namespace Low;
+    using namespace Low::Core;
+
+    p_Pile.world = Physics::World::make(N(BenchReplay));
+    p_Pile.floorShape = make_box_shape(
+        p_Pile.world, Math::Vector3(100.0f, 0.5f, 100.0f));
+    p_Pile.boxShape =
+        make_box_shape(p_Pile.world, Math::Vector3(0.5f));
+
+    p_Pile.world.begin_body_batch();
+    p_Pile.floor = Physics::Body::make(
+        p_Pile.world, p_Pile.floorShape,
+        Math::Vector3(0.0f, -0.5f, 0.0f),
+        Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f),
+        Physics::BodyMotionType::STATIC, 1.0f, false);
+    for (u32 i = 0u; i < p_Count; ++i) {
+      const u32 i_Column = i % 64u;
+      const Math::Vector3 i_Position(
+          (float)(i_Column % 8u) * 1.5f + (float)(i % 3u) * 0.1f,
+          1.0f + (float)(i / 64u) * 1.1f,
+          (float)(i_Column / 8u) * 1.5f);
+      p_Pile.boxes.push_back(Physics::Body::make(
+          p_Pile.world, p_Pile.boxShape, i_Position,
+          Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f),
+          Physics::BodyMotionType::DYNAMIC, 1.0f, false));
+    }
+    p_Pile.world.end_body_batch();
+  }
+
+  void destroy_pile(BoxPile &p_Pile)
+  {
+    for (Low::Core::Physics::Body i_Box : p_Pile.boxes) {
+      i_Box.destroy();
+    }
+    p_Pile.floor.destroy();
+    p_Pile.boxShape.destroy();
+    p_Pile.floorShape.destroy();
+    p_Pile.world.destroy();
+  }
+
+  // Pushes a few boxes from outside the simulation so the recording
+  // has input to replay
+  void push_boxes(BoxPile &p_Pile, u32 p_Frame)
+  {
+    if (p_Frame % 30u) {
+      return;
+    }
+    const u32 l_Count = static_cast<u32>(p_Pile.boxes.size());
+    for (u32 i = p_Frame % 7u; i < l_Count; i += 16u) {
+      p_Pile.boxes[i].set_linear_velocity(
+          Low::Math::Vector3(2.0f, 4.0f, -1.0f));
+    }
+  }
+} // namespace
+
+// Records a pile of falling boxes that get pushed now and then and
+// replays the recording from disk. Every replayed step has to end in
+// the same state hash as the recorded one. A tampered hash has to be
+// reported as the first mismatch, and rolling back to a saved state
+// has to simulate the same steps again.
+LOW_BENCHMARK(replay, 1024u)
+{
+  using namespace Low;
+  using namespace Low::Core;
+
+  const u32 l_FrameCount = 300u;
+  const float l_Delta = 1.0f / 60.0f;
+
+  bool l_Passed = true;
+
+  BoxPile l_Pile;
+  make_pile(l_Pile, p_Count);
+
+  Bench::Timer l_Timer;
+  l_Pile.world.begin_recording();
+  for (u32 i = 0u; i < l_FrameCount; ++i) {
+    push_boxes(l_Pile, i);
+    l_Pile.world.simulate(l_Delta);
+  }
+  Physics::Recording l_Recording;
+  l_Pile.world.end_recording(l_Recording);
+  Bench::report("Record", l_Timer.get_elapsed_ms(), l_FrameCount);
+
+  l_Passed &= Bench::check(!l_Recording.frames.empty(),
+                           "Recording holds no frames");
+
+  l_Passed &= Bench::check(
+      Physics::save_recording(l_Recording, LOW_BENCH_REPLAY_PATH),
+      "Could not write the recording");
+  Physics::Recording l_Loaded;
+  l_Passed &= Bench::check(
+      Physics::load_recording(LOW_BENCH_REPLAY_PATH, l_Loaded) &&
+          l_Loaded.frames.size() == l_Recording.frames.size(),
+      "Could not read the recording back");
+  remove(LOW_BENCH_REPLAY_PATH);
+
+  Physics::ReplayResult l_Result;
+  l_Timer.restart();
+  const bool l_Replayed = l_Pile.world.replay(l_Loaded, l_Result);
+  Bench::report("Replay", l_Timer.get_elapsed_ms(),
+                l_Result.simulated_frames);
+
+  l_Passed &= Bench::check(l_Replayed, "Replay failed");
+  l_Passed &= Bench::check(l_Result.matched,
+                           "Replay diverged from the recording");
+  if (!l_Result.matched) {
+    LOW_LOG_ERROR << "  First mismatch in frame "
+                  << l_Result.first_mismatch << LOW_LOG_END;
+  }
+
+  // The check has to catch a divergence as well
+  if (!l_Loaded.frames.empty()) {
+    const u32 l_Tampered = (u32)l_Loaded.frames.size() / 2u;
+    l_Loaded.frames[l_Tampered].hash ^= 1u;
+    Physics::ReplayResult l_TamperedResult;
+    l_Pile.world.replay(l_Loaded, l_TamperedResult);
+    l_Passed &= Bench::check(!l_TamperedResult.matched &&
+                                 l_TamperedResult.first_mismatch ==
+                                     l_Tampered,
+                             "Replay missed a diverging frame");
+  }
+
+  // Rolling back and simulating the same steps again
+  Util::List<u8> l_State;
+  l_Passed &= Bench::check(l_Pile.world.save_state(l_State),
+                           "Could not save the world state");
+  l_Pile.world.set_deterministic(true);
+  for (u32 i = 0u; i < 60u; ++i) {
+    l_Pile.world.simulate(l_Delta);
+  }
+  const u64 l_FirstHash = l_Pile.world.get_state_hash();
+
+  l_Timer.restart();
+  l_Passed &= Bench::check(l_Pile.world.restore_state(l_State),
+                           "Could not restore the world state");
+  Bench::report("Rollback", l_Timer.get_elapsed_ms(), p_Count);
+  for (u32 i = 0u; i < 60u; ++i) {
+    l_Pile.world.simulate(l_Delta);
+  }
+  l_Passed &=
+      Bench::check(l_Pile.world.get_state_hash() == l_FirstHash,
+                   "Rollback did not simulate the same steps");
+  l_Pile.world.set_deterministic(false);
+
+  LOW_LOG_INFO << "  Recording: " << (u32)l_Recording.frames.size()
+               << " frames, " << (u32)l_Recording.initial_state.size()
+               << " bytes of initial state" << LOW_LOG_END;
+  LOW_LOG_INFO << "  Replay step: "
+               << (float)(l_Result.simulated_frames
+                              ? l_Result.total_step_ms /
+                                    l_Result.simulated_frames
+                              : 0.0)
+               << " ms average, " << (float)l_Result.max_step_ms
+               << " ms max" << LOW_LOG_END;
+
+  destroy_pile(l_Pile);
+
+  return l_Passed;
+}
@@ -0,0 +1,222 @@
+#include "LowBench.h"
+
+#include "LowUtilHandle.h"
+#include "LowUtilLogger.h"
+#include "LowUtilSerialization.h"
+
+#include "LowCoreEntity.h"
+#include "LowCoreRegion.h"
+#include "LowCoreScene.h"
+#include "LowCoreSnapshot.h"
+#include "LowCoreTransform.h"
+
+#include <stdio.h>
+
+#define LOW_BENCH_SNAPSHOT_YAML_PATH "lowbench_snapshot.entities.yaml"
+
+namespace {
+  struct EntityRecord
+  {
+    Low::Util::UniqueId uniqueId;
+    Low::Util::Name name;
+    Low::Math::Vector3 position;
+    Low::Math::Quaternion rotation;
+    Low::Math::Vector3 scale;
+    u64 parentUniqueId;
+  };
+
+  Low::Util::List<EntityRecord>
+  record_entities(Low::Core::Region p_Region)
+  {
+    using namespace Low;
+    using namespace Low::Core;
+
+    Util::List<EntityRecord> l_Records;
+    for (auto it = p_Region.get_entities().begin();
+         it != p_Region.get_entities().end(); ++it) {
+      Entity i_Entity = Util::find_handle_by_unique_id(*it).get_id();
+      Component::Transform i_Transform = i_Entity.get_transform();
+
+      EntityRecord i_Record;
+      i_Record.uniqueId = i_Entity.get_unique_id();
+      i_Record.name = i_Entity.get_name();
+      i_Record.position = i_Transform.position();
+      i_Record.rotation = i_Transform.rotation();
+      i_Record.scale = i_Transform.scale();
+      i_Record.parentUniqueId = i_Transform.get_parent_uid();
+      l_Records.push_back(i_Record);
+    }
+    return l_Records;
+  }
+
+  // Compares the recorded entities with the ones that currently live
+  // under the same unique ids
+  bool verify_entities(const Low::Util::List<EntityRecord> &p_Records,
+                       Low::Core::Region p_Region)
+  {
+    using namespace Low;
+    using namespace Low::Core;
+
+    if (p_Region.get_entities().size() != p_Records.size()) {
+      return false;
+    }
+
+    for (const EntityRecord &i_Record : p_Records) {
+      Entity i_Entity =
+          Util::find_handle_by_unique_id(i_Record.uniqueId).get_id();
+      if (!i_Entity.is_alive() ||
+          i_Entity.get_name() != i_Record.name) {
+        return false;
+      }
+
+      Component::Transform i_Transform = i_Entity.get_transform();
+      if (!i_Transform.is_alive() ||
+          i_Transform.position() != i_Record.position ||
+          i_Transform.rotation() != i_Record.rotation ||
+          i_Transform.scale() != i_Record.scale ||
+          i_Transform.get_parent_uid() != i_Record.parentUniqueId) {
+        return false;
+      }
+
+      // The parent has to know about the restored child as well
+      if (i_Record.parentUniqueId) {
+        Component::Transform i_Parent = i_Transform.get_parent();
+        if (!i_Parent.is_alive() ||
+            i_Parent.get_unique_id() != i_Record.parentUniqueId) {
+          return false;
+        }
+        bool i_Found = false;
+        for (u64 i_Child : i_Parent.get_children()) {
+          i_Found |= i_Child == i_Transform.get_id();
+        }
+        if (!i_Found) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool all_transforms_dirty(Low::Core::Region p_Region)
+  {
+    using namespace Low;
+    using namespace Low::Core;
+
+    for (auto it = p_Region.get_entities().begin();
+         it != p_Region.get_entities().end(); ++it) {
+      Entity i_Entity = Util::find_handle_by_unique_id(*it).get_id();
+      Component::Transform i_Transform = i_Entity.get_transform();
+      if (!i_Transform.is_dirty() || !i_Transform.is_world_dirty()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void destroy_entities(Low::Core::Region p_Region)
+  {
+    using namespace Low;
+    using namespace Low::Core;
+
+    while (!p_Region.get_entities().empty()) {
+      Entity i_Entity = Util::find_handle_by_unique_id(
+                            *p_Region.get_entities().begin())
+                            .get_id();
+      i_Entity.destroy();
+    }
+  }
+} // namespace
+
+// Captures and restores a scene with a snapshot and compares it with
+// saving and loading the same entities through the YAML files that
+// the editor writes. Both paths have to bring back the same data.
+LOW_BENCHMARK(snapshot, 10000u)
+{
+  using namespace Low;
+  using namespace Low::Core;
+
+  Scene l_Scene = Scene::make(N(BenchScene));
+  Region l_Region = Region::make(N(BenchRegion));
+  l_Region.set_scene(l_Scene);
+
+  // Every fourth entity starts a new chain so the snapshot has to
+  // bring back parents as well
+  Entity l_Parent;
+  for (u32 i = 0u; i < p_Count; ++i) {
+    Entity i_Entity = Entity::make(N(BenchEntity), l_Region);
+    Component::Transform i_Transform =
+        Component::Transform::make(i_Entity);
+    i_Transform.position(
+        Math::Vector3((float)i, (float)(i % 7u), -(float)i));
+    i_Transform.rotation(Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f));
+    i_Transform.scale(Math::Vector3(1.0f + (float)(i % 3u)));
+
+    if (i % 4u && l_Parent.is_alive()) {
+      i_Transform.set_parent(l_Parent.get_transform().get_id());
+    }
+    l_Parent = i_Entity;
+  }
+
+  const Util::List<EntityRecord> l_Records =
+      record_entities(l_Region);
+
+  bool l_Passed = true;
+
+  Bench::Timer l_Timer;
+  Util::List<u8> l_Data;
+  Snapshot::capture(l_Scene, l_Data);
+  Bench::report("Snapshot capture", l_Timer.get_elapsed_ms(),
+                p_Count);
+
+  l_Timer.restart();
+  const bool l_Restored = Snapshot::restore(l_Scene, l_Data);
+  Bench::report("Snapshot restore", l_Timer.get_elapsed_ms(),
+                p_Count);
+
+  l_Passed &= Bench::check(l_Restored, "Snapshot restore failed");
+  l_Passed &=
+      Bench::check(verify_entities(l_Records, l_Region),
+                   "Snapshot did not restore the captured entities");
+  l_Passed &= Bench::check(all_transforms_dirty(l_Region),
+                           "Snapshot restore left transforms clean");
+
+  // Capturing the restored scene again has to produce the same
+  // amount of data
+  Util::List<u8> l_SecondData;
+  Snapshot::capture(l_Scene, l_SecondData);
+  l_Passed &= Bench::check(l_SecondData.size() == l_Data.size(),
+                           "Snapshot round trip changed the data");
+
+  l_Timer.restart();
+  Util::Serial::Node l_Node;
+  l_Region.serialize_entities(l_Node);
+  Util::Serial::write_yaml_file(LOW_BENCH_SNAPSHOT_YAML_PATH, l_Node);
+  Bench::report("YAML save", l_Timer.get_elapsed_ms(), p_Count);
+
+  destroy_entities(l_Region);
+
+  l_Timer.restart();
+  Util::Serial::Node l_RootNode =
+      Util::Serial::load_yaml_file(LOW_BENCH_SNAPSHOT_YAML_PATH);
+  Util::Serial::Node l_EntitiesNode = l_RootNode["entities"];
+  for (auto [i_Key, i_Value] : l_EntitiesNode) {
+    Entity::deserialize(i_Value, l_Region);
+  }
+  Util::resolve_all_handle_references();
+  Bench::report("YAML load", l_Timer.get_elapsed_ms(), p_Count);
+
+  remove(LOW_BENCH_SNAPSHOT_YAML_PATH);
+
+  l_Passed &=
+      Bench::check(verify_entities(l_Records, l_Region),
+                   "YAML did not restore the same entities");
+
+  LOW_LOG_INFO << "  Snapshot size: " << (u32)l_Data.size()
+               << " bytes" << LOW_LOG_END;
+
+  destroy_entities(l_Region);
+  l_Region.destroy();
+  l_Scene.destroy();
+
+  return l_Passed;
+}
@@ -0,0 +1,100 @@
+#include "LowBench.h"
+
+#include "LowUtil.h"
+#include "LowUtilLogger.h"
+
+#include "LowRenderer.h"
+
+#include "LowCore.h"
+
+#include <cstring>
+#include <iostream>
+#include <stdlib.h>
+
+// Runs the engine benchmarks without starting the editor or the
+// game loop. Run it from the project directory:
+//
+//   lowbench                  runs every benchmark
+//   lowbench <name> [count]   runs one benchmark with an item count
+//   lowbench --list           prints the available benchmarks
+//
+// Exits with 1 if one of the checks of a benchmark failed.
+
+void *operator new[](size_t size, const char *pName, int flags,
+                     unsigned debugFlags, const char *file, int line)
+{
+  return malloc(size);
+}
+
+void *operator new[](size_t size, size_t alignment,
+                     size_t alignmentOffset, const char *pName,
+                     int flags, unsigned debugFlags, const char *file,
+                     int line)
+{
+  return malloc(size);
+}
+
+static bool run_benchmark(const Low::Bench::Benchmark &p_Benchmark,
+                          u32 p_Count)
+{
+  LOW_LOG_INFO << "Running " << p_Benchmark.name << " with "
+               << p_Count << " items" << LOW_LOG_END;
+
+  const bool l_Result = p_Benchmark.function(p_Count);
+  if (!l_Result) {
+    LOW_LOG_ERROR << p_Benchmark.name << " failed" << LOW_LOG_END;
+  }
+  return l_Result;
+}
+
+int main(int argc, char *argv[])
+{
+  using namespace Low;
+
+  Util::List<Bench::Benchmark> &l_Benchmarks =
+      Bench::get_benchmarks();
+
+  if (argc > 1 && strcmp(argv[1], "--list") == 0) {
+    for (const Bench::Benchmark &i_Benchmark : l_Benchmarks) {
+      std::cout << i_Benchmark.name << std::endl;
+    }
+    return 0;
+  }
+
+  const Bench::Benchmark *l_Selected = nullptr;
+  if (argc > 1) {
+    for (const Bench::Benchmark &i_Benchmark : l_Benchmarks) {
+      if (strcmp(argv[1], i_Benchmark.name) == 0) {
+        l_Selected = &i_Benchmark;
+      }
+    }
+    if (!l_Selected) {
+      std::cerr << "Unknown benchmark '" << argv[1]
+                << "', see lowbench --list" << std::endl;
+      return 2;
+    }
+  }
+
+  Util::set_main_window_initially_hidden(true);
+  Util::initialize();
+  Renderer::initialize();
+  Core::initialize();
+
+  bool l_Passed = true;
+  if (l_Selected) {
+    const u32 l_Count = argc > 2 ? (u32)strtoul(argv[2], nullptr, 10)
+                                 : l_Selected->default_count;
+    l_Passed = run_benchmark(*l_Selected, l_Count);
+  } else {
+    for (const Bench::Benchmark &i_Benchmark : l_Benchmarks) {
+      l_Passed &=
+          run_benchmark(i_Benchmark, i_Benchmark.default_count);
+    }
+  }
+
+  Core::cleanup();
+  Renderer::cleanup();
+  Util::cleanup();
+
+  return l_Passed ? 0 : 1;
+}
@@ -11,7 +11,7 @@
 namespace Low {
   namespace Core {
     namespace Animation {
-      struct WeightedLocalPose
+      struct LOW_CORE_API WeightedLocalPose
       {
         WeightedLocalPose(const LocalPose &p_Pose, float p_Weight);
 
@@ -20,16 +20,30 @@ namespace Low {
       };
 
       namespace Blender {
-        float normalize_weight(float p_Weight);
-
-        JointPose blend(const JointPose &p_A, const JointPose &p_B,
-                        float p_Weight);
-
-        bool blend(const LocalPose &p_A, const LocalPose &p_B,
-                   float p_Weight, LocalPose &p_OutPose);
-
-        bool blend(const Util::List<WeightedLocalPose> &p_Inputs,
-                   LocalPose &p_OutPose);
+        LOW_CORE_API float normalize_weight(float p_Weight);
+
+        LOW_CORE_API JointPose blend(const JointPose &p_A,
+                                     const JointPose &p_B,
+                                     float p_Weight);
+
+        LOW_CORE_API bool blend(const LocalPose &p_A,
+                                const LocalPose &p_B, float p_Weight,
+                                LocalPose &p_OutPose);
+
+        LOW_CORE_API bool
+        blend(const Util::List<WeightedLocalPose> &p_Inputs,
+              LocalPose &p_OutPose);
+
+        // Stores how p_Pose differs from p_Reference so it can be
+        // layered on top of other poses
+        LOW_CORE_API bool make_additive(const LocalPose &p_Pose,
+                                        const LocalPose &p_Reference,
+                                        LocalPose &p_OutPose);
+
+        // Layers an additive pose on top of p_Base
+        LOW_CORE_API bool add(const LocalPose &p_Base,
+                              const LocalPose &p_Additive,
+                              float p_Weight, LocalPose &p_OutPose);
       } // namespace Blender
     }   // namespace Animation
   }     // namespace Core
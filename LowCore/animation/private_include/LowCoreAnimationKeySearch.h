@@ -0,0 +1,54 @@
+#pragma once
+
+#ifndef LOW_CORE_ANIMATION_INTERNAL
+#error "LowCoreAnimationKeySearch.h is private to the LowCore animation module."
+#endif
+
+#include "LowMath.h"
+
+#include <algorithm>
+
+namespace Low {
+  namespace Core {
+    namespace Animation {
+      namespace KeySearch {
+        // Keys the cursor steps over before falling back to a
+        // binary search
+        static const u32 CURSOR_MAX_STEPS = 4u;
+
+        // Returns the last key at or before p_Time
+        inline u32 find_key_binary(const float *p_Times, u32 p_Count,
+                                   float p_Time)
+        {
+          const float *l_Upper =
+              std::upper_bound(p_Times, p_Times + p_Count, p_Time);
+          return l_Upper == p_Times
+                     ? 0u
+                     : static_cast<u32>(l_Upper - p_Times) - 1u;
+        }
+
+        // Same as find_key_binary but starts from the key the last
+        // search of the track ended on. Playback mostly moves
+        // forward by a key or two between samples.
+        inline u32 find_key(const float *p_Times, u32 p_Count,
+                            float p_Time, u32 &p_Cursor)
+        {
+          u32 l_Key = p_Cursor < p_Count ? p_Cursor : 0u;
+          if (p_Times[l_Key] <= p_Time) {
+            for (u32 i = 0u; i < CURSOR_MAX_STEPS; ++i) {
+              if (l_Key + 1u >= p_Count ||
+                  p_Times[l_Key + 1u] > p_Time) {
+                p_Cursor = l_Key;
+                return l_Key;
+              }
+              ++l_Key;
+            }
+          }
+
+          p_Cursor = find_key_binary(p_Times, p_Count, p_Time);
+          return p_Cursor;
+        }
+      } // namespace KeySearch
+    }   // namespace Animation
+  }     // namespace Core
+} // namespace Low
@@ -4,13 +4,17 @@
 #error "LowCoreAnimationLocalPose.h is private to the LowCore animation module."
 #endif
 
+#include "LowCoreApi.h"
+
 #include "LowMath.h"
 #include "LowUtilContainers.h"
 
+#include "LowRendererSkeleton.h"
+
 namespace Low {
   namespace Core {
     namespace Animation {
-      struct JointPose
+      struct LOW_CORE_API JointPose
       {
         Math::Vector3 position;
         Math::Quaternion rotation;
@@ -19,15 +23,57 @@ namespace Low {
         JointPose();
       };
 
-      struct LocalPose
+      enum JointComponent : u32
+      {
+        JOINT_POSITION_X,
+        JOINT_POSITION_Y,
+        JOINT_POSITION_Z,
+        JOINT_ROTATION_X,
+        JOINT_ROTATION_Y,
+        JOINT_ROTATION_Z,
+        JOINT_ROTATION_W,
+        JOINT_SCALE_X,
+        JOINT_SCALE_Y,
+        JOINT_SCALE_Z,
+        JOINT_COMPONENT_COUNT
+      };
+
+      // Joints are stored one component after the other so the
+      // kernels work on four joints at once. Every component block
+      // is padded to a multiple of four joints and the padding is
+      // kept at the identity transform.
+      struct LOW_CORE_API LocalPose
       {
-        Util::List<JointPose> joints;
+        Util::List<float> components;
 
         void clear();
         void resize(u32 p_JointCount);
         u32 joint_count() const;
+        u32 lane_count() const;
         bool empty() const;
+
+        float *get_component(u32 p_Component);
+        const float *get_component(u32 p_Component) const;
+
+        JointPose get_joint(u32 p_Index) const;
+        void set_joint(u32 p_Index, const JointPose &p_Joint);
+        void set_position(u32 p_Index,
+                          const Math::Vector3 &p_Position);
+        void set_rotation(u32 p_Index,
+                          const Math::Quaternion &p_Rotation);
+        void set_scale(u32 p_Index, const Math::Vector3 &p_Scale);
+
+      private:
+        u32 m_JointCount = 0u;
+        u32 m_LaneCount = 0u;
       };
+
+      // Converts the joints of the pose into model space matrices.
+      // Parent bones have to come before their children.
+      LOW_CORE_API void local_to_model(
+          const LocalPose &p_Pose,
+          const Util::List<Renderer::SkeletonBone> &p_Bones,
+          Util::List<Math::Matrix4x4> &p_OutMatrices);
     } // namespace Animation
   } // namespace Core
 } // namespace Low
@@ -0,0 +1,265 @@
+#pragma once
+
+#ifndef LOW_CORE_ANIMATION_INTERNAL
+#error "LowCoreAnimationSimd.h is private to the LowCore animation module."
+#endif
+
+#include "LowMath.h"
+
+#include <algorithm>
+#include <cmath>
+
+// SSE2 is part of every x64 target so it does not need any compiler
+// flags. Other targets run the same kernels on plain floats.
+#if defined(_M_X64) || defined(__SSE2__)
+#define LOW_CORE_ANIMATION_SSE 1
+#include <emmintrin.h>
+#else
+#define LOW_CORE_ANIMATION_SSE 0
+#endif
+
+namespace Low {
+  namespace Core {
+    namespace Animation {
+      namespace Simd {
+        // Lanes of the structure of arrays pose kernels
+        static const u32 LANE_COUNT = 4u;
+
+        struct Float4
+        {
+#if LOW_CORE_ANIMATION_SSE
+          __m128 lanes;
+#else
+          float lanes[LANE_COUNT];
+#endif
+        };
+
+#if LOW_CORE_ANIMATION_SSE
+        inline Float4 load(const float *p_Source)
+        {
+          return Float4{_mm_loadu_ps(p_Source)};
+        }
+
+        inline void store(float *p_Target, Float4 p_Value)
+        {
+          _mm_storeu_ps(p_Target, p_Value.lanes);
+        }
+
+        inline Float4 splat(float p_Value)
+        {
+          return Float4{_mm_set1_ps(p_Value)};
+        }
+
+        inline Float4 add(Float4 p_A, Float4 p_B)
+        {
+          return Float4{_mm_add_ps(p_A.lanes, p_B.lanes)};
+        }
+
+        inline Float4 sub(Float4 p_A, Float4 p_B)
+        {
+          return Float4{_mm_sub_ps(p_A.lanes, p_B.lanes)};
+        }
+
+        inline Float4 mul(Float4 p_A, Float4 p_B)
+        {
+          return Float4{_mm_mul_ps(p_A.lanes, p_B.lanes)};
+        }
+
+        inline Float4 div(Float4 p_A, Float4 p_B)
+        {
+          return Float4{_mm_div_ps(p_A.lanes, p_B.lanes)};
+        }
+
+        inline Float4 max(Float4 p_A, Float4 p_B)
+        {
+          return Float4{_mm_max_ps(p_A.lanes, p_B.lanes)};
+        }
+
+        inline Float4 sqrt(Float4 p_Value)
+        {
+          return Float4{_mm_sqrt_ps(p_Value.lanes)};
+        }
+
+        // Flips p_Value in every lane where p_Sign is negative
+        inline Float4 flip_sign(Float4 p_Value, Float4 p_Sign)
+        {
+          const __m128 l_SignMask = _mm_set1_ps(-0.0f);
+          return Float4{_mm_xor_ps(
+              p_Value.lanes, _mm_and_ps(p_Sign.lanes, l_SignMask))};
+        }
+
+        // Takes p_Fallback in every lane where |p_Value| is below
+        // p_Epsilon
+        inline Float4 replace_small(Float4 p_Value, Float4 p_Fallback,
+                                    float p_Epsilon)
+        {
+          const __m128 l_Abs =
+              _mm_andnot_ps(_mm_set1_ps(-0.0f), p_Value.lanes);
+          const __m128 l_Small =
+              _mm_cmplt_ps(l_Abs, _mm_set1_ps(p_Epsilon));
+          return Float4{
+              _mm_or_ps(_mm_and_ps(l_Small, p_Fallback.lanes),
+                        _mm_andnot_ps(l_Small, p_Value.lanes))};
+        }
+
+        // glm matrices are column major, every column of the result
+        // is a combination of the columns of p_A
+        inline Math::Matrix4x4 multiply(const Math::Matrix4x4 &p_A,
+                                        const Math::Matrix4x4 &p_B)
+        {
+          const __m128 l_A0 = _mm_loadu_ps(&p_A[0][0]);
+          const __m128 l_A1 = _mm_loadu_ps(&p_A[1][0]);
+          const __m128 l_A2 = _mm_loadu_ps(&p_A[2][0]);
+          const __m128 l_A3 = _mm_loadu_ps(&p_A[3][0]);
+
+          Math::Matrix4x4 l_Result;
+          for (u32 i = 0u; i < 4u; ++i) {
+            __m128 i_Column =
+                _mm_mul_ps(l_A0, _mm_set1_ps(p_B[i][0]));
+            i_Column = _mm_add_ps(
+                i_Column, _mm_mul_ps(l_A1, _mm_set1_ps(p_B[i][1])));
+            i_Column = _mm_add_ps(
+                i_Column, _mm_mul_ps(l_A2, _mm_set1_ps(p_B[i][2])));
+            i_Column = _mm_add_ps(
+                i_Column, _mm_mul_ps(l_A3, _mm_set1_ps(p_B[i][3])));
+            _mm_storeu_ps(&l_Result[i][0], i_Column);
+          }
+          return l_Result;
+        }
+#else
+        inline Float4 load(const float *p_Source)
+        {
+          Float4 l_Result;
+          for (u32 i = 0u; i < LANE_COUNT; ++i) {
+            l_Result.lanes[i] = p_Source[i];
+          }
+          return l_Result;
+        }
+
+        inline void store(float *p_Target, Float4 p_Value)
+        {
+          for (u32 i = 0u; i < LANE_COUNT; ++i) {
+            p_Target[i] = p_Value.lanes[i];
+          }
+        }
+
+        inline Float4 splat(float p_Value)
+        {
+          return Float4{{p_Value, p_Value, p_Value, p_Value}};
+        }
+
+        inline Float4 add(Float4 p_A, Float4 p_B)
+        {
+          Float4 l_Result;
+          for (u32 i = 0u; i < LANE_COUNT; ++i) {
+            l_Result.lanes[i] = p_A.lanes[i] + p_B.lanes[i];
+          }
+          return l_Result;
+        }
+
+        inline Float4 sub(Float4 p_A, Float4 p_B)
+        {
+          Float4 l_Result;
+          for (u32 i = 0u; i < LANE_COUNT; ++i) {
+            l_Result.lanes[i] = p_A.lanes[i] - p_B.lanes[i];
+          }
+          return l_Result;
+        }
+
+        inline Float4 mul(Float4 p_A, Float4 p_B)
+        {
+          Float4 l_Result;
+          for (u32 i = 0u; i < LANE_COUNT; ++i) {
+            l_Result.lanes[i] = p_A.lanes[i] * p_B.lanes[i];
+          }
+          return l_Result;
+        }
+
+        inline Float4 div(Float4 p_A, Float4 p_B)
+        {
+          Float4 l_Result;
+          for (u32 i = 0u; i < LANE_COUNT; ++i) {
+            l_Result.lanes[i] = p_A.lanes[i] / p_B.lanes[i];
+          }
+          return l_Result;
+        }
+
+        inline Float4 max(Float4 p_A, Float4 p_B)
+        {
+          Float4 l_Result;
+          for (u32 i = 0u; i < LANE_COUNT; ++i) {
+            l_Result.lanes[i] = std::max(p_A.lanes[i], p_B.lanes[i]);
+          }
+          return l_Result;
+        }
+
+        inline Float4 flip_sign(Float4 p_Value, Float4 p_Sign)
+        {
+          Float4 l_Result;
+          for (u32 i = 0u; i < LANE_COUNT; ++i) {
+            l_Result.lanes[i] = std::signbit(p_Sign.lanes[i])
+                                    ? -p_Value.lanes[i]
+                                    : p_Value.lanes[i];
+          }
+          return l_Result;
+        }
+
+        inline Float4 sqrt(Float4 p_Value)
+        {
+          Float4 l_Result;
+          for (u32 i = 0u; i < LANE_COUNT; ++i) {
+            l_Result.lanes[i] = std::sqrt(p_Value.lanes[i]);
+          }
+          return l_Result;
+        }
+
+        inline Float4 replace_small(Float4 p_Value, Float4 p_Fallback,
+                                    float p_Epsilon)
+        {
+          Float4 l_Result;
+          for (u32 i = 0u; i < LANE_COUNT; ++i) {
+            l_Result.lanes[i] = std::abs(p_Value.lanes[i]) < p_Epsilon
+                                    ? p_Fallback.lanes[i]
+                                    : p_Value.lanes[i];
+          }
+          return l_Result;
+        }
+
+        inline Math::Matrix4x4 multiply(const Math::Matrix4x4 &p_A,
+                                        const Math::Matrix4x4 &p_B)
+        {
+          return p_A * p_B;
+        }
+#endif
+
+        // p_A + (p_B - p_A) * p_Factor
+        inline Float4 lerp(Float4 p_A, Float4 p_B, Float4 p_Factor)
+        {
+          return add(p_A, mul(sub(p_B, p_A), p_Factor));
+        }
+
+        inline Float4 dot(Float4 p_AX, Float4 p_AY, Float4 p_AZ,
+                          Float4 p_AW, Float4 p_BX, Float4 p_BY,
+                          Float4 p_BZ, Float4 p_BW)
+        {
+          return add(add(mul(p_AX, p_BX), mul(p_AY, p_BY)),
+                     add(mul(p_AZ, p_BZ), mul(p_AW, p_BW)));
+        }
+
+        // Normalizes four quaternions at once
+        inline void normalize(Float4 &p_X, Float4 &p_Y, Float4 &p_Z,
+                              Float4 &p_W)
+        {
+          const Float4 l_Length = sqrt(max(
+              dot(p_X, p_Y, p_Z, p_W, p_X, p_Y, p_Z, p_W),
+              splat(LOW_MATH_EPSILON)));
+          const Float4 l_Inverse = div(splat(1.0f), l_Length);
+          p_X = mul(p_X, l_Inverse);
+          p_Y = mul(p_Y, l_Inverse);
+          p_Z = mul(p_Z, l_Inverse);
+          p_W = mul(p_W, l_Inverse);
+        }
+      } // namespace Simd
+    }   // namespace Animation
+  }     // namespace Core
+} // namespace Low
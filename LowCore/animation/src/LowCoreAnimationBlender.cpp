@@ -1,8 +1,11 @@
 #include "LowCoreAnimationBlender.h"
 
+#include "LowCoreAnimationSimd.h"
+
 #include "LowMath.h"
 #include "LowMathQuaternionUtil.h"
 #include "LowMathVectorUtil.h"
+#include "LowUtilAssert.h"
 
 namespace Low {
   namespace Core {
@@ -18,6 +21,82 @@ namespace Low {
           }
           return p_Value;
         }
+
+        // Components that get blended linearly
+        const u32 g_VectorComponents[] = {
+            JOINT_POSITION_X, JOINT_POSITION_Y, JOINT_POSITION_Z,
+            JOINT_SCALE_X,    JOINT_SCALE_Y,    JOINT_SCALE_Z};
+
+        // Rotations of four joints
+        struct Rotation4
+        {
+          Simd::Float4 x;
+          Simd::Float4 y;
+          Simd::Float4 z;
+          Simd::Float4 w;
+        };
+
+        Rotation4 load_rotation(const LocalPose &p_Pose, u32 p_Index)
+        {
+          return Rotation4{
+              Simd::load(p_Pose.get_component(JOINT_ROTATION_X) +
+                         p_Index),
+              Simd::load(p_Pose.get_component(JOINT_ROTATION_Y) +
+                         p_Index),
+              Simd::load(p_Pose.get_component(JOINT_ROTATION_Z) +
+                         p_Index),
+              Simd::load(p_Pose.get_component(JOINT_ROTATION_W) +
+                         p_Index)};
+        }
+
+        void store_rotation(LocalPose &p_Pose, u32 p_Index,
+                            const Rotation4 &p_Rotation)
+        {
+          Simd::store(
+              p_Pose.get_component(JOINT_ROTATION_X) + p_Index,
+              p_Rotation.x);
+          Simd::store(
+              p_Pose.get_component(JOINT_ROTATION_Y) + p_Index,
+              p_Rotation.y);
+          Simd::store(
+              p_Pose.get_component(JOINT_ROTATION_Z) + p_Index,
+              p_Rotation.z);
+          Simd::store(
+              p_Pose.get_component(JOINT_ROTATION_W) + p_Index,
+              p_Rotation.w);
+        }
+
+        Rotation4 shortest_path(const Rotation4 &p_Reference,
+                                const Rotation4 &p_Value)
+        {
+          const Simd::Float4 l_Dot = Simd::dot(
+              p_Reference.x, p_Reference.y, p_Reference.z,
+              p_Reference.w, p_Value.x, p_Value.y, p_Value.z,
+              p_Value.w);
+          return Rotation4{Simd::flip_sign(p_Value.x, l_Dot),
+                           Simd::flip_sign(p_Value.y, l_Dot),
+                           Simd::flip_sign(p_Value.z, l_Dot),
+                           Simd::flip_sign(p_Value.w, l_Dot)};
+        }
+
+        // Same order as glm, p_A * p_B
+        Rotation4 multiply(const Rotation4 &p_A, const Rotation4 &p_B)
+        {
+          using namespace Simd;
+          return Rotation4{
+              sub(add(add(mul(p_A.w, p_B.x), mul(p_A.x, p_B.w)),
+                      mul(p_A.y, p_B.z)),
+                  mul(p_A.z, p_B.y)),
+              sub(add(add(mul(p_A.w, p_B.y), mul(p_A.y, p_B.w)),
+                      mul(p_A.z, p_B.x)),
+                  mul(p_A.x, p_B.z)),
+              sub(add(add(mul(p_A.w, p_B.z), mul(p_A.z, p_B.w)),
+                      mul(p_A.x, p_B.y)),
+                  mul(p_A.y, p_B.x)),
+              sub(sub(sub(mul(p_A.w, p_B.w), mul(p_A.x, p_B.x)),
+                      mul(p_A.y, p_B.y)),
+                  mul(p_A.z, p_B.z))};
+        }
       } // namespace
 
       WeightedLocalPose::WeightedLocalPose(const LocalPose &p_Pose,
@@ -52,14 +131,39 @@ namespace Low {
         bool blend(const LocalPose &p_A, const LocalPose &p_B,
                    float p_Weight, LocalPose &p_OutPose)
         {
+          using namespace Simd;
+
           if (p_A.joint_count() != p_B.joint_count()) {
             return false;
           }
+          LOW_ASSERT(&p_OutPose != &p_A && &p_OutPose != &p_B,
+                     "Cannot blend a pose into one of its inputs");
 
           p_OutPose.resize(p_A.joint_count());
-          for (u32 i = 0u; i < p_A.joint_count(); ++i) {
-            p_OutPose.joints[i] =
-                blend(p_A.joints[i], p_B.joints[i], p_Weight);
+          const u32 l_LaneCount = p_OutPose.lane_count();
+          const Float4 l_Weight = splat(normalize_weight(p_Weight));
+
+          for (u32 c : g_VectorComponents) {
+            const float *c_A = p_A.get_component(c);
+            const float *c_B = p_B.get_component(c);
+            float *c_Out = p_OutPose.get_component(c);
+            for (u32 i = 0u; i < l_LaneCount; i += LANE_COUNT) {
+              store(c_Out + i,
+                    lerp(load(c_A + i), load(c_B + i), l_Weight));
+            }
+          }
+
+          for (u32 i = 0u; i < l_LaneCount; i += LANE_COUNT) {
+            const Rotation4 i_A = load_rotation(p_A, i);
+            const Rotation4 i_B =
+                shortest_path(i_A, load_rotation(p_B, i));
+
+            Rotation4 i_Result{lerp(i_A.x, i_B.x, l_Weight),
+                               lerp(i_A.y, i_B.y, l_Weight),
+                               lerp(i_A.z, i_B.z, l_Weight),
+                               lerp(i_A.w, i_B.w, l_Weight)};
+            normalize(i_Result.x, i_Result.y, i_Result.z, i_Result.w);
+            store_rotation(p_OutPose, i, i_Result);
           }
 
           return true;
@@ -68,6 +172,8 @@ namespace Low {
         bool blend(const Util::List<WeightedLocalPose> &p_Inputs,
                    LocalPose &p_OutPose)
         {
+          using namespace Simd;
+
           u32 l_JointCount = 0u;
           float l_TotalWeight = 0.0f;
           const LocalPose *l_ReferencePose = nullptr;
@@ -78,6 +184,8 @@ namespace Low {
             if (it->weight <= 0.0f) {
               continue;
             }
+            LOW_ASSERT(&i_Pose != &p_OutPose,
+                       "Cannot blend a pose into one of its inputs");
 
             if (!l_ReferencePose) {
               l_ReferencePose = &i_Pose;
@@ -94,42 +202,164 @@ namespace Low {
           }
 
           p_OutPose.resize(l_JointCount);
+          const u32 l_LaneCount = p_OutPose.lane_count();
 
-          for (u32 i = 0u; i < l_JointCount; ++i) {
-            Math::Vector3 l_Position(0.0f);
-            Math::Vector3 l_Scale(0.0f);
-            Math::Quaternion l_Rotation(0.0f, 0.0f, 0.0f, 0.0f);
-            bool l_HasRotationReference = false;
-            Math::Quaternion l_RotationReference =
-                Math::QuaternionUtil::get_identity();
-
-            for (auto it = p_Inputs.begin(); it != p_Inputs.end();
-                 ++it) {
-              if (it->weight <= 0.0f) {
-                continue;
-              }
+          // The first input initializes the output, every other one
+          // gets accumulated on top of it. Rotations are flipped onto
+          // the hemisphere of the first input before they are added.
+          bool l_First = true;
+          for (auto it = p_Inputs.begin(); it != p_Inputs.end();
+               ++it) {
+            if (it->weight <= 0.0f) {
+              continue;
+            }
 
-              const float l_NormalizedWeight =
-                  it->weight / l_TotalWeight;
-              const JointPose &l_Joint = it->pose.get().joints[i];
+            const LocalPose &i_Pose = it->pose.get();
+            const Float4 i_Weight = splat(it->weight / l_TotalWeight);
 
-              l_Position += l_Joint.position * l_NormalizedWeight;
-              l_Scale += l_Joint.scale * l_NormalizedWeight;
+            for (u32 c : g_VectorComponents) {
+              const float *c_In = i_Pose.get_component(c);
+              float *c_Out = p_OutPose.get_component(c);
+              for (u32 j = 0u; j < l_LaneCount; j += LANE_COUNT) {
+                const Float4 j_Value = mul(load(c_In + j), i_Weight);
+                store(c_Out + j, l_First
+                                     ? j_Value
+                                     : add(load(c_Out + j), j_Value));
+              }
+            }
 
-              if (!l_HasRotationReference) {
-                l_RotationReference = l_Joint.rotation;
-                l_HasRotationReference = true;
+            for (u32 j = 0u; j < l_LaneCount; j += LANE_COUNT) {
+              const Rotation4 j_Rotation =
+                  shortest_path(load_rotation(*l_ReferencePose, j),
+                                load_rotation(i_Pose, j));
+              Rotation4 j_Result{mul(j_Rotation.x, i_Weight),
+                                 mul(j_Rotation.y, i_Weight),
+                                 mul(j_Rotation.z, i_Weight),
+                                 mul(j_Rotation.w, i_Weight)};
+              if (!l_First) {
+                const Rotation4 j_Sum = load_rotation(p_OutPose, j);
+                j_Result.x = add(j_Sum.x, j_Result.x);
+                j_Result.y = add(j_Sum.y, j_Result.y);
+                j_Result.z = add(j_Sum.z, j_Result.z);
+                j_Result.w = add(j_Sum.w, j_Result.w);
               }
+              store_rotation(p_OutPose, j, j_Result);
+            }
+
+            l_First = false;
+          }
+
+          for (u32 i = 0u; i < l_LaneCount; i += LANE_COUNT) {
+            Rotation4 i_Rotation = load_rotation(p_OutPose, i);
+            normalize(i_Rotation.x, i_Rotation.y, i_Rotation.z,
+                      i_Rotation.w);
+            store_rotation(p_OutPose, i, i_Rotation);
+          }
+
+          return true;
+        }
+
+        bool make_additive(const LocalPose &p_Pose,
+                           const LocalPose &p_Reference,
+                           LocalPose &p_OutPose)
+        {
+          using namespace Simd;
+
+          if (p_Pose.joint_count() != p_Reference.joint_count()) {
+            return false;
+          }
+          LOW_ASSERT(&p_OutPose != &p_Pose &&
+                         &p_OutPose != &p_Reference,
+                     "Cannot write an additive pose into its inputs");
+
+          p_OutPose.resize(p_Pose.joint_count());
+          const u32 l_LaneCount = p_OutPose.lane_count();
+          const Float4 l_One = splat(1.0f);
+
+          for (u32 i = 0u; i < l_LaneCount; i += LANE_COUNT) {
+            for (u32 c = JOINT_POSITION_X; c <= JOINT_POSITION_Z;
+                 ++c) {
+              store(p_OutPose.get_component(c) + i,
+                    sub(load(p_Pose.get_component(c) + i),
+                        load(p_Reference.get_component(c) + i)));
+            }
 
-              l_Rotation += shortest_path(l_RotationReference,
-                                          l_Joint.rotation) *
-                            l_NormalizedWeight;
+            // Reference joints scaled down to nothing leave the
+            // scale of the pose as it is
+            for (u32 c = JOINT_SCALE_X; c <= JOINT_SCALE_Z; ++c) {
+              store(p_OutPose.get_component(c) + i,
+                    div(load(p_Pose.get_component(c) + i),
+                        replace_small(
+                            load(p_Reference.get_component(c) + i),
+                            l_One, LOW_MATH_EPSILON)));
             }
 
-            p_OutPose.joints[i].position = l_Position;
-            p_OutPose.joints[i].scale = l_Scale;
-            p_OutPose.joints[i].rotation =
-                Math::QuaternionUtil::normalize(l_Rotation);
+            // The inverse of a unit quaternion is its conjugate
+            const Rotation4 i_Reference =
+                load_rotation(p_Reference, i);
+            const Rotation4 i_Inverse{
+                sub(splat(0.0f), i_Reference.x),
+                sub(splat(0.0f), i_Reference.y),
+                sub(splat(0.0f), i_Reference.z), i_Reference.w};
+            Rotation4 i_Delta =
+                multiply(i_Inverse, load_rotation(p_Pose, i));
+            normalize(i_Delta.x, i_Delta.y, i_Delta.z, i_Delta.w);
+            store_rotation(p_OutPose, i, i_Delta);
+          }
+
+          return true;
+        }
+
+        bool add(const LocalPose &p_Base, const LocalPose &p_Additive,
+                 float p_Weight, LocalPose &p_OutPose)
+        {
+          using namespace Simd;
+
+          if (p_Base.joint_count() != p_Additive.joint_count()) {
+            return false;
+          }
+          LOW_ASSERT(&p_OutPose != &p_Base &&
+                         &p_OutPose != &p_Additive,
+                     "Cannot layer a pose into one of its inputs");
+
+          p_OutPose.resize(p_Base.joint_count());
+          const u32 l_LaneCount = p_OutPose.lane_count();
+          const Float4 l_Weight = splat(normalize_weight(p_Weight));
+          const Float4 l_Zero = splat(0.0f);
+          const Float4 l_One = splat(1.0f);
+
+          for (u32 i = 0u; i < l_LaneCount; i += LANE_COUNT) {
+            for (u32 c = JOINT_POSITION_X; c <= JOINT_POSITION_Z;
+                 ++c) {
+              store(p_OutPose.get_component(c) + i,
+                    add(load(p_Base.get_component(c) + i),
+                        mul(load(p_Additive.get_component(c) + i),
+                            l_Weight)));
+            }
+
+            for (u32 c = JOINT_SCALE_X; c <= JOINT_SCALE_Z; ++c) {
+              store(p_OutPose.get_component(c) + i,
+                    mul(load(p_Base.get_component(c) + i),
+                        lerp(l_One,
+                             load(p_Additive.get_component(c) + i),
+                             l_Weight)));
+            }
+
+            // Weights the additive rotation by blending it from the
+            // identity before it gets applied to the base
+            const Rotation4 i_Identity{l_Zero, l_Zero, l_Zero, l_One};
+            const Rotation4 i_Additive = shortest_path(
+                i_Identity, load_rotation(p_Additive, i));
+            Rotation4 i_Delta{lerp(l_Zero, i_Additive.x, l_Weight),
+                              lerp(l_Zero, i_Additive.y, l_Weight),
+                              lerp(l_Zero, i_Additive.z, l_Weight),
+                              lerp(l_One, i_Additive.w, l_Weight)};
+            normalize(i_Delta.x, i_Delta.y, i_Delta.z, i_Delta.w);
+
+            Rotation4 i_Result =
+                multiply(load_rotation(p_Base, i), i_Delta);
+            normalize(i_Result.x, i_Result.y, i_Result.z, i_Result.w);
+            store_rotation(p_OutPose, i, i_Result);
           }
 
           return true;
@@ -1,6 +1,11 @@
 #include "LowCoreAnimationLocalPose.h"
 
+#include "LowCoreAnimationSimd.h"
+
 #include "LowMathQuaternionUtil.h"
+#include "LowUtilAssert.h"
+
+#include <algorithm>
 
 namespace Low {
   namespace Core {
@@ -13,22 +18,211 @@ namespace Low {
 
       void LocalPose::clear()
       {
-        joints.clear();
+        components.clear();
+        m_JointCount = 0u;
+        m_LaneCount = 0u;
       }
 
+      // Resets all joints to the identity transform
       void LocalPose::resize(u32 p_JointCount)
       {
-        joints.resize(p_JointCount);
+        m_JointCount = p_JointCount;
+        m_LaneCount = (p_JointCount + Simd::LANE_COUNT - 1u) /
+                      Simd::LANE_COUNT * Simd::LANE_COUNT;
+        components.resize(JOINT_COMPONENT_COUNT * m_LaneCount);
+
+        for (u32 i = 0u; i < JOINT_COMPONENT_COUNT; ++i) {
+          const float i_Identity =
+              i == JOINT_ROTATION_W || i >= JOINT_SCALE_X ? 1.0f
+                                                          : 0.0f;
+          float *i_Component = get_component(i);
+          std::fill(i_Component, i_Component + m_LaneCount,
+                    i_Identity);
+        }
       }
 
       u32 LocalPose::joint_count() const
       {
-        return static_cast<u32>(joints.size());
+        return m_JointCount;
+      }
+
+      u32 LocalPose::lane_count() const
+      {
+        return m_LaneCount;
       }
 
       bool LocalPose::empty() const
       {
-        return joints.empty();
+        return m_JointCount == 0u;
+      }
+
+      float *LocalPose::get_component(u32 p_Component)
+      {
+        return components.data() + p_Component * m_LaneCount;
+      }
+
+      const float *LocalPose::get_component(u32 p_Component) const
+      {
+        return components.data() + p_Component * m_LaneCount;
+      }
+
+      JointPose LocalPose::get_joint(u32 p_Index) const
+      {
+        LOW_ASSERT(p_Index < m_JointCount,
+                   "Joint index out of range");
+
+        const float *l_Data = components.data() + p_Index;
+        JointPose l_Joint;
+        l_Joint.position = Math::Vector3(
+            l_Data[JOINT_POSITION_X * m_LaneCount],
+            l_Data[JOINT_POSITION_Y * m_LaneCount],
+            l_Data[JOINT_POSITION_Z * m_LaneCount]);
+        l_Joint.rotation = Math::Quaternion(
+            l_Data[JOINT_ROTATION_W * m_LaneCount],
+            l_Data[JOINT_ROTATION_X * m_LaneCount],
+            l_Data[JOINT_ROTATION_Y * m_LaneCount],
+            l_Data[JOINT_ROTATION_Z * m_LaneCount]);
+        l_Joint.scale = Math::Vector3(
+            l_Data[JOINT_SCALE_X * m_LaneCount],
+            l_Data[JOINT_SCALE_Y * m_LaneCount],
+            l_Data[JOINT_SCALE_Z * m_LaneCount]);
+        return l_Joint;
+      }
+
+      void LocalPose::set_joint(u32 p_Index, const JointPose &p_Joint)
+      {
+        set_position(p_Index, p_Joint.position);
+        set_rotation(p_Index, p_Joint.rotation);
+        set_scale(p_Index, p_Joint.scale);
+      }
+
+      void LocalPose::set_position(u32 p_Index,
+                                   const Math::Vector3 &p_Position)
+      {
+        LOW_ASSERT(p_Index < m_JointCount,
+                   "Joint index out of range");
+
+        float *l_Data = components.data() + p_Index;
+        l_Data[JOINT_POSITION_X * m_LaneCount] = p_Position.x;
+        l_Data[JOINT_POSITION_Y * m_LaneCount] = p_Position.y;
+        l_Data[JOINT_POSITION_Z * m_LaneCount] = p_Position.z;
+      }
+
+      void LocalPose::set_rotation(u32 p_Index,
+                                   const Math::Quaternion &p_Rotation)
+      {
+        LOW_ASSERT(p_Index < m_JointCount,
+                   "Joint index out of range");
+
+        float *l_Data = components.data() + p_Index;
+        l_Data[JOINT_ROTATION_X * m_LaneCount] = p_Rotation.x;
+        l_Data[JOINT_ROTATION_Y * m_LaneCount] = p_Rotation.y;
+        l_Data[JOINT_ROTATION_Z * m_LaneCount] = p_Rotation.z;
+        l_Data[JOINT_ROTATION_W * m_LaneCount] = p_Rotation.w;
+      }
+
+      void LocalPose::set_scale(u32 p_Index,
+                                const Math::Vector3 &p_Scale)
+      {
+        LOW_ASSERT(p_Index < m_JointCount,
+                   "Joint index out of range");
+
+        float *l_Data = components.data() + p_Index;
+        l_Data[JOINT_SCALE_X * m_LaneCount] = p_Scale.x;
+        l_Data[JOINT_SCALE_Y * m_LaneCount] = p_Scale.y;
+        l_Data[JOINT_SCALE_Z * m_LaneCount] = p_Scale.z;
+      }
+
+      void local_to_model(
+          const LocalPose &p_Pose,
+          const Util::List<Renderer::SkeletonBone> &p_Bones,
+          Util::List<Math::Matrix4x4> &p_OutMatrices)
+      {
+        using namespace Simd;
+
+        const u32 l_JointCount = p_Pose.joint_count();
+        LOW_ASSERT(l_JointCount == p_Bones.size(),
+                   "Bonecount missmatch between pose and skeleton.");
+        p_OutMatrices.resize(l_JointCount);
+
+        const Float4 l_One = splat(1.0f);
+        const Float4 l_Two = splat(2.0f);
+
+        // The upper 3x3 of four local matrices, column by column
+        float l_Basis[9][LANE_COUNT];
+
+        for (u32 i = 0u; i < l_JointCount; i += LANE_COUNT) {
+          const Float4 i_X =
+              load(p_Pose.get_component(JOINT_ROTATION_X) + i);
+          const Float4 i_Y =
+              load(p_Pose.get_component(JOINT_ROTATION_Y) + i);
+          const Float4 i_Z =
+              load(p_Pose.get_component(JOINT_ROTATION_Z) + i);
+          const Float4 i_W =
+              load(p_Pose.get_component(JOINT_ROTATION_W) + i);
+          const Float4 i_ScaleX =
+              load(p_Pose.get_component(JOINT_SCALE_X) + i);
+          const Float4 i_ScaleY =
+              load(p_Pose.get_component(JOINT_SCALE_Y) + i);
+          const Float4 i_ScaleZ =
+              load(p_Pose.get_component(JOINT_SCALE_Z) + i);
+
+          const Float4 i_XX = mul(i_X, i_X);
+          const Float4 i_YY = mul(i_Y, i_Y);
+          const Float4 i_ZZ = mul(i_Z, i_Z);
+          const Float4 i_XY = mul(i_X, i_Y);
+          const Float4 i_XZ = mul(i_X, i_Z);
+          const Float4 i_YZ = mul(i_Y, i_Z);
+          const Float4 i_WX = mul(i_W, i_X);
+          const Float4 i_WY = mul(i_W, i_Y);
+          const Float4 i_WZ = mul(i_W, i_Z);
+
+          // Same rotation matrix as glm::mat4_cast, every column
+          // scaled by its scale component
+          store(l_Basis[0],
+                mul(sub(l_One, mul(l_Two, add(i_YY, i_ZZ))),
+                    i_ScaleX));
+          store(l_Basis[1],
+                mul(mul(l_Two, add(i_XY, i_WZ)), i_ScaleX));
+          store(l_Basis[2],
+                mul(mul(l_Two, sub(i_XZ, i_WY)), i_ScaleX));
+          store(l_Basis[3],
+                mul(mul(l_Two, sub(i_XY, i_WZ)), i_ScaleY));
+          store(l_Basis[4],
+                mul(sub(l_One, mul(l_Two, add(i_XX, i_ZZ))),
+                    i_ScaleY));
+          store(l_Basis[5],
+                mul(mul(l_Two, add(i_YZ, i_WX)), i_ScaleY));
+          store(l_Basis[6],
+                mul(mul(l_Two, add(i_XZ, i_WY)), i_ScaleZ));
+          store(l_Basis[7],
+                mul(mul(l_Two, sub(i_YZ, i_WX)), i_ScaleZ));
+          store(l_Basis[8],
+                mul(sub(l_One, mul(l_Two, add(i_XX, i_YY))),
+                    i_ScaleZ));
+
+          // Parents have to be resolved before their children so
+          // the hierarchy is walked joint by joint
+          const u32 i_End = std::min(i + LANE_COUNT, l_JointCount);
+          for (u32 j = i; j < i_End; ++j) {
+            const u32 j_Lane = j - i;
+            const Math::Matrix4x4 j_Local(
+                l_Basis[0][j_Lane], l_Basis[1][j_Lane],
+                l_Basis[2][j_Lane], 0.0f, l_Basis[3][j_Lane],
+                l_Basis[4][j_Lane], l_Basis[5][j_Lane], 0.0f,
+                l_Basis[6][j_Lane], l_Basis[7][j_Lane],
+                l_Basis[8][j_Lane], 0.0f,
+                p_Pose.get_component(JOINT_POSITION_X)[j],
+                p_Pose.get_component(JOINT_POSITION_Y)[j],
+                p_Pose.get_component(JOINT_POSITION_Z)[j], 1.0f);
+
+            const i32 j_Parent = p_Bones[j].parent_index;
+            p_OutMatrices[j] =
+                j_Parent < 0
+                    ? j_Local
+                    : multiply(p_OutMatrices[(u32)j_Parent], j_Local);
+          }
+        }
       }
     } // namespace Animation
   } // namespace Core
@@ -13,10 +13,13 @@
 
 // LOW_CODEGEN:BEGIN:CUSTOM:SOURCE_CODE
 #include "LowCoreAnimationBlender.h"
+#include "LowCoreAnimationKeySearch.h"
 #include "LowCoreAnimationLocalPose.h"
+#include "LowCoreAnimationSimd.h"
 #include "LowMathQuaternionUtil.h"
 #include "LowMathVectorUtil.h"
 #include "LowRendererAnimationClipState.h"
+#include "LowRendererAnimationCompression.h"
 #include "LowRendererSkeletonState.h"
 
 #include <cmath>
@@ -64,15 +67,6 @@ namespace Low {
         p_Rotation = Math::QuaternionUtil::normalize(p_Rotation);
       }
 
-      static Math::Matrix4x4
-      make_transform_matrix(const JointPose &p_Joint)
-      {
-        return glm::translate(Math::Matrix4x4(1.0f),
-                              p_Joint.position) *
-               glm::mat4_cast(p_Joint.rotation) *
-               glm::scale(Math::Matrix4x4(1.0f), p_Joint.scale);
-      }
-
       static Math::Matrix4x4
       make_transform_matrix(const Math::Vector3 &p_Position,
                             const Math::Quaternion &p_Rotation,
@@ -83,73 +77,134 @@ namespace Low {
                glm::scale(Math::Matrix4x4(1.0f), p_Scale);
       }
 
-      static Math::Vector3 sample_vector_keys(
-          const Util::List<Renderer::BinSerial::VecKey> &p_Keys,
-          float p_Time, const Math::Vector3 &p_Default)
+      // Remembers the key every track sampled last. Clips mostly play
+      // forward, so the next sample only has to step ahead a key or
+      // two instead of searching the whole track.
+      struct SampleCursor
       {
-        if (p_Keys.empty()) {
-          return p_Default;
-        }
-        if (p_Keys.size() == 1u || p_Time <= p_Keys[0].time) {
-          return p_Keys[0].value;
+        u64 clip_id = 0ull;
+        // Position, rotation and scale key per track
+        Util::List<u32> keys;
+      };
+
+      // Clips that get blended need one cursor per input
+      struct PoseCursors
+      {
+        SampleCursor a;
+        SampleCursor b;
+      };
+
+      static Util::UnorderedMap<u64, PoseCursors> g_PoseCursors;
+
+      static void prepare_cursor(SampleCursor &p_Cursor,
+                                 Renderer::AnimationClip p_Clip)
+      {
+        const u32 l_KeyCount = static_cast<u32>(
+            p_Clip.get_tracks().tracks.size() * 3u);
+        if (p_Cursor.clip_id != p_Clip.get_id() ||
+            p_Cursor.keys.size() != l_KeyCount) {
+          p_Cursor.clip_id = p_Clip.get_id();
+          p_Cursor.keys.clear();
+          p_Cursor.keys.resize(l_KeyCount, 0u);
         }
+      }
 
-        for (u32 i = 0u; i < p_Keys.size() - 1u; ++i) {
-          const Renderer::BinSerial::VecKey &i_Current = p_Keys[i];
-          const Renderer::BinSerial::VecKey &i_Next = p_Keys[i + 1u];
+      static Math::Vector3
+      sample_vector_keys(const float *p_Times,
+                         const Math::Vector3 *p_Values, u32 p_Count,
+                         float p_Time, u32 &p_Cursor)
+      {
+        if (p_Count == 1u || p_Time <= p_Times[0]) {
+          return p_Values[0];
+        }
 
-          if (p_Time <= i_Next.time) {
-            const float i_Duration = i_Next.time - i_Current.time;
-            if (i_Duration <= LOW_MATH_EPSILON) {
-              return i_Current.value;
-            }
+        const u32 l_Key =
+            KeySearch::find_key(p_Times, p_Count, p_Time, p_Cursor);
+        if (l_Key + 1u >= p_Count) {
+          return p_Values[p_Count - 1u];
+        }
 
-            const float i_Factor =
-                (p_Time - i_Current.time) / i_Duration;
-            return Math::VectorUtil::lerp(i_Current.value,
-                                          i_Next.value, i_Factor);
-          }
+        const float l_Duration = p_Times[l_Key + 1u] - p_Times[l_Key];
+        if (l_Duration <= LOW_MATH_EPSILON) {
+          return p_Values[l_Key];
         }
 
-        return p_Keys[p_Keys.size() - 1u].value;
+        const float l_Factor = (p_Time - p_Times[l_Key]) / l_Duration;
+        return Math::VectorUtil::lerp(p_Values[l_Key],
+                                      p_Values[l_Key + 1u], l_Factor);
       }
 
-      static Math::Quaternion sample_quat_keys(
-          const Util::List<Renderer::BinSerial::QuatKey> &p_Keys,
-          float p_Time, const Math::Quaternion &p_Default)
+      // Rotation keys are normalized when the clip gets loaded
+      static Math::Quaternion
+      sample_quat_keys(const float *p_Times,
+                       const Math::Quaternion *p_Values, u32 p_Count,
+                       float p_Time, u32 &p_Cursor)
       {
-        if (p_Keys.empty()) {
-          return p_Default;
+        if (p_Count == 1u || p_Time <= p_Times[0]) {
+          return p_Values[0];
         }
-        if (p_Keys.size() == 1u || p_Time <= p_Keys[0].time) {
-          return Math::QuaternionUtil::normalize(p_Keys[0].value);
+
+        const u32 l_Key =
+            KeySearch::find_key(p_Times, p_Count, p_Time, p_Cursor);
+        if (l_Key + 1u >= p_Count) {
+          return p_Values[p_Count - 1u];
         }
 
-        for (u32 i = 0u; i < p_Keys.size() - 1u; ++i) {
-          const Renderer::BinSerial::QuatKey &i_Current = p_Keys[i];
-          const Renderer::BinSerial::QuatKey &i_Next = p_Keys[i + 1u];
+        const float l_Duration = p_Times[l_Key + 1u] - p_Times[l_Key];
+        if (l_Duration <= LOW_MATH_EPSILON) {
+          return p_Values[l_Key];
+        }
 
-          if (p_Time <= i_Next.time) {
-            const float i_Duration = i_Next.time - i_Current.time;
-            if (i_Duration <= LOW_MATH_EPSILON) {
-              return Math::QuaternionUtil::normalize(i_Current.value);
-            }
+        const float l_Factor = (p_Time - p_Times[l_Key]) / l_Duration;
+        return Math::QuaternionUtil::normalize(
+            Math::QuaternionUtil::slerp(p_Values[l_Key],
+                                        p_Values[l_Key + 1u],
+                                        l_Factor));
+      }
 
-            const float i_Factor =
-                (p_Time - i_Current.time) / i_Duration;
-            return Math::QuaternionUtil::normalize(
-                Math::QuaternionUtil::slerp(i_Current.value,
-                                            i_Next.value, i_Factor));
+      static Util::List<Math::Vector4> g_CurveScratch;
+
+      // Compressed clips find their keys through the segment of the
+      // sample time, they do not need a cursor
+      static void sample_compressed_tracks(
+          const Renderer::CompressedAnimationTracks &p_Tracks,
+          float p_Time, LocalPose &p_OutPose)
+      {
+        Renderer::AnimationCompression::sample(p_Tracks, p_Time,
+                                               g_CurveScratch);
+
+        const u32 l_BoneCount = p_OutPose.joint_count();
+        for (u32 i = 0u; i < p_Tracks.curves.size(); ++i) {
+          const Renderer::AnimationCurve &i_Curve =
+              p_Tracks.curves[i];
+          if (i_Curve.bone_index >= l_BoneCount) {
+            continue;
           }
-        }
 
-        return Math::QuaternionUtil::normalize(
-            p_Keys[p_Keys.size() - 1u].value);
+          const Math::Vector4 &i_Value = g_CurveScratch[i];
+          switch (i_Curve.target) {
+          case Renderer::AnimationCurveTarget::POSITION:
+            p_OutPose.set_position(i_Curve.bone_index,
+                                   Math::Vector3(i_Value));
+            break;
+          case Renderer::AnimationCurveTarget::ROTATION:
+            p_OutPose.set_rotation(
+                i_Curve.bone_index,
+                Math::Quaternion(i_Value.w, i_Value.x, i_Value.y,
+                                 i_Value.z));
+            break;
+          case Renderer::AnimationCurveTarget::SCALE:
+            p_OutPose.set_scale(i_Curve.bone_index,
+                                Math::Vector3(i_Value));
+            break;
+          }
+        }
       }
 
       static bool sample_clip_to_local_pose(Clip p_Clip,
                                             float p_Progress,
                                             bool p_Looping,
+                                            SampleCursor &p_Cursor,
                                             LocalPose &p_OutPose)
       {
         LOW_ASSERT(p_Clip.is_alive(), "Cannot sample dead clip.");
@@ -174,29 +229,58 @@ namespace Low {
         p_OutPose.resize(l_BoneCount);
 
         for (u32 i = 0u; i < l_BoneCount; ++i) {
-          extract_transform_components(
-              l_Bones[i].local_bind_transform,
-              p_OutPose.joints[i].position,
-              p_OutPose.joints[i].rotation,
-              p_OutPose.joints[i].scale);
+          p_OutPose.set_position(i, l_Bones[i].local_bind_position);
+          p_OutPose.set_rotation(i, l_Bones[i].local_bind_rotation);
+          p_OutPose.set_scale(i, l_Bones[i].local_bind_scale);
         }
 
         const float l_Time = normalize_clip_time(
             p_Progress, l_Clip.get_duration(), p_Looping);
 
-        for (const Renderer::AnimationChannel &i_Channel :
-             l_Clip.get_channels()) {
-          if (i_Channel.bone_index >= l_BoneCount) {
+        const Renderer::AnimationTracks &l_Tracks =
+            l_Clip.get_tracks();
+        if (l_Tracks.is_compressed()) {
+          sample_compressed_tracks(l_Tracks.compressed, l_Time,
+                                   p_OutPose);
+          return true;
+        }
+
+        prepare_cursor(p_Cursor, l_Clip);
+        for (u32 i = 0u; i < l_Tracks.tracks.size(); ++i) {
+          const Renderer::AnimationTrack &i_Track =
+              l_Tracks.tracks[i];
+          if (i_Track.bone_index >= l_BoneCount) {
             continue;
           }
 
-          JointPose &i_Joint = p_OutPose.joints[i_Channel.bone_index];
-          i_Joint.position = sample_vector_keys(
-              i_Channel.positions, l_Time, i_Joint.position);
-          i_Joint.rotation = sample_quat_keys(
-              i_Channel.rotations, l_Time, i_Joint.rotation);
-          i_Joint.scale = sample_vector_keys(i_Channel.scales, l_Time,
-                                             i_Joint.scale);
+          const u32 i_Bone = i_Track.bone_index;
+          u32 *i_Keys = &p_Cursor.keys[i * 3u];
+          if (i_Track.position_count > 0u) {
+            p_OutPose.set_position(
+                i_Bone,
+                sample_vector_keys(
+                    &l_Tracks.position_times[i_Track.position_offset],
+                    &l_Tracks
+                         .position_values[i_Track.position_offset],
+                    i_Track.position_count, l_Time, i_Keys[0]));
+          }
+          if (i_Track.rotation_count > 0u) {
+            p_OutPose.set_rotation(
+                i_Bone,
+                sample_quat_keys(
+                    &l_Tracks.rotation_times[i_Track.rotation_offset],
+                    &l_Tracks
+                         .rotation_values[i_Track.rotation_offset],
+                    i_Track.rotation_count, l_Time, i_Keys[1]));
+          }
+          if (i_Track.scale_count > 0u) {
+            p_OutPose.set_scale(
+                i_Bone,
+                sample_vector_keys(
+                    &l_Tracks.scale_times[i_Track.scale_offset],
+                    &l_Tracks.scale_values[i_Track.scale_offset],
+                    i_Track.scale_count, l_Time, i_Keys[2]));
+          }
         }
 
         return true;
@@ -225,22 +309,11 @@ namespace Low {
         Util::List<Math::Matrix4x4> &l_Matrices =
             p_SkinningPose.get_matrices();
         l_Matrices.resize(l_BoneCount);
-        g_GlobalPoseScratch.resize(l_BoneCount);
+        local_to_model(p_LocalPose, l_Bones, g_GlobalPoseScratch);
 
         for (u32 i = 0u; i < l_BoneCount; ++i) {
-          const Math::Matrix4x4 i_Local =
-              make_transform_matrix(p_LocalPose.joints[i]);
-
-          if (l_Bones[i].parent_index < 0) {
-            g_GlobalPoseScratch[i] = i_Local;
-          } else {
-            g_GlobalPoseScratch[i] =
-                g_GlobalPoseScratch[(u32)l_Bones[i].parent_index] *
-                i_Local;
-          }
-
-          l_Matrices[i] =
-              g_GlobalPoseScratch[i] * l_Bones[i].inverse_bind_matrix;
+          l_Matrices[i] = Simd::multiply(
+              g_GlobalPoseScratch[i], l_Bones[i].inverse_bind_matrix);
         }
 
         p_SkinningPose.mark_dirty();
@@ -249,9 +322,11 @@ namespace Low {
 
       static bool sample_clip_to_skinning_pose(
           Clip p_Clip, float p_Progress, bool p_Looping,
+          SampleCursor &p_Cursor,
           Renderer::SkinningPose p_SkinningPose)
       {
         if (!sample_clip_to_local_pose(p_Clip, p_Progress, p_Looping,
+                                       p_Cursor,
                                        g_SamplePoseScratchA)) {
           return false;
         }
@@ -397,6 +472,7 @@ namespace Low {
           if (get_skinning_pose().is_alive()) {
             get_skinning_pose().destroy();
           }
+          g_PoseCursors.erase(get_id());
           // LOW_CODEGEN::END::CUSTOM:DESTROY
         }
 
@@ -1017,7 +1093,8 @@ namespace Low {
         }
 
         return sample_clip_to_skinning_pose(
-            p_Clip, p_Progress, p_Looping, get_skinning_pose());
+            p_Clip, p_Progress, p_Looping, g_PoseCursors[get_id()].a,
+            get_skinning_pose());
         // LOW_CODEGEN::END::CUSTOM:FUNCTION_sample_clip
       }
 
@@ -1033,14 +1110,15 @@ namespace Low {
         LOW_ASSERT(p_SourceA.is_alive(), "Clip V input dead.");
         LOW_ASSERT(p_SourceB.is_alive(), "Clip A input dead.");
 
+        PoseCursors &l_Cursors = g_PoseCursors[get_id()];
         if (!sample_clip_to_local_pose(p_SourceA, p_ProgressA,
-                                       p_Looping,
+                                       p_Looping, l_Cursors.a,
                                        g_SamplePoseScratchA)) {
           LOW_LOG_WARN << "Failed to sample clip A" << LOW_LOG_END;
           return false;
         }
         if (!sample_clip_to_local_pose(p_SourceB, p_ProgressB,
-                                       p_Looping,
+                                       p_Looping, l_Cursors.b,
                                        g_SamplePoseScratchB)) {
           LOW_LOG_WARN << "Failed to sample clip B" << LOW_LOG_END;
           return false;
@@ -229,6 +229,17 @@ namespace Low {
         static Low::Util::Set<
             Low::Core::Component::CharacterController>
             ms_Dirty;
+
+        // move only queues the move, is_grounded and the position of
+        // the capsule controller reflect it after the late tick of
+        // the physics system. The transform follows in that late tick
+        // either way. This moves the capsule right away so it can be
+        // queried in the same frame. Meant for the player.
+        void move_immediate(Low::Math::Vector3 p_Delta);
+
+        // Destroys the capsule controller so the character stops
+        // colliding with others, rebuild creates it again
+        void release_capsule_controller();
         // LOW_CODEGEN::END::CUSTOM:STRUCT_END_CODE
       };
 
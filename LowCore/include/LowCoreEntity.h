@@ -30,6 +30,7 @@ namespace Low {
       public:
         Util::Map<uint16_t, Util::Handle> components;
         Region region;
+        bool active;
         Low::Util::UniqueId unique_id;
         Low::Util::Name name;
 
@@ -150,6 +151,10 @@ namespace Low {
       Region get_region() const;
       void set_region(Region p_Value);
 
+      bool is_active() const;
+      void set_active(bool p_Value);
+      void toggle_active();
+
       Low::Util::UniqueId get_unique_id() const;
 
       Low::Util::Name get_name() const;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "LowCoreApi.h"
+
+#include "LowCoreEntity.h"
+#include "LowCorePrefab.h"
+
+namespace Low {
+  namespace Core {
+    namespace EntityPool {
+      struct Stats
+      {
+        u32 active = 0u;
+        u32 pooled = 0u;
+        u32 created = 0u;
+        u32 reused = 0u;
+      };
+
+      // Pools keep instances of a prefab around after they have been
+      // released. Released entities are deactivated instead of being
+      // destroyed which removes them from rendering and physics until
+      // they get acquired again.
+      //
+      // Entities handed out by a pool have to be given back through
+      // release instead of being destroyed. Releasing any other
+      // entity only logs a warning.
+
+      LOW_CORE_API void warm_up(Prefab p_Prefab, Region p_Region,
+                                u32 p_Count);
+
+      LOW_CORE_API Entity acquire(Prefab p_Prefab, Region p_Region);
+      LOW_CORE_API void release(Entity p_Entity);
+
+      LOW_CORE_API Stats get_stats(Prefab p_Prefab);
+      LOW_CORE_API Stats get_total_stats();
+
+      // Destroys all entities that are currently waiting in the pool
+      // of the prefab
+      LOW_CORE_API void clear(Prefab p_Prefab);
+
+      LOW_CORE_API void cleanup();
+    } // namespace EntityPool
+  }   // namespace Core
+} // namespace Low
@@ -2,12 +2,18 @@
 
 #include "LowUtilEnums.h"
 
+#include "LowCoreEntity.h"
+
 namespace Low {
   namespace Core {
     namespace System {
       namespace MeshRenderer {
         void tick(float p_Delta, Util::EngineState p_State);
         void late_tick(float p_Delta, Util::EngineState p_State);
+
+        // Inactive entities give up their render objects, they get
+        // recreated on the next tick after reactivation
+        void set_entity_active(Entity p_Entity, bool p_Active);
       } // namespace MeshRenderer
     }   // namespace System
   }     // namespace Core
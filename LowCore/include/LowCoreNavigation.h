@@ -10,6 +10,7 @@
 
 namespace Low {
   namespace Core {
+    struct Region;
     struct Scene;
 
     namespace Navigation {
@@ -51,6 +52,14 @@ namespace Low {
           }
           return z < p_Other.z;
         }
+
+        // Packs both coordinates into one value for hashed lookups
+        uint64_t get_key() const
+        {
+          return (static_cast<uint64_t>(static_cast<uint32_t>(x))
+                  << 32u) |
+                 static_cast<uint64_t>(static_cast<uint32_t>(z));
+        }
       };
 
       struct TileRange
@@ -75,6 +84,12 @@ namespace Low {
         Bounds bounds;
         TileState state = TileState::Empty;
         uint64_t backend_tile_ref = 0u;
+        // Time the last build of the tile took on its thread
+        float last_build_ms = 0.0f;
+        // Grows with every tile of the world that gets dirtied.
+        // Among queued tiles of equal priority the ones that have
+        // been waiting the longest get built first.
+        uint64_t dirty_sequence = 0u;
       };
 
       struct BuildGeometry
@@ -85,6 +100,58 @@ namespace Low {
         Bounds bounds;
       };
 
+      // Frozen agents leave the crowd but keep their position and
+      // target. Reduced agents skip the expensive corridor and
+      // avoidance work.
+      enum class CrowdAgentLod : uint8_t
+      {
+        Full,
+        Reduced,
+        Frozen
+      };
+
+      struct CrowdAgentParams
+      {
+        float radius = 0.5f;
+        float height = 2.0f;
+        float max_speed = 3.5f;
+        float max_acceleration = 8.0f;
+      };
+
+      struct CrowdAgentState
+      {
+        Math::Vector3 position = Math::Vector3(0.0f);
+        Math::Vector3 velocity = Math::Vector3(0.0f);
+        CrowdAgentLod lod = CrowdAgentLod::Full;
+        bool on_navmesh = false;
+        bool has_target = false;
+        // Within the agent radius of its target on the ground plane
+        bool reached_target = false;
+      };
+
+      enum class ObstacleShape : uint8_t
+      {
+        Cylinder,
+        Box,
+        OrientedBox
+      };
+
+      // Obstacles cut holes into the navmesh without rasterizing the
+      // tiles they touch again. Meant for doors, vehicles and other
+      // things that block the way for a while.
+      struct Obstacle
+      {
+        ObstacleShape shape = ObstacleShape::Cylinder;
+        // Bottom center of cylinders, center of boxes
+        Math::Vector3 position = Math::Vector3(0.0f);
+        // Cylinders use x as their radius and y as their height,
+        // boxes take it as their half extents
+        Math::Vector3 extents = Math::Vector3(0.5f);
+        // Rotation around the up axis in radians, only used by
+        // oriented boxes
+        float yaw = 0.0f;
+      };
+
       LOW_STRUCT(scripting, bind_namespace = "Navigation")
       struct NearestPointResult
       {
@@ -103,6 +170,40 @@ namespace Low {
         bool partial = false;
       };
 
+      enum class PathRequestStatus : uint8_t
+      {
+        Pending,
+        Succeeded,
+        Failed
+      };
+
+      struct PathQuery
+      {
+        Math::Vector3 start = Math::Vector3(0.0f);
+        Math::Vector3 end = Math::Vector3(0.0f);
+        Math::Vector3 half_extents = Math::Vector3(1.0f);
+      };
+
+      // Rays walk along the surface of the navmesh from the point
+      // closest to their start and stop at the first wall
+      struct RaycastQuery
+      {
+        Math::Vector3 start = Math::Vector3(0.0f);
+        Math::Vector3 end = Math::Vector3(0.0f);
+        Math::Vector3 half_extents = Math::Vector3(1.0f);
+      };
+
+      struct RaycastResult
+      {
+        // False if the start is not on the navmesh
+        bool valid = false;
+        bool hit = false;
+        // Share of the way to the end the ray made it
+        float fraction = 0.0f;
+        Math::Vector3 position = Math::Vector3(0.0f);
+        Math::Vector3 normal = Math::Vector3(0.0f);
+      };
+
       LOW_CORE_API bool
       collect_build_geometry(BuildGeometry *p_Geometry);
 
@@ -112,7 +213,8 @@ namespace Low {
 
       LOW_CORE_API bool collect_build_geometry_for_world_bounds(
           World p_World, const Bounds &p_Bounds,
-          BuildGeometry *p_Geometry);
+          BuildGeometry *p_Geometry,
+          bool p_IncludeDynamicSources = true);
 
       LOW_CORE_API bool refresh_source_bounds(Source p_Source);
 
@@ -121,6 +223,10 @@ namespace Low {
 
       LOW_CORE_API bool mark_source_dirty(Source p_Source);
 
+      // Drops the cached geometry of the source and removes it from
+      // the tile lookup of its world
+      LOW_CORE_API void forget_source(Source p_Source);
+
       LOW_CORE_API TileCoord world_to_tile_coord(
           Math::Vector3 p_Position, float p_TileWorldSize);
 
@@ -167,7 +273,10 @@ namespace Low {
 
       LOW_CORE_API bool remove_tile(World p_World, TileCoord p_Coord);
 
-      LOW_CORE_API bool queue_tile(World p_World, TileCoord p_Coord);
+      // Queued tiles are built in order of their priority, lowest
+      // first
+      LOW_CORE_API bool queue_tile(World p_World, TileCoord p_Coord,
+                                   float p_Priority = 0.0f);
 
       LOW_CORE_API uint32_t update_invoker_tiles(World p_World,
                                                  float p_MinY,
@@ -187,15 +296,180 @@ namespace Low {
 
       LOW_CORE_API uint64_t get_navmesh_revision(World p_World);
 
-      LOW_CORE_API uint32_t
-      update_tile_builds(World p_World, uint32_t p_MaxTilesToBuild);
+      // Starts builds for up to p_MaxTilesToStart queued tiles on
+      // the job workers and adds the tiles of finished builds to the
+      // navmesh. Snapshotting geometry and adding tiles stops once
+      // p_BudgetMs is used up, zero means no budget. At most
+      // p_MaxRunningBuilds builds run at once, zero picks the
+      // number of workers. Returns the number of tiles that
+      // finished building.
+      LOW_CORE_API uint32_t update_tile_builds(
+          World p_World, uint32_t p_MaxTilesToStart,
+          float p_BudgetMs = 0.0f, uint32_t p_MaxRunningBuilds = 0u);
 
       LOW_CORE_API bool build_tile(World p_World, TileCoord p_Coord);
 
+      LOW_CORE_API bool start_tile_build(World p_World,
+                                         TileCoord p_Coord);
+
+      LOW_CORE_API bool collect_tile_build_geometry(
+          World p_World, TileCoord p_Coord, BuildGeometry *p_Geometry,
+          bool p_IncludeDynamicSources = true);
+
       LOW_CORE_API bool
       build_tile_from_geometry(World p_World, TileCoord p_Coord,
                                const BuildGeometry &p_Geometry);
 
+      // Returns zero if the world has no room for another obstacle.
+      // Obstacles show up in the navmesh with the next
+      // update_obstacles.
+      LOW_CORE_API uint32_t add_obstacle(World p_World,
+                                         const Obstacle &p_Obstacle);
+
+      LOW_CORE_API bool remove_obstacle(World p_World,
+                                        uint32_t p_Obstacle);
+
+      LOW_CORE_API uint32_t get_obstacle_count(World p_World);
+
+      LOW_CORE_API bool update_obstacles(World p_World);
+
+      // Tiles keep the rasterized heightfield layers they were built
+      // from. Loading layers that were saved with the same build
+      // settings replaces all tiles of the world without having to
+      // rasterize their geometry again.
+      LOW_CORE_API void
+      save_tile_layers(World p_World,
+                       Low::Util::List<uint8_t> &p_Data);
+
+      LOW_CORE_API bool
+      load_tile_layers(World p_World,
+                       const Low::Util::List<uint8_t> &p_Data);
+
+      // A baked navmesh holds the tiles built from the static sources
+      // of a scene. Every tile remembers the regions whose sources
+      // touch it and is only part of the navmesh while one of them
+      // is loaded. Static sources leave baked tiles alone, only
+      // dynamic sources rebuild them at runtime.
+      LOW_CORE_API void save_baked_tiles(
+          World p_World,
+          const Low::Util::UnorderedMap<
+              uint64_t, Low::Util::List<uint64_t>> &p_TileOwners,
+          Low::Util::List<uint8_t> &p_Data);
+
+      LOW_CORE_API bool
+      set_baked_tiles(World p_World,
+                      const Low::Util::List<uint8_t> &p_Data);
+
+      LOW_CORE_API void clear_baked_tiles(World p_World);
+
+      LOW_CORE_API bool is_baked_tile(World p_World,
+                                      TileCoord p_Coord);
+
+      LOW_CORE_API uint32_t get_baked_tile_count(World p_World);
+
+      LOW_CORE_API uint32_t stream_in_baked_tiles(World p_World,
+                                                  uint64_t p_Owner);
+
+      LOW_CORE_API uint32_t stream_out_baked_tiles(World p_World,
+                                                   uint64_t p_Owner);
+
+      LOW_CORE_API Low::Util::String
+      get_baked_navmesh_path(Scene p_Scene);
+
+      // Builds every tile the static sources of the loaded regions of
+      // the scene touch and writes them to its baked navmesh
+      LOW_CORE_API bool bake_navmesh(Scene p_Scene);
+
+      // Fails if the scene has no baked navmesh or if it was baked
+      // with another format version or other build settings. The
+      // tiles of the scene are built at runtime in that case.
+      LOW_CORE_API bool load_baked_navmesh(Scene p_Scene);
+
+      LOW_CORE_API void unload_baked_navmesh(Scene p_Scene);
+
+      LOW_CORE_API uint32_t stream_in_region(Region p_Region);
+
+      LOW_CORE_API uint32_t stream_out_region(Region p_Region);
+
+      // Path requests are searched a slice at a time by
+      // update_path_requests, which shares p_MaxIterations search
+      // iterations among the running searches, zero means no limit.
+      // Requests between the same navmesh polygons share one search
+      // and found corridors are cached until the navmesh changes.
+      // Finished requests are handed out once by poll_path_request.
+      LOW_CORE_API uint32_t
+      request_path(World p_World, const Math::Vector3 &p_Start,
+                   const Math::Vector3 &p_End,
+                   const Math::Vector3 &p_HalfExtents);
+
+      LOW_CORE_API PathRequestStatus
+      poll_path_request(World p_World, uint32_t p_Request,
+                        PathResult *p_Result);
+
+      LOW_CORE_API bool cancel_path_request(World p_World,
+                                            uint32_t p_Request);
+
+      LOW_CORE_API uint32_t
+      get_pending_path_request_count(World p_World);
+
+      LOW_CORE_API uint32_t
+      update_path_requests(World p_World, uint32_t p_MaxIterations);
+
+      // Runs the queries on the job workers and waits for them.
+      // Paths that could not be found have no points. Returns the
+      // number of found paths.
+      LOW_CORE_API uint32_t
+      find_path_batch(World p_World,
+                      const Low::Util::List<PathQuery> &p_Queries,
+                      Low::Util::List<PathResult> &p_Results);
+
+      // Returns the number of rays that hit a wall
+      LOW_CORE_API uint32_t
+      raycast_batch(World p_World,
+                    const Low::Util::List<RaycastQuery> &p_Queries,
+                    Low::Util::List<RaycastResult> &p_Results);
+
+      // Crowd agents follow their corridor on the navmesh of the
+      // world and avoid each other. Targets are queued and only
+      // p_MaxTargetRequests of them are handed to the crowd per
+      // update, zero means all of them. Agent ids stay valid until
+      // the agent is removed, even when the navmesh gets rebuilt.
+      LOW_CORE_API int
+      add_crowd_agent(World p_World, const Math::Vector3 &p_Position,
+                      const CrowdAgentParams &p_Params);
+
+      LOW_CORE_API bool remove_crowd_agent(World p_World,
+                                           int p_Agent);
+
+      LOW_CORE_API bool
+      set_crowd_agent_params(World p_World, int p_Agent,
+                             const CrowdAgentParams &p_Params);
+
+      LOW_CORE_API bool
+      set_crowd_agent_target(World p_World, int p_Agent,
+                             const Math::Vector3 &p_Target);
+
+      LOW_CORE_API bool clear_crowd_agent_target(World p_World,
+                                                 int p_Agent);
+
+      LOW_CORE_API bool
+      set_crowd_agent_position(World p_World, int p_Agent,
+                               const Math::Vector3 &p_Position);
+
+      LOW_CORE_API bool set_crowd_agent_lod(World p_World,
+                                            int p_Agent,
+                                            CrowdAgentLod p_Lod);
+
+      LOW_CORE_API bool
+      get_crowd_agent_state(World p_World, int p_Agent,
+                            CrowdAgentState *p_State);
+
+      LOW_CORE_API uint32_t get_crowd_agent_count(World p_World);
+
+      LOW_CORE_API uint32_t
+      update_crowd(World p_World, float p_Delta,
+                   uint32_t p_MaxTargetRequests);
+
       LOW_CORE_API BuildSettings get_project_build_settings();
 
       LOW_CORE_API bool save_project_build_settings(
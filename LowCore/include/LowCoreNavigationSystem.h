@@ -2,11 +2,24 @@
 
 #include "LowUtilEnums.h"
 
+#include "LowMath.h"
+
 namespace Low {
   namespace Core {
+    namespace Component {
+      struct NavmeshAgent;
+    }
+
     namespace System {
       namespace Navigation {
         void tick(float p_Delta, Util::EngineState p_State);
+
+        // Agents join the crowd of their scene's navigation world on
+        // the next tick. Targets set before that are handed over
+        // once they did.
+        void set_agent_target(Component::NavmeshAgent p_Agent,
+                              const Math::Vector3 &p_Target);
+        void remove_agent(Component::NavmeshAgent p_Agent);
       } // namespace Navigation
     }   // namespace System
   }     // namespace Core
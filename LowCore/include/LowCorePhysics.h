@@ -3,7 +3,9 @@
 #include "LowCoreApi.h"
 
 #include "LowMath.h"
+#include "LowUtilContainers.h"
 #include "LowUtilHandle.h"
+#include "LowUtilName.h"
 
 #include <cstdint>
 
@@ -48,6 +50,173 @@ namespace Low {
         HitObjectFamily family = HitObjectFamily::None;
       };
 
+      // Collision layers are set up in the project settings under
+      // physics/layers. Layer 0 is used for static and layer 1 for
+      // moving bodies unless a body gets moved to another layer.
+      const u32 COLLISION_LAYER_COUNT = 32u;
+      const u32 ALL_COLLISION_LAYERS = 0xFFFFFFFFu;
+
+      // Layers are grouped into these broad phase trees. Keeping
+      // rarely moving and short lived bodies apart keeps the trees
+      // of the other groups small.
+      enum class BroadPhaseGroup : uint8_t
+      {
+        Static,
+        Dynamic,
+        Sensor,
+        Debris,
+        Count
+      };
+
+      struct CollisionLayer
+      {
+        Low::Util::Name name;
+        BroadPhaseGroup group = BroadPhaseGroup::Dynamic;
+        // Bit n set means this layer collides with layer n. Two
+        // layers only collide if both of them agree.
+        u32 collision_mask = ALL_COLLISION_LAYERS;
+      };
+
+      struct CollisionLayerSettings
+      {
+        u32 layer_count = 0u;
+        CollisionLayer layers[COLLISION_LAYER_COUNT];
+      };
+
+      LOW_CORE_API CollisionLayerSettings
+      get_default_collision_layers();
+      LOW_CORE_API CollisionLayerSettings
+      get_project_collision_layers();
+      LOW_CORE_API bool save_project_collision_layers(
+          const CollisionLayerSettings &p_Settings);
+      // Returns COLLISION_LAYER_COUNT if no layer has that name
+      LOW_CORE_API u32
+      find_collision_layer(const CollisionLayerSettings &p_Settings,
+                           Low::Util::Name p_Name);
+
+      enum class ContactEventType : uint8_t
+      {
+        Begin,
+        Persist,
+        End
+      };
+
+      enum class TriggerEventType : uint8_t
+      {
+        Enter,
+        Exit
+      };
+
+      // Contacts are reported per pair of bodies. Persist is sent at
+      // most once per pair and frame.
+      struct ContactEvent
+      {
+        ContactEventType type = ContactEventType::Begin;
+        Low::Util::Handle body_a;
+        Low::Util::Handle body_b;
+        Math::Vector3 point = Math::Vector3(0.0f);
+        // Points from body_a towards body_b
+        Math::Vector3 normal = Math::Vector3(0.0f);
+      };
+
+      struct TriggerEvent
+      {
+        TriggerEventType type = TriggerEventType::Enter;
+        Low::Util::Handle trigger;
+        Low::Util::Handle other;
+      };
+
+      enum class QueryMode : uint8_t
+      {
+        Closest,
+        All
+      };
+
+      enum class OverlapShape : uint8_t
+      {
+        Sphere,
+        Box
+      };
+
+      struct RaycastRequest
+      {
+        Math::Vector3 origin = Math::Vector3(0.0f);
+        Math::Vector3 direction = Math::Vector3(0.0f, 0.0f, 1.0f);
+        float max_distance = 0.0f;
+        u32 layer_mask = ALL_COLLISION_LAYERS;
+      };
+
+      struct OverlapRequest
+      {
+        OverlapShape shape = OverlapShape::Sphere;
+        Math::Vector3 position = Math::Vector3(0.0f);
+        Math::Quaternion rotation =
+            Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f);
+        // Used by spheres
+        float radius = 0.5f;
+        // Used by boxes
+        Math::Vector3 half_extents = Math::Vector3(0.5f);
+        u32 layer_mask = ALL_COLLISION_LAYERS;
+      };
+
+      // Hits of a query are stored next to each other in the hit list
+      // that belongs to the batch, starting at first_hit
+      struct QueryResult
+      {
+        u32 first_hit = 0u;
+        u32 hit_count = 0u;
+      };
+
+      const u32 INVALID_QUERY_TICKET = 0u;
+
+      // Characters further than full_rate_distance away from the
+      // focus only get updated every reduced_rate_interval frames
+      // and do not walk stairs
+      struct CharacterUpdateSettings
+      {
+        bool use_focus = false;
+        Math::Vector3 focus = Math::Vector3(0.0f);
+        float full_rate_distance = 30.0f;
+        u32 reduced_rate_interval = 4u;
+        // Characters only collide with characters in the surrounding
+        // cells, this has to be larger than a character plus the
+        // distance it moves per update
+        float cell_size = 4.0f;
+      };
+
+      // One fixed step of a recording. input holds the bodies that
+      // were changed from outside the simulation before the step,
+      // hash the state of all bodies after it.
+      struct RecordingFrame
+      {
+        Util::List<u8> input;
+        u64 hash = 0u;
+      };
+
+      struct Recording
+      {
+        float fixed_delta = 1.0f / 60.0f;
+        u32 collision_steps = 1u;
+        Util::List<u8> initial_state;
+        Util::List<RecordingFrame> frames;
+      };
+
+      struct ReplayResult
+      {
+        bool matched = false;
+        u32 simulated_frames = 0u;
+        // Index of the first frame whose hash differed, equal to the
+        // frame count if all of them matched
+        u32 first_mismatch = 0u;
+        double total_step_ms = 0.0;
+        double max_step_ms = 0.0;
+      };
+
+      LOW_CORE_API bool save_recording(const Recording &p_Recording,
+                                       const Util::String &p_Path);
+      LOW_CORE_API bool load_recording(const Util::String &p_Path,
+                                       Recording &p_Recording);
+
       LOW_FUNCTION(scripting, bind_name = "raycast",
                    bind_namespace = "Physics")
       bool raycast(const Math::Vector3 &p_Origin,
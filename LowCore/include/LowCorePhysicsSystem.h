@@ -4,14 +4,46 @@
 
 #include "LowUtilEnums.h"
 
+#include "LowMath.h"
+
+#include "LowCoreEntity.h"
+
 namespace Low {
   namespace Core {
     namespace System {
       namespace Physics {
+        // Distances are measured from the focus, which is the game
+        // camera unless use_focus is set. A distance of zero turns
+        // the matching level of detail off.
+        struct LodSettings
+        {
+          bool use_focus = false;
+          Math::Vector3 focus = Math::Vector3(0.0f);
+          // All bodies of a loaded streaming region get frozen
+          // together once its streaming position is farther away
+          float region_freeze_distance = 250.0f;
+          // Dynamic bodies farther away get frozen where they are
+          float freeze_distance = 150.0f;
+          // Dynamic bodies farther away only write their transform
+          // back every reduced_interval frames
+          float reduced_distance = 60.0f;
+          u32 reduced_interval = 4u;
+        };
+
         LOW_CORE_API void tick(float p_Delta,
                                Util::EngineState p_State);
         LOW_CORE_API void late_tick(float p_Delta,
                                     Util::EngineState p_State);
+
+        // Removes the bodies and the character capsule of the entity
+        // from the simulation while it is inactive and adds them
+        // back once it gets reactivated
+        LOW_CORE_API void set_entity_active(Entity p_Entity,
+                                            bool p_Active);
+
+        LOW_CORE_API void
+        set_lod_settings(const LodSettings &p_Settings);
+        LOW_CORE_API const LodSettings &get_lod_settings();
       } // namespace Physics
     } // namespace System
   } // namespace Core
@@ -180,7 +180,16 @@ namespace Low {
       void set_unique_id(Low::Util::UniqueId p_Value);
 
       // LOW_CODEGEN:BEGIN:CUSTOM:STRUCT_END_CODE
-
+    public:
+      // Spawns p_Count instances from the compiled spawn template of
+      // this prefab. Positions and rotations are optional and get
+      // applied to the root of each instance.
+      void spawn_batch(Region p_Region, u32 p_Count,
+                       const Math::Vector3 *p_Positions,
+                       const Math::Quaternion *p_Rotations,
+                       Util::List<Entity> &p_Entities);
+
+      static void invalidate_spawn_templates();
       // LOW_CODEGEN::END::CUSTOM:STRUCT_END_CODE
     };
 
@@ -0,0 +1,146 @@
+#pragma once
+
+#include "LowCoreApi.h"
+
+#include "LowUtilContainers.h"
+#include "LowUtilHandle.h"
+#include "LowUtilJobManager.h"
+
+#include "LowCoreEntity.h"
+
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+#define LOW_CORE_QUERY_CHUNK_SIZE 64u
+
+namespace Low {
+  namespace Core {
+    namespace Query {
+      typedef u32 QueryId;
+
+      // A query keeps a packed table with one row per entity that
+      // holds all of the requested component types. The table is
+      // built once on first use and is kept up to date incrementally
+      // whenever a component of one of the types gets added or
+      // removed.
+      //
+      // The columns of the table hold the component handles, not the
+      // component data. The data stays in the pages of its type, so
+      // reading a property still goes through the handle. What the
+      // table saves is finding the entity and its other components.
+      //
+      // Adding or removing components of queried types while
+      // iterating over that same query is not supported.
+
+      LOW_CORE_API QueryId register_query(const u16 *p_ComponentTypes,
+                                          u32 p_ComponentTypeCount);
+
+      LOW_CORE_API u32 get_row_count(QueryId p_Query);
+      LOW_CORE_API Entity *get_entities(QueryId p_Query);
+      LOW_CORE_API u64 *get_column(QueryId p_Query, u32 p_Column);
+
+      LOW_CORE_API void notify_component_added(Entity p_Entity,
+                                               u16 p_ComponentType);
+      LOW_CORE_API void notify_component_removed(Entity p_Entity,
+                                                 u16 p_ComponentType);
+
+      LOW_CORE_API void cleanup();
+
+      template <typename... TComponents> struct Chunk
+      {
+        u32 offset;
+        u32 count;
+        Entity *entities;
+        std::tuple<TComponents *...> columns;
+
+        template <typename T> T *get() const
+        {
+          return std::get<T *>(columns);
+        }
+      };
+
+      template <typename... TComponents> QueryId get_query_id()
+      {
+        const u16 l_ComponentTypes[] = {TComponents::type_id()...};
+        return register_query(l_ComponentTypes,
+                              sizeof...(TComponents));
+      }
+
+      namespace Internal {
+        template <typename... TComponents, size_t... TIndices>
+        Chunk<TComponents...>
+        make_chunk(QueryId p_Query, u32 p_Offset, u32 p_Count,
+                   std::index_sequence<TIndices...>)
+        {
+          Chunk<TComponents...> l_Chunk;
+          l_Chunk.offset = p_Offset;
+          l_Chunk.count = p_Count;
+          l_Chunk.entities = get_entities(p_Query) + p_Offset;
+          l_Chunk.columns = std::make_tuple(
+              reinterpret_cast<TComponents *>(
+                  get_column(p_Query, TIndices)) +
+              p_Offset...);
+          return l_Chunk;
+        }
+      } // namespace Internal
+
+      template <typename... TComponents, typename TFunc>
+      void for_each_chunk(TFunc &&p_Func)
+      {
+        const QueryId l_Query = get_query_id<TComponents...>();
+        const u32 l_RowCount = get_row_count(l_Query);
+
+        for (u32 i = 0u; i < l_RowCount;
+             i += LOW_CORE_QUERY_CHUNK_SIZE) {
+          const u32 i_Count =
+              std::min(LOW_CORE_QUERY_CHUNK_SIZE, l_RowCount - i);
+          p_Func(Internal::make_chunk<TComponents...>(
+              l_Query, i, i_Count,
+              std::index_sequence_for<TComponents...>()));
+        }
+      }
+
+      template <typename... TComponents, typename TFunc>
+      void for_each(TFunc &&p_Func)
+      {
+        for_each_chunk<TComponents...>(
+            [&p_Func](const Chunk<TComponents...> &p_Chunk) {
+              for (u32 i = 0u; i < p_Chunk.count; ++i) {
+                p_Func(p_Chunk.entities[i],
+                       p_Chunk.template get<TComponents>()[i]...);
+              }
+            });
+      }
+
+      // Chunks are handed out to the parallel workers of the job
+      // manager. The callback has to be safe to run concurrently for
+      // different entities.
+      template <typename... TComponents, typename TFunc>
+      void parallel_for_each_chunk(TFunc &&p_Func)
+      {
+        const QueryId l_Query = get_query_id<TComponents...>();
+
+        Util::JobManager::Parallel::for_each(
+            get_row_count(l_Query), LOW_CORE_QUERY_CHUNK_SIZE,
+            [l_Query, &p_Func](u32 p_Begin, u32 p_End) {
+              p_Func(Internal::make_chunk<TComponents...>(
+                  l_Query, p_Begin, p_End - p_Begin,
+                  std::index_sequence_for<TComponents...>()));
+            });
+      }
+
+      template <typename... TComponents, typename TFunc>
+      void parallel_for_each(TFunc &&p_Func)
+      {
+        parallel_for_each_chunk<TComponents...>(
+            [&p_Func](const Chunk<TComponents...> &p_Chunk) {
+              for (u32 i = 0u; i < p_Chunk.count; ++i) {
+                p_Func(p_Chunk.entities[i],
+                       p_Chunk.template get<TComponents>()[i]...);
+              }
+            });
+      }
+    } // namespace Query
+  }   // namespace Core
+} // namespace Low
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "LowCoreApi.h"
+
+#include "LowUtilContainers.h"
+
+#include "LowCoreScene.h"
+
+namespace Low {
+  namespace Core {
+    namespace Snapshot {
+      // A snapshot stores all entities of the regions of a scene
+      // together with their components in one binary blob.
+      // Properties with a fixed size are written column by column
+      // per component type and are copied straight out of and back
+      // into the page buffers of the type. Names and strings go
+      // through a string table, handles are written as unique ids
+      // and container properties are written next to the columns
+      // in a compact node format.
+      //
+      // Restoring a snapshot destroys all entities that currently
+      // live in the regions of the scene and recreates the captured
+      // ones with their original unique ids. Since the columns skip
+      // the setters, all dirty flags of the restored components are
+      // raised afterwards.
+
+      LOW_CORE_API void capture(Scene p_Scene,
+                                Util::List<u8> &p_Data);
+      LOW_CORE_API bool restore(Scene p_Scene,
+                                const Util::List<u8> &p_Data);
+    } // namespace Snapshot
+  }   // namespace Core
+} // namespace Low
@@ -34,6 +34,7 @@ namespace Low {
           AreaType area_type;
           uint32_t agent_mask;
           bool include_children;
+          bool dynamic;
           bool tile_dirty;
           Low::Math::Bounds bounds;
           bool bounds_valid;
@@ -166,6 +167,10 @@ namespace Low {
         void set_include_children(bool p_Value);
         void toggle_include_children();
 
+        bool is_dynamic() const;
+        void set_dynamic(bool p_Value);
+        void toggle_dynamic();
+
         bool is_tile_dirty() const;
         void set_tile_dirty(bool p_Value);
         void toggle_tile_dirty();
@@ -30,7 +30,8 @@ namespace Low {
       void collect_dirty_tiles(WorldBackend *p_World,
                                Low::Util::List<Tile> *p_Tiles);
       bool remove_tile(WorldBackend *p_World, TileCoord p_Coord);
-      bool queue_tile(WorldBackend *p_World, TileCoord p_Coord);
+      bool queue_tile(WorldBackend *p_World, TileCoord p_Coord,
+                      float p_Priority = 0.0f);
       uint32_t queue_dirty_tiles(WorldBackend *p_World,
                                  uint32_t p_MaxTilesToQueue = 0u);
       uint32_t get_queued_tile_count(WorldBackend *p_World);
@@ -44,9 +45,59 @@ namespace Low {
           WorldBackend *p_World, TileCoord p_Coord,
           const BuildGeometry &p_Geometry);
 
+      // Hands the tile to the parallel workers. Its previous version
+      // stays in the navmesh until the build gets finished.
+      // Dirtying or removing the tile cancels the build.
+      bool start_navmesh_tile_build(WorldBackend *p_World,
+                                    TileCoord p_Coord,
+                                    BuildGeometry &&p_Geometry);
+      // Adds the tiles of builds that are done to the navmesh until
+      // p_BudgetMs is used up. Zero means no budget.
+      uint32_t finish_navmesh_tile_builds(WorldBackend *p_World,
+                                          float p_BudgetMs);
+      uint32_t get_running_tile_build_count(WorldBackend *p_World);
+
       bool collect_navmesh_geometry(WorldBackend *p_World,
                                     BuildGeometry *p_Geometry);
 
+      uint32_t add_obstacle(WorldBackend *p_World,
+                            const Obstacle &p_Obstacle);
+      bool remove_obstacle(WorldBackend *p_World,
+                           uint32_t p_Obstacle);
+      uint32_t get_obstacle_count(const WorldBackend *p_World);
+      // Hands waiting obstacle changes to the tile cache and rebuilds
+      // the tiles they touch. Returns true once all of them made it
+      // into the navmesh.
+      bool update_obstacles(WorldBackend *p_World);
+
+      void save_tile_layers(WorldBackend *p_World,
+                            Low::Util::List<uint8_t> &p_Data);
+      bool load_tile_layers(WorldBackend *p_World,
+                            const Low::Util::List<uint8_t> &p_Data);
+
+      // Writes the ready tiles in p_TileOwners together with the
+      // owners listed for them
+      void save_baked_tiles(
+          WorldBackend *p_World,
+          const Low::Util::UnorderedMap<
+              uint64_t, Low::Util::List<uint64_t>> &p_TileOwners,
+          Low::Util::List<uint8_t> &p_Data);
+      // Returns false and keeps the current baked tiles if the data
+      // was baked with another format, Detour version or build
+      // settings
+      bool set_baked_tiles(WorldBackend *p_World,
+                           const Low::Util::List<uint8_t> &p_Data);
+      void clear_baked_tiles(WorldBackend *p_World);
+      bool is_baked_tile(const WorldBackend *p_World,
+                         TileCoord p_Coord);
+      uint32_t get_baked_tile_count(const WorldBackend *p_World);
+      // Baked tiles stay in the navmesh as long as one of their
+      // owners is streamed in
+      uint32_t stream_in_baked_tiles(WorldBackend *p_World,
+                                     uint64_t p_Owner);
+      uint32_t stream_out_baked_tiles(WorldBackend *p_World,
+                                      uint64_t p_Owner);
+
       bool find_nearest_point(
           WorldBackend *p_World, const Math::Vector3 &p_Position,
           const Math::Vector3 &p_HalfExtents,
@@ -57,6 +108,56 @@ namespace Low {
                      const Math::Vector3 &p_End,
                      const Math::Vector3 &p_HalfExtents,
                      PathResult &p_Result);
+
+      uint32_t request_path(WorldBackend *p_World,
+                            const Math::Vector3 &p_Start,
+                            const Math::Vector3 &p_End,
+                            const Math::Vector3 &p_HalfExtents);
+      // Finished requests are released by polling them, unknown ones
+      // count as failed
+      PathRequestStatus poll_path_request(WorldBackend *p_World,
+                                          uint32_t p_Request,
+                                          PathResult *p_Result);
+      bool cancel_path_request(WorldBackend *p_World,
+                               uint32_t p_Request);
+      uint32_t
+      get_pending_path_request_count(const WorldBackend *p_World);
+      // Advances the sliced searches on the job workers. Returns the
+      // number of requests that finished.
+      uint32_t update_path_requests(WorldBackend *p_World,
+                                    uint32_t p_MaxIterations);
+      uint32_t
+      find_path_batch(WorldBackend *p_World,
+                      const Low::Util::List<PathQuery> &p_Queries,
+                      Low::Util::List<PathResult> &p_Results);
+      uint32_t
+      raycast_batch(WorldBackend *p_World,
+                    const Low::Util::List<RaycastQuery> &p_Queries,
+                    Low::Util::List<RaycastResult> &p_Results);
+
+      int add_crowd_agent(WorldBackend *p_World,
+                          const Math::Vector3 &p_Position,
+                          const CrowdAgentParams &p_Params);
+      bool remove_crowd_agent(WorldBackend *p_World, int p_Agent);
+      bool set_crowd_agent_params(WorldBackend *p_World, int p_Agent,
+                                  const CrowdAgentParams &p_Params);
+      bool set_crowd_agent_target(WorldBackend *p_World, int p_Agent,
+                                  const Math::Vector3 &p_Target);
+      bool clear_crowd_agent_target(WorldBackend *p_World,
+                                    int p_Agent);
+      bool set_crowd_agent_position(WorldBackend *p_World,
+                                    int p_Agent,
+                                    const Math::Vector3 &p_Position);
+      bool set_crowd_agent_lod(WorldBackend *p_World, int p_Agent,
+                               CrowdAgentLod p_Lod);
+      bool get_crowd_agent_state(const WorldBackend *p_World,
+                                 int p_Agent,
+                                 CrowdAgentState *p_State);
+      uint32_t get_crowd_agent_count(const WorldBackend *p_World);
+      // Hands up to p_MaxTargetRequests queued targets to the crowd
+      // and steps it. Returns the number of handed over targets.
+      uint32_t update_crowd(WorldBackend *p_World, float p_Delta,
+                            uint32_t p_MaxTargetRequests);
     } // namespace Navigation
   }   // namespace Core
 } // namespace Low
@@ -1,17 +1,28 @@
 #include "LowCoreNavigationBackend.h"
 
+#include "LowMathVectorUtil.h"
 #include "LowUtilAssert.h"
+#include "LowUtilJobManager.h"
 #include "LowUtilLogger.h"
+#include "LowUtilProfiler.h"
 
 #include <DetourAlloc.h>
+#include <DetourCrowd.h>
 #include <DetourNavMesh.h>
 #include <DetourNavMeshBuilder.h>
 #include <DetourNavMeshQuery.h>
+#include <DetourTileCache.h>
+#include <DetourTileCacheBuilder.h>
 #include <Recast.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstring>
+#include <limits>
+#include <memory>
+#include <mutex>
 
 constexpr unsigned char LOW_NAV_AREA_PREFERRED = 1u;
 constexpr unsigned char LOW_NAV_AREA_NORMAL = 2u;
@@ -22,6 +33,19 @@ constexpr int LOW_NAV_MAX_PATH_POLYS = 256;
 constexpr int LOW_NAV_MAX_STRAIGHT_PATH_POINTS = 256;
 constexpr int LOW_NAV_DEFAULT_MAX_TILES = 4096;
 constexpr int LOW_NAV_DEFAULT_MAX_POLYS_PER_TILE = 1024;
+constexpr int LOW_NAV_MIN_CROWD_CAPACITY = 64;
+constexpr unsigned char LOW_NAV_AVOIDANCE_LOW = 0u;
+constexpr unsigned char LOW_NAV_AVOIDANCE_HIGH = 1u;
+constexpr int LOW_NAV_MAX_TILE_LAYERS = 8;
+constexpr int LOW_NAV_MAX_OBSTACLES = 1024;
+constexpr uint32_t LOW_NAV_TILE_LAYERS_MAGIC = 0x4C544E4Cu; // LNTL
+constexpr uint32_t LOW_NAV_TILE_LAYERS_VERSION = 2u;
+constexpr uint32_t LOW_NAV_BAKE_MAGIC = 0x4B424E4Cu; // LNBK
+constexpr uint32_t LOW_NAV_BAKE_VERSION = 2u;
+constexpr int LOW_NAV_QUERY_MAX_NODES = 2048;
+constexpr uint32_t LOW_NAV_MAX_PATH_SEARCHES = 16u;
+constexpr int LOW_NAV_MIN_PATH_SEARCH_ITERATIONS = 16;
+constexpr uint32_t LOW_NAV_PATH_CACHE_SIZE = 256u;
 
   static void copy_vector(const Low::Math::Vector3 &p_Vector,
                           float *p_Out)
@@ -86,27 +110,486 @@ constexpr int LOW_NAV_DEFAULT_MAX_POLYS_PER_TILE = 1024;
     p_Filter.setAreaCost(LOW_NAV_AREA_ROUGH, 2.5f);
     p_Filter.setAreaCost(LOW_NAV_AREA_DIFFICULT, 5.0f);
   }
+
+  // PackBits run length encoding. Heightfield layers are mostly
+  // made of long runs of equal areas and connections which this
+  // shrinks well enough. A control byte below 128 is followed by
+  // that many plus one literal bytes, otherwise the next byte
+  // repeats the control byte minus 125 times. Only runs of three
+  // or more bytes are worth a control byte of their own, shorter
+  // repeats stay part of the literals. Keeps no state so the
+  // workers can share it.
+  struct LayerCompressor : public dtTileCacheCompressor
+  {
+    // Runs never grow the data, so the worst case is a buffer of
+    // nothing but literals with one control byte per 128 of them.
+    // Detour allocates exactly this much for the compressed layer.
+    int maxCompressedSize(const int p_BufferSize) override
+    {
+      return p_BufferSize + (p_BufferSize + 127) / 128;
+    }
+
+    static int get_run_length(const unsigned char *p_Buffer,
+                              const int p_BufferSize,
+                              const int p_Offset)
+    {
+      int l_Run = 1;
+      while (p_Offset + l_Run < p_BufferSize && l_Run < 130 &&
+             p_Buffer[p_Offset + l_Run] == p_Buffer[p_Offset]) {
+        ++l_Run;
+      }
+      return l_Run;
+    }
+
+    dtStatus compress(const unsigned char *p_Buffer,
+                      const int p_BufferSize,
+                      unsigned char *p_Compressed,
+                      const int p_MaxCompressedSize,
+                      int *p_CompressedSize) override
+    {
+      int l_Read = 0;
+      int l_Written = 0;
+      while (l_Read < p_BufferSize) {
+        const int l_Run =
+            get_run_length(p_Buffer, p_BufferSize, l_Read);
+
+        if (l_Run >= 3) {
+          if (l_Written + 2 > p_MaxCompressedSize) {
+            return DT_FAILURE | DT_BUFFER_TOO_SMALL;
+          }
+          p_Compressed[l_Written++] =
+              static_cast<unsigned char>(l_Run + 125);
+          p_Compressed[l_Written++] = p_Buffer[l_Read];
+          l_Read += l_Run;
+          continue;
+        }
+
+        // Literals last until the next run of three equal bytes
+        int l_Literals = l_Run;
+        while (l_Read + l_Literals < p_BufferSize &&
+               l_Literals < 128) {
+          const int i_Run = get_run_length(p_Buffer, p_BufferSize,
+                                           l_Read + l_Literals);
+          if (i_Run >= 3) {
+            break;
+          }
+          l_Literals += i_Run;
+        }
+        if (l_Literals > 128) {
+          l_Literals = 128;
+        }
+
+        if (l_Written + 1 + l_Literals > p_MaxCompressedSize) {
+          return DT_FAILURE | DT_BUFFER_TOO_SMALL;
+        }
+        p_Compressed[l_Written++] =
+            static_cast<unsigned char>(l_Literals - 1);
+        std::memcpy(p_Compressed + l_Written, p_Buffer + l_Read,
+                    l_Literals);
+        l_Written += l_Literals;
+        l_Read += l_Literals;
+      }
+
+      *p_CompressedSize = l_Written;
+      return DT_SUCCESS;
+    }
+
+    dtStatus decompress(const unsigned char *p_Compressed,
+                        const int p_CompressedSize,
+                        unsigned char *p_Buffer,
+                        const int p_MaxBufferSize,
+                        int *p_BufferSize) override
+    {
+      int l_Read = 0;
+      int l_Written = 0;
+      while (l_Read < p_CompressedSize) {
+        const int l_Control = p_Compressed[l_Read++];
+        if (l_Control < 128) {
+          const int l_Literals = l_Control + 1;
+          if (l_Read + l_Literals > p_CompressedSize ||
+              l_Written + l_Literals > p_MaxBufferSize) {
+            return DT_FAILURE | DT_BUFFER_TOO_SMALL;
+          }
+          std::memcpy(p_Buffer + l_Written, p_Compressed + l_Read,
+                      l_Literals);
+          l_Read += l_Literals;
+          l_Written += l_Literals;
+          continue;
+        }
+
+        const int l_Run = l_Control - 125;
+        if (l_Read >= p_CompressedSize ||
+            l_Written + l_Run > p_MaxBufferSize) {
+          return DT_FAILURE | DT_BUFFER_TOO_SMALL;
+        }
+        std::memset(p_Buffer + l_Written, p_Compressed[l_Read++],
+                    l_Run);
+        l_Written += l_Run;
+      }
+
+      *p_BufferSize = l_Written;
+      return DT_SUCCESS;
+    }
+  };
+
+  // Applies the same areas and flags to tiles built from cached
+  // layers that the regular pipeline used to set
+  struct TileMeshProcess : public dtTileCacheMeshProcess
+  {
+    void process(dtNavMeshCreateParams *p_Params,
+                 unsigned char *p_PolyAreas,
+                 unsigned short *p_PolyFlags) override
+    {
+      for (int i = 0; i < p_Params->polyCount; ++i) {
+        if (p_PolyAreas[i] == DT_TILECACHE_WALKABLE_AREA) {
+          p_PolyAreas[i] = LOW_NAV_AREA_NORMAL;
+        }
+        p_PolyFlags[i] = is_walkable_area(p_PolyAreas[i])
+                             ? LOW_NAV_POLYFLAG_WALK
+                             : 0u;
+      }
+    }
+  };
+
+  static LayerCompressor g_LayerCompressor;
+  static TileMeshProcess g_TileMeshProcess;
+  static dtTileCacheAlloc g_TileCacheAlloc;
+
+  template <typename T>
+  static void append_value(Low::Util::List<uint8_t> &p_Data,
+                           const T &p_Value)
+  {
+    const uint8_t *l_Bytes =
+        reinterpret_cast<const uint8_t *>(&p_Value);
+    p_Data.insert(p_Data.end(), l_Bytes, l_Bytes + sizeof(T));
+  }
+
+  struct LayerReader
+  {
+    const Low::Util::List<uint8_t> &data;
+    size_t offset = 0u;
+    bool failed = false;
+
+    const uint8_t *read(size_t p_Size)
+    {
+      if (failed || offset + p_Size > data.size()) {
+        failed = true;
+        return nullptr;
+      }
+      const uint8_t *l_Bytes = data.data() + offset;
+      offset += p_Size;
+      return l_Bytes;
+    }
+
+    template <typename T> T read_value()
+    {
+      T l_Value{};
+      const uint8_t *l_Bytes = read(sizeof(T));
+      if (l_Bytes) {
+        std::memcpy(&l_Value, l_Bytes, sizeof(T));
+      }
+      return l_Value;
+    }
+  };
 namespace Low {
   namespace Core {
     namespace Navigation {
+      // Everything a worker needs to build a tile is copied into the
+      // job. The world only keeps a reference to running jobs, a job
+      // that got cancelled or outlived its world cleans up after
+      // itself once the worker lets go of it.
+      // Compressed heightfield layers of one tile as produced by
+      // dtBuildTileCacheLayer
+      using TileLayers = Low::Util::List<Low::Util::List<uint8_t>>;
+
+      struct TileBuildJob
+      {
+        TileCoord coord;
+        BuildGeometry geometry;
+        BuildSettings settings;
+        std::atomic<bool> cancelled{false};
+        std::atomic<bool> done{false};
+        bool succeeded = false;
+        TileLayers layers;
+        float build_ms = 0.0f;
+      };
+
+      struct ObstacleRecord
+      {
+        Obstacle obstacle;
+        Bounds bounds;
+        // Zero while the obstacle waits to be handed to the cache
+        dtObstacleRef ref = 0u;
+      };
+
+      struct BakedTile
+      {
+        TileCoord coord;
+        float min_y = 0.0f;
+        float max_y = 0.0f;
+        TileLayers layers;
+        // Unique ids of the regions whose sources touch the tile
+        Low::Util::List<uint64_t> owners;
+      };
+
+      // The world keeps its own record of every crowd agent so the
+      // agents outlive the Detour crowd. The crowd gets recreated
+      // whenever the navmesh goes away or runs out of room and the
+      // agents are put back at their last known position.
+      struct CrowdAgentRecord
+      {
+        bool used = false;
+        CrowdAgentParams params;
+        CrowdAgentLod lod = CrowdAgentLod::Full;
+        Math::Vector3 position = Math::Vector3(0.0f);
+        Math::Vector3 velocity = Math::Vector3(0.0f);
+        Math::Vector3 target = Math::Vector3(0.0f);
+        bool has_target = false;
+        // Set while the target waits in the request queue
+        bool target_pending = false;
+        // -1 while the agent is frozen or not part of a crowd yet
+        int crowd_index = -1;
+      };
+
+      // Start and end of a path snapped onto the navmesh
+      struct PathEndpoints
+      {
+        dtPolyRef start_ref = 0;
+        dtPolyRef end_ref = 0;
+        float start[3] = {0.0f, 0.0f, 0.0f};
+        float end[3] = {0.0f, 0.0f, 0.0f};
+      };
+
+      // Polygons a search visited between two endpoint polygons.
+      // Paths between the same polygons share their corridor, only
+      // the straight path along it differs per path.
+      struct PathCorridor
+      {
+        dtPolyRef start_ref = 0;
+        dtPolyRef end_ref = 0;
+        Low::Util::List<dtPolyRef> polys;
+        // The oldest corridor makes room once the cache is full
+        uint64_t stamp = 0ull;
+      };
+
+      // A sliced search keeps its open list in the query, so it owns
+      // the query until it is done
+      struct PathSearch
+      {
+        PathEndpoints endpoints;
+        dtNavMeshQuery *query = nullptr;
+        uint64_t revision = 0ull;
+        bool done = false;
+        Low::Util::List<dtPolyRef> polys;
+        // Every request that waits for this corridor
+        Low::Util::List<uint32_t> requests;
+      };
+
+      struct PathRequest
+      {
+        Math::Vector3 start = Math::Vector3(0.0f);
+        Math::Vector3 end = Math::Vector3(0.0f);
+        Math::Vector3 half_extents = Math::Vector3(0.0f);
+        PathRequestStatus status = PathRequestStatus::Pending;
+        // Set once the endpoints are snapped and the request waits
+        // for a search
+        bool resolved = false;
+        PathEndpoints endpoints;
+        PathResult result;
+      };
+
+      // Entries of the build queue are not removed when their tile
+      // gets evicted or queued again. The ticket tells whether an
+      // entry still belongs to the tile, stale entries get skipped
+      // when they reach the top of the heap.
+      struct QueuedTile
+      {
+        TileCoord coord;
+        float priority = 0.0f;
+        uint64_t dirty_sequence = 0u;
+        uint64_t ticket = 0u;
+      };
+
+      // Heap comparator, the lowest priority ends up on top and
+      // older dirty tiles win among equal priorities
+      static bool queued_tile_after(const QueuedTile &p_A,
+                                    const QueuedTile &p_B)
+      {
+        if (p_A.priority != p_B.priority) {
+          return p_A.priority > p_B.priority;
+        }
+        return p_A.dirty_sequence > p_B.dirty_sequence;
+      }
+
       struct WorldBackend
       {
         rcContext recast_context;
         dtNavMesh *navmesh = nullptr;
+        // Only used from the main thread, workers and sliced
+        // searches take their queries from the pool below
         dtNavMeshQuery *navmesh_query = nullptr;
+        // Sliced searches hold on to the filter between updates
+        dtQueryFilter query_filter;
+        // Keeps the rasterized layers of every tile so obstacles
+        // only have to redo the last stages of the pipeline
+        dtTileCache *tile_cache = nullptr;
         BuildSettings build_settings;
-        Low::Util::Map<TileCoord, Tile> tiles;
-        Low::Util::List<TileCoord> build_queue;
-        Low::Util::List<TileCoord> dirty_tiles;
+        // All tile bookkeeping is keyed by TileCoord::get_key
+        Low::Util::UnorderedMap<uint64_t, Tile> tiles;
+        Low::Util::List<QueuedTile> build_queue;
+        // Ticket of the queue entry that is current for a tile
+        Low::Util::UnorderedMap<uint64_t, uint64_t> queued_tiles;
+        uint64_t next_queue_ticket = 1u;
+        Low::Util::UnorderedSet<uint64_t> dirty_tiles;
+        uint64_t next_dirty_sequence = 1u;
+        Low::Util::UnorderedMap<uint64_t,
+                                std::shared_ptr<TileBuildJob>>
+            tile_builds;
         uint64_t navmesh_revision = 0ull;
+
+        Low::Util::UnorderedMap<uint32_t, ObstacleRecord> obstacles;
+        uint32_t next_obstacle_id = 1u;
+        // The cache only takes a limited number of requests per
+        // update, whatever does not fit is retried on the next one
+        Low::Util::UnorderedSet<uint32_t> pending_obstacles;
+        Low::Util::List<dtObstacleRef> pending_obstacle_removals;
+        Low::Util::List<Bounds> changed_obstacle_bounds;
+        bool obstacle_updates_pending = false;
+
+        // Baked tiles only make it into the navmesh while at least
+        // one of their owners is streamed in
+        Low::Util::UnorderedMap<uint64_t, BakedTile> baked_tiles;
+        Low::Util::UnorderedMap<uint64_t, Low::Util::List<uint64_t>>
+            owner_baked_tiles;
+        Low::Util::UnorderedSet<uint64_t> streamed_owners;
+
+        // Queries are made for the current navmesh. Whoever takes
+        // one out of the pool has it to itself, so there are never
+        // more of them than threads querying at once plus running
+        // searches.
+        std::mutex query_pool_mutex;
+        Low::Util::List<dtNavMeshQuery *> query_pool;
+        Low::Util::List<dtNavMeshQuery *> free_queries;
+
+        Low::Util::UnorderedMap<uint32_t, PathRequest> path_requests;
+        uint32_t next_path_request = 1u;
+        Low::Util::List<uint32_t> unresolved_path_requests;
+        // Searches are keyed by their endpoint polygons so requests
+        // between the same polygons share one
+        Low::Util::UnorderedMap<uint64_t, PathSearch> path_searches;
+        Low::Util::Deque<uint64_t> queued_path_searches;
+        // Corridors are only valid for the navmesh revision they were
+        // searched on
+        Low::Util::UnorderedMap<uint64_t, PathCorridor> path_cache;
+        uint64_t path_cache_revision = 0ull;
+        uint64_t next_path_cache_stamp = 1u;
+
+        dtCrowd *crowd = nullptr;
+        int crowd_capacity = 0;
+        float crowd_max_radius = 0.0f;
+        Low::Util::List<CrowdAgentRecord> crowd_agents;
+        Low::Util::List<int> free_crowd_agents;
+        uint32_t crowd_agent_count = 0u;
+        // Set when agents are waiting to be added to the crowd
+        bool crowd_agents_dirty = false;
+        uint64_t crowd_placement_revision = 0ull;
+        Low::Util::Deque<int> crowd_target_requests;
       };
 
+      static void request_crowd_agent_target(WorldBackend *p_World,
+                                             int p_Agent)
+      {
+        CrowdAgentRecord &l_Agent = p_World->crowd_agents[p_Agent];
+        if (!l_Agent.has_target || l_Agent.target_pending) {
+          return;
+        }
+
+        l_Agent.target_pending = true;
+        p_World->crowd_target_requests.push_back(p_Agent);
+      }
+
+      // Detour crowds point at their navmesh, so they have to go
+      // before it does
+      static void release_crowd(WorldBackend *p_World)
+      {
+        if (!p_World->crowd) {
+          return;
+        }
+
+        dtFreeCrowd(p_World->crowd);
+        p_World->crowd = nullptr;
+        p_World->crowd_capacity = 0;
+        p_World->crowd_max_radius = 0.0f;
+
+        for (CrowdAgentRecord &i_Agent : p_World->crowd_agents) {
+          if (i_Agent.used && i_Agent.crowd_index >= 0) {
+            i_Agent.crowd_index = -1;
+            p_World->crowd_agents_dirty = true;
+          }
+        }
+      }
+
+      static void cancel_tile_build(WorldBackend *p_World,
+                                    TileCoord p_Coord)
+      {
+        auto i_It = p_World->tile_builds.find(p_Coord.get_key());
+        if (i_It == p_World->tile_builds.end()) {
+          return;
+        }
+
+        i_It->second->cancelled.store(true,
+                                      std::memory_order_relaxed);
+        p_World->tile_builds.erase(i_It);
+      }
+
+      static void cancel_all_tile_builds(WorldBackend *p_World)
+      {
+        for (auto &i_Entry : p_World->tile_builds) {
+          i_Entry.second->cancelled.store(true,
+                                          std::memory_order_relaxed);
+        }
+        p_World->tile_builds.clear();
+      }
+
+      static void free_query_pool(WorldBackend *p_World)
+      {
+        std::lock_guard<std::mutex> l_Lock(p_World->query_pool_mutex);
+        for (dtNavMeshQuery *i_Query : p_World->query_pool) {
+          dtFreeNavMeshQuery(i_Query);
+        }
+        p_World->query_pool.clear();
+        p_World->free_queries.clear();
+      }
+
+      // Running searches point into the navmesh. Their requests
+      // start over once there is a navmesh again.
+      static void reset_path_searches(WorldBackend *p_World)
+      {
+        for (auto &i_Entry : p_World->path_searches) {
+          for (uint32_t i_Id : i_Entry.second.requests) {
+            auto i_It = p_World->path_requests.find(i_Id);
+            if (i_It == p_World->path_requests.end()) {
+              continue;
+            }
+            i_It->second.resolved = false;
+            p_World->unresolved_path_requests.push_back(i_Id);
+          }
+        }
+        p_World->path_searches.clear();
+        p_World->queued_path_searches.clear();
+        p_World->path_cache.clear();
+      }
+
       static void clear_navmesh(WorldBackend *p_World)
       {
         if (!p_World) {
           return;
         }
 
+        release_crowd(p_World);
+        reset_path_searches(p_World);
+        free_query_pool(p_World);
+
         if (p_World->navmesh_query) {
           dtFreeNavMeshQuery(p_World->navmesh_query);
           p_World->navmesh_query = nullptr;
@@ -116,6 +599,100 @@ namespace Low {
           dtFreeNavMesh(p_World->navmesh);
           p_World->navmesh = nullptr;
         }
+
+        if (p_World->tile_cache) {
+          dtFreeTileCache(p_World->tile_cache);
+          p_World->tile_cache = nullptr;
+        }
+
+        // The obstacles outlive the cache and get handed to the next
+        // one
+        p_World->pending_obstacle_removals.clear();
+        p_World->changed_obstacle_bounds.clear();
+        p_World->obstacle_updates_pending = false;
+        for (auto &i_Entry : p_World->obstacles) {
+          i_Entry.second.ref = 0u;
+          p_World->pending_obstacles.insert(i_Entry.first);
+        }
+      }
+
+      static void clear_tiles(WorldBackend *p_World)
+      {
+        p_World->tiles.clear();
+        p_World->build_queue.clear();
+        p_World->queued_tiles.clear();
+        p_World->dirty_tiles.clear();
+      }
+
+      static void refresh_tile_ref(WorldBackend *p_World,
+                                   Tile &p_Tile)
+      {
+        p_Tile.backend_tile_ref = 0u;
+        if (!p_World->navmesh) {
+          return;
+        }
+
+        const dtMeshTile *l_Tiles[LOW_NAV_MAX_TILE_LAYERS];
+        const int l_Count = p_World->navmesh->getTilesAt(
+            p_Tile.coord.x, p_Tile.coord.z, l_Tiles,
+            LOW_NAV_MAX_TILE_LAYERS);
+        if (l_Count > 0) {
+          p_Tile.backend_tile_ref = static_cast<uint64_t>(
+              p_World->navmesh->getTileRef(l_Tiles[0]));
+        }
+      }
+
+      // Drops the cached layers of the tile together with the
+      // navmesh tiles that were built from them
+      static bool remove_tile_layers(WorldBackend *p_World,
+                                     TileCoord p_Coord)
+      {
+        if (p_World->tile_cache) {
+          dtCompressedTileRef l_Refs[LOW_NAV_MAX_TILE_LAYERS];
+          const int l_Count = p_World->tile_cache->getTilesAt(
+              p_Coord.x, p_Coord.z, l_Refs, LOW_NAV_MAX_TILE_LAYERS);
+          for (int i = 0; i < l_Count; ++i) {
+            p_World->tile_cache->removeTile(l_Refs[i], nullptr,
+                                            nullptr);
+          }
+        }
+
+        if (!p_World->navmesh) {
+          return false;
+        }
+
+        const dtMeshTile *l_Tiles[LOW_NAV_MAX_TILE_LAYERS];
+        const int l_Count = p_World->navmesh->getTilesAt(
+            p_Coord.x, p_Coord.z, l_Tiles, LOW_NAV_MAX_TILE_LAYERS);
+        for (int i = 0; i < l_Count; ++i) {
+          unsigned char *i_RemovedData = nullptr;
+          int i_RemovedDataSize = 0;
+          p_World->navmesh->removeTile(
+              p_World->navmesh->getTileRef(l_Tiles[i]),
+              &i_RemovedData, &i_RemovedDataSize);
+          if (i_RemovedData) {
+            dtFree(i_RemovedData);
+          }
+        }
+        return l_Count > 0;
+      }
+
+      static bool build_settings_equal(const BuildSettings &p_A,
+                                       const BuildSettings &p_B)
+      {
+        return p_A.cell_size == p_B.cell_size &&
+               p_A.cell_height == p_B.cell_height &&
+               p_A.agent_height == p_B.agent_height &&
+               p_A.agent_radius == p_B.agent_radius &&
+               p_A.agent_max_climb == p_B.agent_max_climb &&
+               p_A.agent_max_slope == p_B.agent_max_slope &&
+               p_A.tile_size == p_B.tile_size;
+      }
+
+      static void drop_baked_tiles(WorldBackend *p_World)
+      {
+        p_World->baked_tiles.clear();
+        p_World->owner_baked_tiles.clear();
       }
 
       WorldBackend *
@@ -125,6 +702,10 @@ namespace Low {
         l_World->build_settings = p_BuildSettings;
         l_World->recast_context.enableLog(true);
 
+        l_World->query_filter.setIncludeFlags(LOW_NAV_POLYFLAG_WALK);
+        l_World->query_filter.setExcludeFlags(0);
+        configure_filter_costs(l_World->query_filter);
+
         return l_World;
       }
 
@@ -134,6 +715,7 @@ namespace Low {
           return;
         }
 
+        cancel_all_tile_builds(p_World);
         clear_navmesh(p_World);
         delete p_World;
       }
@@ -144,11 +726,15 @@ namespace Low {
       {
         LOW_ASSERT(p_World,
                    "Cannot set build settings on null navmesh world");
+        // Baked layers were rasterized with the old settings
+        if (!build_settings_equal(p_World->build_settings,
+                                  p_BuildSettings)) {
+          drop_baked_tiles(p_World);
+        }
         p_World->build_settings = p_BuildSettings;
+        cancel_all_tile_builds(p_World);
         clear_navmesh(p_World);
-        p_World->tiles.clear();
-        p_World->build_queue.clear();
-        p_World->dirty_tiles.clear();
+        clear_tiles(p_World);
         ++p_World->navmesh_revision;
       }
 
@@ -165,66 +751,63 @@ namespace Low {
       {
         LOW_ASSERT(p_World,
                    "Cannot clear tile registry on null navigation world");
+        cancel_all_tile_builds(p_World);
         clear_navmesh(p_World);
-        p_World->tiles.clear();
-        p_World->build_queue.clear();
-        p_World->dirty_tiles.clear();
+        clear_tiles(p_World);
         ++p_World->navmesh_revision;
-      }
 
-      static bool is_tile_queued(WorldBackend *p_World,
-                                 TileCoord p_Coord)
-      {
-        for (const TileCoord &i_Coord : p_World->build_queue) {
-          if (i_Coord == p_Coord) {
-            return true;
-          }
+        // Invokers do not build baked tiles, the ones of owners that
+        // are still streamed in come back right away
+        for (uint64_t i_Owner : p_World->streamed_owners) {
+          stream_in_baked_tiles(p_World, i_Owner);
         }
-        return false;
       }
 
-      static bool is_tile_dirty_tracked(WorldBackend *p_World,
-                                        TileCoord p_Coord)
+      static bool is_tile_queued(WorldBackend *p_World,
+                                 TileCoord p_Coord)
       {
-        for (const TileCoord &i_Coord : p_World->dirty_tiles) {
-          if (i_Coord == p_Coord) {
-            return true;
-          }
-        }
-        return false;
+        return p_World->queued_tiles.find(p_Coord.get_key()) !=
+               p_World->queued_tiles.end();
       }
 
       static void remove_tile_from_queue(WorldBackend *p_World,
                                          TileCoord p_Coord)
       {
-        for (auto it = p_World->build_queue.begin();
-             it != p_World->build_queue.end();) {
-          if (*it == p_Coord) {
-            it = p_World->build_queue.erase(it);
-          } else {
-            ++it;
-          }
+        p_World->queued_tiles.erase(p_Coord.get_key());
+
+        // Stale entries are dropped in bulk once they outnumber the
+        // live ones
+        if (p_World->build_queue.size() >
+            (p_World->queued_tiles.size() * 2u) + 64u) {
+          p_World->build_queue.erase(
+              std::remove_if(
+                  p_World->build_queue.begin(),
+                  p_World->build_queue.end(),
+                  [p_World](const QueuedTile &p_Entry) {
+                    auto l_Pos = p_World->queued_tiles.find(
+                        p_Entry.coord.get_key());
+                    return l_Pos == p_World->queued_tiles.end() ||
+                           l_Pos->second != p_Entry.ticket;
+                  }),
+              p_World->build_queue.end());
+          std::make_heap(p_World->build_queue.begin(),
+                         p_World->build_queue.end(),
+                         queued_tile_after);
         }
       }
 
       static void remove_tile_from_dirty_list(WorldBackend *p_World,
                                               TileCoord p_Coord)
       {
-        for (auto it = p_World->dirty_tiles.begin();
-             it != p_World->dirty_tiles.end();) {
-          if (*it == p_Coord) {
-            it = p_World->dirty_tiles.erase(it);
-          } else {
-            ++it;
-          }
-        }
+        p_World->dirty_tiles.erase(p_Coord.get_key());
       }
 
       static void add_tile_to_dirty_list(WorldBackend *p_World,
-                                         TileCoord p_Coord)
+                                         Tile &p_Tile)
       {
-        if (!is_tile_dirty_tracked(p_World, p_Coord)) {
-          p_World->dirty_tiles.push_back(p_Coord);
+        if (p_World->dirty_tiles.insert(p_Tile.coord.get_key())
+                .second) {
+          p_Tile.dirty_sequence = p_World->next_dirty_sequence++;
         }
       }
 
@@ -234,7 +817,7 @@ namespace Low {
         LOW_ASSERT(p_World,
                    "Cannot ensure tile on null navigation world");
 
-        auto i_It = p_World->tiles.find(p_Coord);
+        auto i_It = p_World->tiles.find(p_Coord.get_key());
         if (i_It == p_World->tiles.end()) {
           Tile l_Tile;
           l_Tile.coord = p_Coord;
@@ -242,8 +825,9 @@ namespace Low {
               p_Coord, get_tile_world_size(p_World->build_settings),
               p_MinY, p_MaxY);
           l_Tile.state = TileState::Empty;
-          i_It = p_World->tiles.insert(eastl::make_pair(
-                                           p_Coord, l_Tile))
+          i_It = p_World->tiles
+                     .insert(eastl::make_pair(p_Coord.get_key(),
+                                              l_Tile))
                      .first;
         }
 
@@ -259,14 +843,17 @@ namespace Low {
         LOW_ASSERT(p_World,
                    "Cannot set tile state on null navigation world");
 
-        auto i_It = p_World->tiles.find(p_Coord);
+        auto i_It = p_World->tiles.find(p_Coord.get_key());
         if (i_It == p_World->tiles.end()) {
           return false;
         }
 
         i_It->second.state = p_State;
         if (p_State == TileState::Dirty) {
-          add_tile_to_dirty_list(p_World, p_Coord);
+          // The running build works on outdated geometry, the tile
+          // gets queued again with a fresh snapshot
+          cancel_tile_build(p_World, p_Coord);
+          add_tile_to_dirty_list(p_World, i_It->second);
         } else {
           remove_tile_from_dirty_list(p_World, p_Coord);
         }
@@ -282,7 +869,7 @@ namespace Low {
           return false;
         }
 
-        auto i_It = p_World->tiles.find(p_Coord);
+        auto i_It = p_World->tiles.find(p_Coord.get_key());
         if (i_It == p_World->tiles.end()) {
           return false;
         }
@@ -319,8 +906,8 @@ namespace Low {
         p_Tiles->clear();
         p_Tiles->reserve(
             static_cast<uint32_t>(p_World->dirty_tiles.size()));
-        for (const TileCoord &i_Coord : p_World->dirty_tiles) {
-          auto i_It = p_World->tiles.find(i_Coord);
+        for (uint64_t i_Key : p_World->dirty_tiles) {
+          auto i_It = p_World->tiles.find(i_Key);
           if (i_It == p_World->tiles.end() ||
               i_It->second.state != TileState::Dirty) {
             continue;
@@ -334,25 +921,16 @@ namespace Low {
         LOW_ASSERT(p_World,
                    "Cannot remove tile from null navigation world");
 
-        auto i_It = p_World->tiles.find(p_Coord);
+        cancel_tile_build(p_World, p_Coord);
+
+        auto i_It = p_World->tiles.find(p_Coord.get_key());
         if (i_It == p_World->tiles.end()) {
           remove_tile_from_queue(p_World, p_Coord);
           remove_tile_from_dirty_list(p_World, p_Coord);
           return false;
         }
 
-        if (p_World->navmesh &&
-            i_It->second.backend_tile_ref != 0u) {
-          unsigned char *l_RemovedData = nullptr;
-          int l_RemovedDataSize = 0;
-          p_World->navmesh->removeTile(
-              static_cast<dtTileRef>(
-                  i_It->second.backend_tile_ref),
-              &l_RemovedData, &l_RemovedDataSize);
-          if (l_RemovedData) {
-            dtFree(l_RemovedData);
-          }
-        }
+        remove_tile_layers(p_World, p_Coord);
 
         remove_tile_from_queue(p_World, p_Coord);
         remove_tile_from_dirty_list(p_World, p_Coord);
@@ -361,12 +939,13 @@ namespace Low {
         return true;
       }
 
-      bool queue_tile(WorldBackend *p_World, TileCoord p_Coord)
+      bool queue_tile(WorldBackend *p_World, TileCoord p_Coord,
+                      float p_Priority)
       {
         LOW_ASSERT(p_World,
                    "Cannot queue tile on null navigation world");
 
-        auto i_It = p_World->tiles.find(p_Coord);
+        auto i_It = p_World->tiles.find(p_Coord.get_key());
         if (i_It == p_World->tiles.end() ||
             is_tile_queued(p_World, p_Coord)) {
           return false;
@@ -374,7 +953,16 @@ namespace Low {
 
         i_It->second.state = TileState::Queued;
         remove_tile_from_dirty_list(p_World, p_Coord);
-        p_World->build_queue.push_back(p_Coord);
+
+        QueuedTile l_Entry;
+        l_Entry.coord = p_Coord;
+        l_Entry.priority = p_Priority;
+        l_Entry.dirty_sequence = i_It->second.dirty_sequence;
+        l_Entry.ticket = p_World->next_queue_ticket++;
+        p_World->queued_tiles[p_Coord.get_key()] = l_Entry.ticket;
+        p_World->build_queue.push_back(l_Entry);
+        std::push_heap(p_World->build_queue.begin(),
+                       p_World->build_queue.end(), queued_tile_after);
         return true;
       }
 
@@ -384,16 +972,23 @@ namespace Low {
         LOW_ASSERT(p_World,
                    "Cannot queue dirty tiles on null navigation world");
 
+        // Oldest dirty tiles first
+        Low::Util::List<Tile> l_DirtyTiles;
+        collect_dirty_tiles(p_World, &l_DirtyTiles);
+        std::sort(l_DirtyTiles.begin(), l_DirtyTiles.end(),
+                  [](const Tile &p_A, const Tile &p_B) {
+                    return p_A.dirty_sequence < p_B.dirty_sequence;
+                  });
+
         uint32_t l_QueuedCount = 0u;
-        Low::Util::List<TileCoord> l_DirtyTiles =
-            p_World->dirty_tiles;
-        for (const TileCoord &i_Coord : l_DirtyTiles) {
+        for (const Tile &i_Tile : l_DirtyTiles) {
           if (p_MaxTilesToQueue > 0u &&
               l_QueuedCount >= p_MaxTilesToQueue) {
             break;
           }
 
-          auto i_It = p_World->tiles.find(i_Coord);
+          const TileCoord i_Coord = i_Tile.coord;
+          auto i_It = p_World->tiles.find(i_Coord.get_key());
           if (i_It == p_World->tiles.end() ||
               i_It->second.state != TileState::Dirty ||
               is_tile_queued(p_World, i_Coord)) {
@@ -413,7 +1008,7 @@ namespace Low {
         LOW_ASSERT(p_World,
                    "Cannot count queued tiles on null navigation world");
 
-        return static_cast<uint32_t>(p_World->build_queue.size());
+        return static_cast<uint32_t>(p_World->queued_tiles.size());
       }
 
       uint64_t get_navmesh_revision(WorldBackend *p_World)
@@ -430,13 +1025,29 @@ namespace Low {
       {
         LOW_ASSERT(p_World,
                    "Cannot pop queued tile from null navigation world");
-        if (!p_Coord || p_World->build_queue.empty()) {
+        if (!p_Coord) {
           return false;
         }
 
-        *p_Coord = p_World->build_queue.front();
-        p_World->build_queue.erase(p_World->build_queue.begin());
-        return true;
+        while (!p_World->build_queue.empty()) {
+          std::pop_heap(p_World->build_queue.begin(),
+                        p_World->build_queue.end(),
+                        queued_tile_after);
+          const QueuedTile i_Entry = p_World->build_queue.back();
+          p_World->build_queue.pop_back();
+
+          auto i_Pos =
+              p_World->queued_tiles.find(i_Entry.coord.get_key());
+          if (i_Pos == p_World->queued_tiles.end() ||
+              i_Pos->second != i_Entry.ticket) {
+            continue;
+          }
+
+          p_World->queued_tiles.erase(i_Pos);
+          *p_Coord = i_Entry.coord;
+          return true;
+        }
+        return false;
       }
 
       static bool ensure_tiled_navmesh(WorldBackend *p_World)
@@ -444,7 +1055,8 @@ namespace Low {
         LOW_ASSERT(p_World,
                    "Cannot initialize null navigation world");
 
-        if (p_World->navmesh && p_World->navmesh_query) {
+        if (p_World->navmesh && p_World->navmesh_query &&
+            p_World->tile_cache) {
           return true;
         }
 
@@ -452,7 +1064,9 @@ namespace Low {
 
         p_World->navmesh = dtAllocNavMesh();
         p_World->navmesh_query = dtAllocNavMeshQuery();
-        if (!p_World->navmesh || !p_World->navmesh_query) {
+        p_World->tile_cache = dtAllocTileCache();
+        if (!p_World->navmesh || !p_World->navmesh_query ||
+            !p_World->tile_cache) {
           clear_navmesh(p_World);
           return false;
         }
@@ -469,9 +1083,26 @@ namespace Low {
         l_Params.maxTiles = LOW_NAV_DEFAULT_MAX_TILES;
         l_Params.maxPolys = LOW_NAV_DEFAULT_MAX_POLYS_PER_TILE;
 
+        const BuildSettings &l_Settings = p_World->build_settings;
+        dtTileCacheParams l_CacheParams;
+        std::memset(&l_CacheParams, 0, sizeof(l_CacheParams));
+        l_CacheParams.cs = l_Settings.cell_size;
+        l_CacheParams.ch = l_Settings.cell_height;
+        l_CacheParams.width = l_Settings.tile_size;
+        l_CacheParams.height = l_Settings.tile_size;
+        l_CacheParams.walkableHeight = l_Settings.agent_height;
+        l_CacheParams.walkableRadius = l_Settings.agent_radius;
+        l_CacheParams.walkableClimb = l_Settings.agent_max_climb;
+        l_CacheParams.maxSimplificationError = 1.3f;
+        l_CacheParams.maxTiles = LOW_NAV_DEFAULT_MAX_TILES;
+        l_CacheParams.maxObstacles = LOW_NAV_MAX_OBSTACLES;
+
         if (!dtStatusSucceed(p_World->navmesh->init(&l_Params)) ||
             !dtStatusSucceed(p_World->navmesh_query->init(
-                p_World->navmesh, 2048))) {
+                p_World->navmesh, LOW_NAV_QUERY_MAX_NODES)) ||
+            !dtStatusSucceed(p_World->tile_cache->init(
+                &l_CacheParams, &g_TileCacheAlloc,
+                &g_LayerCompressor, &g_TileMeshProcess))) {
           clear_navmesh(p_World);
           return false;
         }
@@ -479,15 +1110,21 @@ namespace Low {
         return true;
       }
 
-      static bool build_tile_data_from_geometry(
-          WorldBackend *p_World, TileCoord p_Coord,
-          const BuildGeometry &p_Geometry, unsigned char **p_NavData,
-          int *p_NavDataSize)
+      // Rasterizes the geometry of one tile into compressed
+      // heightfield layers for the tile cache. This is the expensive
+      // part of the pipeline, the cache builds the polygons from the
+      // layers. Only touches its parameters so it can run on any
+      // thread as long as every thread brings its own context.
+      // p_Cancelled is checked between the stages of the pipeline.
+      static bool rasterize_tile_layers(
+          const BuildSettings &p_Settings, rcContext &p_Context,
+          TileCoord p_Coord, const BuildGeometry &p_Geometry,
+          const std::atomic<bool> *p_Cancelled,
+          TileLayers *p_Layers)
       {
-        LOW_ASSERT(p_World,
-                   "Cannot build navmesh in null navigation world");
-        LOW_ASSERT(p_NavData && p_NavDataSize,
-                   "Cannot write tile navmesh data to null output");
+        LOW_ASSERT(p_Layers,
+                   "Cannot write tile layers to null output");
+        p_Layers->clear();
 
         const int l_VertexCount =
             static_cast<int>(p_Geometry.vertices.size());
@@ -522,7 +1159,7 @@ namespace Low {
           l_Indices.push_back(static_cast<int>(i_Index));
         }
 
-        const BuildSettings &l_Settings = p_World->build_settings;
+        const BuildSettings &l_Settings = p_Settings;
         rcConfig l_Config;
         std::memset(&l_Config, 0, sizeof(l_Config));
         l_Config.cs = l_Settings.cell_size;
@@ -559,12 +1196,8 @@ namespace Low {
 
         rcHeightfield *l_Heightfield = rcAllocHeightfield();
         rcCompactHeightfield *l_CompactHeightfield = nullptr;
-        rcContourSet *l_ContourSet = nullptr;
-        rcPolyMesh *l_PolyMesh = nullptr;
-        rcPolyMeshDetail *l_DetailMesh = nullptr;
+        rcHeightfieldLayerSet *l_LayerSet = nullptr;
         unsigned char *l_TriangleAreas = nullptr;
-        unsigned char *l_NavData = nullptr;
-        int l_NavDataSize = 0;
 
         auto cleanup = [&]() {
           if (l_TriangleAreas) {
@@ -576,18 +1209,17 @@ namespace Low {
           if (l_CompactHeightfield) {
             rcFreeCompactHeightfield(l_CompactHeightfield);
           }
-          if (l_ContourSet) {
-            rcFreeContourSet(l_ContourSet);
-          }
-          if (l_PolyMesh) {
-            rcFreePolyMesh(l_PolyMesh);
-          }
-          if (l_DetailMesh) {
-            rcFreePolyMeshDetail(l_DetailMesh);
+          if (l_LayerSet) {
+            rcFreeHeightfieldLayerSet(l_LayerSet);
           }
         };
 
-        rcContext &l_Context = p_World->recast_context;
+        auto is_cancelled = [&]() {
+          return p_Cancelled &&
+                 p_Cancelled->load(std::memory_order_relaxed);
+        };
+
+        rcContext &l_Context = p_Context;
         const int l_TriangleCount = l_IndexCount / 3;
         if (!p_Geometry.triangle_area_types.empty() &&
             p_Geometry.triangle_area_types.size() !=
@@ -629,7 +1261,8 @@ namespace Low {
         if (!rcRasterizeTriangles(
                 &l_Context, l_Vertices.data(), l_VertexCount,
                 l_Indices.data(), l_TriangleAreas, l_TriangleCount,
-                *l_Heightfield, l_Config.walkableClimb)) {
+                *l_Heightfield, l_Config.walkableClimb) ||
+            is_cancelled()) {
           cleanup();
           return false;
         }
@@ -646,101 +1279,188 @@ namespace Low {
             !rcBuildCompactHeightfield(
                 &l_Context, l_Config.walkableHeight,
                 l_Config.walkableClimb, *l_Heightfield,
-                *l_CompactHeightfield)) {
+                *l_CompactHeightfield) ||
+            is_cancelled()) {
           cleanup();
           return false;
         }
 
         if (!rcErodeWalkableArea(&l_Context, l_Config.walkableRadius,
                                  *l_CompactHeightfield) ||
-            !rcBuildDistanceField(&l_Context,
-                                  *l_CompactHeightfield) ||
-            !rcBuildRegions(&l_Context, *l_CompactHeightfield,
-                            l_Config.borderSize,
-                            l_Config.minRegionArea,
-                            l_Config.mergeRegionArea)) {
+            is_cancelled()) {
           cleanup();
           return false;
         }
 
-        l_ContourSet = rcAllocContourSet();
-        if (!l_ContourSet ||
-            !rcBuildContours(&l_Context, *l_CompactHeightfield,
-                             l_Config.maxSimplificationError,
-                             l_Config.maxEdgeLen, *l_ContourSet) ||
-            l_ContourSet->nconts == 0) {
+        l_LayerSet = rcAllocHeightfieldLayerSet();
+        if (!l_LayerSet ||
+            !rcBuildHeightfieldLayers(&l_Context,
+                                      *l_CompactHeightfield,
+                                      l_Config.borderSize,
+                                      l_Config.walkableHeight,
+                                      *l_LayerSet) ||
+            l_LayerSet->nlayers == 0 || is_cancelled()) {
           cleanup();
           return false;
         }
 
-        l_PolyMesh = rcAllocPolyMesh();
-        if (!l_PolyMesh ||
-            !rcBuildPolyMesh(&l_Context, *l_ContourSet,
-                             l_Config.maxVertsPerPoly, *l_PolyMesh)) {
-          cleanup();
-          return false;
+        const int l_LayerCount =
+            std::min(l_LayerSet->nlayers, LOW_NAV_MAX_TILE_LAYERS);
+        for (int i = 0; i < l_LayerCount; ++i) {
+          const rcHeightfieldLayer &i_Layer = l_LayerSet->layers[i];
+
+          dtTileCacheLayerHeader i_Header;
+          std::memset(&i_Header, 0, sizeof(i_Header));
+          i_Header.magic = DT_TILECACHE_MAGIC;
+          i_Header.version = DT_TILECACHE_VERSION;
+          i_Header.tx = p_Coord.x;
+          i_Header.ty = p_Coord.z;
+          i_Header.tlayer = i;
+          rcVcopy(i_Header.bmin, i_Layer.bmin);
+          rcVcopy(i_Header.bmax, i_Layer.bmax);
+          i_Header.width = static_cast<unsigned char>(i_Layer.width);
+          i_Header.height =
+              static_cast<unsigned char>(i_Layer.height);
+          i_Header.minx = static_cast<unsigned char>(i_Layer.minx);
+          i_Header.maxx = static_cast<unsigned char>(i_Layer.maxx);
+          i_Header.miny = static_cast<unsigned char>(i_Layer.miny);
+          i_Header.maxy = static_cast<unsigned char>(i_Layer.maxy);
+          i_Header.hmin = static_cast<unsigned short>(i_Layer.hmin);
+          i_Header.hmax = static_cast<unsigned short>(i_Layer.hmax);
+
+          unsigned char *i_Data = nullptr;
+          int i_DataSize = 0;
+          if (!dtStatusSucceed(dtBuildTileCacheLayer(
+                  &g_LayerCompressor, &i_Header, i_Layer.heights,
+                  i_Layer.areas, i_Layer.cons, &i_Data,
+                  &i_DataSize))) {
+            p_Layers->clear();
+            cleanup();
+            return false;
+          }
+
+          p_Layers->emplace_back(i_Data, i_Data + i_DataSize);
+          dtFree(i_Data);
         }
 
-        l_DetailMesh = rcAllocPolyMeshDetail();
-        if (!l_DetailMesh ||
-            !rcBuildPolyMeshDetail(
-                &l_Context, *l_PolyMesh, *l_CompactHeightfield,
-                l_Config.detailSampleDist,
-                l_Config.detailSampleMaxError, *l_DetailMesh)) {
-          cleanup();
+        cleanup();
+        return true;
+      }
+
+      static bool obstacle_overlaps(const ObstacleRecord &p_Record,
+                                    const Bounds &p_Bounds)
+      {
+        return p_Record.bounds.min.x <= p_Bounds.max.x &&
+               p_Record.bounds.max.x >= p_Bounds.min.x &&
+               p_Record.bounds.min.z <= p_Bounds.max.z &&
+               p_Record.bounds.max.z >= p_Bounds.min.z;
+      }
+
+      // Hands the obstacle to the tile cache, replacing the version
+      // the cache knew before. The cache only applies obstacles to
+      // the tiles that existed when it received them, so this also
+      // runs for every obstacle on a tile that got new layers.
+      static void submit_obstacle(WorldBackend *p_World,
+                                  uint32_t p_Id,
+                                  ObstacleRecord &p_Record)
+      {
+        dtTileCache *l_Cache = p_World->tile_cache;
+        if (!l_Cache) {
+          p_World->pending_obstacles.insert(p_Id);
+          return;
+        }
+
+        if (p_Record.ref != 0u) {
+          if (!dtStatusSucceed(
+                  l_Cache->removeObstacle(p_Record.ref))) {
+            p_World->pending_obstacle_removals.push_back(
+                p_Record.ref);
+          }
+          p_Record.ref = 0u;
+        }
+
+        const Obstacle &l_Obstacle = p_Record.obstacle;
+        float l_Position[3];
+        float l_Extents[3];
+        copy_vector(l_Obstacle.position, l_Position);
+        copy_vector(l_Obstacle.extents, l_Extents);
+
+        dtStatus l_Status = DT_FAILURE;
+        switch (l_Obstacle.shape) {
+        case ObstacleShape::Cylinder:
+          l_Status = l_Cache->addObstacle(l_Position, l_Extents[0],
+                                          l_Extents[1],
+                                          &p_Record.ref);
+          break;
+        case ObstacleShape::Box: {
+          float l_Min[3];
+          float l_Max[3];
+          copy_vector(p_Record.bounds.min, l_Min);
+          copy_vector(p_Record.bounds.max, l_Max);
+          l_Status = l_Cache->addBoxObstacle(l_Min, l_Max,
+                                             &p_Record.ref);
+          break;
+        }
+        case ObstacleShape::OrientedBox:
+          l_Status = l_Cache->addBoxObstacle(l_Position, l_Extents,
+                                             l_Obstacle.yaw,
+                                             &p_Record.ref);
+          break;
+        }
+
+        if (dtStatusSucceed(l_Status)) {
+          p_World->pending_obstacles.erase(p_Id);
+          p_World->changed_obstacle_bounds.push_back(
+              p_Record.bounds);
+          p_World->obstacle_updates_pending = true;
+        } else {
+          p_Record.ref = 0u;
+          p_World->pending_obstacles.insert(p_Id);
+        }
+      }
+
+      // Replaces the cached layers of the tile and builds its
+      // navmesh tiles from them
+      static bool add_tile_layers(WorldBackend *p_World,
+                                  Tile &p_Tile,
+                                  const TileLayers &p_Layers)
+      {
+        remove_tile_layers(p_World, p_Tile.coord);
+        p_Tile.backend_tile_ref = 0u;
+
+        if (p_Layers.empty() || !ensure_tiled_navmesh(p_World)) {
           return false;
         }
 
-        for (int i = 0; i < l_PolyMesh->npolys; ++i) {
-          if (l_PolyMesh->areas[i] == RC_WALKABLE_AREA) {
-            l_PolyMesh->areas[i] = LOW_NAV_AREA_NORMAL;
+        for (const Low::Util::List<uint8_t> &i_Layer : p_Layers) {
+          const int i_Size = static_cast<int>(i_Layer.size());
+          unsigned char *i_Data = static_cast<unsigned char *>(
+              dtAlloc(i_Size, DT_ALLOC_PERM));
+          if (!i_Data) {
+            continue;
           }
-          if (is_walkable_area(l_PolyMesh->areas[i])) {
-            l_PolyMesh->flags[i] = LOW_NAV_POLYFLAG_WALK;
+          std::memcpy(i_Data, i_Layer.data(), i_Size);
+          if (!dtStatusSucceed(p_World->tile_cache->addTile(
+                  i_Data, i_Size, DT_COMPRESSEDTILE_FREE_DATA,
+                  nullptr))) {
+            dtFree(i_Data);
           }
         }
 
-        dtNavMeshCreateParams l_Params;
-        std::memset(&l_Params, 0, sizeof(l_Params));
-        l_Params.verts = l_PolyMesh->verts;
-        l_Params.vertCount = l_PolyMesh->nverts;
-        l_Params.polys = l_PolyMesh->polys;
-        l_Params.polyAreas = l_PolyMesh->areas;
-        l_Params.polyFlags = l_PolyMesh->flags;
-        l_Params.polyCount = l_PolyMesh->npolys;
-        l_Params.nvp = l_PolyMesh->nvp;
-        l_Params.detailMeshes = l_DetailMesh->meshes;
-        l_Params.detailVerts = l_DetailMesh->verts;
-        l_Params.detailVertsCount = l_DetailMesh->nverts;
-        l_Params.detailTris = l_DetailMesh->tris;
-        l_Params.detailTriCount = l_DetailMesh->ntris;
-        l_Params.walkableHeight =
-            static_cast<float>(l_Settings.agent_height);
-        l_Params.walkableRadius =
-            static_cast<float>(l_Settings.agent_radius);
-        l_Params.walkableClimb =
-            static_cast<float>(l_Settings.agent_max_climb);
-        rcVcopy(l_Params.bmin, l_PolyMesh->bmin);
-        rcVcopy(l_Params.bmax, l_PolyMesh->bmax);
-        l_Params.cs = l_Config.cs;
-        l_Params.ch = l_Config.ch;
-        l_Params.buildBvTree = true;
-        l_Params.tileX = p_Coord.x;
-        l_Params.tileY = p_Coord.z;
-        l_Params.tileLayer = 0;
-
-        if (!dtCreateNavMeshData(&l_Params, &l_NavData,
-                                 &l_NavDataSize)) {
-          cleanup();
+        if (!dtStatusSucceed(p_World->tile_cache->buildNavMeshTilesAt(
+                p_Tile.coord.x, p_Tile.coord.z, p_World->navmesh))) {
           return false;
         }
 
-        *p_NavData = l_NavData;
-        *p_NavDataSize = l_NavDataSize;
-        l_NavData = nullptr;
+        refresh_tile_ref(p_World, p_Tile);
 
-        cleanup();
-        return true;
+        for (auto &i_Entry : p_World->obstacles) {
+          if (obstacle_overlaps(i_Entry.second, p_Tile.bounds)) {
+            submit_obstacle(p_World, i_Entry.first, i_Entry.second);
+          }
+        }
+
+        return p_Tile.backend_tile_ref != 0u;
       }
 
       bool build_navmesh_tile_from_geometry(
@@ -750,11 +1470,13 @@ namespace Low {
         LOW_ASSERT(p_World,
                    "Cannot build navmesh tile in null navigation world");
 
-        auto i_It = p_World->tiles.find(p_Coord);
+        auto i_It = p_World->tiles.find(p_Coord.get_key());
         if (i_It == p_World->tiles.end()) {
           return false;
         }
 
+        // Building right away supersedes a build on the workers
+        cancel_tile_build(p_World, p_Coord);
         i_It->second.state = TileState::Building;
         remove_tile_from_dirty_list(p_World, p_Coord);
 
@@ -764,58 +1486,713 @@ namespace Low {
           return false;
         }
 
-        if (i_It->second.backend_tile_ref != 0u) {
-          unsigned char *l_RemovedData = nullptr;
-          int l_RemovedDataSize = 0;
-          p_World->navmesh->removeTile(
-              static_cast<dtTileRef>(
-                  i_It->second.backend_tile_ref),
-              &l_RemovedData, &l_RemovedDataSize);
-          if (l_RemovedData) {
-            dtFree(l_RemovedData);
-          }
-          i_It->second.backend_tile_ref = 0u;
-        }
-
-        unsigned char *l_NavData = nullptr;
-        int l_NavDataSize = 0;
-        if (!build_tile_data_from_geometry(
-                p_World, p_Coord, p_Geometry, &l_NavData,
-                &l_NavDataSize)) {
+        TileLayers l_Layers;
+        const auto l_BuildStart = std::chrono::steady_clock::now();
+        const bool l_Built = rasterize_tile_layers(
+            p_World->build_settings, p_World->recast_context, p_Coord,
+            p_Geometry, nullptr, &l_Layers);
+        i_It->second.last_build_ms =
+            std::chrono::duration<float, std::milli>(
+                std::chrono::steady_clock::now() - l_BuildStart)
+                .count();
+        if (!l_Built) {
           i_It->second.state = TileState::Failed;
           remove_tile_from_dirty_list(p_World, p_Coord);
           return false;
         }
 
-        dtTileRef l_TileRef = 0;
-        if (!dtStatusSucceed(p_World->navmesh->addTile(
-                l_NavData, l_NavDataSize, DT_TILE_FREE_DATA, 0,
-                &l_TileRef))) {
-          dtFree(l_NavData);
-          i_It->second.state = TileState::Failed;
-          remove_tile_from_dirty_list(p_World, p_Coord);
+        const bool l_Added =
+            add_tile_layers(p_World, i_It->second, l_Layers);
+        ++p_World->navmesh_revision;
+        i_It->second.state =
+            l_Added ? TileState::Ready : TileState::Failed;
+        remove_tile_from_dirty_list(p_World, p_Coord);
+        return l_Added;
+      }
+
+      bool start_navmesh_tile_build(WorldBackend *p_World,
+                                    TileCoord p_Coord,
+                                    BuildGeometry &&p_Geometry)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot start tile build in null navigation world");
+
+        auto i_It = p_World->tiles.find(p_Coord.get_key());
+        if (i_It == p_World->tiles.end()) {
           return false;
         }
 
-        i_It->second.backend_tile_ref =
-            static_cast<uint64_t>(l_TileRef);
-        i_It->second.state = TileState::Ready;
+        cancel_tile_build(p_World, p_Coord);
+        i_It->second.state = TileState::Building;
         remove_tile_from_dirty_list(p_World, p_Coord);
-        ++p_World->navmesh_revision;
+
+        std::shared_ptr<TileBuildJob> l_Job =
+            std::make_shared<TileBuildJob>();
+        l_Job->coord = p_Coord;
+        l_Job->geometry = std::move(p_Geometry);
+        l_Job->settings = p_World->build_settings;
+        p_World->tile_builds[p_Coord.get_key()] = l_Job;
+
+        Low::Util::JobManager::Parallel::submit([l_Job]() {
+          const auto l_Start = std::chrono::steady_clock::now();
+
+          // Recast contexts are not thread safe, logging and timers
+          // are turned off for worker builds
+          rcContext l_Context(false);
+          l_Job->succeeded =
+              !l_Job->cancelled.load(std::memory_order_relaxed) &&
+              rasterize_tile_layers(
+                  l_Job->settings, l_Context, l_Job->coord,
+                  l_Job->geometry, &l_Job->cancelled,
+                  &l_Job->layers);
+          l_Job->geometry = BuildGeometry();
+
+          l_Job->build_ms =
+              std::chrono::duration<float, std::milli>(
+                  std::chrono::steady_clock::now() - l_Start)
+                  .count();
+          l_Job->done.store(true, std::memory_order_release);
+        });
+
         return true;
       }
 
-      bool
-      build_navmesh_from_geometry(WorldBackend *p_World,
-                                  const BuildGeometry &p_Geometry)
+      static bool finish_tile_build(WorldBackend *p_World,
+                                    TileBuildJob &p_Job)
+      {
+        auto i_It = p_World->tiles.find(p_Job.coord.get_key());
+        if (i_It == p_World->tiles.end()) {
+          return false;
+        }
+
+        Tile &l_Tile = i_It->second;
+        l_Tile.last_build_ms = p_Job.build_ms;
+
+        if (!p_Job.succeeded || !ensure_tiled_navmesh(p_World)) {
+          l_Tile.state = TileState::Failed;
+          return false;
+        }
+
+        // The previous version of the tile stays in the navmesh
+        // until its replacement is ready
+        const bool l_Added =
+            add_tile_layers(p_World, l_Tile, p_Job.layers);
+        ++p_World->navmesh_revision;
+        l_Tile.state = l_Added ? TileState::Ready : TileState::Failed;
+        return l_Added;
+      }
+
+      uint32_t finish_navmesh_tile_builds(WorldBackend *p_World,
+                                          float p_BudgetMs)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot finish tile builds in null navigation world");
+
+        const auto l_Start = std::chrono::steady_clock::now();
+
+        uint32_t l_FinishedCount = 0u;
+        float l_TotalBuildMs = 0.0f;
+        float l_MaxBuildMs = 0.0f;
+        for (auto it = p_World->tile_builds.begin();
+             it != p_World->tile_builds.end();) {
+          // At least one tile gets added per call so a small budget
+          // cannot stall the navmesh
+          if (p_BudgetMs > 0.0f && l_FinishedCount > 0u &&
+              std::chrono::duration<float, std::milli>(
+                  std::chrono::steady_clock::now() - l_Start)
+                      .count() >= p_BudgetMs) {
+            break;
+          }
+
+          std::shared_ptr<TileBuildJob> i_Job = it->second;
+          if (!i_Job->done.load(std::memory_order_acquire)) {
+            ++it;
+            continue;
+          }
+
+          it = p_World->tile_builds.erase(it);
+          finish_tile_build(p_World, *i_Job);
+
+          ++l_FinishedCount;
+          l_TotalBuildMs += i_Job->build_ms;
+          l_MaxBuildMs = std::max(l_MaxBuildMs, i_Job->build_ms);
+        }
+
+        LOW_PROFILE_COUNTER("Navigation", "Tile builds running",
+                            p_World->tile_builds.size());
+        if (l_FinishedCount > 0u) {
+          LOW_PROFILE_COUNTER("Navigation", "Tile build avg (ms)",
+                              l_TotalBuildMs / l_FinishedCount);
+          LOW_PROFILE_COUNTER("Navigation", "Tile build max (ms)",
+                              l_MaxBuildMs);
+        }
+
+        return l_FinishedCount;
+      }
+
+      uint32_t get_running_tile_build_count(WorldBackend *p_World)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot count tile builds on null navigation world");
+
+        return static_cast<uint32_t>(p_World->tile_builds.size());
+      }
+
+      static Bounds get_obstacle_bounds(const Obstacle &p_Obstacle)
+      {
+        Bounds l_Bounds;
+        switch (p_Obstacle.shape) {
+        case ObstacleShape::Cylinder: {
+          const float l_Radius = p_Obstacle.extents.x;
+          l_Bounds.min =
+              p_Obstacle.position -
+              Math::Vector3(l_Radius, 0.0f, l_Radius);
+          l_Bounds.max =
+              p_Obstacle.position +
+              Math::Vector3(l_Radius, p_Obstacle.extents.y, l_Radius);
+          break;
+        }
+        case ObstacleShape::Box:
+          l_Bounds.min = p_Obstacle.position - p_Obstacle.extents;
+          l_Bounds.max = p_Obstacle.position + p_Obstacle.extents;
+          break;
+        case ObstacleShape::OrientedBox: {
+          // Same conservative footprint the tile cache uses
+          const float l_Reach =
+              std::sqrt(p_Obstacle.extents.x * p_Obstacle.extents.x +
+                        p_Obstacle.extents.z * p_Obstacle.extents.z);
+          l_Bounds.min =
+              p_Obstacle.position -
+              Math::Vector3(l_Reach, p_Obstacle.extents.y, l_Reach);
+          l_Bounds.max =
+              p_Obstacle.position +
+              Math::Vector3(l_Reach, p_Obstacle.extents.y, l_Reach);
+          break;
+        }
+        }
+        return l_Bounds;
+      }
+
+      uint32_t add_obstacle(WorldBackend *p_World,
+                            const Obstacle &p_Obstacle)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot add obstacle to null navigation world");
+
+        if (p_World->obstacles.size() >=
+            static_cast<size_t>(LOW_NAV_MAX_OBSTACLES)) {
+          LOW_LOG_WARN << "Navigation world ran out of obstacles"
+                       << LOW_LOG_END;
+          return 0u;
+        }
+
+        const uint32_t l_Id = p_World->next_obstacle_id++;
+        ObstacleRecord &l_Record = p_World->obstacles[l_Id];
+        l_Record.obstacle = p_Obstacle;
+        l_Record.bounds = get_obstacle_bounds(p_Obstacle);
+        submit_obstacle(p_World, l_Id, l_Record);
+        return l_Id;
+      }
+
+      bool remove_obstacle(WorldBackend *p_World, uint32_t p_Obstacle)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot remove obstacle from null navigation world");
+
+        auto l_Pos = p_World->obstacles.find(p_Obstacle);
+        if (l_Pos == p_World->obstacles.end()) {
+          return false;
+        }
+
+        const ObstacleRecord &l_Record = l_Pos->second;
+        if (l_Record.ref != 0u && p_World->tile_cache) {
+          if (!dtStatusSucceed(p_World->tile_cache->removeObstacle(
+                  l_Record.ref))) {
+            p_World->pending_obstacle_removals.push_back(
+                l_Record.ref);
+          }
+          p_World->changed_obstacle_bounds.push_back(l_Record.bounds);
+          p_World->obstacle_updates_pending = true;
+        }
+
+        p_World->pending_obstacles.erase(p_Obstacle);
+        p_World->obstacles.erase(l_Pos);
+        return true;
+      }
+
+      uint32_t get_obstacle_count(const WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot count obstacles of null navigation world");
+
+        return static_cast<uint32_t>(p_World->obstacles.size());
+      }
+
+      bool update_obstacles(WorldBackend *p_World)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot update obstacles of null navigation world");
+
+        dtTileCache *l_Cache = p_World->tile_cache;
+        if (!l_Cache) {
+          return p_World->obstacles.empty();
+        }
+
+        while (!p_World->pending_obstacle_removals.empty()) {
+          if (!dtStatusSucceed(l_Cache->removeObstacle(
+                  p_World->pending_obstacle_removals.back()))) {
+            break;
+          }
+          p_World->pending_obstacle_removals.pop_back();
+          p_World->obstacle_updates_pending = true;
+        }
+
+        if (!p_World->pending_obstacles.empty()) {
+          const Low::Util::List<uint32_t> l_Pending(
+              p_World->pending_obstacles.begin(),
+              p_World->pending_obstacles.end());
+          for (uint32_t i_Id : l_Pending) {
+            auto i_Pos = p_World->obstacles.find(i_Id);
+            if (i_Pos == p_World->obstacles.end()) {
+              p_World->pending_obstacles.erase(i_Id);
+              continue;
+            }
+            submit_obstacle(p_World, i_Id, i_Pos->second);
+          }
+        }
+
+        if (!p_World->obstacle_updates_pending) {
+          return p_World->pending_obstacles.empty();
+        }
+
+        LOW_PROFILE_CPU("Navigation", "Update obstacles");
+
+        bool l_UpToDate = false;
+        l_Cache->update(0.0f, p_World->navmesh, &l_UpToDate);
+        ++p_World->navmesh_revision;
+
+        if (!l_UpToDate || !p_World->pending_obstacles.empty() ||
+            !p_World->pending_obstacle_removals.empty()) {
+          return false;
+        }
+
+        // Rebuilt navmesh tiles got new refs
+        const float l_TileWorldSize =
+            get_tile_world_size(p_World->build_settings);
+        for (const Bounds &i_Bounds :
+             p_World->changed_obstacle_bounds) {
+          const TileRange i_Range =
+              tile_range_for_bounds(i_Bounds, l_TileWorldSize);
+          for (int x = i_Range.minimum.x; x <= i_Range.maximum.x;
+               ++x) {
+            for (int z = i_Range.minimum.z; z <= i_Range.maximum.z;
+                 ++z) {
+              auto i_Tile =
+                  p_World->tiles.find(TileCoord{x, z}.get_key());
+              if (i_Tile != p_World->tiles.end()) {
+                refresh_tile_ref(p_World, i_Tile->second);
+              }
+            }
+          }
+        }
+        p_World->changed_obstacle_bounds.clear();
+        p_World->obstacle_updates_pending = false;
+        return true;
+      }
+
+      static void
+      append_build_settings(Low::Util::List<uint8_t> &p_Data,
+                            const BuildSettings &p_Settings)
+      {
+        append_value(p_Data, p_Settings.cell_size);
+        append_value(p_Data, p_Settings.cell_height);
+        append_value(p_Data, p_Settings.agent_height);
+        append_value(p_Data, p_Settings.agent_radius);
+        append_value(p_Data, p_Settings.agent_max_climb);
+        append_value(p_Data, p_Settings.agent_max_slope);
+        append_value(p_Data, p_Settings.tile_size);
+      }
+
+      static BuildSettings read_build_settings(LayerReader &p_Reader)
+      {
+        BuildSettings l_Settings;
+        l_Settings.cell_size = p_Reader.read_value<float>();
+        l_Settings.cell_height = p_Reader.read_value<float>();
+        l_Settings.agent_height = p_Reader.read_value<float>();
+        l_Settings.agent_radius = p_Reader.read_value<float>();
+        l_Settings.agent_max_climb = p_Reader.read_value<float>();
+        l_Settings.agent_max_slope = p_Reader.read_value<float>();
+        l_Settings.tile_size = p_Reader.read_value<int>();
+        return l_Settings;
+      }
+
+      static void append_tile_layers(WorldBackend *p_World,
+                                     TileCoord p_Coord,
+                                     Low::Util::List<uint8_t> &p_Data)
+      {
+        dtCompressedTileRef l_Refs[LOW_NAV_MAX_TILE_LAYERS];
+        const int l_Count =
+            p_World->tile_cache
+                ? p_World->tile_cache->getTilesAt(
+                      p_Coord.x, p_Coord.z, l_Refs,
+                      LOW_NAV_MAX_TILE_LAYERS)
+                : 0;
+
+        append_value(p_Data, static_cast<uint32_t>(l_Count));
+        for (int i = 0; i < l_Count; ++i) {
+          const dtCompressedTile *i_Layer =
+              p_World->tile_cache->getTileByRef(l_Refs[i]);
+          const uint32_t i_Size =
+              i_Layer ? static_cast<uint32_t>(i_Layer->dataSize) : 0u;
+          append_value(p_Data, i_Size);
+          if (i_Size > 0u) {
+            p_Data.insert(p_Data.end(), i_Layer->data,
+                          i_Layer->data + i_Size);
+          }
+        }
+      }
+
+      static bool read_tile_layers(LayerReader &p_Reader,
+                                   TileLayers &p_Layers)
+      {
+        const uint32_t l_LayerCount = p_Reader.read_value<uint32_t>();
+        for (uint32_t i = 0u; i < l_LayerCount && !p_Reader.failed;
+             ++i) {
+          const uint32_t i_Size = p_Reader.read_value<uint32_t>();
+          const uint8_t *i_Bytes = p_Reader.read(i_Size);
+          if (i_Bytes) {
+            p_Layers.emplace_back(i_Bytes, i_Bytes + i_Size);
+          }
+        }
+        return !p_Reader.failed;
+      }
+
+      void save_tile_layers(WorldBackend *p_World,
+                            Low::Util::List<uint8_t> &p_Data)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot save tile layers of null navigation world");
+
+        p_Data.clear();
+        append_value(p_Data, LOW_NAV_TILE_LAYERS_MAGIC);
+        append_value(p_Data, LOW_NAV_TILE_LAYERS_VERSION);
+        append_build_settings(p_Data, p_World->build_settings);
+
+        Low::Util::List<const Tile *> l_Tiles;
+        if (p_World->tile_cache) {
+          for (const auto &i_Entry : p_World->tiles) {
+            if (i_Entry.second.state == TileState::Ready) {
+              l_Tiles.push_back(&i_Entry.second);
+            }
+          }
+        }
+
+        append_value(p_Data, static_cast<uint32_t>(l_Tiles.size()));
+        for (const Tile *i_Tile : l_Tiles) {
+          append_value(p_Data, i_Tile->coord.x);
+          append_value(p_Data, i_Tile->coord.z);
+          append_value(p_Data, i_Tile->bounds.min.y);
+          append_value(p_Data, i_Tile->bounds.max.y);
+          append_tile_layers(p_World, i_Tile->coord, p_Data);
+        }
+      }
+
+      bool load_tile_layers(WorldBackend *p_World,
+                            const Low::Util::List<uint8_t> &p_Data)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot load tile layers into null navigation world");
+
+        LayerReader l_Reader{p_Data};
+        if (l_Reader.read_value<uint32_t>() !=
+                LOW_NAV_TILE_LAYERS_MAGIC ||
+            l_Reader.read_value<uint32_t>() !=
+                LOW_NAV_TILE_LAYERS_VERSION) {
+          return false;
+        }
+
+        // Layers are only valid for the settings they were
+        // rasterized with
+        if (!build_settings_equal(read_build_settings(l_Reader),
+                                  p_World->build_settings) ||
+            l_Reader.failed) {
+          return false;
+        }
+
+        cancel_all_tile_builds(p_World);
+        clear_navmesh(p_World);
+        clear_tiles(p_World);
+        ++p_World->navmesh_revision;
+
+        if (!ensure_tiled_navmesh(p_World)) {
+          return false;
+        }
+
+        const uint32_t l_TileCount = l_Reader.read_value<uint32_t>();
+        for (uint32_t i = 0u; i < l_TileCount && !l_Reader.failed;
+             ++i) {
+          TileCoord i_Coord;
+          i_Coord.x = l_Reader.read_value<int>();
+          i_Coord.z = l_Reader.read_value<int>();
+          const float i_MinY = l_Reader.read_value<float>();
+          const float i_MaxY = l_Reader.read_value<float>();
+
+          TileLayers i_Layers;
+          if (!read_tile_layers(l_Reader, i_Layers)) {
+            break;
+          }
+
+          ensure_tile(p_World, i_Coord, i_MinY, i_MaxY, nullptr);
+          Tile &i_Tile = p_World->tiles[i_Coord.get_key()];
+          i_Tile.state = add_tile_layers(p_World, i_Tile, i_Layers)
+                             ? TileState::Ready
+                             : TileState::Failed;
+        }
+
+        if (l_Reader.failed) {
+          LOW_LOG_WARN << "Navigation tile layers are truncated"
+                       << LOW_LOG_END;
+          return false;
+        }
+        return true;
+      }
+
+      void save_baked_tiles(
+          WorldBackend *p_World,
+          const Low::Util::UnorderedMap<
+              uint64_t, Low::Util::List<uint64_t>> &p_TileOwners,
+          Low::Util::List<uint8_t> &p_Data)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot save baked tiles of null navigation world");
+
+        p_Data.clear();
+        append_value(p_Data, LOW_NAV_BAKE_MAGIC);
+        append_value(p_Data, LOW_NAV_BAKE_VERSION);
+        // Layers of another Detour version cannot be read back
+        append_value(p_Data, static_cast<int>(DT_TILECACHE_VERSION));
+        append_value(p_Data, static_cast<int>(DT_NAVMESH_VERSION));
+        append_build_settings(p_Data, p_World->build_settings);
+
+        Low::Util::List<const Tile *> l_Tiles;
+        for (const auto &i_Entry : p_TileOwners) {
+          auto i_It = p_World->tiles.find(i_Entry.first);
+          if (i_It != p_World->tiles.end() &&
+              i_It->second.state == TileState::Ready) {
+            l_Tiles.push_back(&i_It->second);
+          }
+        }
+        // Baking the same scene twice gives the same file
+        std::sort(l_Tiles.begin(), l_Tiles.end(),
+                  [](const Tile *p_A, const Tile *p_B) {
+                    return p_A->coord < p_B->coord;
+                  });
+
+        append_value(p_Data, static_cast<uint32_t>(l_Tiles.size()));
+        for (const Tile *i_Tile : l_Tiles) {
+          const Low::Util::List<uint64_t> &i_Owners =
+              p_TileOwners.find(i_Tile->coord.get_key())->second;
+
+          append_value(p_Data, i_Tile->coord.x);
+          append_value(p_Data, i_Tile->coord.z);
+          append_value(p_Data, i_Tile->bounds.min.y);
+          append_value(p_Data, i_Tile->bounds.max.y);
+          append_value(p_Data,
+                       static_cast<uint32_t>(i_Owners.size()));
+          for (uint64_t i_Owner : i_Owners) {
+            append_value(p_Data, i_Owner);
+          }
+          append_tile_layers(p_World, i_Tile->coord, p_Data);
+        }
+      }
+
+      bool set_baked_tiles(WorldBackend *p_World,
+                           const Low::Util::List<uint8_t> &p_Data)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot set baked tiles of null navigation world");
+
+        LayerReader l_Reader{p_Data};
+        if (l_Reader.read_value<uint32_t>() != LOW_NAV_BAKE_MAGIC ||
+            l_Reader.read_value<uint32_t>() != LOW_NAV_BAKE_VERSION ||
+            l_Reader.read_value<int>() != DT_TILECACHE_VERSION ||
+            l_Reader.read_value<int>() != DT_NAVMESH_VERSION) {
+          return false;
+        }
+
+        if (!build_settings_equal(read_build_settings(l_Reader),
+                                  p_World->build_settings) ||
+            l_Reader.failed) {
+          return false;
+        }
+
+        Low::Util::UnorderedMap<uint64_t, BakedTile> l_Tiles;
+        const uint32_t l_TileCount = l_Reader.read_value<uint32_t>();
+        for (uint32_t i = 0u; i < l_TileCount && !l_Reader.failed;
+             ++i) {
+          BakedTile i_Tile;
+          i_Tile.coord.x = l_Reader.read_value<int>();
+          i_Tile.coord.z = l_Reader.read_value<int>();
+          i_Tile.min_y = l_Reader.read_value<float>();
+          i_Tile.max_y = l_Reader.read_value<float>();
+
+          const uint32_t i_OwnerCount =
+              l_Reader.read_value<uint32_t>();
+          for (uint32_t j = 0u;
+               j < i_OwnerCount && !l_Reader.failed; ++j) {
+            i_Tile.owners.push_back(l_Reader.read_value<uint64_t>());
+          }
+
+          if (!read_tile_layers(l_Reader, i_Tile.layers)) {
+            break;
+          }
+          l_Tiles[i_Tile.coord.get_key()] = std::move(i_Tile);
+        }
+
+        if (l_Reader.failed) {
+          LOW_LOG_WARN << "Baked navigation tiles are truncated"
+                       << LOW_LOG_END;
+          return false;
+        }
+
+        drop_baked_tiles(p_World);
+        p_World->baked_tiles = std::move(l_Tiles);
+        for (const auto &i_Entry : p_World->baked_tiles) {
+          for (uint64_t i_Owner : i_Entry.second.owners) {
+            p_World->owner_baked_tiles[i_Owner].push_back(
+                i_Entry.first);
+          }
+        }
+
+        for (uint64_t i_Owner : p_World->streamed_owners) {
+          stream_in_baked_tiles(p_World, i_Owner);
+        }
+        return true;
+      }
+
+      void clear_baked_tiles(WorldBackend *p_World)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot clear baked tiles of null navigation world");
+
+        drop_baked_tiles(p_World);
+        p_World->streamed_owners.clear();
+      }
+
+      bool is_baked_tile(const WorldBackend *p_World,
+                         TileCoord p_Coord)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot check baked tile of null navigation world");
+
+        return p_World->baked_tiles.find(p_Coord.get_key()) !=
+               p_World->baked_tiles.end();
+      }
+
+      uint32_t get_baked_tile_count(const WorldBackend *p_World)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot count baked tiles of null navigation world");
+
+        return static_cast<uint32_t>(p_World->baked_tiles.size());
+      }
+
+      uint32_t stream_in_baked_tiles(WorldBackend *p_World,
+                                     uint64_t p_Owner)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot stream in baked tiles of null navigation world");
+
+        p_World->streamed_owners.insert(p_Owner);
+
+        auto l_Owned = p_World->owner_baked_tiles.find(p_Owner);
+        if (l_Owned == p_World->owner_baked_tiles.end()) {
+          return 0u;
+        }
+
+        uint32_t l_AddedCount = 0u;
+        for (uint64_t i_Key : l_Owned->second) {
+          // Tiles that came in through another owner or that dynamic
+          // sources already rebuilt stay as they are
+          auto i_It = p_World->tiles.find(i_Key);
+          if (i_It != p_World->tiles.end() &&
+              i_It->second.state != TileState::Empty) {
+            continue;
+          }
+
+          const BakedTile &i_Baked =
+              p_World->baked_tiles.find(i_Key)->second;
+          ensure_tile(p_World, i_Baked.coord, i_Baked.min_y,
+                      i_Baked.max_y);
+          Tile &i_Tile = p_World->tiles[i_Key];
+          i_Tile.state =
+              add_tile_layers(p_World, i_Tile, i_Baked.layers)
+                  ? TileState::Ready
+                  : TileState::Failed;
+          remove_tile_from_dirty_list(p_World, i_Baked.coord);
+          ++l_AddedCount;
+        }
+
+        if (l_AddedCount > 0u) {
+          ++p_World->navmesh_revision;
+        }
+        return l_AddedCount;
+      }
+
+      uint32_t stream_out_baked_tiles(WorldBackend *p_World,
+                                      uint64_t p_Owner)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot stream out baked tiles of null navigation world");
+
+        p_World->streamed_owners.erase(p_Owner);
+
+        auto l_Owned = p_World->owner_baked_tiles.find(p_Owner);
+        if (l_Owned == p_World->owner_baked_tiles.end()) {
+          return 0u;
+        }
+
+        uint32_t l_RemovedCount = 0u;
+        for (uint64_t i_Key : l_Owned->second) {
+          const BakedTile &i_Baked =
+              p_World->baked_tiles.find(i_Key)->second;
+          const bool i_StillStreamed = std::any_of(
+              i_Baked.owners.begin(), i_Baked.owners.end(),
+              [p_World](uint64_t p_Other) {
+                return p_World->streamed_owners.find(p_Other) !=
+                       p_World->streamed_owners.end();
+              });
+          if (!i_StillStreamed &&
+              remove_tile(p_World, i_Baked.coord)) {
+            ++l_RemovedCount;
+          }
+        }
+        return l_RemovedCount;
+      }
+
+      bool
+      build_navmesh_from_geometry(WorldBackend *p_World,
+                                  const BuildGeometry &p_Geometry)
       {
         LOW_ASSERT(p_World,
                    "Cannot build navmesh in null navigation world");
 
+        cancel_all_tile_builds(p_World);
         clear_navmesh(p_World);
-        p_World->tiles.clear();
-        p_World->build_queue.clear();
-        p_World->dirty_tiles.clear();
+        clear_tiles(p_World);
         ++p_World->navmesh_revision;
 
         if (p_Geometry.vertices.empty() ||
@@ -990,69 +2367,115 @@ namespace Low {
         return true;
       }
 
-      bool find_path(WorldBackend *p_World,
-                     const Math::Vector3 &p_Start,
-                     const Math::Vector3 &p_End,
-                     const Math::Vector3 &p_HalfExtents,
-                     PathResult &p_Result)
+      static dtNavMeshQuery *acquire_query(WorldBackend *p_World)
       {
-        LOW_ASSERT(p_World,
-                   "Cannot find path in null navigation world");
-        p_Result.points.clear();
-        p_Result.navmesh_revision = get_navmesh_revision(p_World);
-        p_Result.partial = false;
+        std::lock_guard<std::mutex> l_Lock(p_World->query_pool_mutex);
+        if (!p_World->free_queries.empty()) {
+          dtNavMeshQuery *l_Query = p_World->free_queries.back();
+          p_World->free_queries.pop_back();
+          return l_Query;
+        }
 
-        if (!p_World->navmesh || !p_World->navmesh_query) {
-          return false;
+        dtNavMeshQuery *l_Query = dtAllocNavMeshQuery();
+        if (!l_Query) {
+          return nullptr;
+        }
+        const dtStatus l_Status = l_Query->init(
+            p_World->navmesh, LOW_NAV_QUERY_MAX_NODES);
+        if (!dtStatusSucceed(l_Status)) {
+          dtFreeNavMeshQuery(l_Query);
+          return nullptr;
         }
+        p_World->query_pool.push_back(l_Query);
+        return l_Query;
+      }
 
-        float l_Start[3];
-        float l_End[3];
-        float l_HalfExtents[3];
-        float l_NearestStart[3];
-        float l_NearestEnd[3];
+      static void release_query(WorldBackend *p_World,
+                                dtNavMeshQuery *p_Query)
+      {
+        std::lock_guard<std::mutex> l_Lock(p_World->query_pool_mutex);
+        p_World->free_queries.push_back(p_Query);
+      }
+
+      static uint64_t get_path_key(dtPolyRef p_StartRef,
+                                   dtPolyRef p_EndRef)
+      {
+        return (static_cast<uint64_t>(p_StartRef) << 32) ^
+               static_cast<uint64_t>(p_EndRef);
+      }
+
+      static bool
+      snap_path_endpoints(dtNavMeshQuery *p_Query,
+                          const dtQueryFilter &p_Filter,
+                          const Math::Vector3 &p_Start,
+                          const Math::Vector3 &p_End,
+                          const Math::Vector3 &p_HalfExtents,
+                          PathEndpoints &p_Endpoints)
+      {
+        float l_Start[3];
+        float l_End[3];
+        float l_HalfExtents[3];
         copy_vector(p_Start, l_Start);
         copy_vector(p_End, l_End);
         copy_vector(p_HalfExtents, l_HalfExtents);
 
-        dtQueryFilter l_Filter;
-        l_Filter.setIncludeFlags(LOW_NAV_POLYFLAG_WALK);
-        l_Filter.setExcludeFlags(0);
-        configure_filter_costs(l_Filter);
-
-        dtPolyRef l_StartRef = 0;
-        dtPolyRef l_EndRef = 0;
-        dtStatus l_Status = p_World->navmesh_query->findNearestPoly(
-            l_Start, l_HalfExtents, &l_Filter, &l_StartRef,
-            l_NearestStart);
-        if (!dtStatusSucceed(l_Status) || l_StartRef == 0) {
+        dtStatus l_Status = p_Query->findNearestPoly(
+            l_Start, l_HalfExtents, &p_Filter, &p_Endpoints.start_ref,
+            p_Endpoints.start);
+        if (!dtStatusSucceed(l_Status) ||
+            p_Endpoints.start_ref == 0) {
           return false;
         }
 
-        l_Status = p_World->navmesh_query->findNearestPoly(
-            l_End, l_HalfExtents, &l_Filter, &l_EndRef, l_NearestEnd);
-        if (!dtStatusSucceed(l_Status) || l_EndRef == 0) {
-          return false;
-        }
+        l_Status = p_Query->findNearestPoly(
+            l_End, l_HalfExtents, &p_Filter, &p_Endpoints.end_ref,
+            p_Endpoints.end);
+        return dtStatusSucceed(l_Status) && p_Endpoints.end_ref != 0;
+      }
 
-        dtPolyRef l_Path[LOW_NAV_MAX_PATH_POLYS];
+      static bool search_path_corridor(
+          dtNavMeshQuery *p_Query, const dtQueryFilter &p_Filter,
+          const PathEndpoints &p_Endpoints,
+          Low::Util::List<dtPolyRef> &p_Polys)
+      {
+        p_Polys.resize(LOW_NAV_MAX_PATH_POLYS);
         int l_PathCount = 0;
-        l_Status = p_World->navmesh_query->findPath(
-            l_StartRef, l_EndRef, l_NearestStart, l_NearestEnd,
-            &l_Filter, l_Path, &l_PathCount, LOW_NAV_MAX_PATH_POLYS);
+        const dtStatus l_Status = p_Query->findPath(
+            p_Endpoints.start_ref, p_Endpoints.end_ref,
+            p_Endpoints.start, p_Endpoints.end, &p_Filter,
+            p_Polys.data(), &l_PathCount, LOW_NAV_MAX_PATH_POLYS);
         if (!dtStatusSucceed(l_Status) || l_PathCount <= 0) {
+          p_Polys.clear();
+          return false;
+        }
+
+        p_Polys.resize(static_cast<uint32_t>(l_PathCount));
+        return true;
+      }
+
+      static bool
+      build_straight_path(dtNavMeshQuery *p_Query,
+                          const PathEndpoints &p_Endpoints,
+                          const Low::Util::List<dtPolyRef> &p_Polys,
+                          PathResult &p_Result)
+      {
+        p_Result.points.clear();
+        p_Result.partial = false;
+        if (p_Polys.empty()) {
           return false;
         }
 
-        p_Result.partial = l_Path[l_PathCount - 1] != l_EndRef;
+        const int l_PathCount = static_cast<int>(p_Polys.size());
+        p_Result.partial =
+            p_Polys[l_PathCount - 1] != p_Endpoints.end_ref;
 
-        float l_PathEnd[3] = {l_NearestEnd[0], l_NearestEnd[1],
-                              l_NearestEnd[2]};
+        float l_PathEnd[3] = {p_Endpoints.end[0], p_Endpoints.end[1],
+                              p_Endpoints.end[2]};
         if (p_Result.partial) {
           const dtStatus l_ClosestStatus =
-              p_World->navmesh_query->closestPointOnPoly(
-                  l_Path[l_PathCount - 1], l_NearestEnd, l_PathEnd,
-                  nullptr);
+              p_Query->closestPointOnPoly(p_Polys[l_PathCount - 1],
+                                          p_Endpoints.end, l_PathEnd,
+                                          nullptr);
           if (!dtStatusSucceed(l_ClosestStatus)) {
             return false;
           }
@@ -1064,8 +2487,8 @@ namespace Low {
         dtPolyRef
             l_StraightPathRefs[LOW_NAV_MAX_STRAIGHT_PATH_POINTS];
         int l_StraightPathCount = 0;
-        l_Status = p_World->navmesh_query->findStraightPath(
-            l_NearestStart, l_PathEnd, l_Path, l_PathCount,
+        const dtStatus l_Status = p_Query->findStraightPath(
+            p_Endpoints.start, l_PathEnd, p_Polys.data(), l_PathCount,
             l_StraightPath, l_StraightPathFlags, l_StraightPathRefs,
             &l_StraightPathCount, LOW_NAV_MAX_STRAIGHT_PATH_POINTS);
         if (!dtStatusSucceed(l_Status) || l_StraightPathCount <= 0) {
@@ -1082,6 +2505,1116 @@ namespace Low {
 
         return !p_Result.points.empty();
       }
+
+      static void validate_path_cache(WorldBackend *p_World)
+      {
+        const uint64_t l_Revision = get_navmesh_revision(p_World);
+        if (p_World->path_cache_revision != l_Revision) {
+          p_World->path_cache.clear();
+          p_World->path_cache_revision = l_Revision;
+        }
+      }
+
+      // Does not touch the cache, so workers may look corridors up
+      // while the main thread waits for them
+      static const PathCorridor *
+      find_cached_corridor(const WorldBackend *p_World,
+                           const PathEndpoints &p_Endpoints)
+      {
+        auto i_It = p_World->path_cache.find(get_path_key(
+            p_Endpoints.start_ref, p_Endpoints.end_ref));
+        if (i_It == p_World->path_cache.end() ||
+            i_It->second.start_ref != p_Endpoints.start_ref ||
+            i_It->second.end_ref != p_Endpoints.end_ref) {
+          return nullptr;
+        }
+        return &i_It->second;
+      }
+
+      static void
+      cache_path_corridor(WorldBackend *p_World,
+                          const PathEndpoints &p_Endpoints,
+                          const Low::Util::List<dtPolyRef> &p_Polys)
+      {
+        if (p_Polys.empty()) {
+          return;
+        }
+
+        const uint64_t l_Key =
+            get_path_key(p_Endpoints.start_ref, p_Endpoints.end_ref);
+        if (p_World->path_cache.size() >= LOW_NAV_PATH_CACHE_SIZE &&
+            p_World->path_cache.find(l_Key) ==
+                p_World->path_cache.end()) {
+          auto l_Oldest = p_World->path_cache.begin();
+          for (auto it = p_World->path_cache.begin();
+               it != p_World->path_cache.end(); ++it) {
+            if (it->second.stamp < l_Oldest->second.stamp) {
+              l_Oldest = it;
+            }
+          }
+          p_World->path_cache.erase(l_Oldest);
+        }
+
+        PathCorridor &l_Corridor = p_World->path_cache[l_Key];
+        l_Corridor.start_ref = p_Endpoints.start_ref;
+        l_Corridor.end_ref = p_Endpoints.end_ref;
+        l_Corridor.polys = p_Polys;
+        l_Corridor.stamp = p_World->next_path_cache_stamp++;
+      }
+
+      bool find_path(WorldBackend *p_World,
+                     const Math::Vector3 &p_Start,
+                     const Math::Vector3 &p_End,
+                     const Math::Vector3 &p_HalfExtents,
+                     PathResult &p_Result)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot find path in null navigation world");
+        p_Result.points.clear();
+        p_Result.navmesh_revision = get_navmesh_revision(p_World);
+        p_Result.partial = false;
+
+        if (!p_World->navmesh || !p_World->navmesh_query) {
+          return false;
+        }
+
+        PathEndpoints l_Endpoints;
+        if (!snap_path_endpoints(
+                p_World->navmesh_query, p_World->query_filter,
+                p_Start, p_End, p_HalfExtents, l_Endpoints)) {
+          return false;
+        }
+
+        validate_path_cache(p_World);
+        const PathCorridor *l_Cached =
+            find_cached_corridor(p_World, l_Endpoints);
+        if (l_Cached) {
+          return build_straight_path(p_World->navmesh_query,
+                                     l_Endpoints, l_Cached->polys,
+                                     p_Result);
+        }
+
+        Low::Util::List<dtPolyRef> l_Polys;
+        if (!search_path_corridor(p_World->navmesh_query,
+                                  p_World->query_filter, l_Endpoints,
+                                  l_Polys)) {
+          return false;
+        }
+        cache_path_corridor(p_World, l_Endpoints, l_Polys);
+
+        return build_straight_path(p_World->navmesh_query,
+                                   l_Endpoints, l_Polys, p_Result);
+      }
+
+      uint32_t request_path(WorldBackend *p_World,
+                            const Math::Vector3 &p_Start,
+                            const Math::Vector3 &p_End,
+                            const Math::Vector3 &p_HalfExtents)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot request path in null navigation world");
+
+        // Zero is never handed out and once the ids wrap around the
+        // ones of requests nobody picked up yet get skipped
+        uint32_t l_Id = 0u;
+        do {
+          l_Id = p_World->next_path_request++;
+        } while (l_Id == 0u || p_World->path_requests.find(l_Id) !=
+                                   p_World->path_requests.end());
+
+        PathRequest &l_Request = p_World->path_requests[l_Id];
+        l_Request.start = p_Start;
+        l_Request.end = p_End;
+        l_Request.half_extents = p_HalfExtents;
+        p_World->unresolved_path_requests.push_back(l_Id);
+        return l_Id;
+      }
+
+      PathRequestStatus poll_path_request(WorldBackend *p_World,
+                                          uint32_t p_Request,
+                                          PathResult *p_Result)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot poll path request in null navigation world");
+
+        auto i_It = p_World->path_requests.find(p_Request);
+        if (i_It == p_World->path_requests.end()) {
+          return PathRequestStatus::Failed;
+        }
+
+        const PathRequestStatus l_Status = i_It->second.status;
+        if (l_Status == PathRequestStatus::Pending) {
+          return l_Status;
+        }
+
+        if (p_Result) {
+          *p_Result = std::move(i_It->second.result);
+        }
+        p_World->path_requests.erase(i_It);
+        return l_Status;
+      }
+
+      bool cancel_path_request(WorldBackend *p_World,
+                               uint32_t p_Request)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot cancel path request in null navigation world");
+
+        // Searches skip requests that are gone once they are done
+        return p_World->path_requests.erase(p_Request) > 0u;
+      }
+
+      uint32_t
+      get_pending_path_request_count(const WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World, "Cannot count path requests in null "
+                            "navigation world");
+
+        uint32_t l_Count = 0u;
+        for (const auto &i_Entry : p_World->path_requests) {
+          if (i_Entry.second.status == PathRequestStatus::Pending) {
+            ++l_Count;
+          }
+        }
+        return l_Count;
+      }
+
+      static void finish_path_request(WorldBackend *p_World,
+                                      PathRequest &p_Request,
+                                      bool p_Succeeded)
+      {
+        p_Request.result.navmesh_revision =
+            get_navmesh_revision(p_World);
+        p_Request.status = p_Succeeded ? PathRequestStatus::Succeeded
+                                       : PathRequestStatus::Failed;
+      }
+
+      // Snaps waiting requests onto the navmesh and either answers
+      // them from the cache or hands them to a search. Returns the
+      // number of requests that got finished right away.
+      static uint32_t resolve_path_requests(WorldBackend *p_World)
+      {
+        uint32_t l_FinishedCount = 0u;
+        Low::Util::List<uint32_t> l_Unresolved;
+        l_Unresolved.swap(p_World->unresolved_path_requests);
+
+        for (uint32_t i_Id : l_Unresolved) {
+          auto i_It = p_World->path_requests.find(i_Id);
+          if (i_It == p_World->path_requests.end() ||
+              i_It->second.resolved) {
+            continue;
+          }
+
+          PathRequest &i_Request = i_It->second;
+          if (!snap_path_endpoints(p_World->navmesh_query,
+                                   p_World->query_filter,
+                                   i_Request.start, i_Request.end,
+                                   i_Request.half_extents,
+                                   i_Request.endpoints)) {
+            finish_path_request(p_World, i_Request, false);
+            ++l_FinishedCount;
+            continue;
+          }
+
+          const PathCorridor *i_Cached =
+              find_cached_corridor(p_World, i_Request.endpoints);
+          if (i_Cached) {
+            finish_path_request(
+                p_World, i_Request,
+                build_straight_path(p_World->navmesh_query,
+                                    i_Request.endpoints,
+                                    i_Cached->polys,
+                                    i_Request.result));
+            ++l_FinishedCount;
+            continue;
+          }
+
+          const uint64_t i_Key =
+              get_path_key(i_Request.endpoints.start_ref,
+                           i_Request.endpoints.end_ref);
+          auto i_SearchIt = p_World->path_searches.find(i_Key);
+          if (i_SearchIt == p_World->path_searches.end()) {
+            PathSearch &i_Search = p_World->path_searches[i_Key];
+            i_Search.endpoints = i_Request.endpoints;
+            p_World->queued_path_searches.push_back(i_Key);
+            i_SearchIt = p_World->path_searches.find(i_Key);
+          } else if (i_SearchIt->second.endpoints.start_ref !=
+                         i_Request.endpoints.start_ref ||
+                     i_SearchIt->second.endpoints.end_ref !=
+                         i_Request.endpoints.end_ref) {
+            // Another pair of polygons landed on the same key, the
+            // request tries again once that search is done
+            p_World->unresolved_path_requests.push_back(i_Id);
+            continue;
+          }
+
+          i_Request.resolved = true;
+          i_SearchIt->second.requests.push_back(i_Id);
+        }
+
+        return l_FinishedCount;
+      }
+
+      static void start_path_searches(WorldBackend *p_World,
+                                      uint32_t p_RunningCount)
+      {
+        while (p_RunningCount < LOW_NAV_MAX_PATH_SEARCHES &&
+               !p_World->queued_path_searches.empty()) {
+          const uint64_t i_Key =
+              p_World->queued_path_searches.front();
+          p_World->queued_path_searches.pop_front();
+
+          auto i_It = p_World->path_searches.find(i_Key);
+          if (i_It == p_World->path_searches.end()) {
+            continue;
+          }
+
+          PathSearch &i_Search = i_It->second;
+          i_Search.query = acquire_query(p_World);
+          i_Search.revision = get_navmesh_revision(p_World);
+          if (!i_Search.query) {
+            i_Search.done = true;
+            continue;
+          }
+
+          const PathEndpoints &i_Endpoints = i_Search.endpoints;
+          const dtStatus i_Status =
+              i_Search.query->initSlicedFindPath(
+                  i_Endpoints.start_ref, i_Endpoints.end_ref,
+                  i_Endpoints.start, i_Endpoints.end,
+                  &p_World->query_filter);
+          if (dtStatusFailed(i_Status)) {
+            i_Search.done = true;
+            continue;
+          }
+          ++p_RunningCount;
+        }
+      }
+
+      // Only touches the search and its query, so searches can
+      // advance on any thread while the navmesh stays as it is
+      static void advance_path_search(PathSearch &p_Search,
+                                      int p_MaxIterations)
+      {
+        int l_Iterations = 0;
+        dtStatus l_Status = p_Search.query->updateSlicedFindPath(
+            p_MaxIterations, &l_Iterations);
+        if (dtStatusInProgress(l_Status)) {
+          return;
+        }
+
+        p_Search.done = true;
+        if (dtStatusFailed(l_Status)) {
+          return;
+        }
+
+        p_Search.polys.resize(LOW_NAV_MAX_PATH_POLYS);
+        int l_PathCount = 0;
+        l_Status = p_Search.query->finalizeSlicedFindPath(
+            p_Search.polys.data(), &l_PathCount,
+            LOW_NAV_MAX_PATH_POLYS);
+        p_Search.polys.resize(
+            dtStatusSucceed(l_Status) && l_PathCount > 0
+                ? static_cast<uint32_t>(l_PathCount)
+                : 0u);
+      }
+
+      uint32_t update_path_requests(WorldBackend *p_World,
+                                    uint32_t p_MaxIterations)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot update path requests in null navigation world");
+
+        if (p_World->unresolved_path_requests.empty() &&
+            p_World->path_searches.empty()) {
+          return 0u;
+        }
+
+        LOW_PROFILE_CPU("Navigation", "Update path requests");
+
+        uint32_t l_FinishedCount = 0u;
+        if (!p_World->navmesh || !p_World->navmesh_query) {
+          // Same as find_path without a navmesh
+          for (uint32_t i_Id : p_World->unresolved_path_requests) {
+            auto i_It = p_World->path_requests.find(i_Id);
+            if (i_It != p_World->path_requests.end()) {
+              finish_path_request(p_World, i_It->second, false);
+              ++l_FinishedCount;
+            }
+          }
+          p_World->unresolved_path_requests.clear();
+          return l_FinishedCount;
+        }
+
+        validate_path_cache(p_World);
+        l_FinishedCount += resolve_path_requests(p_World);
+
+        uint32_t l_RunningCount = 0u;
+        for (const auto &i_Entry : p_World->path_searches) {
+          if (i_Entry.second.query && !i_Entry.second.done) {
+            ++l_RunningCount;
+          }
+        }
+        start_path_searches(p_World, l_RunningCount);
+
+        Low::Util::List<PathSearch *> l_Running;
+        for (auto &i_Entry : p_World->path_searches) {
+          if (i_Entry.second.query && !i_Entry.second.done) {
+            l_Running.push_back(&i_Entry.second);
+          }
+        }
+
+        // The budget is shared among the running searches, zero lets
+        // all of them run until they are done
+        int l_Iterations = std::numeric_limits<int>::max();
+        if (p_MaxIterations > 0u && !l_Running.empty()) {
+          const uint32_t l_Share =
+              p_MaxIterations /
+              static_cast<uint32_t>(l_Running.size());
+          l_Iterations = std::max(static_cast<int>(l_Share),
+                                  LOW_NAV_MIN_PATH_SEARCH_ITERATIONS);
+        }
+
+        Low::Util::JobManager::Parallel::for_each(
+            static_cast<uint32_t>(l_Running.size()), 1u,
+            [&](uint32_t p_Begin, uint32_t p_End) {
+              for (uint32_t i = p_Begin; i < p_End; ++i) {
+                advance_path_search(*l_Running[i], l_Iterations);
+              }
+            });
+
+        // Every request of a finished search gets the straight path
+        // along the shared corridor
+        struct FinishedRequest
+        {
+          PathRequest *request;
+          const PathSearch *search;
+        };
+        Low::Util::List<FinishedRequest> l_Finished;
+        Low::Util::List<uint64_t> l_DoneSearches;
+        const uint64_t l_Revision = get_navmesh_revision(p_World);
+        for (auto &i_Entry : p_World->path_searches) {
+          PathSearch &i_Search = i_Entry.second;
+          if (!i_Search.done) {
+            continue;
+          }
+
+          if (i_Search.query) {
+            release_query(p_World, i_Search.query);
+            i_Search.query = nullptr;
+          }
+          if (i_Search.revision == l_Revision) {
+            cache_path_corridor(p_World, i_Search.endpoints,
+                                i_Search.polys);
+          }
+
+          for (uint32_t i_Id : i_Search.requests) {
+            auto i_It = p_World->path_requests.find(i_Id);
+            if (i_It != p_World->path_requests.end()) {
+              l_Finished.push_back({&i_It->second, &i_Search});
+            }
+          }
+          l_DoneSearches.push_back(i_Entry.first);
+        }
+
+        Low::Util::List<uint8_t> l_Succeeded(l_Finished.size(), 0u);
+        Low::Util::JobManager::Parallel::for_each(
+            static_cast<uint32_t>(l_Finished.size()), 16u,
+            [&](uint32_t p_Begin, uint32_t p_End) {
+              dtNavMeshQuery *l_Query = acquire_query(p_World);
+              if (!l_Query) {
+                return;
+              }
+              for (uint32_t i = p_Begin; i < p_End; ++i) {
+                l_Succeeded[i] = build_straight_path(
+                    l_Query, l_Finished[i].request->endpoints,
+                    l_Finished[i].search->polys,
+                    l_Finished[i].request->result);
+              }
+              release_query(p_World, l_Query);
+            });
+
+        for (uint32_t i = 0u; i < l_Finished.size(); ++i) {
+          finish_path_request(p_World, *l_Finished[i].request,
+                              l_Succeeded[i] != 0u);
+        }
+        l_FinishedCount += static_cast<uint32_t>(l_Finished.size());
+
+        for (uint64_t i_Key : l_DoneSearches) {
+          p_World->path_searches.erase(i_Key);
+        }
+
+        LOW_PROFILE_COUNTER("Navigation", "Path searches",
+                            p_World->path_searches.size());
+        LOW_PROFILE_COUNTER("Navigation", "Cached path corridors",
+                            p_World->path_cache.size());
+
+        return l_FinishedCount;
+      }
+
+      uint32_t
+      find_path_batch(WorldBackend *p_World,
+                      const Low::Util::List<PathQuery> &p_Queries,
+                      Low::Util::List<PathResult> &p_Results)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot find paths in null navigation world");
+
+        const uint64_t l_Revision = get_navmesh_revision(p_World);
+        p_Results.clear();
+        p_Results.resize(p_Queries.size());
+        for (PathResult &i_Result : p_Results) {
+          i_Result.navmesh_revision = l_Revision;
+        }
+
+        if (!p_World->navmesh || !p_World->navmesh_query ||
+            p_Queries.empty()) {
+          return 0u;
+        }
+
+        LOW_PROFILE_CPU("Navigation", "Find path batch");
+
+        validate_path_cache(p_World);
+
+        // Corridors that had to be searched get cached once the
+        // workers are done with the cache
+        Low::Util::List<PathEndpoints> l_Endpoints(p_Queries.size());
+        Low::Util::List<Low::Util::List<dtPolyRef>> l_Searched(
+            p_Queries.size());
+        Low::Util::JobManager::Parallel::for_each(
+            static_cast<uint32_t>(p_Queries.size()), 8u,
+            [&](uint32_t p_Begin, uint32_t p_End) {
+              dtNavMeshQuery *l_Query = acquire_query(p_World);
+              if (!l_Query) {
+                return;
+              }
+              for (uint32_t i = p_Begin; i < p_End; ++i) {
+                const PathQuery &i_Query = p_Queries[i];
+                if (!snap_path_endpoints(
+                        l_Query, p_World->query_filter, i_Query.start,
+                        i_Query.end, i_Query.half_extents,
+                        l_Endpoints[i])) {
+                  continue;
+                }
+
+                const PathCorridor *i_Cached =
+                    find_cached_corridor(p_World, l_Endpoints[i]);
+                if (i_Cached) {
+                  build_straight_path(l_Query, l_Endpoints[i],
+                                      i_Cached->polys, p_Results[i]);
+                } else if (search_path_corridor(
+                               l_Query, p_World->query_filter,
+                               l_Endpoints[i], l_Searched[i])) {
+                  build_straight_path(l_Query, l_Endpoints[i],
+                                      l_Searched[i], p_Results[i]);
+                }
+              }
+              release_query(p_World, l_Query);
+            });
+
+        uint32_t l_FoundCount = 0u;
+        for (uint32_t i = 0u; i < p_Queries.size(); ++i) {
+          cache_path_corridor(p_World, l_Endpoints[i], l_Searched[i]);
+          if (!p_Results[i].points.empty()) {
+            ++l_FoundCount;
+          }
+        }
+        return l_FoundCount;
+      }
+
+      uint32_t
+      raycast_batch(WorldBackend *p_World,
+                    const Low::Util::List<RaycastQuery> &p_Queries,
+                    Low::Util::List<RaycastResult> &p_Results)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot raycast in null navigation world");
+
+        p_Results.clear();
+        p_Results.resize(p_Queries.size());
+        if (!p_World->navmesh || !p_World->navmesh_query ||
+            p_Queries.empty()) {
+          return 0u;
+        }
+
+        LOW_PROFILE_CPU("Navigation", "Raycast batch");
+
+        std::atomic<uint32_t> l_HitCount{0u};
+        Low::Util::JobManager::Parallel::for_each(
+            static_cast<uint32_t>(p_Queries.size()), 32u,
+            [&](uint32_t p_Begin, uint32_t p_End) {
+              dtNavMeshQuery *l_Query = acquire_query(p_World);
+              if (!l_Query) {
+                return;
+              }
+              uint32_t l_Hits = 0u;
+              for (uint32_t i = p_Begin; i < p_End; ++i) {
+                const RaycastQuery &i_Query = p_Queries[i];
+                RaycastResult &i_Result = p_Results[i];
+
+                float i_Start[3];
+                float i_End[3];
+                float i_HalfExtents[3];
+                float i_NearestStart[3];
+                copy_vector(i_Query.start, i_Start);
+                copy_vector(i_Query.end, i_End);
+                copy_vector(i_Query.half_extents, i_HalfExtents);
+
+                dtPolyRef i_StartRef = 0;
+                dtStatus i_Status = l_Query->findNearestPoly(
+                    i_Start, i_HalfExtents, &p_World->query_filter,
+                    &i_StartRef, i_NearestStart);
+                if (!dtStatusSucceed(i_Status) || i_StartRef == 0) {
+                  continue;
+                }
+
+                float i_T = 0.0f;
+                float i_Normal[3] = {0.0f, 0.0f, 0.0f};
+                int i_PathCount = 0;
+                i_Status = l_Query->raycast(
+                    i_StartRef, i_NearestStart, i_End,
+                    &p_World->query_filter, &i_T, i_Normal, nullptr,
+                    &i_PathCount, 0);
+                if (!dtStatusSucceed(i_Status)) {
+                  continue;
+                }
+
+                // Detour reports rays that reach their end with a
+                // huge t
+                i_Result.valid = true;
+                i_Result.hit = i_T <= 1.0f;
+                i_Result.fraction = i_Result.hit ? i_T : 1.0f;
+                const Math::Vector3 i_From =
+                    read_vector(i_NearestStart);
+                i_Result.position =
+                    i_From +
+                    (i_Query.end - i_From) * i_Result.fraction;
+                i_Result.normal = read_vector(i_Normal);
+                if (i_Result.hit) {
+                  ++l_Hits;
+                }
+              }
+              release_query(p_World, l_Query);
+              l_HitCount.fetch_add(l_Hits, std::memory_order_relaxed);
+            });
+
+        return l_HitCount.load(std::memory_order_relaxed);
+      }
+
+      static bool is_crowd_agent(const WorldBackend *p_World,
+                                 int p_Agent)
+      {
+        return p_Agent >= 0 &&
+               p_Agent <
+                   static_cast<int>(p_World->crowd_agents.size()) &&
+               p_World->crowd_agents[p_Agent].used;
+      }
+
+      static void fill_crowd_agent_params(
+          const CrowdAgentRecord &p_Agent,
+          dtCrowdAgentParams &p_Params)
+      {
+        std::memset(&p_Params, 0, sizeof(p_Params));
+        p_Params.radius = p_Agent.params.radius;
+        p_Params.height = p_Agent.params.height;
+        p_Params.maxAcceleration = p_Agent.params.max_acceleration;
+        p_Params.maxSpeed = p_Agent.params.max_speed;
+        p_Params.collisionQueryRange = p_Agent.params.radius * 12.0f;
+        p_Params.pathOptimizationRange =
+            p_Agent.params.radius * 30.0f;
+        p_Params.separationWeight = 2.0f;
+        p_Params.queryFilterType = 0;
+
+        // Reduced agents still follow their corridor but skip the
+        // topology optimization and steer with the cheap avoidance
+        // settings
+        if (p_Agent.lod == CrowdAgentLod::Full) {
+          p_Params.updateFlags =
+              DT_CROWD_ANTICIPATE_TURNS | DT_CROWD_OPTIMIZE_VIS |
+              DT_CROWD_OPTIMIZE_TOPO | DT_CROWD_OBSTACLE_AVOIDANCE |
+              DT_CROWD_SEPARATION;
+          p_Params.obstacleAvoidanceType = LOW_NAV_AVOIDANCE_HIGH;
+        } else {
+          p_Params.updateFlags =
+              DT_CROWD_OPTIMIZE_VIS | DT_CROWD_OBSTACLE_AVOIDANCE;
+          p_Params.obstacleAvoidanceType = LOW_NAV_AVOIDANCE_LOW;
+        }
+      }
+
+      static void configure_crowd(dtCrowd *p_Crowd)
+      {
+        dtQueryFilter *l_Filter = p_Crowd->getEditableFilter(0);
+        l_Filter->setIncludeFlags(LOW_NAV_POLYFLAG_WALK);
+        l_Filter->setExcludeFlags(0);
+        configure_filter_costs(*l_Filter);
+
+        dtObstacleAvoidanceParams l_Params;
+        std::memcpy(&l_Params,
+                    p_Crowd->getObstacleAvoidanceParams(0),
+                    sizeof(l_Params));
+
+        l_Params.velBias = 0.5f;
+        l_Params.adaptiveDivs = 5;
+        l_Params.adaptiveRings = 2;
+        l_Params.adaptiveDepth = 1;
+        p_Crowd->setObstacleAvoidanceParams(LOW_NAV_AVOIDANCE_LOW,
+                                            &l_Params);
+
+        l_Params.adaptiveDivs = 7;
+        l_Params.adaptiveRings = 2;
+        l_Params.adaptiveDepth = 3;
+        p_Crowd->setObstacleAvoidanceParams(LOW_NAV_AVOIDANCE_HIGH,
+                                            &l_Params);
+      }
+
+      static bool ensure_crowd(WorldBackend *p_World)
+      {
+        if (!p_World->navmesh) {
+          return false;
+        }
+
+        if (p_World->crowd &&
+            static_cast<int>(p_World->crowd_agent_count) <=
+                p_World->crowd_capacity) {
+          return true;
+        }
+
+        release_crowd(p_World);
+
+        float l_MaxRadius = p_World->build_settings.agent_radius;
+        for (const CrowdAgentRecord &i_Agent :
+             p_World->crowd_agents) {
+          if (i_Agent.used) {
+            l_MaxRadius =
+                std::max(l_MaxRadius, i_Agent.params.radius);
+          }
+        }
+
+        // Leaves room so a growing crowd does not get recreated for
+        // every agent that is added
+        const int l_Capacity = std::max(
+            LOW_NAV_MIN_CROWD_CAPACITY,
+            static_cast<int>(p_World->crowd_agent_count) * 2);
+
+        p_World->crowd = dtAllocCrowd();
+        if (!p_World->crowd ||
+            !p_World->crowd->init(l_Capacity, l_MaxRadius,
+                                  p_World->navmesh)) {
+          LOW_LOG_ERROR << "Failed to initialize navigation crowd"
+                        << LOW_LOG_END;
+          if (p_World->crowd) {
+            dtFreeCrowd(p_World->crowd);
+            p_World->crowd = nullptr;
+          }
+          return false;
+        }
+
+        configure_crowd(p_World->crowd);
+        p_World->crowd_capacity = l_Capacity;
+        p_World->crowd_max_radius = l_MaxRadius;
+        p_World->crowd_agents_dirty = true;
+        return true;
+      }
+
+      static void add_agents_to_crowd(WorldBackend *p_World)
+      {
+        if (!p_World->crowd_agents_dirty) {
+          return;
+        }
+        p_World->crowd_agents_dirty = false;
+
+        for (int i = 0;
+             i < static_cast<int>(p_World->crowd_agents.size());
+             ++i) {
+          CrowdAgentRecord &i_Agent = p_World->crowd_agents[i];
+          if (!i_Agent.used || i_Agent.crowd_index >= 0 ||
+              i_Agent.lod == CrowdAgentLod::Frozen) {
+            continue;
+          }
+
+          dtCrowdAgentParams i_Params;
+          fill_crowd_agent_params(i_Agent, i_Params);
+          float i_Position[3];
+          copy_vector(i_Agent.position, i_Position);
+
+          i_Agent.crowd_index =
+              p_World->crowd->addAgent(i_Position, &i_Params);
+          if (i_Agent.crowd_index < 0) {
+            p_World->crowd_agents_dirty = true;
+            continue;
+          }
+
+          // Targets that were handed to the previous crowd are
+          // requested again
+          request_crowd_agent_target(p_World, i);
+        }
+      }
+
+      static void remove_agent_from_crowd(WorldBackend *p_World,
+                                          CrowdAgentRecord &p_Agent)
+      {
+        if (p_Agent.crowd_index < 0) {
+          return;
+        }
+
+        if (p_World->crowd) {
+          p_World->crowd->removeAgent(p_Agent.crowd_index);
+        }
+        p_Agent.crowd_index = -1;
+        p_Agent.velocity = Math::Vector3(0.0f);
+      }
+
+      // Detour never places an agent again that was added where
+      // there was no navmesh yet, those agents get added again once
+      // new tiles came in
+      static void replace_invalid_crowd_agents(WorldBackend *p_World)
+      {
+        if (p_World->crowd_placement_revision ==
+            p_World->navmesh_revision) {
+          return;
+        }
+        p_World->crowd_placement_revision = p_World->navmesh_revision;
+
+        for (CrowdAgentRecord &i_Agent : p_World->crowd_agents) {
+          if (!i_Agent.used || i_Agent.crowd_index < 0) {
+            continue;
+          }
+
+          const dtCrowdAgent *i_CrowdAgent =
+              p_World->crowd->getAgent(i_Agent.crowd_index);
+          if (i_CrowdAgent &&
+              i_CrowdAgent->state == DT_CROWDAGENT_STATE_INVALID) {
+            remove_agent_from_crowd(p_World, i_Agent);
+            p_World->crowd_agents_dirty = true;
+          }
+        }
+      }
+
+      // Resolves queued targets to navmesh polygons and hands them
+      // to the crowd. The actual path search is spread over the
+      // following updates by the path queue of the crowd.
+      static uint32_t process_crowd_target_requests(
+          WorldBackend *p_World, uint32_t p_MaxRequests)
+      {
+        const dtNavMeshQuery *l_Query =
+            p_World->crowd->getNavMeshQuery();
+        const dtQueryFilter *l_Filter = p_World->crowd->getFilter(0);
+
+        uint32_t l_RequestCount = 0u;
+        while (!p_World->crowd_target_requests.empty() &&
+               (p_MaxRequests == 0u ||
+                l_RequestCount < p_MaxRequests)) {
+          const int i_AgentIndex =
+              p_World->crowd_target_requests.front();
+          p_World->crowd_target_requests.pop_front();
+
+          // Requests of removed agents stay in the queue
+          if (!is_crowd_agent(p_World, i_AgentIndex)) {
+            continue;
+          }
+          CrowdAgentRecord &i_Agent =
+              p_World->crowd_agents[i_AgentIndex];
+          if (!i_Agent.target_pending) {
+            continue;
+          }
+          i_Agent.target_pending = false;
+
+          // Frozen agents ask again once they are thawed
+          if (!i_Agent.has_target || i_Agent.crowd_index < 0) {
+            continue;
+          }
+
+          float i_Target[3];
+          float i_HalfExtents[3] = {
+              i_Agent.params.radius * 4.0f, i_Agent.params.height,
+              i_Agent.params.radius * 4.0f};
+          float i_NearestTarget[3];
+          copy_vector(i_Agent.target, i_Target);
+
+          dtPolyRef i_TargetRef = 0;
+          const dtStatus i_Status = l_Query->findNearestPoly(
+              i_Target, i_HalfExtents, l_Filter, &i_TargetRef,
+              i_NearestTarget);
+          if (!dtStatusSucceed(i_Status) || i_TargetRef == 0) {
+            p_World->crowd->resetMoveTarget(i_Agent.crowd_index);
+            continue;
+          }
+
+          p_World->crowd->requestMoveTarget(i_Agent.crowd_index,
+                                            i_TargetRef,
+                                            i_NearestTarget);
+          ++l_RequestCount;
+        }
+
+        return l_RequestCount;
+      }
+
+      int add_crowd_agent(WorldBackend *p_World,
+                          const Math::Vector3 &p_Position,
+                          const CrowdAgentParams &p_Params)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot add crowd agent to null navigation world");
+
+        int l_AgentIndex = -1;
+        if (!p_World->free_crowd_agents.empty()) {
+          l_AgentIndex = p_World->free_crowd_agents.back();
+          p_World->free_crowd_agents.pop_back();
+        } else {
+          l_AgentIndex =
+              static_cast<int>(p_World->crowd_agents.size());
+          p_World->crowd_agents.push_back(CrowdAgentRecord());
+        }
+
+        CrowdAgentRecord &l_Agent =
+            p_World->crowd_agents[l_AgentIndex];
+        l_Agent = CrowdAgentRecord();
+        l_Agent.used = true;
+        l_Agent.params = p_Params;
+        l_Agent.position = p_Position;
+
+        ++p_World->crowd_agent_count;
+        p_World->crowd_agents_dirty = true;
+
+        // The crowd only knows the radius it got created with
+        if (p_World->crowd &&
+            p_Params.radius > p_World->crowd_max_radius) {
+          release_crowd(p_World);
+        }
+
+        return l_AgentIndex;
+      }
+
+      bool remove_crowd_agent(WorldBackend *p_World, int p_Agent)
+      {
+        LOW_ASSERT(
+            p_World,
+            "Cannot remove crowd agent from null navigation world");
+        if (!is_crowd_agent(p_World, p_Agent)) {
+          return false;
+        }
+
+        CrowdAgentRecord &l_Agent = p_World->crowd_agents[p_Agent];
+        remove_agent_from_crowd(p_World, l_Agent);
+        l_Agent = CrowdAgentRecord();
+
+        p_World->free_crowd_agents.push_back(p_Agent);
+        --p_World->crowd_agent_count;
+        return true;
+      }
+
+      bool set_crowd_agent_params(WorldBackend *p_World, int p_Agent,
+                                  const CrowdAgentParams &p_Params)
+      {
+        LOW_ASSERT(p_World, "Cannot set crowd agent parameters in "
+                            "null navigation world");
+        if (!is_crowd_agent(p_World, p_Agent)) {
+          return false;
+        }
+
+        CrowdAgentRecord &l_Agent = p_World->crowd_agents[p_Agent];
+        l_Agent.params = p_Params;
+
+        if (p_World->crowd &&
+            p_Params.radius > p_World->crowd_max_radius) {
+          release_crowd(p_World);
+        } else if (p_World->crowd && l_Agent.crowd_index >= 0) {
+          dtCrowdAgentParams l_Params;
+          fill_crowd_agent_params(l_Agent, l_Params);
+          p_World->crowd->updateAgentParameters(l_Agent.crowd_index,
+                                                &l_Params);
+        }
+        return true;
+      }
+
+      bool set_crowd_agent_target(WorldBackend *p_World, int p_Agent,
+                                  const Math::Vector3 &p_Target)
+      {
+        LOW_ASSERT(p_World, "Cannot set crowd agent target in null "
+                            "navigation world");
+        if (!is_crowd_agent(p_World, p_Agent)) {
+          return false;
+        }
+
+        CrowdAgentRecord &l_Agent = p_World->crowd_agents[p_Agent];
+        l_Agent.target = p_Target;
+        l_Agent.has_target = true;
+        request_crowd_agent_target(p_World, p_Agent);
+        return true;
+      }
+
+      bool clear_crowd_agent_target(WorldBackend *p_World,
+                                    int p_Agent)
+      {
+        LOW_ASSERT(p_World, "Cannot clear crowd agent target in null "
+                            "navigation world");
+        if (!is_crowd_agent(p_World, p_Agent)) {
+          return false;
+        }
+
+        CrowdAgentRecord &l_Agent = p_World->crowd_agents[p_Agent];
+        l_Agent.has_target = false;
+        l_Agent.target_pending = false;
+        if (p_World->crowd && l_Agent.crowd_index >= 0) {
+          p_World->crowd->resetMoveTarget(l_Agent.crowd_index);
+        }
+        return true;
+      }
+
+      bool set_crowd_agent_position(WorldBackend *p_World,
+                                    int p_Agent,
+                                    const Math::Vector3 &p_Position)
+      {
+        LOW_ASSERT(p_World, "Cannot move crowd agent in null "
+                            "navigation world");
+        if (!is_crowd_agent(p_World, p_Agent)) {
+          return false;
+        }
+
+        CrowdAgentRecord &l_Agent = p_World->crowd_agents[p_Agent];
+        l_Agent.position = p_Position;
+
+        // Detour agents cannot be teleported, the agent is added
+        // again at its new position on the next update
+        if (l_Agent.crowd_index >= 0) {
+          remove_agent_from_crowd(p_World, l_Agent);
+          p_World->crowd_agents_dirty = true;
+        }
+        return true;
+      }
+
+      bool set_crowd_agent_lod(WorldBackend *p_World, int p_Agent,
+                               CrowdAgentLod p_Lod)
+      {
+        LOW_ASSERT(p_World, "Cannot set crowd agent lod in null "
+                            "navigation world");
+        if (!is_crowd_agent(p_World, p_Agent)) {
+          return false;
+        }
+
+        CrowdAgentRecord &l_Agent = p_World->crowd_agents[p_Agent];
+        if (l_Agent.lod == p_Lod) {
+          return true;
+        }
+        l_Agent.lod = p_Lod;
+
+        if (p_Lod == CrowdAgentLod::Frozen) {
+          // Frozen agents keep their position and target but leave
+          // the crowd so they cost nothing while they are away
+          remove_agent_from_crowd(p_World, l_Agent);
+        } else if (l_Agent.crowd_index < 0) {
+          p_World->crowd_agents_dirty = true;
+        } else if (p_World->crowd) {
+          dtCrowdAgentParams l_Params;
+          fill_crowd_agent_params(l_Agent, l_Params);
+          p_World->crowd->updateAgentParameters(l_Agent.crowd_index,
+                                                &l_Params);
+        }
+        return true;
+      }
+
+      bool get_crowd_agent_state(const WorldBackend *p_World,
+                                 int p_Agent,
+                                 CrowdAgentState *p_State)
+      {
+        LOW_ASSERT(p_World, "Cannot get crowd agent state from null "
+                            "navigation world");
+        if (!p_State || !is_crowd_agent(p_World, p_Agent)) {
+          return false;
+        }
+
+        const CrowdAgentRecord &l_Agent =
+            p_World->crowd_agents[p_Agent];
+        p_State->position = l_Agent.position;
+        p_State->velocity = l_Agent.velocity;
+        p_State->lod = l_Agent.lod;
+        p_State->has_target = l_Agent.has_target;
+        p_State->on_navmesh = false;
+        p_State->reached_target = false;
+
+        if (p_World->crowd && l_Agent.crowd_index >= 0) {
+          const dtCrowdAgent *l_CrowdAgent =
+              p_World->crowd->getAgent(l_Agent.crowd_index);
+          p_State->on_navmesh =
+              l_CrowdAgent &&
+              l_CrowdAgent->state != DT_CROWDAGENT_STATE_INVALID;
+        }
+
+        if (l_Agent.has_target) {
+          Math::Vector3 l_Difference =
+              l_Agent.target - l_Agent.position;
+          l_Difference.y = 0.0f;
+          p_State->reached_target =
+              Math::VectorUtil::magnitude_squared(l_Difference) <=
+              l_Agent.params.radius * l_Agent.params.radius;
+        }
+        return true;
+      }
+
+      uint32_t get_crowd_agent_count(const WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World, "Cannot count crowd agents in null "
+                            "navigation world");
+        return p_World->crowd_agent_count;
+      }
+
+      uint32_t update_crowd(WorldBackend *p_World, float p_Delta,
+                            uint32_t p_MaxTargetRequests)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot update crowd in null navigation world");
+
+        if (p_World->crowd_agent_count == 0u ||
+            !ensure_crowd(p_World)) {
+          return 0u;
+        }
+
+        LOW_PROFILE_CPU("Navigation", "Update crowd");
+
+        replace_invalid_crowd_agents(p_World);
+        add_agents_to_crowd(p_World);
+        const uint32_t l_RequestCount =
+            process_crowd_target_requests(p_World,
+                                          p_MaxTargetRequests);
+
+        // Steering, avoidance and integration all happen inside of
+        // this call and share the proximity grid of the crowd
+        p_World->crowd->update(p_Delta, nullptr);
+
+        // Reading the results back only touches each agent's own
+        // record
+        dtCrowd *l_Crowd = p_World->crowd;
+        Low::Util::List<CrowdAgentRecord> &l_Agents =
+            p_World->crowd_agents;
+        Low::Util::JobManager::Parallel::for_each(
+            static_cast<uint32_t>(l_Agents.size()), 256u,
+            [&](uint32_t p_Begin, uint32_t p_End) {
+              for (uint32_t i = p_Begin; i < p_End; ++i) {
+                CrowdAgentRecord &i_Agent = l_Agents[i];
+                if (!i_Agent.used || i_Agent.crowd_index < 0) {
+                  continue;
+                }
+
+                const dtCrowdAgent *i_CrowdAgent =
+                    l_Crowd->getAgent(i_Agent.crowd_index);
+                if (!i_CrowdAgent || !i_CrowdAgent->active) {
+                  continue;
+                }
+                i_Agent.position = read_vector(i_CrowdAgent->npos);
+                i_Agent.velocity = read_vector(i_CrowdAgent->vel);
+              }
+            });
+
+        LOW_PROFILE_COUNTER("Navigation", "Crowd agents",
+                            p_World->crowd_agent_count);
+        LOW_PROFILE_COUNTER("Navigation", "Crowd target requests",
+                            p_World->crowd_target_requests.size());
+
+        return l_RequestCount;
+      }
     } // namespace Navigation
   } // namespace Core
 } // namespace Low
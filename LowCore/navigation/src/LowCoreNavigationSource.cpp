@@ -12,6 +12,7 @@
 #include "LowUtilObserverManager.h"
 
 #include "LowCorePrefabInstance.h"
+#include "LowCoreQuery.h"
 // LOW_CODEGEN:BEGIN:CUSTOM:SOURCE_CODE
 #include "LowCoreNavigation.h"
 // LOW_CODEGEN::END::CUSTOM:SOURCE_CODE
@@ -106,6 +107,7 @@ namespace Low {
                                    AreaType)) AreaType();
         ACCESSOR_TYPE_SOA(l_Handle, Source, include_children, bool) =
             false;
+        ACCESSOR_TYPE_SOA(l_Handle, Source, dynamic, bool) = false;
         ACCESSOR_TYPE_SOA(l_Handle, Source, tile_dirty, bool) = false;
         new (ACCESSOR_TYPE_SOA_PTR(l_Handle, Source, bounds,
                                    Low::Math::Bounds))
@@ -148,9 +150,13 @@ namespace Low {
 
         {
           // LOW_CODEGEN:BEGIN:CUSTOM:DESTROY
+          Low::Core::Navigation::forget_source(*this);
           // LOW_CODEGEN::END::CUSTOM:DESTROY
         }
 
+        Low::Core::Query::notify_component_removed(get_entity(),
+                                                   ms_TypeId);
+
         broadcast_observable(OBSERVABLE_DESTROY);
 
         Low::Util::remove_unique_id(get_unique_id());
@@ -221,6 +227,16 @@ namespace Low {
         l_TypeInfo.get_living_count = &Source::living_count;
         l_TypeInfo.component = true;
         l_TypeInfo.uiComponent = false;
+        l_TypeInfo.get_page =
+            [](u32 p_Index,
+               u32 &p_SlotIndex) -> Low::Util::Instances::Page * {
+          u32 l_PageIndex = 0;
+          if (!get_page_for_index(p_Index, l_PageIndex,
+                                  p_SlotIndex)) {
+            return nullptr;
+          }
+          return ms_Pages[l_PageIndex];
+        };
         {
           // Property: mode
           Low::Util::RTTI::PropertyInfo l_PropertyInfo;
@@ -369,6 +385,34 @@ namespace Low {
           l_TypeInfo.properties[l_PropertyInfo.name] = l_PropertyInfo;
           // End property: include_children
         }
+        {
+          // Property: dynamic
+          Low::Util::RTTI::PropertyInfo l_PropertyInfo;
+          l_PropertyInfo.name = N(dynamic);
+          l_PropertyInfo.editorProperty = true;
+          l_PropertyInfo.dataOffset = offsetof(Source::Data, dynamic);
+          l_PropertyInfo.type = Low::Util::RTTI::PropertyType::BOOL;
+          l_PropertyInfo.handleType = 0;
+          l_PropertyInfo.get_return =
+              [](Low::Util::Handle p_Handle) -> void const * {
+            Source l_Handle = p_Handle.get_id();
+            l_Handle.is_dynamic();
+            return (void *)&ACCESSOR_TYPE_SOA(p_Handle, Source,
+                                              dynamic, bool);
+          };
+          l_PropertyInfo.set = [](Low::Util::Handle p_Handle,
+                                  const void *p_Data) -> void {
+            Source l_Handle = p_Handle.get_id();
+            l_Handle.set_dynamic(*(bool *)p_Data);
+          };
+          l_PropertyInfo.get = [](Low::Util::Handle p_Handle,
+                                  void *p_Data) {
+            Source l_Handle = p_Handle.get_id();
+            *((bool *)p_Data) = l_Handle.is_dynamic();
+          };
+          l_TypeInfo.properties[l_PropertyInfo.name] = l_PropertyInfo;
+          // End property: dynamic
+        }
         {
           // Property: tile_dirty
           Low::Util::RTTI::PropertyInfo l_PropertyInfo;
@@ -606,6 +650,7 @@ namespace Low {
         l_Handle.set_area_type(get_area_type());
         l_Handle.set_agent_mask(get_agent_mask());
         l_Handle.set_include_children(is_include_children());
+        l_Handle.set_dynamic(is_dynamic());
         l_Handle.set_tile_dirty(is_tile_dirty());
 
         // LOW_CODEGEN:BEGIN:CUSTOM:DUPLICATE
@@ -644,6 +689,7 @@ namespace Low {
             static_cast<uint8_t>(get_area_type()));
         p_Node["agent_mask"] = get_agent_mask();
         p_Node["include_children"] = is_include_children();
+        p_Node["dynamic"] = is_dynamic();
         p_Node["_unique_id"] = Low::Util::U64Id{get_unique_id()};
 
         // LOW_CODEGEN:BEGIN:CUSTOM:SERIALIZER
@@ -694,6 +740,9 @@ namespace Low {
           l_Handle.set_include_children(
               p_Node["include_children"].as<bool>());
         }
+        if (p_Node["dynamic"]) {
+          l_Handle.set_dynamic(p_Node["dynamic"].as<bool>());
+        }
         if (p_Node["unique_id"]) {
           l_Handle.set_unique_id(
               p_Node["unique_id"].as<Low::Util::UniqueId>());
@@ -998,6 +1047,61 @@ namespace Low {
         }
       }
 
+      bool Source::is_dynamic() const
+      {
+        _LOW_ASSERT(is_alive());
+
+        // LOW_CODEGEN:BEGIN:CUSTOM:GETTER_dynamic
+        // LOW_CODEGEN::END::CUSTOM:GETTER_dynamic
+
+        return TYPE_SOA(Source, dynamic, bool);
+      }
+      void Source::toggle_dynamic()
+      {
+        set_dynamic(!is_dynamic());
+      }
+
+      void Source::set_dynamic(bool p_Value)
+      {
+        _LOW_ASSERT(is_alive());
+
+        // LOW_CODEGEN:BEGIN:CUSTOM:PRESETTER_dynamic
+        // LOW_CODEGEN::END::CUSTOM:PRESETTER_dynamic
+
+        if (is_dynamic() != p_Value) {
+          // Set dirty flags
+          mark_dirty();
+
+          // Set new value
+          TYPE_SOA(Source, dynamic, bool) = p_Value;
+          {
+            Low::Core::Entity l_Entity = get_entity();
+            if (l_Entity.has_component(
+                    Low::Core::Component::PrefabInstance::
+                        type_id())) {
+              Low::Core::Component::PrefabInstance l_Instance =
+                  l_Entity.get_component(
+                      Low::Core::Component::PrefabInstance::
+                          type_id());
+              Low::Core::Prefab l_Prefab = l_Instance.get_prefab();
+              if (l_Prefab.is_alive()) {
+                l_Instance.override(ms_TypeId, N(dynamic),
+                                    !l_Prefab.compare_property(
+                                        *this, N(dynamic)));
+              }
+            }
+          }
+
+          // LOW_CODEGEN:BEGIN:CUSTOM:SETTER_dynamic
+          // Baked tiles only react to dynamic sources, the dirty
+          // flag above still saw the old value
+          mark_dirty();
+          // LOW_CODEGEN::END::CUSTOM:SETTER_dynamic
+
+          broadcast_observable(N(dynamic));
+        }
+      }
+
       bool Source::is_tile_dirty() const
       {
         _LOW_ASSERT(is_alive());
@@ -13,6 +13,10 @@
 
 // LOW_CODEGEN:BEGIN:CUSTOM:SOURCE_CODE
 #include "LowCoreNavigationBackend.h"
+
+#include "LowUtilJobManager.h"
+
+#include <chrono>
 // LOW_CODEGEN::END::CUSTOM:SOURCE_CODE
 
 namespace Low {
@@ -176,14 +180,15 @@ namespace Low {
             p_Coord);
       }
 
-      bool queue_tile(World p_World, TileCoord p_Coord)
+      bool queue_tile(World p_World, TileCoord p_Coord,
+                      float p_Priority)
       {
         LOW_ASSERT(p_World.is_alive(),
                    "Cannot queue tile on dead navigation world");
 
         return Navigation::queue_tile(
             static_cast<WorldBackend *>(p_World.get_world_ptr()),
-            p_Coord);
+            p_Coord, p_Priority);
       }
 
       uint32_t get_queued_tile_count(World p_World)
@@ -207,16 +212,44 @@ namespace Low {
       }
 
       uint32_t update_tile_builds(World p_World,
-                                  uint32_t p_MaxTilesToBuild)
+                                  uint32_t p_MaxTilesToStart,
+                                  float p_BudgetMs,
+                                  uint32_t p_MaxRunningBuilds)
       {
         LOW_ASSERT(
             p_World.is_alive(),
             "Cannot update tile builds on dead navigation world");
 
-        uint32_t l_BuiltTileCount = 0u;
+        LOW_PROFILE_CPU("Navigation", "Update tile builds");
+
+        const auto l_Start = std::chrono::steady_clock::now();
+        auto budget_left = [&]() {
+          return p_BudgetMs <= 0.0f ||
+                 std::chrono::duration<float, std::milli>(
+                     std::chrono::steady_clock::now() - l_Start)
+                         .count() < p_BudgetMs;
+        };
+
         WorldBackend *l_Backend =
             static_cast<WorldBackend *>(p_World.get_world_ptr());
-        while (l_BuiltTileCount < p_MaxTilesToBuild) {
+
+        // Finished tiles are added first so their workers are free
+        // for the builds started below
+        const uint32_t l_FinishedCount =
+            finish_navmesh_tile_builds(l_Backend, p_BudgetMs);
+
+        const uint32_t l_MaxRunningBuilds =
+            p_MaxRunningBuilds > 0u
+                ? p_MaxRunningBuilds
+                : std::max(Low::Util::JobManager::Parallel::
+                               get_worker_count(),
+                           1u);
+
+        uint32_t l_StartedCount = 0u;
+        while (l_StartedCount < p_MaxTilesToStart &&
+               get_running_tile_build_count(l_Backend) <
+                   l_MaxRunningBuilds &&
+               budget_left()) {
           TileCoord i_Coord;
           if (!Navigation::pop_next_queued_tile(l_Backend,
                                                 &i_Coord)) {
@@ -230,11 +263,30 @@ namespace Low {
             continue;
           }
 
-          build_tile(p_World, i_Coord);
-          ++l_BuiltTileCount;
+          start_tile_build(p_World, i_Coord);
+          ++l_StartedCount;
+        }
+
+        return l_FinishedCount;
+      }
+
+      bool start_tile_build(World p_World, TileCoord p_Coord)
+      {
+        LOW_ASSERT(p_World.is_alive(),
+                   "Cannot build tile on dead navigation world");
+
+        // Sources are read on the main thread, the workers only get
+        // to see the snapshot
+        BuildGeometry l_Geometry;
+        if (!collect_tile_build_geometry(p_World, p_Coord,
+                                         &l_Geometry)) {
+          set_tile_state(p_World, p_Coord, TileState::Failed);
+          return false;
         }
 
-        return l_BuiltTileCount;
+        return start_navmesh_tile_build(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Coord, std::move(l_Geometry));
       }
 
       bool build_tile_from_geometry(World p_World, TileCoord p_Coord,
@@ -247,6 +299,352 @@ namespace Low {
             static_cast<WorldBackend *>(p_World.get_world_ptr()),
             p_Coord, p_Geometry);
       }
+
+      uint32_t add_obstacle(World p_World,
+                            const Obstacle &p_Obstacle)
+      {
+        LOW_ASSERT(p_World.is_alive(),
+                   "Cannot add obstacle to dead navigation world");
+
+        return Navigation::add_obstacle(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Obstacle);
+      }
+
+      bool remove_obstacle(World p_World, uint32_t p_Obstacle)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot remove obstacle from dead navigation world");
+
+        return Navigation::remove_obstacle(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Obstacle);
+      }
+
+      uint32_t get_obstacle_count(World p_World)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot count obstacles of dead navigation world");
+
+        return Navigation::get_obstacle_count(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()));
+      }
+
+      bool update_obstacles(World p_World)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot update obstacles of dead navigation world");
+
+        return Navigation::update_obstacles(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()));
+      }
+
+      void save_tile_layers(World p_World,
+                            Low::Util::List<uint8_t> &p_Data)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot save tile layers of dead navigation world");
+
+        Navigation::save_tile_layers(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Data);
+      }
+
+      bool load_tile_layers(World p_World,
+                            const Low::Util::List<uint8_t> &p_Data)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot load tile layers into dead navigation world");
+
+        return Navigation::load_tile_layers(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Data);
+      }
+
+      void save_baked_tiles(
+          World p_World,
+          const Low::Util::UnorderedMap<
+              uint64_t, Low::Util::List<uint64_t>> &p_TileOwners,
+          Low::Util::List<uint8_t> &p_Data)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot save baked tiles of dead navigation world");
+
+        Navigation::save_baked_tiles(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_TileOwners, p_Data);
+      }
+
+      bool set_baked_tiles(World p_World,
+                           const Low::Util::List<uint8_t> &p_Data)
+      {
+        LOW_ASSERT(p_World.is_alive(),
+                   "Cannot set baked tiles of dead navigation world");
+
+        return Navigation::set_baked_tiles(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Data);
+      }
+
+      void clear_baked_tiles(World p_World)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot clear baked tiles of dead navigation world");
+
+        Navigation::clear_baked_tiles(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()));
+      }
+
+      bool is_baked_tile(World p_World, TileCoord p_Coord)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot check baked tile of dead navigation world");
+
+        return Navigation::is_baked_tile(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Coord);
+      }
+
+      uint32_t get_baked_tile_count(World p_World)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot count baked tiles of dead navigation world");
+
+        return Navigation::get_baked_tile_count(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()));
+      }
+
+      uint32_t stream_in_baked_tiles(World p_World, uint64_t p_Owner)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot stream in baked tiles of dead navigation world");
+
+        return Navigation::stream_in_baked_tiles(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Owner);
+      }
+
+      uint32_t stream_out_baked_tiles(World p_World,
+                                      uint64_t p_Owner)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot stream out baked tiles of dead navigation world");
+
+        return Navigation::stream_out_baked_tiles(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Owner);
+      }
+
+      uint32_t request_path(World p_World,
+                            const Math::Vector3 &p_Start,
+                            const Math::Vector3 &p_End,
+                            const Math::Vector3 &p_HalfExtents)
+      {
+        LOW_ASSERT(p_World.is_alive(),
+                   "Cannot request path in dead navigation world");
+
+        return Navigation::request_path(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Start, p_End, p_HalfExtents);
+      }
+
+      PathRequestStatus poll_path_request(World p_World,
+                                          uint32_t p_Request,
+                                          PathResult *p_Result)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot poll path request in dead navigation world");
+
+        return Navigation::poll_path_request(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Request, p_Result);
+      }
+
+      bool cancel_path_request(World p_World, uint32_t p_Request)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot cancel path request in dead navigation world");
+
+        return Navigation::cancel_path_request(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Request);
+      }
+
+      uint32_t get_pending_path_request_count(World p_World)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot count path requests in dead navigation world");
+
+        return Navigation::get_pending_path_request_count(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()));
+      }
+
+      uint32_t update_path_requests(World p_World,
+                                    uint32_t p_MaxIterations)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot update path requests in dead navigation world");
+
+        return Navigation::update_path_requests(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_MaxIterations);
+      }
+
+      uint32_t
+      find_path_batch(World p_World,
+                      const Low::Util::List<PathQuery> &p_Queries,
+                      Low::Util::List<PathResult> &p_Results)
+      {
+        LOW_ASSERT(p_World.is_alive(),
+                   "Cannot find paths in dead navigation world");
+
+        return Navigation::find_path_batch(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Queries, p_Results);
+      }
+
+      uint32_t
+      raycast_batch(World p_World,
+                    const Low::Util::List<RaycastQuery> &p_Queries,
+                    Low::Util::List<RaycastResult> &p_Results)
+      {
+        LOW_ASSERT(p_World.is_alive(),
+                   "Cannot raycast in dead navigation world");
+
+        return Navigation::raycast_batch(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Queries, p_Results);
+      }
+
+      int add_crowd_agent(World p_World,
+                          const Math::Vector3 &p_Position,
+                          const CrowdAgentParams &p_Params)
+      {
+        LOW_ASSERT(p_World.is_alive(),
+                   "Cannot add crowd agent to dead navigation world");
+
+        return Navigation::add_crowd_agent(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Position, p_Params);
+      }
+
+      bool remove_crowd_agent(World p_World, int p_Agent)
+      {
+        if (!p_World.is_alive()) {
+          return false;
+        }
+
+        return Navigation::remove_crowd_agent(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Agent);
+      }
+
+      bool set_crowd_agent_params(World p_World, int p_Agent,
+                                  const CrowdAgentParams &p_Params)
+      {
+        LOW_ASSERT(p_World.is_alive(),
+                   "Cannot set crowd agent parameters in dead "
+                   "navigation world");
+
+        return Navigation::set_crowd_agent_params(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Agent, p_Params);
+      }
+
+      bool set_crowd_agent_target(World p_World, int p_Agent,
+                                  const Math::Vector3 &p_Target)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot set crowd agent target in dead navigation world");
+
+        return Navigation::set_crowd_agent_target(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Agent, p_Target);
+      }
+
+      bool clear_crowd_agent_target(World p_World, int p_Agent)
+      {
+        LOW_ASSERT(p_World.is_alive(),
+                   "Cannot clear crowd agent target in dead "
+                   "navigation world");
+
+        return Navigation::clear_crowd_agent_target(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Agent);
+      }
+
+      bool set_crowd_agent_position(World p_World, int p_Agent,
+                                    const Math::Vector3 &p_Position)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot move crowd agent in dead navigation world");
+
+        return Navigation::set_crowd_agent_position(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Agent, p_Position);
+      }
+
+      bool set_crowd_agent_lod(World p_World, int p_Agent,
+                               CrowdAgentLod p_Lod)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot set crowd agent lod in dead navigation world");
+
+        return Navigation::set_crowd_agent_lod(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Agent, p_Lod);
+      }
+
+      bool get_crowd_agent_state(World p_World, int p_Agent,
+                                 CrowdAgentState *p_State)
+      {
+        if (!p_World.is_alive()) {
+          return false;
+        }
+
+        return Navigation::get_crowd_agent_state(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Agent, p_State);
+      }
+
+      uint32_t get_crowd_agent_count(World p_World)
+      {
+        LOW_ASSERT(
+            p_World.is_alive(),
+            "Cannot count crowd agents in dead navigation world");
+
+        return Navigation::get_crowd_agent_count(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()));
+      }
+
+      uint32_t update_crowd(World p_World, float p_Delta,
+                            uint32_t p_MaxTargetRequests)
+      {
+        LOW_ASSERT(p_World.is_alive(),
+                   "Cannot update crowd in dead navigation world");
+
+        return Navigation::update_crowd(
+            static_cast<WorldBackend *>(p_World.get_world_ptr()),
+            p_Delta, p_MaxTargetRequests);
+      }
       // LOW_CODEGEN::END::CUSTOM:NAMESPACE_CODE
 
       u16 World::ms_TypeId = 0;
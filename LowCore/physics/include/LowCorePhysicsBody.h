@@ -189,6 +189,33 @@ namespace Low {
         void set_shape(Shape p_Value);
 
         // LOW_CODEGEN:BEGIN:CUSTOM:STRUCT_END_CODE
+      public:
+        // Disabled bodies stay alive but are removed from the
+        // simulation until they get enabled again
+        void set_enabled(bool p_Enabled);
+
+        // Transform blended between the last two fixed physics steps,
+        // meant for presenting the body
+        void get_interpolated_transform(Math::Vector3 &p_Position,
+                                        Math::Quaternion &p_Rotation);
+
+        // Moves the body to another collision layer of its world
+        void set_layer(u32 p_Layer);
+        u32 get_layer();
+
+        // Sensors do not collide but report trigger events instead
+        void set_sensor(bool p_Sensor);
+        // Opts the body into the contact events of its world
+        void set_contact_events(bool p_Enabled);
+
+        // Bodies that moved during the last simulate call of the
+        // world, including the ones that just fell asleep
+        static void get_active(World p_World,
+                               Low::Util::List<Body> &p_Bodies);
+        // Puts the bodies to sleep or wakes them up in bulk. Frozen
+        // bodies still wake up when something active touches them.
+        static void set_frozen(const Low::Util::List<Body> &p_Bodies,
+                               bool p_Frozen);
         // LOW_CODEGEN::END::CUSTOM:STRUCT_END_CODE
       };
 
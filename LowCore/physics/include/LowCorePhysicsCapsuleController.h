@@ -178,6 +178,19 @@ namespace Low {
         void set_world(World p_Value);
 
         // LOW_CODEGEN:BEGIN:CUSTOM:STRUCT_END_CODE
+      public:
+        // Microseconds the last update of this controller took
+        float get_update_cost();
+
+        // move only collects the move. It gets applied together with
+        // the moves of all other controllers in the late tick of the
+        // physics system, so position and is_grounded lag behind by
+        // one frame. move_immediate applies it on the calling thread
+        // right away, which is meant for the controller of the
+        // player. It must not be called while the world updates its
+        // controllers.
+        void move_immediate(Low::Math::Vector3 p_Delta,
+                            float p_DeltaTime);
         // LOW_CODEGEN::END::CUSTOM:STRUCT_END_CODE
       };
 
@@ -12,6 +12,7 @@
 
 // LOW_CODEGEN:BEGIN:CUSTOM:HEADER_CODE
 #include "LowRendererRenderView.h"
+#include "LowUtilResource.h"
 // LOW_CODEGEN::END::CUSTOM:HEADER_CODE
 
 namespace Low {
@@ -22,7 +23,9 @@ namespace Low {
       {
         Sphere,
         Box,
-        ConvexHull
+        ConvexHull,
+        Mesh,
+        HeightField
       };
       // LOW_CODEGEN::END::CUSTOM:NAMESPACE_CODE
 
@@ -185,6 +188,40 @@ namespace Low {
         void set_type(ShapeType p_Value);
 
         // LOW_CODEGEN:BEGIN:CUSTOM:STRUCT_END_CODE
+      public:
+        // Triangle mesh shapes can only be used by static and
+        // kinematic bodies. Every three indices form one triangle.
+        static Shape
+        make_mesh(World p_World,
+                  const Util::List<Math::Vector3> &p_Vertices,
+                  const Util::List<u32> &p_Indices);
+        // Collects the triangles of all submeshes with their node
+        // transforms applied
+        static Shape make_mesh(World p_World,
+                               const Util::Resource::Mesh &p_Mesh,
+                               const Math::Vector3 &p_Scale);
+        // p_Samples holds p_SampleCount * p_SampleCount heights, see
+        // create_height_field_shape for the layout
+        static Shape
+        make_height_field(World p_World,
+                          const Util::List<float> &p_Samples,
+                          u32 p_SampleCount,
+                          const Math::Vector3 &p_Offset,
+                          const Math::Vector3 &p_Scale);
+
+        // Cooked data stores the built shape so it can be restored
+        // without building its acceleration structures again
+        bool cook(Util::List<u8> &p_Data) const;
+        static Shape make_cooked(World p_World,
+                                 const Util::List<u8> &p_Data);
+        bool save_cooked(const Util::String &p_Path) const;
+        static Shape load_cooked(World p_World,
+                                 const Util::String &p_Path);
+
+      private:
+        static Shape make_from_backend(World p_World,
+                                       uint64_t p_BackendId,
+                                       ShapeType p_Type);
         // LOW_CODEGEN::END::CUSTOM:STRUCT_END_CODE
       };
 
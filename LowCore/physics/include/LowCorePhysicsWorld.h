@@ -148,7 +148,7 @@ namespace Low {
         void simulate(float p_Delta);
         bool raycast(Low::Math::Vector3 p_Origin,
                      Low::Math::Vector3 p_Direction,
-                     float p_MaxDistance,
+                     float p_MaxDistance, uint32_t p_LayerMask,
                      Low::Core::Physics::QueryHit *p_Hit);
         bool sphere_cast(Low::Math::Vector3 p_Origin, float p_Radius,
                          Low::Math::Vector3 p_Direction,
@@ -161,11 +161,12 @@ namespace Low {
                       float p_MaxDistance,
                       Low::Core::Physics::QueryHit *p_Hit);
         bool overlap_sphere(Low::Math::Vector3 p_Position,
-                            float p_Radius,
+                            float p_Radius, uint32_t p_LayerMask,
                             Low::Core::Physics::QueryHit *p_Hit);
         bool overlap_box(Low::Math::Vector3 p_Position,
                          Low::Math::Vector3 p_HalfExtents,
                          Low::Math::Quaternion p_Rotation,
+                         uint32_t p_LayerMask,
                          Low::Core::Physics::QueryHit *p_Hit);
         Low::Math::Vector3 get_gravity();
         void set_gravity(Low::Math::Vector3 p_Value);
@@ -182,6 +183,71 @@ namespace Low {
         void set_world_ptr(void *p_Value);
 
         // LOW_CODEGEN:BEGIN:CUSTOM:STRUCT_END_CODE
+      public:
+        // Bodies that get created while a batch is open are added to
+        // the simulation together when the outermost batch ends
+        void begin_body_batch();
+        void end_body_batch();
+
+        // The world is simulated in steps of p_FixedDelta seconds.
+        // At most p_MaxSteps get taken per frame.
+        void set_step_settings(float p_FixedDelta,
+                               u32 p_CollisionSteps = 1u,
+                               u32 p_MaxSteps = 4u);
+
+        // Events of the last simulate call. Only bodies that enabled
+        // contact events or are sensors show up here.
+        const Low::Util::List<ContactEvent> &get_contact_events();
+        const Low::Util::List<TriggerEvent> &get_trigger_events();
+
+        // Runs all requests on the job workers. The hits of request i
+        // are p_Hits[p_Results[i].first_hit] onwards. Closest mode
+        // reports at most one hit per request.
+        void raycast_batch(
+            const Low::Util::List<RaycastRequest> &p_Requests,
+            QueryMode p_Mode, u32 p_MaxHits,
+            Low::Util::List<QueryResult> &p_Results,
+            Low::Util::List<QueryHit> &p_Hits);
+        void overlap_batch(
+            const Low::Util::List<OverlapRequest> &p_Requests,
+            QueryMode p_Mode, u32 p_MaxHits,
+            Low::Util::List<QueryResult> &p_Results,
+            Low::Util::List<QueryHit> &p_Hits);
+
+        // Deferred queries get resolved together at the end of the
+        // frame. The returned ticket can be used to fetch the hits
+        // until the next resolve.
+        u32 submit_raycast(const RaycastRequest &p_Request,
+                           QueryMode p_Mode = QueryMode::Closest);
+        u32 submit_overlap(const OverlapRequest &p_Request,
+                           QueryMode p_Mode = QueryMode::Closest);
+        void resolve_deferred_queries();
+        bool get_query_hits(u32 p_Ticket,
+                            Low::Util::List<QueryHit> &p_Hits);
+
+        // Applies the moves of all capsule controllers in parallel
+        void update_capsule_controllers();
+        // The physics system sets the focus of these settings to its
+        // level of detail focus every frame
+        void set_character_update_settings(
+            const CharacterUpdateSettings &p_Settings);
+        const CharacterUpdateSettings &
+        get_character_update_settings();
+
+        // Snapshots of the simulation state. A snapshot of only the
+        // active bodies has to be restored on top of a full one.
+        bool save_state(Low::Util::List<u8> &p_Data,
+                        bool p_ActiveBodiesOnly = false);
+        bool restore_state(const Low::Util::List<u8> &p_Data);
+        u64 get_state_hash();
+
+        void set_deterministic(bool p_Deterministic);
+        // Recording makes the world deterministic until it gets
+        // changed back by hand
+        void begin_recording();
+        void end_recording(Recording &p_Recording);
+        bool replay(const Recording &p_Recording,
+                    ReplayResult &p_Result);
         // LOW_CODEGEN::END::CUSTOM:STRUCT_END_CODE
       };
 
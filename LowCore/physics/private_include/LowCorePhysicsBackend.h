@@ -56,6 +56,9 @@ namespace Low {
         BodyMotionType motion_type = BodyMotionType::STATIC;
         float mass = 1.0f;
         bool gravity = true;
+        // Sensors do not collide but report trigger events
+        bool sensor = false;
+        bool contact_events = false;
         void *user_data = nullptr;
       };
 
@@ -82,14 +85,46 @@ namespace Low {
         void *user_data = nullptr;
       };
 
-      WorldBackend *create_world_backend();
+      WorldBackend *create_world_backend(
+          const CollisionLayerSettings &p_CollisionLayers);
       void destroy_world_backend(WorldBackend *p_World);
 
+      // Advances the world in fixed steps and keeps the remainder
+      // of the delta for the next call
       void simulate_world(WorldBackend *p_World, float p_Delta);
+      void set_world_step_settings(WorldBackend *p_World,
+                                   float p_FixedDelta,
+                                   uint32_t p_CollisionSteps,
+                                   uint32_t p_MaxSteps);
       void set_world_gravity(WorldBackend *p_World,
                              const Math::Vector3 &p_Gravity);
       Math::Vector3 get_world_gravity(WorldBackend *p_World);
 
+      // Full states contain everything needed to continue the
+      // simulation. A state with only the active bodies is a delta
+      // that has to be restored on top of a full state. Restoring
+      // fails if bodies were added or removed since saving.
+      bool save_world_state(WorldBackend *p_World,
+                            Low::Util::List<uint8_t> &p_Data,
+                            bool p_ActiveBodiesOnly);
+      bool
+      restore_world_state(WorldBackend *p_World,
+                          const Low::Util::List<uint8_t> &p_Data);
+      uint64_t hash_world_state(WorldBackend *p_World);
+      // Deterministic worlds process contacts and character
+      // controllers in a fixed order
+      void set_world_deterministic(WorldBackend *p_World,
+                                   bool p_Deterministic);
+      void begin_world_recording(WorldBackend *p_World);
+      void end_world_recording(WorldBackend *p_World,
+                               Recording &p_Recording);
+      // Resimulates the recording and compares the state hash after
+      // every step. The world is put back into its current state
+      // afterwards.
+      bool replay_world_recording(WorldBackend *p_World,
+                                  const Recording &p_Recording,
+                                  ReplayResult &p_Result);
+
       ShapeBackendHandle
       create_shape(WorldBackend *p_World,
                    const ShapeCreateInfo &p_CreateInfo);
@@ -100,6 +135,27 @@ namespace Low {
       ShapeBackendHandle
       create_convex_hull_shape(WorldBackend *p_World,
                                const Low::Util::List<Math::Vector3> &p_Points);
+      // Triangle meshes only collide as static or kinematic bodies.
+      // p_Indices holds three indices per triangle.
+      ShapeBackendHandle create_mesh_shape(
+          WorldBackend *p_World, const Math::Vector3 *p_Vertices,
+          uint32_t p_VertexCount, const uint32_t *p_Indices,
+          uint32_t p_IndexCount);
+      // p_Samples holds p_SampleCount * p_SampleCount heights in row
+      // major order. Sample (x, y) ends up at
+      // p_Offset + p_Scale * (x, height, y) in local space.
+      ShapeBackendHandle create_height_field_shape(
+          WorldBackend *p_World, const float *p_Samples,
+          uint32_t p_SampleCount, const Math::Vector3 &p_Offset,
+          const Math::Vector3 &p_Scale);
+      // Cooked shapes contain the fully built Jolt shape including
+      // acceleration structures, restoring them skips the build step
+      bool cook_shape(WorldBackend *p_World,
+                      ShapeBackendHandle p_Shape,
+                      Low::Util::List<uint8_t> &p_Data);
+      ShapeBackendHandle create_cooked_shape(WorldBackend *p_World,
+                                             const uint8_t *p_Data,
+                                             uint32_t p_Size);
       void visualize_convex_hull(
           WorldBackend *p_World, ShapeBackendHandle p_Shape,
           Renderer::RenderView p_RenderView,
@@ -113,11 +169,54 @@ namespace Low {
       BodyBackendHandle create_body(WorldBackend *p_World,
                                     const BodyCreateInfo &p_CreateInfo);
       void destroy_body(WorldBackend *p_World, BodyBackendHandle p_Body);
+      void set_body_enabled(WorldBackend *p_World,
+                            BodyBackendHandle p_Body, bool p_Enabled);
+      // Handles of the bodies that moved during the last simulate
+      // call. Bodies that fell asleep during it are part of the list
+      // once more so their final pose can be presented.
+      void
+      get_active_bodies(WorldBackend *p_World,
+                        Low::Util::List<Low::Util::Handle> &p_Bodies);
+      // Frozen bodies are put to sleep in bulk. Like any sleeping
+      // body they wake up again when something active touches them.
+      void set_bodies_frozen(WorldBackend *p_World,
+                             const BodyBackendHandle *p_Bodies,
+                             uint32_t p_Count, bool p_Frozen);
+      // Layers index into the collision layer settings the world was
+      // created with
+      void set_body_layer(WorldBackend *p_World,
+                          BodyBackendHandle p_Body, uint32_t p_Layer);
+      uint32_t get_body_layer(WorldBackend *p_World,
+                              BodyBackendHandle p_Body);
+      void set_body_sensor(WorldBackend *p_World,
+                           BodyBackendHandle p_Body, bool p_Sensor);
+      // Only pairs where at least one body opted in (or is a sensor)
+      // end up in the event lists
+      void set_body_contact_events(WorldBackend *p_World,
+                                   BodyBackendHandle p_Body,
+                                   bool p_Enabled);
+
+      // Events recorded during the last call to simulate_world. The
+      // lists stay valid until the world gets simulated again.
+      const Low::Util::List<ContactEvent> &
+      get_contact_events(WorldBackend *p_World);
+      const Low::Util::List<TriggerEvent> &
+      get_trigger_events(WorldBackend *p_World);
+
+      // Bodies created between begin and end are added to the world
+      // in one go when the outermost batch ends
+      void begin_body_batch(WorldBackend *p_World);
+      void end_body_batch(WorldBackend *p_World);
 
       void set_body_transform(WorldBackend *p_World,
                               BodyBackendHandle p_Body,
                               const Math::Vector3 &p_Position,
                               const Math::Quaternion &p_Rotation);
+      // Blends between the last two fixed steps by the time that
+      // has not been simulated yet
+      void get_body_interpolated_transform(
+          WorldBackend *p_World, BodyBackendHandle p_Body,
+          Math::Vector3 &p_Position, Math::Quaternion &p_Rotation);
       Math::Vector3 get_body_position(WorldBackend *p_World,
                                       BodyBackendHandle p_Body);
       Math::Quaternion get_body_rotation(WorldBackend *p_World,
@@ -136,7 +235,8 @@ namespace Low {
       bool raycast_world(WorldBackend *p_World,
                          const Math::Vector3 &p_Origin,
                          const Math::Vector3 &p_Direction,
-                         float p_MaxDistance, BackendQueryHit &p_Hit);
+                         float p_MaxDistance, uint32_t p_LayerMask,
+                         BackendQueryHit &p_Hit);
       bool sphere_cast_world(WorldBackend *p_World,
                              const Math::Vector3 &p_Origin,
                              float p_Radius,
@@ -152,24 +252,72 @@ namespace Low {
                           BackendQueryHit &p_Hit);
       bool overlap_sphere_world(WorldBackend *p_World,
                                 const Math::Vector3 &p_Position,
-                                float p_Radius,
+                                float p_Radius, uint32_t p_LayerMask,
                                 BackendQueryHit *p_Hit = nullptr);
       bool overlap_box_world(WorldBackend *p_World,
                              const Math::Vector3 &p_Position,
                              const Math::Vector3 &p_HalfExtents,
                              const Math::Quaternion &p_Rotation,
+                             uint32_t p_LayerMask,
                              BackendQueryHit *p_Hit = nullptr);
 
+      // Batched queries run across the parallel workers. The results
+      // and hits of the batch get appended to the lists.
+      void raycast_world_batch(
+          WorldBackend *p_World, const RaycastRequest *p_Requests,
+          uint32_t p_Count, QueryMode p_Mode, uint32_t p_MaxHits,
+          Low::Util::List<QueryResult> &p_Results,
+          Low::Util::List<BackendQueryHit> &p_Hits);
+      void overlap_world_batch(
+          WorldBackend *p_World, const OverlapRequest *p_Requests,
+          uint32_t p_Count, QueryMode p_Mode, uint32_t p_MaxHits,
+          Low::Util::List<QueryResult> &p_Results,
+          Low::Util::List<BackendQueryHit> &p_Hits);
+
+      // Deferred queries wait until resolve_deferred_queries runs
+      // them all in one parallel pass. Their results stay available
+      // until the next pass.
+      uint32_t submit_deferred_raycast(
+          WorldBackend *p_World, const RaycastRequest &p_Request,
+          QueryMode p_Mode);
+      uint32_t submit_deferred_overlap(
+          WorldBackend *p_World, const OverlapRequest &p_Request,
+          QueryMode p_Mode);
+      void resolve_deferred_queries(WorldBackend *p_World);
+      bool get_deferred_query_result(WorldBackend *p_World,
+                                     uint32_t p_Ticket,
+                                     QueryResult &p_Result);
+      const Low::Util::List<BackendQueryHit> &
+      get_deferred_query_hits(WorldBackend *p_World);
+
       CapsuleControllerBackendHandle create_capsule_controller(
           WorldBackend *p_World,
           const CapsuleControllerCreateInfo &p_CreateInfo);
       void destroy_capsule_controller(
           WorldBackend *p_World,
           CapsuleControllerBackendHandle p_Controller);
+      // Moves are applied by the next update_capsule_controllers
+      // call, moves with a delta time of zero teleport right away
       void move_capsule_controller(
           WorldBackend *p_World,
           CapsuleControllerBackendHandle p_Controller,
           const Math::Vector3 &p_Delta, float p_DeltaTime);
+      // Applies the pending moves of one controller right away on
+      // the calling thread
+      void flush_capsule_controller(
+          WorldBackend *p_World,
+          CapsuleControllerBackendHandle p_Controller);
+      // Updates all controllers that got moved on the job workers
+      void update_capsule_controllers(WorldBackend *p_World);
+      void set_character_update_settings(
+          WorldBackend *p_World,
+          const CharacterUpdateSettings &p_Settings);
+      const CharacterUpdateSettings &
+      get_character_update_settings(WorldBackend *p_World);
+      // Time the last update of the controller took in microseconds
+      float get_capsule_controller_update_cost(
+          WorldBackend *p_World,
+          CapsuleControllerBackendHandle p_Controller);
       bool is_capsule_controller_grounded(
           WorldBackend *p_World,
           CapsuleControllerBackendHandle p_Controller);
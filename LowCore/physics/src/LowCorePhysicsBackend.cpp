@@ -1,19 +1,29 @@
 #include "LowCorePhysicsBackend.h"
 
 #include "LowCoreDebugGeometry.h"
+#include "LowMathVectorUtil.h"
 #include "LowUtilAssert.h"
+#include "LowUtilHashing.h"
+#include "LowUtilJobManager.h"
+#include "LowUtilLogger.h"
+#include "LowUtilProfiler.h"
 
 #include <Jolt/Jolt.h>
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
-#include <Jolt/Core/JobSystemThreadPool.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/StreamWrapper.h>
 #include <Jolt/Core/TempAllocator.h>
+#include <Jolt/Physics/Body/BodyActivationListener.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/Body/BodyLock.h>
 #include <Jolt/Physics/Character/CharacterVirtual.h>
 #include <Jolt/Physics/Collision/CastResult.h>
 #include <Jolt/Physics/Collision/CollideShape.h>
 #include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Collision/CollisionDispatch.h>
+#include <Jolt/Physics/Collision/ContactListener.h>
 #include <Jolt/Physics/Collision/NarrowPhaseQuery.h>
 #include <Jolt/Physics/Collision/RayCast.h>
 #include <Jolt/Physics/Collision/ShapeCast.h>
@@ -21,114 +31,412 @@
 #include <Jolt/Physics/Collision/Shape/CapsuleShape.h>
 #include <Jolt/Physics/Collision/Shape/ConvexHullShape.h>
 #include <Jolt/Physics/Collision/Shape/CylinderShape.h>
+#include <Jolt/Physics/Collision/Shape/HeightFieldShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
 #include <Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h>
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
 #include <Jolt/Physics/PhysicsSystem.h>
+#include <Jolt/Physics/StateRecorderImpl.h>
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <mutex>
+#include <sstream>
 #include <thread>
+#include <tuple>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 JPH_SUPPRESS_WARNINGS
 
 namespace {
   namespace Layers {
+    // Default layers for bodies by motion type, see
+    // CollisionLayerSettings
     static constexpr JPH::ObjectLayer NON_MOVING = 0;
     static constexpr JPH::ObjectLayer MOVING = 1;
-    static constexpr JPH::ObjectLayer NUM_LAYERS = 2;
   } // namespace Layers
 
-  namespace BroadPhaseLayers {
-    static constexpr JPH::BroadPhaseLayer NON_MOVING(0);
-    static constexpr JPH::BroadPhaseLayer MOVING(1);
-    static constexpr JPH::uint NUM_LAYERS = 2;
-  } // namespace BroadPhaseLayers
+  using Low::Core::Physics::BroadPhaseGroup;
+  using Low::Core::Physics::COLLISION_LAYER_COUNT;
+
+  static constexpr JPH::uint g_BroadPhaseGroupCount =
+      static_cast<JPH::uint>(BroadPhaseGroup::Count);
+
+  // Lookup tables built from the collision layer settings of the
+  // project. The Jolt filters below only read from them.
+  struct CollisionLayerTable
+  {
+    uint32_t layer_count = 0u;
+    // Bit n set means the layer collides with layer n
+    uint32_t collision_masks[COLLISION_LAYER_COUNT] = {};
+    // Bit n set means the layer collides with something in the broad
+    // phase group n
+    uint32_t group_masks[COLLISION_LAYER_COUNT] = {};
+    JPH::BroadPhaseLayer groups[COLLISION_LAYER_COUNT];
+
+    void build(
+        const Low::Core::Physics::CollisionLayerSettings &p_Settings)
+    {
+      LOW_ASSERT(p_Settings.layer_count >= 2u &&
+                     p_Settings.layer_count <= COLLISION_LAYER_COUNT,
+                 "Invalid collision layer count");
+
+      layer_count = p_Settings.layer_count;
+      for (uint32_t i = 0u; i < layer_count; ++i) {
+        groups[i] = JPH::BroadPhaseLayer(
+            static_cast<JPH::uint8>(p_Settings.layers[i].group));
+      }
+
+      // Both layers have to agree, that keeps the matrix symmetric
+      for (uint32_t i = 0u; i < layer_count; ++i) {
+        collision_masks[i] = 0u;
+        group_masks[i] = 0u;
+        for (uint32_t i_Other = 0u; i_Other < layer_count;
+             ++i_Other) {
+          if ((p_Settings.layers[i].collision_mask &
+               (1u << i_Other)) &&
+              (p_Settings.layers[i_Other].collision_mask &
+               (1u << i))) {
+            collision_masks[i] |= 1u << i_Other;
+            group_masks[i] |=
+                1u << static_cast<uint32_t>(
+                    p_Settings.layers[i_Other].group);
+          }
+        }
+      }
+    }
+
+    // Broad phase groups that contain at least one of the layers
+    uint32_t get_group_mask(uint32_t p_LayerMask) const
+    {
+      uint32_t l_GroupMask = 0u;
+      for (uint32_t i = 0u; i < layer_count; ++i) {
+        if (p_LayerMask & (1u << i)) {
+          l_GroupMask |= 1u << groups[i].GetValue();
+        }
+      }
+      return l_GroupMask;
+    }
+  };
 
   class ObjectLayerPairFilter final
       : public JPH::ObjectLayerPairFilter
   {
   public:
+    explicit ObjectLayerPairFilter(const CollisionLayerTable &p_Table)
+        : m_Table(p_Table)
+    {
+    }
+
     bool ShouldCollide(JPH::ObjectLayer p_Object1,
                        JPH::ObjectLayer p_Object2) const override
     {
-      if (p_Object1 == Layers::NON_MOVING) {
-        return p_Object2 == Layers::MOVING;
-      }
-      if (p_Object1 == Layers::MOVING) {
-        return true;
-      }
-      LOW_ASSERT(false, "Invalid Jolt object layer");
-      return false;
+      LOW_ASSERT(p_Object1 < m_Table.layer_count,
+                 "Invalid Jolt object layer");
+      return (m_Table.collision_masks[p_Object1] &
+              (1u << p_Object2)) != 0u;
     }
+
+  private:
+    const CollisionLayerTable &m_Table;
   };
 
   class BroadPhaseLayerInterface final
       : public JPH::BroadPhaseLayerInterface
   {
   public:
-    BroadPhaseLayerInterface()
+    explicit BroadPhaseLayerInterface(
+        const CollisionLayerTable &p_Table)
+        : m_Table(p_Table)
     {
-      m_ObjectToBroadPhase[Layers::NON_MOVING] =
-          BroadPhaseLayers::NON_MOVING;
-      m_ObjectToBroadPhase[Layers::MOVING] = BroadPhaseLayers::MOVING;
     }
 
     JPH::uint GetNumBroadPhaseLayers() const override
     {
-      return BroadPhaseLayers::NUM_LAYERS;
+      return g_BroadPhaseGroupCount;
     }
 
     JPH::BroadPhaseLayer
     GetBroadPhaseLayer(JPH::ObjectLayer p_Layer) const override
     {
-      LOW_ASSERT(p_Layer < Layers::NUM_LAYERS,
+      LOW_ASSERT(p_Layer < m_Table.layer_count,
                  "Invalid Jolt object layer");
-      return m_ObjectToBroadPhase[p_Layer];
+      return m_Table.groups[p_Layer];
     }
 
 #if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
     const char *GetBroadPhaseLayerName(
         JPH::BroadPhaseLayer p_Layer) const override
     {
-      if (p_Layer == BroadPhaseLayers::NON_MOVING) {
-        return "NON_MOVING";
-      }
-      if (p_Layer == BroadPhaseLayers::MOVING) {
-        return "MOVING";
+      switch (static_cast<BroadPhaseGroup>(p_Layer.GetValue())) {
+      case BroadPhaseGroup::Static:
+        return "STATIC";
+      case BroadPhaseGroup::Dynamic:
+        return "DYNAMIC";
+      case BroadPhaseGroup::Sensor:
+        return "SENSOR";
+      case BroadPhaseGroup::Debris:
+        return "DEBRIS";
+      default:
+        return "INVALID";
       }
-      return "INVALID";
     }
 #endif
 
   private:
-    JPH::BroadPhaseLayer m_ObjectToBroadPhase[Layers::NUM_LAYERS];
+    const CollisionLayerTable &m_Table;
   };
 
   class ObjectVsBroadPhaseLayerFilter final
       : public JPH::ObjectVsBroadPhaseLayerFilter
   {
   public:
+    explicit ObjectVsBroadPhaseLayerFilter(
+        const CollisionLayerTable &p_Table)
+        : m_Table(p_Table)
+    {
+    }
+
     bool ShouldCollide(JPH::ObjectLayer p_Layer1,
                        JPH::BroadPhaseLayer p_Layer2) const override
     {
-      if (p_Layer1 == Layers::NON_MOVING) {
-        return p_Layer2 == BroadPhaseLayers::MOVING;
+      LOW_ASSERT(p_Layer1 < m_Table.layer_count,
+                 "Invalid Jolt object layer");
+      return (m_Table.group_masks[p_Layer1] &
+              (1u << p_Layer2.GetValue())) != 0u;
+    }
+
+  private:
+    const CollisionLayerTable &m_Table;
+  };
+
+  // Filters for queries that should only see some of the layers
+  class QueryLayerFilter final : public JPH::ObjectLayerFilter
+  {
+  public:
+    explicit QueryLayerFilter(uint32_t p_LayerMask)
+        : m_LayerMask(p_LayerMask)
+    {
+    }
+
+    bool ShouldCollide(JPH::ObjectLayer p_Layer) const override
+    {
+      return (m_LayerMask & (1u << p_Layer)) != 0u;
+    }
+
+  private:
+    uint32_t m_LayerMask;
+  };
+
+  class QueryBroadPhaseFilter final
+      : public JPH::BroadPhaseLayerFilter
+  {
+  public:
+    explicit QueryBroadPhaseFilter(uint32_t p_GroupMask)
+        : m_GroupMask(p_GroupMask)
+    {
+    }
+
+    bool ShouldCollide(JPH::BroadPhaseLayer p_Layer) const override
+    {
+      return (m_GroupMask & (1u << p_Layer.GetValue())) != 0u;
+    }
+
+  private:
+    uint32_t m_GroupMask;
+  };
+
+  // Hands the jobs of Jolt to the parallel workers of the engine so
+  // that all physics worlds share one set of threads
+  class EngineJobSystem final : public JPH::JobSystemWithBarrier
+  {
+  public:
+    EngineJobSystem()
+    {
+      JobSystemWithBarrier::Init(JPH::cMaxPhysicsBarriers);
+      m_Jobs.Init(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsJobs);
+    }
+
+    int GetMaxConcurrency() const override
+    {
+      namespace Parallel = Low::Util::JobManager::Parallel;
+      return static_cast<int>(Parallel::get_worker_count()) + 1;
+    }
+
+    JobHandle CreateJob(const char *p_Name, JPH::ColorArg p_Color,
+                        const JobFunction &p_Function,
+                        JPH::uint32 p_NumDependencies = 0u) override
+    {
+      JPH::uint32 l_Index;
+      while (true) {
+        l_Index =
+            m_Jobs.ConstructObject(p_Name, p_Color, this, p_Function,
+                                   p_NumDependencies);
+        if (l_Index != AvailableJobs::cInvalidObjectIndex) {
+          break;
+        }
+        // All jobs are in flight, wait for the workers to free some
+        std::this_thread::yield();
       }
-      if (p_Layer1 == Layers::MOVING) {
-        return true;
+
+      Job *l_Job = &m_Jobs.Get(l_Index);
+      // The handle keeps the job alive since it may already be done
+      // once QueueJob returns
+      JobHandle l_Handle(l_Job);
+      if (p_NumDependencies == 0u) {
+        QueueJob(l_Job);
+      }
+      return l_Handle;
+    }
+
+  protected:
+    // Jolt queues thousands of small jobs per step. The job itself
+    // is the task data, so queueing one neither allocates nor locks.
+    void QueueJob(Job *p_Job) override
+    {
+      p_Job->AddRef();
+      Low::Util::JobManager::Parallel::submit_task(&execute_job,
+                                                   p_Job);
+    }
+
+    void QueueJobs(Job **p_Jobs, JPH::uint p_NumJobs) override
+    {
+      for (JPH::uint i = 0u; i < p_NumJobs; ++i) {
+        QueueJob(p_Jobs[i]);
+      }
+    }
+
+    void FreeJob(Job *p_Job) override
+    {
+      m_Jobs.DestroyObject(p_Job);
+    }
+
+  private:
+    static void execute_job(void *p_Data)
+    {
+      Job *l_Job = static_cast<Job *>(p_Data);
+      l_Job->Execute();
+      l_Job->Release();
+    }
+
+    using AvailableJobs = JPH::FixedSizeFreeList<Job>;
+    AvailableJobs m_Jobs;
+  };
+
+  // Dense storage for backend objects. Ids pack the slot index in
+  // the lower and a generation in the upper 32 bits so stale handles
+  // are detected after a slot got reused. Generations start at 1 so
+  // an id is never 0.
+  template <typename T> class SlotMap
+  {
+  public:
+    uint64_t insert(const T &p_Value)
+    {
+      uint32_t l_Index;
+      if (!m_FreeSlots.empty()) {
+        l_Index = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+      } else {
+        l_Index = static_cast<uint32_t>(m_Slots.size());
+        m_Slots.emplace_back();
+      }
+
+      Slot &l_Slot = m_Slots[l_Index];
+      l_Slot.value = p_Value;
+      l_Slot.alive = true;
+      return (static_cast<uint64_t>(l_Slot.generation) << 32u) |
+             l_Index;
+    }
+
+    T *find(uint64_t p_Id)
+    {
+      const uint32_t l_Index = static_cast<uint32_t>(p_Id);
+      if (l_Index >= m_Slots.size()) {
+        return nullptr;
+      }
+
+      Slot &l_Slot = m_Slots[l_Index];
+      if (!l_Slot.alive ||
+          l_Slot.generation != static_cast<uint32_t>(p_Id >> 32u)) {
+        return nullptr;
+      }
+      return &l_Slot.value;
+    }
+
+    bool erase(uint64_t p_Id)
+    {
+      if (!find(p_Id)) {
+        return false;
+      }
+
+      const uint32_t l_Index = static_cast<uint32_t>(p_Id);
+      Slot &l_Slot = m_Slots[l_Index];
+      l_Slot.value = T();
+      l_Slot.alive = false;
+      l_Slot.generation++;
+      m_FreeSlots.push_back(l_Index);
+      return true;
+    }
+
+    template <typename Func> void for_each(Func p_Func)
+    {
+      for (Slot &i_Slot : m_Slots) {
+        if (i_Slot.alive) {
+          p_Func(i_Slot.value);
+        }
       }
-      LOW_ASSERT(false, "Invalid Jolt object layer");
-      return false;
     }
+
+    void clear()
+    {
+      m_Slots.clear();
+      m_FreeSlots.clear();
+    }
+
+  private:
+    struct Slot
+    {
+      T value = T();
+      uint32_t generation = 1u;
+      bool alive = false;
+    };
+
+    std::vector<Slot> m_Slots;
+    std::vector<uint32_t> m_FreeSlots;
   };
 
+  // Every thread that touches the physics worlds from a job gets a
+  // slot so it can own per thread scratch data
+  const uint32_t g_MaxThreadSlots = 64u;
+  std::atomic<uint32_t> g_NextThreadSlot{0u};
+  thread_local uint32_t t_ThreadSlot = UINT32_MAX;
+
+  uint32_t get_thread_slot()
+  {
+    if (t_ThreadSlot == UINT32_MAX) {
+      t_ThreadSlot = g_NextThreadSlot.fetch_add(1u);
+    }
+    return t_ThreadSlot;
+  }
+
+  // Worlds are only ever updated from the main thread one after the
+  // other so they can share the job system and the temp allocator
   struct JoltRuntime
   {
     std::mutex mutex;
     uint32_t world_count = 0u;
     bool initialized = false;
+    JPH::TempAllocatorImpl *temp_allocator = nullptr;
+    EngineJobSystem *job_system = nullptr;
+    // Work that runs on the job workers outside of the physics
+    // update (e.g. character updates) cannot share temp_allocator
+    std::array<JPH::TempAllocatorImpl *, g_MaxThreadSlots>
+        thread_temp_allocators{};
   };
 
   JoltRuntime &runtime()
@@ -146,6 +454,9 @@ namespace {
       JPH::RegisterDefaultAllocator();
       JPH::Factory::sInstance = new JPH::Factory();
       JPH::RegisterTypes();
+      l_Runtime.temp_allocator =
+          new JPH::TempAllocatorImpl(10u * 1024u * 1024u);
+      l_Runtime.job_system = new EngineJobSystem();
       l_Runtime.initialized = true;
     }
     ++l_Runtime.world_count;
@@ -161,6 +472,15 @@ namespace {
     --l_Runtime.world_count;
 
     if (l_Runtime.world_count == 0u && l_Runtime.initialized) {
+      delete l_Runtime.job_system;
+      l_Runtime.job_system = nullptr;
+      delete l_Runtime.temp_allocator;
+      l_Runtime.temp_allocator = nullptr;
+      for (JPH::TempAllocatorImpl *&i_Allocator :
+           l_Runtime.thread_temp_allocators) {
+        delete i_Allocator;
+        i_Allocator = nullptr;
+      }
       JPH::UnregisterTypes();
       delete JPH::Factory::sInstance;
       JPH::Factory::sInstance = nullptr;
@@ -168,6 +488,23 @@ namespace {
     }
   }
 
+  JPH::TempAllocator &get_thread_temp_allocator()
+  {
+    const uint32_t l_Slot = get_thread_slot();
+    if (l_Slot >= g_MaxThreadSlots) {
+      thread_local JPH::TempAllocatorMalloc t_Fallback;
+      return t_Fallback;
+    }
+
+    // Only the owning thread ever touches its slot
+    JPH::TempAllocatorImpl *&l_Allocator =
+        runtime().thread_temp_allocators[l_Slot];
+    if (!l_Allocator) {
+      l_Allocator = new JPH::TempAllocatorImpl(1024u * 1024u);
+    }
+    return *l_Allocator;
+  }
+
   JPH::Vec3 to_jolt(const Low::Math::Vector3 &p_Value)
   {
     return JPH::Vec3(p_Value.x, p_Value.y, p_Value.z);
@@ -226,6 +563,388 @@ namespace {
                ? Layers::NON_MOVING
                : Layers::MOVING;
   }
+
+  // What the contact recorder needs to know about a body. Indexed by
+  // the index of the Jolt body.
+  struct BodyEntry
+  {
+    JPH::BodyID body_id;
+    uint64_t id = 0u;
+    void *user_data = nullptr;
+    bool sensor = false;
+    bool contact_events = false;
+  };
+
+  enum class RawContactType : uint8_t
+  {
+    Added,
+    Persisted,
+    Removed
+  };
+
+  // Contact of two sub shapes as reported by Jolt. Bodies are ordered
+  // by id so the same pair always ends up with the same key.
+  struct RawContact
+  {
+    RawContactType type = RawContactType::Added;
+    JPH::BodyID body_a;
+    JPH::BodyID body_b;
+    bool sensor = false;
+    Low::Math::Vector3 point = Low::Math::Vector3(0.0f);
+    Low::Math::Vector3 normal = Low::Math::Vector3(0.0f);
+
+    uint64_t get_pair_key() const
+    {
+      return (static_cast<uint64_t>(
+                  body_a.GetIndexAndSequenceNumber())
+              << 32u) |
+             body_b.GetIndexAndSequenceNumber();
+    }
+  };
+
+  // Jolt reports contacts from its jobs. Every thread appends to its
+  // own buffer so recording does not need a lock. Threads beyond the
+  // slot count share a locked overflow buffer.
+  class ContactRecorder final : public JPH::ContactListener
+  {
+  public:
+    explicit ContactRecorder(const std::vector<BodyEntry> &p_Entries)
+        : m_Entries(p_Entries)
+    {
+    }
+
+    void OnContactAdded(const JPH::Body &p_Body1,
+                        const JPH::Body &p_Body2,
+                        const JPH::ContactManifold &p_Manifold,
+                        JPH::ContactSettings &p_Settings) override
+    {
+      record(RawContactType::Added, p_Body1, p_Body2, p_Manifold);
+    }
+
+    void OnContactPersisted(const JPH::Body &p_Body1,
+                            const JPH::Body &p_Body2,
+                            const JPH::ContactManifold &p_Manifold,
+                            JPH::ContactSettings &p_Settings) override
+    {
+      record(RawContactType::Persisted, p_Body1, p_Body2,
+             p_Manifold);
+    }
+
+    void OnContactRemoved(const JPH::SubShapeIDPair &p_Pair) override
+    {
+      const BodyEntry *l_Entry1 = get_entry(p_Pair.GetBody1ID());
+      const BodyEntry *l_Entry2 = get_entry(p_Pair.GetBody2ID());
+      if (!wants_events(l_Entry1) && !wants_events(l_Entry2)) {
+        return;
+      }
+
+      RawContact l_Contact;
+      l_Contact.type = RawContactType::Removed;
+      l_Contact.body_a = p_Pair.GetBody1ID();
+      l_Contact.body_b = p_Pair.GetBody2ID();
+      l_Contact.sensor = (l_Entry1 && l_Entry1->sensor) ||
+                         (l_Entry2 && l_Entry2->sensor);
+      if (l_Contact.body_b < l_Contact.body_a) {
+        std::swap(l_Contact.body_a, l_Contact.body_b);
+      }
+      push(l_Contact);
+    }
+
+    // Hands all recorded contacts to p_Func and empties the buffers.
+    // Must not be called while the world is being updated.
+    template <typename Func> void drain(Func p_Func)
+    {
+      for (ThreadBuffer &i_Buffer : m_Buffers) {
+        for (const RawContact &i_Contact : i_Buffer.contacts) {
+          p_Func(i_Contact);
+        }
+        i_Buffer.contacts.clear();
+      }
+      for (const RawContact &i_Contact : m_Overflow) {
+        p_Func(i_Contact);
+      }
+      m_Overflow.clear();
+    }
+
+  private:
+    struct alignas(64) ThreadBuffer
+    {
+      std::vector<RawContact> contacts;
+    };
+
+    const BodyEntry *get_entry(const JPH::BodyID &p_BodyId) const
+    {
+      const uint32_t l_Index = p_BodyId.GetIndex();
+      if (l_Index >= m_Entries.size() ||
+          m_Entries[l_Index].body_id != p_BodyId) {
+        return nullptr;
+      }
+      return &m_Entries[l_Index];
+    }
+
+    static bool wants_events(const BodyEntry *p_Entry)
+    {
+      return p_Entry && (p_Entry->sensor || p_Entry->contact_events);
+    }
+
+    void record(RawContactType p_Type, const JPH::Body &p_Body1,
+                const JPH::Body &p_Body2,
+                const JPH::ContactManifold &p_Manifold)
+    {
+      if (!wants_events(get_entry(p_Body1.GetID())) &&
+          !wants_events(get_entry(p_Body2.GetID()))) {
+        return;
+      }
+
+      RawContact l_Contact;
+      l_Contact.type = p_Type;
+      l_Contact.body_a = p_Body1.GetID();
+      l_Contact.body_b = p_Body2.GetID();
+      l_Contact.sensor = p_Body1.IsSensor() || p_Body2.IsSensor();
+      l_Contact.point =
+          p_Manifold.mRelativeContactPointsOn1.empty()
+              ? from_jolt_position(p_Manifold.mBaseOffset)
+              : from_jolt_position(
+                    p_Manifold.GetWorldSpaceContactPointOn1(0));
+      l_Contact.normal = from_jolt(p_Manifold.mWorldSpaceNormal);
+
+      if (l_Contact.body_b < l_Contact.body_a) {
+        std::swap(l_Contact.body_a, l_Contact.body_b);
+        l_Contact.normal = -l_Contact.normal;
+      }
+      push(l_Contact);
+    }
+
+    void push(const RawContact &p_Contact)
+    {
+      const uint32_t l_Slot = get_thread_slot();
+      if (l_Slot < g_MaxThreadSlots) {
+        m_Buffers[l_Slot].contacts.push_back(p_Contact);
+        return;
+      }
+
+      std::lock_guard<std::mutex> l_Lock(m_OverflowMutex);
+      m_Overflow.push_back(p_Contact);
+    }
+
+    const std::vector<BodyEntry> &m_Entries;
+    std::array<ThreadBuffer, g_MaxThreadSlots> m_Buffers;
+    std::mutex m_OverflowMutex;
+    std::vector<RawContact> m_Overflow;
+  };
+
+  // Bodies that fall asleep leave the active body list of Jolt. They
+  // are remembered so their final pose still gets written back.
+  class SleepRecorder final : public JPH::BodyActivationListener
+  {
+  public:
+    void OnBodyActivated(const JPH::BodyID &p_BodyId,
+                         JPH::uint64 p_UserData) override
+    {
+    }
+
+    void OnBodyDeactivated(const JPH::BodyID &p_BodyId,
+                           JPH::uint64 p_UserData) override
+    {
+      std::lock_guard<std::mutex> l_Lock(m_Mutex);
+      m_Bodies.push_back(p_BodyId);
+    }
+
+    // Must not be called while the world is being updated
+    const std::vector<JPH::BodyID> &get_bodies() const
+    {
+      return m_Bodies;
+    }
+
+    void clear()
+    {
+      m_Bodies.clear();
+    }
+
+  private:
+    std::mutex m_Mutex;
+    std::vector<JPH::BodyID> m_Bodies;
+  };
+
+  // Characters are sorted into a uniform grid on the XZ plane before
+  // they get updated. A character only collides with characters in
+  // its own and the eight surrounding cells, which keeps the checks
+  // local and lets cells that do not touch update in parallel.
+  class CharacterGrid final
+      : public JPH::CharacterVsCharacterCollision
+  {
+  public:
+    void
+    build(const std::vector<JPH::CharacterVirtual *> &p_Characters,
+          float p_CellSize)
+    {
+      m_CellSize = p_CellSize;
+      clear();
+      for (JPH::CharacterVirtual *i_Character : p_Characters) {
+        const uint64_t i_Key =
+            get_cell_key(i_Character->GetPosition());
+        m_Cells[i_Key].push_back(i_Character);
+        m_HomeCells[i_Character] = i_Key;
+      }
+    }
+
+    void clear()
+    {
+      m_Cells.clear();
+      m_HomeCells.clear();
+    }
+
+    const std::unordered_map<uint64_t,
+                             std::vector<JPH::CharacterVirtual *>> &
+    get_cells() const
+    {
+      return m_Cells;
+    }
+
+    uint64_t get_cell_key(JPH::RVec3Arg p_Position) const
+    {
+      return make_cell_key(get_cell_coordinate(p_Position.GetX()),
+                           get_cell_coordinate(p_Position.GetZ()));
+    }
+
+    static uint64_t make_cell_key(int32_t p_X, int32_t p_Z)
+    {
+      return (static_cast<uint64_t>(static_cast<uint32_t>(p_X))
+              << 32u) |
+             static_cast<uint32_t>(p_Z);
+    }
+
+    static int32_t get_cell_x(uint64_t p_Key)
+    {
+      return static_cast<int32_t>(
+          static_cast<uint32_t>(p_Key >> 32u));
+    }
+
+    static int32_t get_cell_z(uint64_t p_Key)
+    {
+      return static_cast<int32_t>(static_cast<uint32_t>(p_Key));
+    }
+
+    void CollideCharacter(
+        const JPH::CharacterVirtual *p_Character,
+        JPH::RMat44Arg p_CenterOfMassTransform,
+        const JPH::CollideShapeSettings &p_Settings,
+        JPH::RVec3Arg p_BaseOffset,
+        JPH::CollideShapeCollector &p_Collector) const override
+    {
+      const JPH::Mat44 l_Transform =
+          p_CenterOfMassTransform.PostTranslated(-p_BaseOffset)
+              .ToMat44();
+      JPH::CollideShapeSettings l_Settings = p_Settings;
+
+      for_each_neighbour(
+          p_Character,
+          [&](const JPH::CharacterVirtual *p_Other) {
+            if (p_Other == p_Character ||
+                p_Collector.ShouldEarlyOut()) {
+              return;
+            }
+            p_Collector.SetUserData(
+                reinterpret_cast<uint64_t>(p_Other));
+
+            const JPH::Mat44 l_OtherTransform =
+                p_Other->GetCenterOfMassTransform()
+                    .PostTranslated(-p_BaseOffset)
+                    .ToMat44();
+            // The padding of the other character is added so its
+            // outer shell gets detected
+            l_Settings.mMaxSeparationDistance =
+                p_Settings.mMaxSeparationDistance +
+                p_Other->GetCharacterPadding();
+            JPH::CollisionDispatch::sCollideShapeVsShape(
+                p_Character->GetShape(), p_Other->GetShape(),
+                JPH::Vec3::sOne(), JPH::Vec3::sOne(), l_Transform,
+                l_OtherTransform, JPH::SubShapeIDCreator(),
+                JPH::SubShapeIDCreator(), l_Settings, p_Collector);
+          });
+
+      p_Collector.SetUserData(0);
+    }
+
+    void CastCharacter(
+        const JPH::CharacterVirtual *p_Character,
+        JPH::RMat44Arg p_CenterOfMassTransform,
+        JPH::Vec3Arg p_Direction,
+        const JPH::ShapeCastSettings &p_Settings,
+        JPH::RVec3Arg p_BaseOffset,
+        JPH::CastShapeCollector &p_Collector) const override
+    {
+      const JPH::Mat44 l_Transform =
+          p_CenterOfMassTransform.PostTranslated(-p_BaseOffset)
+              .ToMat44();
+      const JPH::ShapeCast l_Cast(p_Character->GetShape(),
+                                  JPH::Vec3::sOne(), l_Transform,
+                                  p_Direction);
+
+      for_each_neighbour(
+          p_Character,
+          [&](const JPH::CharacterVirtual *p_Other) {
+            if (p_Other == p_Character ||
+                p_Collector.ShouldEarlyOut()) {
+              return;
+            }
+            p_Collector.SetUserData(
+                reinterpret_cast<uint64_t>(p_Other));
+
+            const JPH::Mat44 l_OtherTransform =
+                p_Other->GetCenterOfMassTransform()
+                    .PostTranslated(-p_BaseOffset)
+                    .ToMat44();
+            JPH::CollisionDispatch::sCastShapeVsShapeWorldSpace(
+                l_Cast, p_Settings, p_Other->GetShape(),
+                JPH::Vec3::sOne(), {}, l_OtherTransform,
+                JPH::SubShapeIDCreator(), JPH::SubShapeIDCreator(),
+                p_Collector);
+          });
+
+      p_Collector.SetUserData(0);
+    }
+
+  private:
+    int32_t get_cell_coordinate(float p_Value) const
+    {
+      return static_cast<int32_t>(std::floor(p_Value / m_CellSize));
+    }
+
+    // The cell a character was sorted into is used even after it
+    // moved out of it. Looking at the cells around its current
+    // position could reach into cells that are updated in parallel.
+    template <typename Func>
+    void for_each_neighbour(const JPH::CharacterVirtual *p_Character,
+                            Func p_Func) const
+    {
+      auto l_HomeCell = m_HomeCells.find(p_Character);
+      if (l_HomeCell == m_HomeCells.end()) {
+        return;
+      }
+
+      const int32_t l_X = get_cell_x(l_HomeCell->second);
+      const int32_t l_Z = get_cell_z(l_HomeCell->second);
+      for (int32_t i_X = l_X - 1; i_X <= l_X + 1; ++i_X) {
+        for (int32_t i_Z = l_Z - 1; i_Z <= l_Z + 1; ++i_Z) {
+          auto i_Cell = m_Cells.find(make_cell_key(i_X, i_Z));
+          if (i_Cell == m_Cells.end()) {
+            continue;
+          }
+          for (const JPH::CharacterVirtual *i_Other :
+               i_Cell->second) {
+            p_Func(i_Other);
+          }
+        }
+      }
+    }
+
+    float m_CellSize = 4.0f;
+    std::unordered_map<uint64_t, std::vector<JPH::CharacterVirtual *>>
+        m_Cells;
+    std::unordered_map<const JPH::CharacterVirtual *, uint64_t>
+        m_HomeCells;
+  };
 } // namespace
 
 namespace Low {
@@ -239,53 +958,155 @@ namespace Low {
           float center_offset = 0.0f;
           float step_offset = 0.0f;
           float skin_width = 0.0f;
+
+          // Moves get collected during the frame and applied by
+          // update_capsule_controllers
+          bool pending = false;
+          Math::Vector3 pending_delta = Math::Vector3(0.0f);
+          float pending_time = 0.0f;
+          uint64_t last_move_frame = UINT64_MAX;
+          // Spreads the reduced rate updates over the frames
+          uint32_t stagger = 0u;
+          float update_cost_us = 0.0f;
         };
 
+        CollisionLayerTable collision_layers;
         BroadPhaseLayerInterface broad_phase_layer_interface;
         ObjectVsBroadPhaseLayerFilter
             object_vs_broadphase_layer_filter;
         ObjectLayerPairFilter object_vs_object_layer_filter;
         JPH::PhysicsSystem physics_system;
-        JPH::TempAllocatorImpl temp_allocator;
-        JPH::JobSystemThreadPool job_system;
-        std::unordered_map<uint64_t, JPH::ShapeRefC> shapes;
-        std::unordered_map<uint64_t, JPH::BodyID> bodies;
+        JPH::TempAllocatorImpl &temp_allocator;
+        JPH::JobSystem &job_system;
+        SlotMap<JPH::ShapeRefC> shapes;
+        SlotMap<JPH::BodyID> bodies;
+        // Indexed by the index of the Jolt body, used to translate
+        // query hits and contacts without searching
+        std::vector<BodyEntry> body_entries;
         std::unordered_map<uint64_t, CapsuleControllerBackend>
             capsule_controllers;
-        uint64_t next_shape_id = 1u;
-        uint64_t next_body_id = 1u;
         uint64_t next_capsule_controller_id = 1u;
-
-        WorldBackend()
-            : temp_allocator(10u * 1024u * 1024u),
-              job_system(
-                  JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers,
-                  std::max(1u, std::thread::hardware_concurrency()) -
-                      1u)
+        CharacterUpdateSettings character_settings;
+        CharacterGrid character_grid;
+        uint64_t character_frame = 0u;
+
+        // Bodies that get created while a batch is open are added to
+        // the broad phase in bulk once the batch ends. Bodies that
+        // get destroyed are removed and destroyed in bulk as well.
+        uint32_t body_batch_depth = 0u;
+        JPH::Array<JPH::BodyID> batched_bodies;
+        JPH::Array<JPH::BodyID> batched_active_bodies;
+        JPH::Array<JPH::BodyID> batched_destroyed_bodies;
+        std::unordered_set<uint32_t> batched_body_ids;
+        bool optimize_broad_phase = false;
+
+        // The simulation always advances in fixed steps. Whatever is
+        // left of the frame time is kept for the next frame and used
+        // to interpolate the bodies between the last two steps.
+        struct BodyState
+        {
+          Math::Vector3 position;
+          Math::Quaternion rotation;
+        };
+        float fixed_delta = 1.0f / 60.0f;
+        uint32_t collision_steps = 1u;
+        uint32_t max_steps = 4u;
+        float accumulator = 0.0f;
+        float interpolation_alpha = 1.0f;
+        std::unordered_map<uint32_t, BodyState> previous_states;
+
+        // Sub shape contacts are counted per pair of bodies so that
+        // compound shapes only begin and end once
+        ContactRecorder contact_recorder;
+        SleepRecorder sleep_recorder;
+        // Scratch list for the bulk body operations
+        JPH::BodyIDVector body_id_scratch;
+        std::unordered_map<uint64_t, uint32_t> contact_pairs;
+        // Bodies destroyed since the last step. Their pairs get
+        // dropped together in one pass before the pairs are used.
+        std::unordered_set<uint32_t> forgotten_contact_bodies;
+        std::unordered_map<uint64_t, RawContact> persisted_contacts;
+        std::unordered_set<uint64_t> reported_pairs;
+        Util::List<ContactEvent> contact_events;
+        Util::List<TriggerEvent> trigger_events;
+
+        struct DeferredQuery
+        {
+          bool overlap = false;
+          QueryMode mode = QueryMode::Closest;
+          RaycastRequest ray;
+          OverlapRequest shape;
+        };
+        Util::List<DeferredQuery> pending_queries;
+        uint32_t next_query_ticket = 1u;
+        uint32_t resolved_first_ticket = 0u;
+        Util::List<QueryResult> resolved_queries;
+        Util::List<BackendQueryHit> resolved_hits;
+        // Workers write the hits of query i to a fixed slice of the
+        // scratch list, they get packed once the batch is done
+        Util::List<uint32_t> query_hit_counts;
+        Util::List<BackendQueryHit> query_scratch_hits;
+
+        bool deterministic = false;
+        // While recording, bodies that get changed from outside of
+        // the simulation are remembered until the next step stores
+        // them as its input
+        bool recording = false;
+        Recording active_recording;
+        std::unordered_set<uint32_t> touched_bodies;
+
+        explicit WorldBackend(
+            const CollisionLayerSettings &p_CollisionLayers)
+            : broad_phase_layer_interface(collision_layers),
+              object_vs_broadphase_layer_filter(collision_layers),
+              object_vs_object_layer_filter(collision_layers),
+              temp_allocator(*runtime().temp_allocator),
+              job_system(*runtime().job_system),
+              contact_recorder(body_entries)
         {
           const JPH::uint l_MaxBodies = 65536u;
           const JPH::uint l_NumBodyMutexes = 0u;
           const JPH::uint l_MaxBodyPairs = 65536u;
           const JPH::uint l_MaxContactConstraints = 10240u;
 
+          collision_layers.build(p_CollisionLayers);
+
           physics_system.Init(l_MaxBodies, l_NumBodyMutexes,
                               l_MaxBodyPairs, l_MaxContactConstraints,
                               broad_phase_layer_interface,
                               object_vs_broadphase_layer_filter,
                               object_vs_object_layer_filter);
+          physics_system.SetContactListener(&contact_recorder);
+          physics_system.SetBodyActivationListener(&sleep_recorder);
+
+          // Only needed for replays and rollback, see
+          // set_world_deterministic
+          JPH::PhysicsSettings l_Settings =
+              physics_system.GetPhysicsSettings();
+          l_Settings.mDeterministicSimulation = false;
+          physics_system.SetPhysicsSettings(l_Settings);
         }
       };
 
-      static uint64_t get_backend_body_id(WorldBackend *p_World,
-                                          const JPH::BodyID &p_BodyId)
+      static const BodyEntry *
+      get_body_entry(WorldBackend *p_World,
+                     const JPH::BodyID &p_BodyId)
       {
-        for (const auto &i_Body : p_World->bodies) {
-          if (i_Body.second == p_BodyId) {
-            return i_Body.first;
-          }
+        const uint32_t l_Index = p_BodyId.GetIndex();
+        // Jolt reuses body indices, the sequence number tells whether
+        // the entry still belongs to this body
+        if (l_Index >= p_World->body_entries.size() ||
+            p_World->body_entries[l_Index].body_id != p_BodyId) {
+          return nullptr;
         }
+        return &p_World->body_entries[l_Index];
+      }
 
-        return 0u;
+      static uint64_t get_backend_body_id(WorldBackend *p_World,
+                                          const JPH::BodyID &p_BodyId)
+      {
+        const BodyEntry *l_Entry = get_body_entry(p_World, p_BodyId);
+        return l_Entry ? l_Entry->id : 0u;
       }
 
       static void fill_body_query_hit(WorldBackend *p_World,
@@ -424,7 +1245,8 @@ namespace Low {
       static bool overlap_query_shape(
           WorldBackend *p_World, const JPH::Shape *p_Shape,
           const Math::Vector3 &p_Position,
-          const Math::Quaternion &p_Rotation, BackendQueryHit *p_Hit)
+          const Math::Quaternion &p_Rotation, uint32_t p_LayerMask,
+          BackendQueryHit *p_Hit)
       {
         LOW_ASSERT(p_World,
                    "Cannot overlap shape in null physics world");
@@ -433,12 +1255,17 @@ namespace Low {
             JPH::RMat44::sRotationTranslation(
                 to_jolt(p_Rotation), to_jolt_position(p_Position));
 
+        const QueryBroadPhaseFilter l_BroadPhaseFilter(
+            p_World->collision_layers.get_group_mask(p_LayerMask));
+        const QueryLayerFilter l_LayerFilter(p_LayerMask);
+
         JPH::CollideShapeSettings l_Settings;
         JPH::ClosestHitCollisionCollector<JPH::CollideShapeCollector>
             l_Collector;
         p_World->physics_system.GetNarrowPhaseQuery().CollideShape(
             p_Shape, JPH::Vec3::sReplicate(1.0f), l_Transform,
-            l_Settings, JPH::RVec3::sZero(), l_Collector);
+            l_Settings, JPH::RVec3::sZero(), l_Collector,
+            l_BroadPhaseFilter, l_LayerFilter);
 
         if (!l_Collector.HadHit()) {
           return false;
@@ -450,10 +1277,784 @@ namespace Low {
         return true;
       }
 
-      WorldBackend *create_world_backend()
+      static uint32_t raycast_query(WorldBackend *p_World,
+                                    const RaycastRequest &p_Request,
+                                    QueryMode p_Mode,
+                                    uint32_t p_MaxHits,
+                                    BackendQueryHit *p_Hits)
+      {
+        const float l_DirectionLength =
+            glm::length(p_Request.direction);
+        if (l_DirectionLength <= LOW_MATH_EPSILON ||
+            p_Request.max_distance <= 0.0f || p_MaxHits == 0u) {
+          return 0u;
+        }
+
+        const JPH::RRayCast l_Ray(
+            to_jolt_position(p_Request.origin),
+            to_jolt((p_Request.direction / l_DirectionLength) *
+                    p_Request.max_distance));
+
+        const QueryBroadPhaseFilter l_BroadPhaseFilter(
+            p_World->collision_layers.get_group_mask(
+                p_Request.layer_mask));
+        const QueryLayerFilter l_LayerFilter(p_Request.layer_mask);
+        const JPH::NarrowPhaseQuery &l_Query =
+            p_World->physics_system.GetNarrowPhaseQuery();
+
+        if (p_Mode == QueryMode::Closest) {
+          JPH::RayCastResult l_Result;
+          if (!l_Query.CastRay(l_Ray, l_Result, l_BroadPhaseFilter,
+                               l_LayerFilter)) {
+            return 0u;
+          }
+          fill_raycast_hit(p_World, l_Ray, l_Result,
+                           p_Request.max_distance, p_Hits[0]);
+          return 1u;
+        }
+
+        JPH::RayCastSettings l_Settings;
+        JPH::AllHitCollisionCollector<JPH::CastRayCollector>
+            l_Collector;
+        l_Query.CastRay(l_Ray, l_Settings, l_Collector,
+                        l_BroadPhaseFilter, l_LayerFilter);
+        l_Collector.Sort();
+
+        const uint32_t l_Count =
+            std::min(static_cast<uint32_t>(l_Collector.mHits.size()),
+                     p_MaxHits);
+        for (uint32_t i = 0u; i < l_Count; ++i) {
+          fill_raycast_hit(p_World, l_Ray, l_Collector.mHits[i],
+                           p_Request.max_distance, p_Hits[i]);
+        }
+        return l_Count;
+      }
+
+      static uint32_t overlap_query(WorldBackend *p_World,
+                                    const OverlapRequest &p_Request,
+                                    QueryMode p_Mode,
+                                    uint32_t p_MaxHits,
+                                    BackendQueryHit *p_Hits)
+      {
+        if (p_MaxHits == 0u) {
+          return 0u;
+        }
+
+        const JPH::ShapeRefC l_Shape =
+            p_Request.shape == OverlapShape::Box
+                ? create_box_query_shape(p_Request.half_extents)
+                : create_sphere_query_shape(p_Request.radius);
+        const JPH::RMat44 l_Transform =
+            JPH::RMat44::sRotationTranslation(
+                to_jolt(p_Request.rotation),
+                to_jolt_position(p_Request.position));
+
+        const QueryBroadPhaseFilter l_BroadPhaseFilter(
+            p_World->collision_layers.get_group_mask(
+                p_Request.layer_mask));
+        const QueryLayerFilter l_LayerFilter(p_Request.layer_mask);
+        const JPH::NarrowPhaseQuery &l_Query =
+            p_World->physics_system.GetNarrowPhaseQuery();
+        JPH::CollideShapeSettings l_Settings;
+
+        if (p_Mode == QueryMode::Closest) {
+          JPH::ClosestHitCollisionCollector<
+              JPH::CollideShapeCollector>
+              l_Collector;
+          l_Query.CollideShape(l_Shape.GetPtr(),
+                               JPH::Vec3::sReplicate(1.0f),
+                               l_Transform, l_Settings,
+                               JPH::RVec3::sZero(), l_Collector,
+                               l_BroadPhaseFilter, l_LayerFilter);
+          if (!l_Collector.HadHit()) {
+            return 0u;
+          }
+          fill_overlap_hit(p_World, l_Collector.mHit, p_Hits[0]);
+          return 1u;
+        }
+
+        JPH::AllHitCollisionCollector<JPH::CollideShapeCollector>
+            l_Collector;
+        l_Query.CollideShape(l_Shape.GetPtr(),
+                             JPH::Vec3::sReplicate(1.0f), l_Transform,
+                             l_Settings, JPH::RVec3::sZero(),
+                             l_Collector, l_BroadPhaseFilter,
+                             l_LayerFilter);
+        l_Collector.Sort();
+
+        const uint32_t l_Count =
+            std::min(static_cast<uint32_t>(l_Collector.mHits.size()),
+                     p_MaxHits);
+        for (uint32_t i = 0u; i < l_Count; ++i) {
+          fill_overlap_hit(p_World, l_Collector.mHits[i], p_Hits[i]);
+        }
+        return l_Count;
+      }
+
+      // Queries are cheap one by one, handing them to the workers in
+      // small groups keeps the scheduling overhead down
+      static const uint32_t g_QueryBatchSize = 32u;
+      static const uint32_t g_MaxDeferredQueryHits = 16u;
+
+      // p_Run(index, hits, max hits) runs query index and returns the
+      // number of hits it wrote
+      template <typename RunFunc>
+      static void run_query_batch(
+          WorldBackend *p_World, uint32_t p_Count, uint32_t p_MaxHits,
+          RunFunc p_Run, Util::List<QueryResult> &p_Results,
+          Util::List<BackendQueryHit> &p_Hits)
+      {
+        LOW_PROFILE_CPU("Physics", "Run query batch");
+
+        // Callers pair the results with their requests by index, so
+        // every request gets a result even if it cannot have hits
+        if (p_MaxHits == 0u) {
+          QueryResult l_Empty;
+          l_Empty.first_hit = static_cast<uint32_t>(p_Hits.size());
+          l_Empty.hit_count = 0u;
+          p_Results.insert(p_Results.end(), p_Count, l_Empty);
+          return;
+        }
+        if (p_Count == 0u) {
+          return;
+        }
+
+        p_World->query_hit_counts.resize(p_Count);
+        p_World->query_scratch_hits.resize(
+            static_cast<size_t>(p_Count) * p_MaxHits);
+
+        uint32_t *l_Counts = p_World->query_hit_counts.data();
+        BackendQueryHit *l_Scratch =
+            p_World->query_scratch_hits.data();
+        Util::JobManager::Parallel::for_each(
+            p_Count, g_QueryBatchSize,
+            [&](uint32_t p_Begin, uint32_t p_End) {
+              for (uint32_t i = p_Begin; i < p_End; ++i) {
+                l_Counts[i] = p_Run(
+                    i, l_Scratch + static_cast<size_t>(i) * p_MaxHits,
+                    p_MaxHits);
+              }
+            });
+
+        p_Results.reserve(p_Results.size() + p_Count);
+        for (uint32_t i = 0u; i < p_Count; ++i) {
+          QueryResult i_Result;
+          i_Result.first_hit = static_cast<uint32_t>(p_Hits.size());
+          i_Result.hit_count = l_Counts[i];
+          p_Results.push_back(i_Result);
+
+          const BackendQueryHit *i_Hits =
+              l_Scratch + static_cast<size_t>(i) * p_MaxHits;
+          p_Hits.insert(p_Hits.end(), i_Hits, i_Hits + l_Counts[i]);
+        }
+      }
+
+      // Adding fewer bodies than this in one batch does not degrade
+      // the broad phase enough to be worth rebuilding its trees
+      static const uint32_t g_OptimizeBroadPhaseThreshold = 256u;
+
+      static bool is_batched_body(WorldBackend *p_World,
+                                  const JPH::BodyID &p_BodyId)
+      {
+        return p_World->body_batch_depth > 0u &&
+               p_World->batched_body_ids.find(
+                   p_BodyId.GetIndexAndSequenceNumber()) !=
+                   p_World->batched_body_ids.end();
+      }
+
+      // Only drops the id from the lookup, the body gets filtered
+      // out of the batch lists when the batch ends
+      static void remove_batched_body(WorldBackend *p_World,
+                                      const JPH::BodyID &p_BodyId)
+      {
+        if (p_World->body_batch_depth > 0u) {
+          p_World->batched_body_ids.erase(
+              p_BodyId.GetIndexAndSequenceNumber());
+        }
+      }
+
+      static void
+      add_batched_bodies(WorldBackend *p_World,
+                         JPH::Array<JPH::BodyID> &p_Bodies,
+                         JPH::EActivation p_Activation)
+      {
+        uint32_t l_Count = 0u;
+        for (const JPH::BodyID &i_BodyId : p_Bodies) {
+          if (p_World->batched_body_ids.find(
+                  i_BodyId.GetIndexAndSequenceNumber()) !=
+              p_World->batched_body_ids.end()) {
+            p_Bodies[l_Count++] = i_BodyId;
+          }
+        }
+        p_Bodies.resize(l_Count);
+
+        if (p_Bodies.empty()) {
+          return;
+        }
+
+        JPH::BodyInterface &l_BodyInterface =
+            p_World->physics_system.GetBodyInterface();
+
+        JPH::BodyInterface::AddState l_State =
+            l_BodyInterface.AddBodiesPrepare(p_Bodies.data(),
+                                             (int)l_Count);
+        l_BodyInterface.AddBodiesFinalize(
+            p_Bodies.data(), (int)l_Count, l_State, p_Activation);
+
+        if (l_Count >= g_OptimizeBroadPhaseThreshold) {
+          p_World->optimize_broad_phase = true;
+        }
+        p_Bodies.clear();
+      }
+
+      static void store_previous_body_states(WorldBackend *p_World)
+      {
+        JPH::BodyIDVector l_ActiveBodies;
+        p_World->physics_system.GetActiveBodies(
+            JPH::EBodyType::RigidBody, l_ActiveBodies);
+
+        const JPH::BodyLockInterfaceNoLock &l_LockInterface =
+            p_World->physics_system.GetBodyLockInterfaceNoLock();
+
+        p_World->previous_states.clear();
+        for (const JPH::BodyID &i_BodyId : l_ActiveBodies) {
+          JPH::BodyLockRead i_Lock(l_LockInterface, i_BodyId);
+          if (!i_Lock.Succeeded()) {
+            continue;
+          }
+
+          const JPH::Body &i_Body = i_Lock.GetBody();
+          const uint32_t i_Key = i_BodyId.GetIndexAndSequenceNumber();
+          WorldBackend::BodyState &i_State =
+              p_World->previous_states[i_Key];
+          i_State.position = from_jolt_position(i_Body.GetPosition());
+          i_State.rotation = from_jolt(i_Body.GetRotation());
+        }
+      }
+
+      static Util::Handle get_body_handle(WorldBackend *p_World,
+                                          const JPH::BodyID &p_BodyId)
+      {
+        const BodyEntry *l_Entry = get_body_entry(p_World, p_BodyId);
+        if (!l_Entry) {
+          return Util::Handle::DEAD;
+        }
+        return reinterpret_cast<uint64_t>(l_Entry->user_data);
+      }
+
+      static void emit_contact_event(WorldBackend *p_World,
+                                     const RawContact &p_Contact,
+                                     bool p_Begin)
+      {
+        const Util::Handle l_BodyA =
+            get_body_handle(p_World, p_Contact.body_a);
+        const Util::Handle l_BodyB =
+            get_body_handle(p_World, p_Contact.body_b);
+        // Bodies that got destroyed in the meantime are not reported
+        if (l_BodyA.get_id() == Util::Handle::DEAD ||
+            l_BodyB.get_id() == Util::Handle::DEAD) {
+          return;
+        }
+
+        p_World->reported_pairs.insert(p_Contact.get_pair_key());
+
+        if (p_Contact.sensor) {
+          const BodyEntry *l_EntryA =
+              get_body_entry(p_World, p_Contact.body_a);
+          const bool l_TriggerIsA = l_EntryA && l_EntryA->sensor;
+
+          TriggerEvent l_Event;
+          l_Event.type = p_Begin ? TriggerEventType::Enter
+                                 : TriggerEventType::Exit;
+          l_Event.trigger = l_TriggerIsA ? l_BodyA : l_BodyB;
+          l_Event.other = l_TriggerIsA ? l_BodyB : l_BodyA;
+          p_World->trigger_events.push_back(l_Event);
+          return;
+        }
+
+        ContactEvent l_Event;
+        l_Event.type =
+            p_Begin ? ContactEventType::Begin : ContactEventType::End;
+        l_Event.body_a = l_BodyA;
+        l_Event.body_b = l_BodyB;
+        l_Event.point = p_Contact.point;
+        l_Event.normal = p_Contact.normal;
+        p_World->contact_events.push_back(l_Event);
+      }
+
+      // Merges what the recorder collected during one step into the
+      // per pair counts. Added contacts go first so a pair that only
+      // moves between sub shapes does not end and begin again.
+      static void collect_contacts(WorldBackend *p_World)
+      {
+        LOW_PROFILE_CPU("Physics", "Collect contacts");
+
+        Util::List<RawContact> l_Removed;
+        auto l_Collect = [&](const RawContact &i_Contact) {
+          const uint64_t i_Key = i_Contact.get_pair_key();
+          switch (i_Contact.type) {
+          case RawContactType::Added:
+            if (p_World->contact_pairs[i_Key]++ == 0u) {
+              emit_contact_event(p_World, i_Contact, true);
+            }
+            break;
+          case RawContactType::Persisted:
+            if (!i_Contact.sensor) {
+              p_World->persisted_contacts[i_Key] = i_Contact;
+            }
+            break;
+          case RawContactType::Removed:
+            l_Removed.push_back(i_Contact);
+            break;
+          }
+        };
+        if (p_World->deterministic) {
+          // Every worker thread has its own buffer, sorting takes the
+          // thread scheduling out of the event order
+          Util::List<RawContact> l_Contacts;
+          p_World->contact_recorder.drain(
+              [&](const RawContact &i_Contact) {
+                l_Contacts.push_back(i_Contact);
+              });
+          std::sort(l_Contacts.begin(), l_Contacts.end(),
+                    [](const RawContact &p_A, const RawContact &p_B) {
+                      const uint64_t l_KeyA = p_A.get_pair_key();
+                      const uint64_t l_KeyB = p_B.get_pair_key();
+                      if (l_KeyA != l_KeyB) {
+                        return l_KeyA < l_KeyB;
+                      }
+                      if (p_A.type != p_B.type) {
+                        return p_A.type < p_B.type;
+                      }
+                      return std::tie(p_A.point.x, p_A.point.y,
+                                      p_A.point.z) <
+                             std::tie(p_B.point.x, p_B.point.y,
+                                      p_B.point.z);
+                    });
+          for (const RawContact &i_Contact : l_Contacts) {
+            l_Collect(i_Contact);
+          }
+        } else {
+          p_World->contact_recorder.drain(l_Collect);
+        }
+
+        for (const RawContact &i_Contact : l_Removed) {
+          auto i_Pair =
+              p_World->contact_pairs.find(i_Contact.get_pair_key());
+          if (i_Pair == p_World->contact_pairs.end()) {
+            continue;
+          }
+          if (--i_Pair->second == 0u) {
+            p_World->contact_pairs.erase(i_Pair);
+            emit_contact_event(p_World, i_Contact, false);
+          }
+        }
+      }
+
+      // Persist is sent once per frame and only for pairs that did
+      // not begin or end in the same frame
+      static void flush_persisted_contacts(WorldBackend *p_World)
+      {
+        for (auto &i_Entry : p_World->persisted_contacts) {
+          if (p_World->reported_pairs.count(i_Entry.first) ||
+              !p_World->contact_pairs.count(i_Entry.first)) {
+            continue;
+          }
+
+          const RawContact &i_Contact = i_Entry.second;
+          ContactEvent i_Event;
+          i_Event.type = ContactEventType::Persist;
+          i_Event.body_a = get_body_handle(p_World, i_Contact.body_a);
+          i_Event.body_b = get_body_handle(p_World, i_Contact.body_b);
+          i_Event.point = i_Contact.point;
+          i_Event.normal = i_Contact.normal;
+          p_World->contact_events.push_back(i_Event);
+        }
+        p_World->persisted_contacts.clear();
+        p_World->reported_pairs.clear();
+      }
+
+      static void forget_body_contacts(WorldBackend *p_World,
+                                       const JPH::BodyID &p_BodyId)
+      {
+        if (!p_World->contact_pairs.empty()) {
+          p_World->forgotten_contact_bodies.insert(
+              p_BodyId.GetIndexAndSequenceNumber());
+        }
+      }
+
+      static void flush_forgotten_contacts(WorldBackend *p_World)
+      {
+        std::unordered_set<uint32_t> &l_Bodies =
+            p_World->forgotten_contact_bodies;
+        if (l_Bodies.empty()) {
+          return;
+        }
+
+        for (auto it = p_World->contact_pairs.begin();
+             it != p_World->contact_pairs.end();) {
+          const uint32_t i_BodyA =
+              static_cast<uint32_t>(it->first >> 32u);
+          const uint32_t i_BodyB = static_cast<uint32_t>(it->first);
+          if (l_Bodies.count(i_BodyA) || l_Bodies.count(i_BodyB)) {
+            it = p_World->contact_pairs.erase(it);
+          } else {
+            ++it;
+          }
+        }
+        l_Bodies.clear();
+      }
+
+      static void mark_body_touched(WorldBackend *p_World,
+                                    const JPH::BodyID &p_BodyId)
+      {
+        if (p_World->recording) {
+          p_World->touched_bodies.insert(
+              p_BodyId.GetIndexAndSequenceNumber());
+        }
+      }
+
+      class TouchedBodyFilter final : public JPH::StateRecorderFilter
+      {
+      public:
+        explicit TouchedBodyFilter(
+            const std::unordered_set<uint32_t> &p_Bodies)
+            : m_Bodies(p_Bodies)
+        {
+        }
+
+        bool ShouldSaveBody(const JPH::Body &p_Body) const override
+        {
+          return m_Bodies.count(
+                     p_Body.GetID().GetIndexAndSequenceNumber()) > 0u;
+        }
+
+      private:
+        const std::unordered_set<uint32_t> &m_Bodies;
+      };
+
+      class ActiveBodyFilter final : public JPH::StateRecorderFilter
+      {
+      public:
+        bool ShouldSaveBody(const JPH::Body &p_Body) const override
+        {
+          return p_Body.IsActive();
+        }
+      };
+
+      static const uint32_t g_WorldStateMagic = 0x5357504Cu; // LPWS
+      static const uint32_t g_WorldStateVersion = 1u;
+
+      static void
+      copy_recorder_data(JPH::StateRecorderImpl &p_Recorder,
+                         Util::List<uint8_t> &p_Data)
+      {
+        const std::string l_Bytes = p_Recorder.GetData();
+        p_Data.resize(l_Bytes.size());
+        memcpy(p_Data.data(), l_Bytes.data(), l_Bytes.size());
+      }
+
+      // A delta only holds the bodies that pass p_Filter and none of
+      // the bookkeeping of the world
+      static bool save_state(WorldBackend *p_World,
+                             const JPH::StateRecorderFilter *p_Filter,
+                             Util::List<uint8_t> &p_Data)
+      {
+        const bool l_Delta = p_Filter != nullptr;
+
+        flush_forgotten_contacts(p_World);
+
+        JPH::StateRecorderImpl l_Recorder;
+        l_Recorder.Write(g_WorldStateMagic);
+        l_Recorder.Write(g_WorldStateVersion);
+        l_Recorder.Write(l_Delta);
+
+        p_World->physics_system.SaveState(
+            l_Recorder,
+            l_Delta ? JPH::EStateRecorderState::Global |
+                          JPH::EStateRecorderState::Bodies
+                    : JPH::EStateRecorderState::All,
+            p_Filter);
+
+        if (!l_Delta) {
+          l_Recorder.Write(p_World->accumulator);
+          l_Recorder.Write(p_World->character_frame);
+
+          // Written in key order so equal worlds produce equal data
+          std::vector<std::pair<uint64_t, uint32_t>> l_Pairs(
+              p_World->contact_pairs.begin(),
+              p_World->contact_pairs.end());
+          std::sort(l_Pairs.begin(), l_Pairs.end());
+          l_Recorder.Write(static_cast<uint32_t>(l_Pairs.size()));
+          for (const auto &i_Pair : l_Pairs) {
+            l_Recorder.Write(i_Pair.first);
+            l_Recorder.Write(i_Pair.second);
+          }
+
+          std::vector<uint64_t> l_Controllers;
+          l_Controllers.reserve(p_World->capsule_controllers.size());
+          for (const auto &i_Entry : p_World->capsule_controllers) {
+            l_Controllers.push_back(i_Entry.first);
+          }
+          std::sort(l_Controllers.begin(), l_Controllers.end());
+          l_Recorder.Write(
+              static_cast<uint32_t>(l_Controllers.size()));
+          for (uint64_t i_Id : l_Controllers) {
+            l_Recorder.Write(i_Id);
+            p_World->capsule_controllers[i_Id].controller->SaveState(
+                l_Recorder);
+          }
+        }
+
+        if (l_Recorder.IsFailed()) {
+          return false;
+        }
+        copy_recorder_data(l_Recorder, p_Data);
+        return true;
+      }
+
+      bool save_world_state(WorldBackend *p_World,
+                            Util::List<uint8_t> &p_Data,
+                            bool p_ActiveBodiesOnly)
+      {
+        LOW_PROFILE_CPU("Physics", "Save world state");
+        LOW_ASSERT(p_World,
+                   "Cannot save state of null physics world");
+
+        const ActiveBodyFilter l_Filter;
+        return save_state(p_World,
+                          p_ActiveBodiesOnly ? &l_Filter : nullptr,
+                          p_Data);
+      }
+
+      bool restore_world_state(WorldBackend *p_World,
+                               const Util::List<uint8_t> &p_Data)
+      {
+        LOW_PROFILE_CPU("Physics", "Restore world state");
+        LOW_ASSERT(p_World,
+                   "Cannot restore state of null physics world");
+
+        if (p_Data.empty()) {
+          return false;
+        }
+
+        JPH::StateRecorderImpl l_Recorder;
+        l_Recorder.WriteBytes(p_Data.data(), p_Data.size());
+        l_Recorder.Rewind();
+
+        uint32_t l_Magic = 0u;
+        uint32_t l_Version = 0u;
+        bool l_Delta = false;
+        l_Recorder.Read(l_Magic);
+        l_Recorder.Read(l_Version);
+        l_Recorder.Read(l_Delta);
+        if (l_Recorder.IsFailed() || l_Magic != g_WorldStateMagic ||
+            l_Version != g_WorldStateVersion) {
+          LOW_LOG_WARN << "Physics world state data is not valid"
+                       << LOW_LOG_END;
+          return false;
+        }
+
+        if (!p_World->physics_system.RestoreState(l_Recorder)) {
+          LOW_LOG_ERROR << "Could not restore physics world state, "
+                           "the bodies of the world changed"
+                        << LOW_LOG_END;
+          return false;
+        }
+
+        if (!l_Delta) {
+          l_Recorder.Read(p_World->accumulator);
+          l_Recorder.Read(p_World->character_frame);
+
+          uint32_t l_PairCount = 0u;
+          l_Recorder.Read(l_PairCount);
+          p_World->contact_pairs.clear();
+          for (uint32_t i = 0u; i < l_PairCount; ++i) {
+            uint64_t i_Key = 0u;
+            uint32_t i_Count = 0u;
+            l_Recorder.Read(i_Key);
+            l_Recorder.Read(i_Count);
+            p_World->contact_pairs[i_Key] = i_Count;
+          }
+
+          uint32_t l_ControllerCount = 0u;
+          l_Recorder.Read(l_ControllerCount);
+          for (uint32_t i = 0u; i < l_ControllerCount; ++i) {
+            uint64_t i_Id = 0u;
+            l_Recorder.Read(i_Id);
+            auto i_Controller =
+                p_World->capsule_controllers.find(i_Id);
+            if (i_Controller == p_World->capsule_controllers.end()) {
+              LOW_LOG_ERROR
+                  << "Could not restore physics world state, a "
+                     "capsule controller is missing"
+                  << LOW_LOG_END;
+              return false;
+            }
+            i_Controller->second.controller->RestoreState(l_Recorder);
+          }
+        }
+
+        // Restored bodies jump, blending them from their old place
+        // would show the jump in slow motion
+        p_World->previous_states.clear();
+        p_World->interpolation_alpha = 1.0f;
+        p_World->persisted_contacts.clear();
+        p_World->reported_pairs.clear();
+
+        return !l_Recorder.IsFailed();
+      }
+
+      uint64_t hash_world_state(WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot hash state of null physics world");
+
+        JPH::StateRecorderImpl l_Recorder;
+        p_World->physics_system.SaveState(
+            l_Recorder, JPH::EStateRecorderState::Bodies);
+        const std::string l_Bytes = l_Recorder.GetData();
+        return Util::fnv1a_64(l_Bytes.data(), l_Bytes.size());
+      }
+
+      void set_world_deterministic(WorldBackend *p_World,
+                                   bool p_Deterministic)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot change determinism of null physics world");
+
+        p_World->deterministic = p_Deterministic;
+        JPH::PhysicsSettings l_Settings =
+            p_World->physics_system.GetPhysicsSettings();
+        l_Settings.mDeterministicSimulation = p_Deterministic;
+        p_World->physics_system.SetPhysicsSettings(l_Settings);
+      }
+
+      static void record_step_input(WorldBackend *p_World)
+      {
+        RecordingFrame l_Frame;
+        if (!p_World->touched_bodies.empty()) {
+          const TouchedBodyFilter l_Filter(p_World->touched_bodies);
+          save_state(p_World, &l_Filter, l_Frame.input);
+          p_World->touched_bodies.clear();
+        }
+        p_World->active_recording.frames.push_back(l_Frame);
+      }
+
+      void begin_world_recording(WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World, "Cannot record null physics world");
+        LOW_ASSERT(!p_World->recording,
+                   "Physics world is already being recorded");
+
+        // Replays have to produce the same steps as the recording
+        set_world_deterministic(p_World, true);
+
+        Recording &l_Recording = p_World->active_recording;
+        l_Recording = Recording();
+        l_Recording.fixed_delta = p_World->fixed_delta;
+        l_Recording.collision_steps = p_World->collision_steps;
+        save_state(p_World, nullptr, l_Recording.initial_state);
+
+        p_World->touched_bodies.clear();
+        p_World->recording = true;
+      }
+
+      void end_world_recording(WorldBackend *p_World,
+                               Recording &p_Recording)
+      {
+        LOW_ASSERT(p_World, "Cannot record null physics world");
+        LOW_ASSERT(p_World->recording,
+                   "Physics world is not being recorded");
+
+        p_World->recording = false;
+        p_World->touched_bodies.clear();
+        p_Recording = std::move(p_World->active_recording);
+        p_World->active_recording = Recording();
+      }
+
+      bool replay_world_recording(WorldBackend *p_World,
+                                  const Recording &p_Recording,
+                                  ReplayResult &p_Result)
+      {
+        LOW_PROFILE_CPU("Physics", "Replay world recording");
+        LOW_ASSERT(p_World, "Cannot replay in null physics world");
+        LOW_ASSERT(!p_World->recording,
+                   "Cannot replay while recording the physics world");
+
+        p_Result = ReplayResult();
+
+        // The world gets put back the way it was once the replay is
+        // done
+        Util::List<uint8_t> l_CurrentState;
+        const bool l_WasDeterministic = p_World->deterministic;
+        if (!save_state(p_World, nullptr, l_CurrentState)) {
+          return false;
+        }
+        if (!restore_world_state(p_World,
+                                 p_Recording.initial_state)) {
+          return false;
+        }
+        set_world_deterministic(p_World, true);
+
+        const uint32_t l_FrameCount =
+            static_cast<uint32_t>(p_Recording.frames.size());
+        p_Result.first_mismatch = l_FrameCount;
+        p_Result.matched = true;
+
+        for (uint32_t i = 0u; i < l_FrameCount; ++i) {
+          const RecordingFrame &i_Frame = p_Recording.frames[i];
+          if (!i_Frame.input.empty() &&
+              !restore_world_state(p_World, i_Frame.input)) {
+            p_Result.matched = false;
+            p_Result.first_mismatch = i;
+            break;
+          }
+
+          const auto i_Start = std::chrono::steady_clock::now();
+          p_World->physics_system.Update(
+              p_Recording.fixed_delta,
+              (int)p_Recording.collision_steps,
+              &p_World->temp_allocator, &p_World->job_system);
+          const double i_StepMs =
+              std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - i_Start)
+                  .count();
+
+          // Contacts of the replay are not reported
+          p_World->contact_recorder.drain([](const RawContact &) {});
+
+          p_Result.total_step_ms += i_StepMs;
+          p_Result.max_step_ms =
+              std::max(p_Result.max_step_ms, i_StepMs);
+          p_Result.simulated_frames++;
+
+          if (p_Result.matched &&
+              hash_world_state(p_World) != i_Frame.hash) {
+            p_Result.matched = false;
+            p_Result.first_mismatch = i;
+          }
+        }
+
+        restore_world_state(p_World, l_CurrentState);
+        set_world_deterministic(p_World, l_WasDeterministic);
+
+        LOW_PROFILE_COUNTER("Physics", "Replay step avg (ms)",
+                            p_Result.simulated_frames
+                                ? p_Result.total_step_ms /
+                                      p_Result.simulated_frames
+                                : 0.0);
+        LOW_PROFILE_COUNTER("Physics", "Replay step max (ms)",
+                            p_Result.max_step_ms);
+
+        return p_Result.matched;
+      }
+
+      WorldBackend *create_world_backend(
+          const CollisionLayerSettings &p_CollisionLayers)
       {
         initialize_jolt_runtime();
-        return new WorldBackend();
+        return new WorldBackend(p_CollisionLayers);
       }
 
       void destroy_world_backend(WorldBackend *p_World)
@@ -465,11 +2066,14 @@ namespace Low {
         JPH::BodyInterface &l_BodyInterface =
             p_World->physics_system.GetBodyInterface();
         p_World->capsule_controllers.clear();
-        for (auto &i_Body : p_World->bodies) {
-          l_BodyInterface.RemoveBody(i_Body.second);
-          l_BodyInterface.DestroyBody(i_Body.second);
-        }
+        p_World->bodies.for_each([&](const JPH::BodyID &i_BodyId) {
+          if (l_BodyInterface.IsAdded(i_BodyId)) {
+            l_BodyInterface.RemoveBody(i_BodyId);
+          }
+          l_BodyInterface.DestroyBody(i_BodyId);
+        });
         p_World->bodies.clear();
+        p_World->body_entries.clear();
         p_World->shapes.clear();
 
         delete p_World;
@@ -480,10 +2084,67 @@ namespace Low {
       {
         LOW_ASSERT(p_World, "Cannot simulate null physics world");
 
-        constexpr int l_CollisionSteps = 1;
-        p_World->physics_system.Update(p_Delta, l_CollisionSteps,
-                                       &p_World->temp_allocator,
-                                       &p_World->job_system);
+        if (p_World->optimize_broad_phase) {
+          p_World->physics_system.OptimizeBroadPhase();
+          p_World->optimize_broad_phase = false;
+        }
+
+        // Clamping the accumulated time keeps a long frame from
+        // dragging the next frames down as well
+        const float l_MaxTime =
+            p_World->fixed_delta * (float)p_World->max_steps;
+        p_World->accumulator =
+            std::min(p_World->accumulator + p_Delta, l_MaxTime);
+
+        const uint32_t l_Steps = (uint32_t)(p_World->accumulator /
+                                            p_World->fixed_delta);
+
+        p_World->contact_events.clear();
+        p_World->trigger_events.clear();
+        p_World->sleep_recorder.clear();
+
+        // Has to happen before the step so that contacts of destroyed
+        // bodies do not report an end
+        flush_forgotten_contacts(p_World);
+
+        for (uint32_t i = 0u; i < l_Steps; ++i) {
+          if (i == l_Steps - 1u) {
+            store_previous_body_states(p_World);
+          }
+          if (p_World->recording) {
+            record_step_input(p_World);
+          }
+          p_World->physics_system.Update(
+              p_World->fixed_delta, (int)p_World->collision_steps,
+              &p_World->temp_allocator, &p_World->job_system);
+          collect_contacts(p_World);
+          if (p_World->recording) {
+            p_World->active_recording.frames.back().hash =
+                hash_world_state(p_World);
+          }
+        }
+        flush_persisted_contacts(p_World);
+
+        p_World->accumulator -=
+            (float)l_Steps * p_World->fixed_delta;
+        p_World->interpolation_alpha =
+            glm::clamp(p_World->accumulator / p_World->fixed_delta,
+                       0.0f, 1.0f);
+      }
+
+      void set_world_step_settings(WorldBackend *p_World,
+                                   float p_FixedDelta,
+                                   uint32_t p_CollisionSteps,
+                                   uint32_t p_MaxSteps)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot set step settings on null physics world");
+        LOW_ASSERT(p_FixedDelta > 0.0f,
+                   "Fixed physics delta has to be positive");
+
+        p_World->fixed_delta = p_FixedDelta;
+        p_World->collision_steps = std::max(p_CollisionSteps, 1u);
+        p_World->max_steps = std::max(p_MaxSteps, 1u);
       }
 
       void set_world_gravity(WorldBackend *p_World,
@@ -539,49 +2200,197 @@ namespace Low {
           return ShapeBackendHandle();
         }
 
-        LOW_ASSERT(l_Shape != nullptr,
-                   "Could not create Jolt physics shape");
-
+        LOW_ASSERT(l_Shape != nullptr,
+                   "Could not create Jolt physics shape");
+
+        ShapeBackendHandle l_Handle;
+        l_Handle.id = p_World->shapes.insert(l_Shape);
+        return l_Handle;
+      }
+
+      ShapeBackendHandle
+      create_convex_hull_shape(WorldBackend *p_World,
+                               const Math::Vector3 *p_Points,
+                               uint32_t p_PointCount)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot create shape in null physics world");
+        LOW_ASSERT(p_Points && p_PointCount >= 4,
+                   "Convex hull requires at least 4 points");
+
+        JPH::Array<JPH::Vec3> l_JoltPoints;
+        l_JoltPoints.reserve(p_PointCount);
+        for (uint32_t i = 0; i < p_PointCount; ++i) {
+          l_JoltPoints.push_back(to_jolt(p_Points[i]));
+        }
+
+        JPH::ConvexHullShapeSettings l_Settings(
+            l_JoltPoints.data(), (int)l_JoltPoints.size());
+        JPH::Shape::ShapeResult l_Result = l_Settings.Create();
+        LOW_ASSERT(l_Result.IsValid(),
+                   "Could not create Jolt convex hull shape");
+
+        ShapeBackendHandle l_Handle;
+        l_Handle.id = p_World->shapes.insert(l_Result.Get());
+        return l_Handle;
+      }
+
+      ShapeBackendHandle create_convex_hull_shape(
+          WorldBackend *p_World,
+          const Low::Util::List<Math::Vector3> &p_Points)
+      {
+        return create_convex_hull_shape(p_World, p_Points.data(),
+                                        (uint32_t)p_Points.size());
+      }
+
+      ShapeBackendHandle create_mesh_shape(
+          WorldBackend *p_World, const Math::Vector3 *p_Vertices,
+          uint32_t p_VertexCount, const uint32_t *p_Indices,
+          uint32_t p_IndexCount)
+      {
+        LOW_PROFILE_CPU("Physics", "Create mesh shape");
+        LOW_ASSERT(p_World,
+                   "Cannot create shape in null physics world");
+        LOW_ASSERT(p_Vertices && p_VertexCount >= 3u,
+                   "Mesh shape requires at least 3 vertices");
+        LOW_ASSERT(p_Indices && p_IndexCount >= 3u &&
+                       (p_IndexCount % 3u) == 0u,
+                   "Mesh shape requires whole triangles");
+
+        JPH::VertexList l_Vertices;
+        l_Vertices.reserve(p_VertexCount);
+        for (uint32_t i = 0u; i < p_VertexCount; ++i) {
+          l_Vertices.push_back(JPH::Float3(
+              p_Vertices[i].x, p_Vertices[i].y, p_Vertices[i].z));
+        }
+
+        JPH::IndexedTriangleList l_Triangles;
+        l_Triangles.reserve(p_IndexCount / 3u);
+        for (uint32_t i = 0u; i < p_IndexCount; i += 3u) {
+          LOW_ASSERT(p_Indices[i] < p_VertexCount &&
+                         p_Indices[i + 1u] < p_VertexCount &&
+                         p_Indices[i + 2u] < p_VertexCount,
+                     "Mesh shape index out of range");
+          l_Triangles.push_back(JPH::IndexedTriangle(
+              p_Indices[i], p_Indices[i + 1u], p_Indices[i + 2u]));
+        }
+
+        JPH::MeshShapeSettings l_Settings(std::move(l_Vertices),
+                                          std::move(l_Triangles));
+        JPH::Shape::ShapeResult l_Result = l_Settings.Create();
+        if (!l_Result.IsValid()) {
+          LOW_LOG_ERROR << "Could not create Jolt mesh shape: "
+                        << l_Result.GetError().c_str() << LOW_LOG_END;
+          return ShapeBackendHandle();
+        }
+
+        ShapeBackendHandle l_Handle;
+        l_Handle.id = p_World->shapes.insert(l_Result.Get());
+        return l_Handle;
+      }
+
+      ShapeBackendHandle create_height_field_shape(
+          WorldBackend *p_World, const float *p_Samples,
+          uint32_t p_SampleCount, const Math::Vector3 &p_Offset,
+          const Math::Vector3 &p_Scale)
+      {
+        LOW_PROFILE_CPU("Physics", "Create height field shape");
+        LOW_ASSERT(p_World,
+                   "Cannot create shape in null physics world");
+        LOW_ASSERT(p_Samples && p_SampleCount >= 2u,
+                   "Height field requires at least 2x2 samples");
+
+        JPH::HeightFieldShapeSettings l_Settings(
+            p_Samples, to_jolt(p_Offset), to_jolt(p_Scale),
+            p_SampleCount);
+        JPH::Shape::ShapeResult l_Result = l_Settings.Create();
+        if (!l_Result.IsValid()) {
+          LOW_LOG_ERROR << "Could not create Jolt height field "
+                        << "shape: " << l_Result.GetError().c_str()
+                        << LOW_LOG_END;
+          return ShapeBackendHandle();
+        }
+
         ShapeBackendHandle l_Handle;
-        l_Handle.id = p_World->next_shape_id++;
-        p_World->shapes[l_Handle.id] = l_Shape;
+        l_Handle.id = p_World->shapes.insert(l_Result.Get());
         return l_Handle;
       }
 
-      ShapeBackendHandle
-      create_convex_hull_shape(WorldBackend *p_World,
-                               const Math::Vector3 *p_Points,
-                               uint32_t p_PointCount)
+      // Jolt does not guarantee a stable binary layout between
+      // versions, bump the version when updating the library so
+      // stale cooked data gets rebuilt instead of misread
+      static const uint32_t g_CookedShapeMagic = 0x4353504Cu; // LPSC
+      static const uint32_t g_CookedShapeVersion = 1u;
+
+      bool cook_shape(WorldBackend *p_World,
+                      ShapeBackendHandle p_Shape,
+                      Low::Util::List<uint8_t> &p_Data)
       {
+        LOW_PROFILE_CPU("Physics", "Cook shape");
         LOW_ASSERT(p_World,
-                   "Cannot create shape in null physics world");
-        LOW_ASSERT(p_Points && p_PointCount >= 4,
-                   "Convex hull requires at least 4 points");
+                   "Cannot cook shape in null physics world");
 
-        JPH::Array<JPH::Vec3> l_JoltPoints;
-        l_JoltPoints.reserve(p_PointCount);
-        for (uint32_t i = 0; i < p_PointCount; ++i) {
-          l_JoltPoints.push_back(to_jolt(p_Points[i]));
-        }
+        JPH::ShapeRefC *l_Shape = p_World->shapes.find(p_Shape.id);
+        LOW_ASSERT(l_Shape, "Unknown physics shape handle");
 
-        JPH::ConvexHullShapeSettings l_Settings(
-            l_JoltPoints.data(), (int)l_JoltPoints.size());
-        JPH::Shape::ShapeResult l_Result = l_Settings.Create();
-        LOW_ASSERT(l_Result.IsValid(),
-                   "Could not create Jolt convex hull shape");
+        std::stringstream l_Stream;
+        JPH::StreamOutWrapper l_Out(l_Stream);
+        l_Out.Write(g_CookedShapeMagic);
+        l_Out.Write(g_CookedShapeVersion);
 
-        ShapeBackendHandle l_Handle;
-        l_Handle.id = p_World->next_shape_id++;
-        p_World->shapes[l_Handle.id] = l_Result.Get();
-        return l_Handle;
+        JPH::Shape::ShapeToIDMap l_ShapeMap;
+        JPH::Shape::MaterialToIDMap l_MaterialMap;
+        (*l_Shape)->SaveWithChildren(l_Out, l_ShapeMap,
+                                     l_MaterialMap);
+        if (l_Out.IsFailed()) {
+          return false;
+        }
+
+        const std::string l_Bytes = l_Stream.str();
+        p_Data.resize(l_Bytes.size());
+        memcpy(p_Data.data(), l_Bytes.data(), l_Bytes.size());
+        return true;
       }
 
-      ShapeBackendHandle create_convex_hull_shape(
-          WorldBackend *p_World,
-          const Low::Util::List<Math::Vector3> &p_Points)
+      ShapeBackendHandle create_cooked_shape(WorldBackend *p_World,
+                                             const uint8_t *p_Data,
+                                             uint32_t p_Size)
       {
-        return create_convex_hull_shape(p_World, p_Points.data(),
-                                        (uint32_t)p_Points.size());
+        LOW_PROFILE_CPU("Physics", "Restore cooked shape");
+        LOW_ASSERT(p_World,
+                   "Cannot create shape in null physics world");
+        LOW_ASSERT(p_Data && p_Size > 0u,
+                   "Cannot restore shape from empty data");
+
+        std::stringstream l_Stream(std::string(
+            reinterpret_cast<const char *>(p_Data), p_Size));
+        JPH::StreamInWrapper l_In(l_Stream);
+
+        uint32_t l_Magic = 0u;
+        uint32_t l_Version = 0u;
+        l_In.Read(l_Magic);
+        l_In.Read(l_Version);
+        if (l_In.IsFailed() || l_Magic != g_CookedShapeMagic ||
+            l_Version != g_CookedShapeVersion) {
+          LOW_LOG_WARN << "Cooked physics shape data is outdated"
+                       << LOW_LOG_END;
+          return ShapeBackendHandle();
+        }
+
+        JPH::Shape::IDToShapeMap l_ShapeMap;
+        JPH::Shape::IDToMaterialMap l_MaterialMap;
+        JPH::Shape::ShapeResult l_Result =
+            JPH::Shape::sRestoreWithChildren(l_In, l_ShapeMap,
+                                             l_MaterialMap);
+        if (!l_Result.IsValid()) {
+          LOW_LOG_ERROR << "Could not restore cooked physics shape: "
+                        << l_Result.GetError().c_str() << LOW_LOG_END;
+          return ShapeBackendHandle();
+        }
+
+        ShapeBackendHandle l_Handle;
+        l_Handle.id = p_World->shapes.insert(l_Result.Get());
+        return l_Handle;
       }
 
       void visualize_convex_hull(WorldBackend *p_World,
@@ -595,16 +2404,15 @@ namespace Low {
         LOW_ASSERT(p_World,
                    "Cannot visualize shape in null physics world");
 
-        auto l_ShapeIt = p_World->shapes.find(p_Shape.id);
-        LOW_ASSERT(l_ShapeIt != p_World->shapes.end(),
-                   "Unknown physics shape handle");
-        LOW_ASSERT(l_ShapeIt->second->GetSubType() ==
+        JPH::ShapeRefC *l_Shape = p_World->shapes.find(p_Shape.id);
+        LOW_ASSERT(l_Shape, "Unknown physics shape handle");
+        LOW_ASSERT((*l_Shape)->GetSubType() ==
                        JPH::EShapeSubType::ConvexHull,
                    "Physics shape is not a convex hull");
 
         const JPH::ConvexHullShape *l_Hull =
             static_cast<const JPH::ConvexHullShape *>(
-                l_ShapeIt->second.GetPtr());
+                l_Shape->GetPtr());
         const Math::Vector3 l_CenterOfMass =
             from_jolt(l_Hull->GetCenterOfMass());
 
@@ -681,13 +2489,19 @@ namespace Low {
         LOW_ASSERT(p_CreateInfo.shape.is_valid(),
                    "Cannot create body without a valid shape");
 
-        auto l_ShapeIt = p_World->shapes.find(p_CreateInfo.shape.id);
-        LOW_ASSERT(l_ShapeIt != p_World->shapes.end(),
-                   "Unknown physics shape handle");
+        JPH::ShapeRefC *l_Shape =
+            p_World->shapes.find(p_CreateInfo.shape.id);
+        LOW_ASSERT(l_Shape, "Unknown physics shape handle");
+
+        const JPH::EShapeSubType l_SubType = (*l_Shape)->GetSubType();
+        LOW_ASSERT(p_CreateInfo.motion_type !=
+                           BodyMotionType::DYNAMIC ||
+                       (l_SubType != JPH::EShapeSubType::Mesh &&
+                        l_SubType != JPH::EShapeSubType::HeightField),
+                   "Mesh and height field shapes cannot be dynamic");
 
         JPH::BodyCreationSettings l_Settings(
-            l_ShapeIt->second,
-            to_jolt_position(p_CreateInfo.position),
+            *l_Shape, to_jolt_position(p_CreateInfo.position),
             to_jolt(p_CreateInfo.rotation),
             to_jolt(p_CreateInfo.motion_type),
             get_layer_for_motion_type(p_CreateInfo.motion_type));
@@ -698,21 +2512,49 @@ namespace Low {
             p_CreateInfo.gravity ? 1.0f : 0.0f;
         l_Settings.mUserData =
             reinterpret_cast<uint64_t>(p_CreateInfo.user_data);
+        l_Settings.mIsSensor = p_CreateInfo.sensor;
 
         const JPH::EActivation l_Activation =
             p_CreateInfo.motion_type == BodyMotionType::DYNAMIC
                 ? JPH::EActivation::Activate
                 : JPH::EActivation::DontActivate;
 
-        JPH::BodyID l_BodyId =
-            p_World->physics_system.GetBodyInterface()
-                .CreateAndAddBody(l_Settings, l_Activation);
+        JPH::BodyInterface &l_BodyInterface =
+            p_World->physics_system.GetBodyInterface();
+
+        JPH::BodyID l_BodyId;
+        if (p_World->body_batch_depth > 0u) {
+          JPH::Body *l_Body = l_BodyInterface.CreateBody(l_Settings);
+          LOW_ASSERT(l_Body, "Could not create Jolt physics body");
+          l_BodyId = l_Body->GetID();
+          p_World->batched_body_ids.insert(
+              l_BodyId.GetIndexAndSequenceNumber());
+
+          if (l_Activation == JPH::EActivation::Activate) {
+            p_World->batched_active_bodies.push_back(l_BodyId);
+          } else {
+            p_World->batched_bodies.push_back(l_BodyId);
+          }
+        } else {
+          l_BodyId = l_BodyInterface.CreateAndAddBody(l_Settings,
+                                                      l_Activation);
+        }
         LOW_ASSERT(!l_BodyId.IsInvalid(),
                    "Could not create Jolt physics body");
 
         BodyBackendHandle l_Handle;
-        l_Handle.id = p_World->next_body_id++;
-        p_World->bodies[l_Handle.id] = l_BodyId;
+        l_Handle.id = p_World->bodies.insert(l_BodyId);
+
+        const uint32_t l_Index = l_BodyId.GetIndex();
+        if (l_Index >= p_World->body_entries.size()) {
+          p_World->body_entries.resize(l_Index + 1u);
+        }
+        BodyEntry &l_Entry = p_World->body_entries[l_Index];
+        l_Entry.body_id = l_BodyId;
+        l_Entry.id = l_Handle.id;
+        l_Entry.user_data = p_CreateInfo.user_data;
+        l_Entry.sensor = p_CreateInfo.sensor;
+        l_Entry.contact_events = p_CreateInfo.contact_events;
         return l_Handle;
       }
 
@@ -725,16 +2567,259 @@ namespace Low {
           return;
         }
 
-        auto l_BodyIt = p_World->bodies.find(p_Body.id);
-        if (l_BodyIt == p_World->bodies.end()) {
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        if (!l_BodyId) {
+          return;
+        }
+
+        JPH::BodyInterface &l_BodyInterface =
+            p_World->physics_system.GetBodyInterface();
+        remove_batched_body(p_World, *l_BodyId);
+        if (p_World->body_batch_depth > 0u) {
+          p_World->batched_destroyed_bodies.push_back(*l_BodyId);
+        } else {
+          if (l_BodyInterface.IsAdded(*l_BodyId)) {
+            l_BodyInterface.RemoveBody(*l_BodyId);
+          }
+          l_BodyInterface.DestroyBody(*l_BodyId);
+        }
+        forget_body_contacts(p_World, *l_BodyId);
+        p_World->body_entries[l_BodyId->GetIndex()] = BodyEntry();
+        p_World->bodies.erase(p_Body.id);
+      }
+
+      // Bodies that were created in the same batch never got added,
+      // all others are taken out of the broad phase together first.
+      // RemoveBodies deactivates the active ones on the way.
+      static void destroy_batched_bodies(WorldBackend *p_World)
+      {
+        JPH::Array<JPH::BodyID> &l_Bodies =
+            p_World->batched_destroyed_bodies;
+        if (l_Bodies.empty()) {
+          return;
+        }
+
+        JPH::BodyInterface &l_BodyInterface =
+            p_World->physics_system.GetBodyInterface();
+
+        auto l_AddedEnd = std::partition(
+            l_Bodies.begin(), l_Bodies.end(),
+            [&l_BodyInterface](const JPH::BodyID &p_BodyId) {
+              return l_BodyInterface.IsAdded(p_BodyId);
+            });
+        const int l_AddedCount =
+            static_cast<int>(l_AddedEnd - l_Bodies.begin());
+        if (l_AddedCount > 0) {
+          l_BodyInterface.RemoveBodies(l_Bodies.data(), l_AddedCount);
+        }
+        l_BodyInterface.DestroyBodies(
+            l_Bodies.data(), static_cast<int>(l_Bodies.size()));
+        l_Bodies.clear();
+      }
+
+      void begin_body_batch(WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot begin body batch in null physics world");
+        p_World->body_batch_depth++;
+      }
+
+      void end_body_batch(WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot end body batch in null physics world");
+        LOW_ASSERT(p_World->body_batch_depth > 0u,
+                   "No body batch has been started");
+
+        if (--p_World->body_batch_depth > 0u) {
+          return;
+        }
+
+        add_batched_bodies(p_World, p_World->batched_bodies,
+                           JPH::EActivation::DontActivate);
+        add_batched_bodies(p_World, p_World->batched_active_bodies,
+                           JPH::EActivation::Activate);
+        p_World->batched_body_ids.clear();
+
+        destroy_batched_bodies(p_World);
+      }
+
+      void set_body_enabled(WorldBackend *p_World,
+                            BodyBackendHandle p_Body, bool p_Enabled)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot enable body in null physics world");
+
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
+
+        // Bodies that are still waiting in a batch get added when
+        // the batch ends, disabling just takes them out of it
+        if (is_batched_body(p_World, *l_BodyId)) {
+          if (!p_Enabled) {
+            remove_batched_body(p_World, *l_BodyId);
+          }
           return;
         }
 
         JPH::BodyInterface &l_BodyInterface =
             p_World->physics_system.GetBodyInterface();
-        l_BodyInterface.RemoveBody(l_BodyIt->second);
-        l_BodyInterface.DestroyBody(l_BodyIt->second);
-        p_World->bodies.erase(l_BodyIt);
+        const bool l_Added =
+            l_BodyInterface.IsAdded(*l_BodyId);
+
+        if (p_Enabled && !l_Added) {
+          l_BodyInterface.AddBody(*l_BodyId,
+                                  JPH::EActivation::Activate);
+        } else if (!p_Enabled && l_Added) {
+          l_BodyInterface.RemoveBody(*l_BodyId);
+        }
+      }
+
+      void get_active_bodies(WorldBackend *p_World,
+                             Util::List<Util::Handle> &p_Bodies)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot get active bodies of null physics world");
+
+        JPH::BodyIDVector &l_BodyIds = p_World->body_id_scratch;
+        p_World->physics_system.GetActiveBodies(
+            JPH::EBodyType::RigidBody, l_BodyIds);
+
+        // A body can fall asleep and get woken up again in the same
+        // frame, it only gets reported once
+        const size_t l_ActiveCount = l_BodyIds.size();
+        for (const JPH::BodyID &i_BodyId :
+             p_World->sleep_recorder.get_bodies()) {
+          l_BodyIds.push_back(i_BodyId);
+        }
+        if (l_BodyIds.size() > l_ActiveCount) {
+          std::sort(l_BodyIds.begin(), l_BodyIds.end());
+          l_BodyIds.erase(
+              std::unique(l_BodyIds.begin(), l_BodyIds.end()),
+              l_BodyIds.end());
+        }
+
+        p_Bodies.reserve(p_Bodies.size() + l_BodyIds.size());
+        for (const JPH::BodyID &i_BodyId : l_BodyIds) {
+          const Util::Handle i_Handle =
+              get_body_handle(p_World, i_BodyId);
+          if (i_Handle.get_id() != 0u) {
+            p_Bodies.push_back(i_Handle);
+          }
+        }
+      }
+
+      void set_bodies_frozen(WorldBackend *p_World,
+                             const BodyBackendHandle *p_Bodies,
+                             uint32_t p_Count, bool p_Frozen)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot freeze bodies of null physics world");
+
+        JPH::BodyInterface &l_BodyInterface =
+            p_World->physics_system.GetBodyInterface();
+
+        // Bodies that are batched or disabled are not part of the
+        // simulation and have nothing to freeze
+        JPH::BodyIDVector &l_BodyIds = p_World->body_id_scratch;
+        l_BodyIds.clear();
+        for (uint32_t i = 0u; i < p_Count; ++i) {
+          JPH::BodyID *i_BodyId =
+              p_World->bodies.find(p_Bodies[i].id);
+          if (i_BodyId && !is_batched_body(p_World, *i_BodyId) &&
+              l_BodyInterface.IsAdded(*i_BodyId) &&
+              l_BodyInterface.GetMotionType(*i_BodyId) !=
+                  JPH::EMotionType::Static) {
+            l_BodyIds.push_back(*i_BodyId);
+          }
+        }
+
+        if (l_BodyIds.empty()) {
+          return;
+        }
+        if (p_Frozen) {
+          l_BodyInterface.DeactivateBodies(l_BodyIds.data(),
+                                           (int)l_BodyIds.size());
+        } else {
+          l_BodyInterface.ActivateBodies(l_BodyIds.data(),
+                                         (int)l_BodyIds.size());
+        }
+      }
+
+      void set_body_layer(WorldBackend *p_World,
+                          BodyBackendHandle p_Body, uint32_t p_Layer)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot change body layer in null physics world");
+        LOW_ASSERT(p_Layer < p_World->collision_layers.layer_count,
+                   "Unknown collision layer");
+
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
+
+        p_World->physics_system.GetBodyInterface().SetObjectLayer(
+            *l_BodyId, static_cast<JPH::ObjectLayer>(p_Layer));
+      }
+
+      uint32_t get_body_layer(WorldBackend *p_World,
+                              BodyBackendHandle p_Body)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot get body layer in null physics world");
+
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
+
+        return p_World->physics_system.GetBodyInterface()
+            .GetObjectLayer(*l_BodyId);
+      }
+
+      void set_body_sensor(WorldBackend *p_World,
+                           BodyBackendHandle p_Body, bool p_Sensor)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot change sensor in null physics world");
+
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
+
+        JPH::BodyLockWrite l_Lock(
+            p_World->physics_system.GetBodyLockInterface(),
+            *l_BodyId);
+        if (l_Lock.Succeeded()) {
+          l_Lock.GetBody().SetIsSensor(p_Sensor);
+        }
+        p_World->body_entries[l_BodyId->GetIndex()].sensor = p_Sensor;
+      }
+
+      void set_body_contact_events(WorldBackend *p_World,
+                                   BodyBackendHandle p_Body,
+                                   bool p_Enabled)
+      {
+        LOW_ASSERT(p_World, "Cannot change contact events in null "
+                            "physics world");
+
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
+
+        p_World->body_entries[l_BodyId->GetIndex()].contact_events =
+            p_Enabled;
+      }
+
+      const Util::List<ContactEvent> &
+      get_contact_events(WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot get contact events of null physics world");
+        return p_World->contact_events;
+      }
+
+      const Util::List<TriggerEvent> &
+      get_trigger_events(WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot get trigger events of null physics world");
+        return p_World->trigger_events;
       }
 
       void set_body_transform(WorldBackend *p_World,
@@ -745,14 +2830,50 @@ namespace Low {
         LOW_ASSERT(p_World,
                    "Cannot set transform in null physics world");
 
-        auto l_BodyIt = p_World->bodies.find(p_Body.id);
-        LOW_ASSERT(l_BodyIt != p_World->bodies.end(),
-                   "Unknown physics body handle");
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
 
+        mark_body_touched(p_World, *l_BodyId);
         p_World->physics_system.GetBodyInterface()
             .SetPositionAndRotation(
-                l_BodyIt->second, to_jolt_position(p_Position),
+                *l_BodyId, to_jolt_position(p_Position),
                 to_jolt(p_Rotation), JPH::EActivation::Activate);
+
+        // Teleported bodies should not be blended back towards where
+        // they came from
+        p_World->previous_states.erase(
+            l_BodyId->GetIndexAndSequenceNumber());
+      }
+
+      void get_body_interpolated_transform(
+          WorldBackend *p_World, BodyBackendHandle p_Body,
+          Math::Vector3 &p_Position, Math::Quaternion &p_Rotation)
+      {
+        LOW_ASSERT(p_World, "Cannot get interpolated transform in "
+                            "null physics world");
+
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
+
+        JPH::RVec3 l_Position;
+        JPH::Quat l_Rotation;
+        p_World->physics_system.GetBodyInterface()
+            .GetPositionAndRotation(*l_BodyId, l_Position,
+                                    l_Rotation);
+        p_Position = from_jolt_position(l_Position);
+        p_Rotation = from_jolt(l_Rotation);
+
+        auto l_StateIt = p_World->previous_states.find(
+            l_BodyId->GetIndexAndSequenceNumber());
+        if (l_StateIt == p_World->previous_states.end()) {
+          return;
+        }
+
+        const float l_Alpha = p_World->interpolation_alpha;
+        p_Position =
+            glm::mix(l_StateIt->second.position, p_Position, l_Alpha);
+        p_Rotation = glm::slerp(l_StateIt->second.rotation,
+                                p_Rotation, l_Alpha);
       }
 
       Math::Vector3 get_body_position(WorldBackend *p_World,
@@ -761,13 +2882,12 @@ namespace Low {
         LOW_ASSERT(p_World,
                    "Cannot get body position in null physics world");
 
-        auto l_BodyIt = p_World->bodies.find(p_Body.id);
-        LOW_ASSERT(l_BodyIt != p_World->bodies.end(),
-                   "Unknown physics body handle");
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
 
         return from_jolt_position(
             p_World->physics_system.GetBodyInterface().GetPosition(
-                l_BodyIt->second));
+                *l_BodyId));
       }
 
       Math::Quaternion get_body_rotation(WorldBackend *p_World,
@@ -776,13 +2896,12 @@ namespace Low {
         LOW_ASSERT(p_World,
                    "Cannot get body rotation in null physics world");
 
-        auto l_BodyIt = p_World->bodies.find(p_Body.id);
-        LOW_ASSERT(l_BodyIt != p_World->bodies.end(),
-                   "Unknown physics body handle");
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
 
         return from_jolt(
             p_World->physics_system.GetBodyInterface().GetRotation(
-                l_BodyIt->second));
+                *l_BodyId));
       }
 
       void set_body_linear_velocity(WorldBackend *p_World,
@@ -793,12 +2912,12 @@ namespace Low {
             p_World,
             "Cannot set body linear velocity in null physics world");
 
-        auto l_BodyIt = p_World->bodies.find(p_Body.id);
-        LOW_ASSERT(l_BodyIt != p_World->bodies.end(),
-                   "Unknown physics body handle");
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
 
+        mark_body_touched(p_World, *l_BodyId);
         p_World->physics_system.GetBodyInterface().SetLinearVelocity(
-            l_BodyIt->second, to_jolt(p_Velocity));
+            *l_BodyId, to_jolt(p_Velocity));
       }
 
       Math::Vector3 get_body_linear_velocity(WorldBackend *p_World,
@@ -808,12 +2927,11 @@ namespace Low {
             p_World,
             "Cannot get body linear velocity in null physics world");
 
-        auto l_BodyIt = p_World->bodies.find(p_Body.id);
-        LOW_ASSERT(l_BodyIt != p_World->bodies.end(),
-                   "Unknown physics body handle");
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
 
         return from_jolt(p_World->physics_system.GetBodyInterface()
-                             .GetLinearVelocity(l_BodyIt->second));
+                             .GetLinearVelocity(*l_BodyId));
       }
 
       void set_body_angular_velocity(WorldBackend *p_World,
@@ -824,12 +2942,12 @@ namespace Low {
             p_World,
             "Cannot set body angular velocity in null physics world");
 
-        auto l_BodyIt = p_World->bodies.find(p_Body.id);
-        LOW_ASSERT(l_BodyIt != p_World->bodies.end(),
-                   "Unknown physics body handle");
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
 
+        mark_body_touched(p_World, *l_BodyId);
         p_World->physics_system.GetBodyInterface().SetAngularVelocity(
-            l_BodyIt->second, to_jolt(p_Velocity));
+            *l_BodyId, to_jolt(p_Velocity));
       }
 
       Math::Vector3
@@ -840,18 +2958,18 @@ namespace Low {
             p_World,
             "Cannot get body angular velocity in null physics world");
 
-        auto l_BodyIt = p_World->bodies.find(p_Body.id);
-        LOW_ASSERT(l_BodyIt != p_World->bodies.end(),
-                   "Unknown physics body handle");
+        JPH::BodyID *l_BodyId = p_World->bodies.find(p_Body.id);
+        LOW_ASSERT(l_BodyId, "Unknown physics body handle");
 
         return from_jolt(p_World->physics_system.GetBodyInterface()
-                             .GetAngularVelocity(l_BodyIt->second));
+                             .GetAngularVelocity(*l_BodyId));
       }
 
       bool raycast_world(WorldBackend *p_World,
                          const Math::Vector3 &p_Origin,
                          const Math::Vector3 &p_Direction,
-                         float p_MaxDistance, BackendQueryHit &p_Hit)
+                         float p_MaxDistance, uint32_t p_LayerMask,
+                         BackendQueryHit &p_Hit)
       {
         LOW_ASSERT(p_World, "Cannot raycast in null physics world");
 
@@ -866,9 +2984,13 @@ namespace Low {
             to_jolt((p_Direction / l_DirectionLength) *
                     p_MaxDistance));
 
+        const QueryBroadPhaseFilter l_BroadPhaseFilter(
+            p_World->collision_layers.get_group_mask(p_LayerMask));
+        const QueryLayerFilter l_LayerFilter(p_LayerMask);
+
         JPH::RayCastResult l_Result;
         if (!p_World->physics_system.GetNarrowPhaseQuery().CastRay(
-                l_Ray, l_Result)) {
+                l_Ray, l_Result, l_BroadPhaseFilter, l_LayerFilter)) {
           return false;
         }
 
@@ -905,24 +3027,165 @@ namespace Low {
 
       bool overlap_sphere_world(WorldBackend *p_World,
                                 const Math::Vector3 &p_Position,
-                                float p_Radius, BackendQueryHit *p_Hit)
+                                float p_Radius, uint32_t p_LayerMask,
+                                BackendQueryHit *p_Hit)
       {
         JPH::ShapeRefC l_Shape = create_sphere_query_shape(p_Radius);
         return overlap_query_shape(
             p_World, l_Shape.GetPtr(), p_Position,
-            Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f), p_Hit);
+            Math::Quaternion(1.0f, 0.0f, 0.0f, 0.0f), p_LayerMask,
+            p_Hit);
       }
 
       bool overlap_box_world(WorldBackend *p_World,
                              const Math::Vector3 &p_Position,
                              const Math::Vector3 &p_HalfExtents,
                              const Math::Quaternion &p_Rotation,
+                             uint32_t p_LayerMask,
                              BackendQueryHit *p_Hit)
       {
         JPH::ShapeRefC l_Shape =
             create_box_query_shape(p_HalfExtents);
         return overlap_query_shape(p_World, l_Shape.GetPtr(),
-                                   p_Position, p_Rotation, p_Hit);
+                                   p_Position, p_Rotation,
+                                   p_LayerMask, p_Hit);
+      }
+
+      void raycast_world_batch(
+          WorldBackend *p_World, const RaycastRequest *p_Requests,
+          uint32_t p_Count, QueryMode p_Mode, uint32_t p_MaxHits,
+          Util::List<QueryResult> &p_Results,
+          Util::List<BackendQueryHit> &p_Hits)
+      {
+        LOW_ASSERT(p_World, "Cannot raycast in null physics world");
+
+        const uint32_t l_MaxHits =
+            p_Mode == QueryMode::Closest ? 1u : p_MaxHits;
+        run_query_batch(
+            p_World, p_Count, l_MaxHits,
+            [&](uint32_t p_Index, BackendQueryHit *p_QueryHits,
+                uint32_t p_QueryMaxHits) {
+              return raycast_query(p_World, p_Requests[p_Index],
+                                   p_Mode, p_QueryMaxHits,
+                                   p_QueryHits);
+            },
+            p_Results, p_Hits);
+      }
+
+      void overlap_world_batch(
+          WorldBackend *p_World, const OverlapRequest *p_Requests,
+          uint32_t p_Count, QueryMode p_Mode, uint32_t p_MaxHits,
+          Util::List<QueryResult> &p_Results,
+          Util::List<BackendQueryHit> &p_Hits)
+      {
+        LOW_ASSERT(p_World, "Cannot overlap in null physics world");
+
+        const uint32_t l_MaxHits =
+            p_Mode == QueryMode::Closest ? 1u : p_MaxHits;
+        run_query_batch(
+            p_World, p_Count, l_MaxHits,
+            [&](uint32_t p_Index, BackendQueryHit *p_QueryHits,
+                uint32_t p_QueryMaxHits) {
+              return overlap_query(p_World, p_Requests[p_Index],
+                                   p_Mode, p_QueryMaxHits,
+                                   p_QueryHits);
+            },
+            p_Results, p_Hits);
+      }
+
+      uint32_t submit_deferred_raycast(
+          WorldBackend *p_World, const RaycastRequest &p_Request,
+          QueryMode p_Mode)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot queue raycast in null physics world");
+
+        WorldBackend::DeferredQuery l_Query;
+        l_Query.overlap = false;
+        l_Query.mode = p_Mode;
+        l_Query.ray = p_Request;
+        p_World->pending_queries.push_back(l_Query);
+        return p_World->next_query_ticket++;
+      }
+
+      uint32_t submit_deferred_overlap(
+          WorldBackend *p_World, const OverlapRequest &p_Request,
+          QueryMode p_Mode)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot queue overlap in null physics world");
+
+        WorldBackend::DeferredQuery l_Query;
+        l_Query.overlap = true;
+        l_Query.mode = p_Mode;
+        l_Query.shape = p_Request;
+        p_World->pending_queries.push_back(l_Query);
+        return p_World->next_query_ticket++;
+      }
+
+      void resolve_deferred_queries(WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot resolve queries in null physics world");
+
+        const uint32_t l_Count =
+            static_cast<uint32_t>(p_World->pending_queries.size());
+
+        p_World->resolved_first_ticket =
+            p_World->next_query_ticket - l_Count;
+        p_World->resolved_queries.clear();
+        p_World->resolved_hits.clear();
+
+        const WorldBackend::DeferredQuery *l_Queries =
+            p_World->pending_queries.data();
+        run_query_batch(
+            p_World, l_Count, g_MaxDeferredQueryHits,
+            [&](uint32_t p_Index, BackendQueryHit *p_QueryHits,
+                uint32_t p_QueryMaxHits) {
+              const WorldBackend::DeferredQuery &l_Query =
+                  l_Queries[p_Index];
+              const uint32_t l_MaxHits =
+                  l_Query.mode == QueryMode::Closest ? 1u
+                                                     : p_QueryMaxHits;
+              return l_Query.overlap
+                         ? overlap_query(p_World, l_Query.shape,
+                                         l_Query.mode, l_MaxHits,
+                                         p_QueryHits)
+                         : raycast_query(p_World, l_Query.ray,
+                                         l_Query.mode, l_MaxHits,
+                                         p_QueryHits);
+            },
+            p_World->resolved_queries, p_World->resolved_hits);
+
+        p_World->pending_queries.clear();
+      }
+
+      bool get_deferred_query_result(WorldBackend *p_World,
+                                     uint32_t p_Ticket,
+                                     QueryResult &p_Result)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot get query result of null physics world");
+
+        if (p_Ticket < p_World->resolved_first_ticket) {
+          return false;
+        }
+        const uint32_t l_Index =
+            p_Ticket - p_World->resolved_first_ticket;
+        if (l_Index >= p_World->resolved_queries.size()) {
+          return false;
+        }
+
+        p_Result = p_World->resolved_queries[l_Index];
+        return true;
+      }
+
+      const Util::List<BackendQueryHit> &
+      get_deferred_query_hits(WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World,
+                   "Cannot get query hits of null physics world");
+        return p_World->resolved_hits;
       }
 
       CapsuleControllerBackendHandle create_capsule_controller(
@@ -977,6 +3240,8 @@ namespace Low {
                 reinterpret_cast<uint64_t>(p_CreateInfo.user_data),
                 &p_World->physics_system);
         l_Controller->SetUp(l_Up);
+        l_Controller->SetCharacterVsCharacterCollision(
+            &p_World->character_grid);
 
         CapsuleControllerBackendHandle l_Handle;
         l_Handle.id = p_World->next_capsule_controller_id++;
@@ -987,6 +3252,7 @@ namespace Low {
             std::max(p_CreateInfo.step_offset, 0.0f);
         l_Backend.skin_width =
             std::max(p_CreateInfo.skin_width, 0.0f);
+        l_Backend.stagger = static_cast<uint32_t>(l_Handle.id);
         p_World->capsule_controllers[l_Handle.id] = l_Backend;
 
         l_Controller->RefreshContacts(
@@ -1044,28 +3310,258 @@ namespace Low {
           return;
         }
 
-        const JPH::Vec3 l_DesiredVelocity =
-            to_jolt(p_Delta) / p_DeltaTime;
-        l_Backend.controller->SetLinearVelocity(l_DesiredVelocity);
+        // Several moves in one frame add up their distance but not
+        // their time
+        l_Backend.pending = true;
+        l_Backend.pending_delta += p_Delta;
+        if (l_Backend.last_move_frame != p_World->character_frame) {
+          l_Backend.pending_time += p_DeltaTime;
+          l_Backend.last_move_frame = p_World->character_frame;
+        }
+      }
+
+      static void update_capsule_controller(
+          WorldBackend *p_World,
+          WorldBackend::CapsuleControllerBackend &p_Backend,
+          bool p_Reduced, JPH::TempAllocator &p_TempAllocator)
+      {
+        const auto l_Start = std::chrono::steady_clock::now();
+
+        JPH::CharacterVirtual &l_Controller = *p_Backend.controller;
+        l_Controller.SetLinearVelocity(
+            to_jolt(p_Backend.pending_delta) /
+            p_Backend.pending_time);
 
         JPH::CharacterVirtual::ExtendedUpdateSettings
             l_UpdateSettings;
-        const JPH::Vec3 l_Up = l_Backend.controller->GetUp();
+        const JPH::Vec3 l_Up = l_Controller.GetUp();
+        // Walking stairs costs several extra sweeps, distant
+        // characters do without it
         l_UpdateSettings.mWalkStairsStepUp =
-            l_Up * l_Backend.step_offset;
+            p_Reduced ? JPH::Vec3::sZero()
+                      : l_Up * p_Backend.step_offset;
         l_UpdateSettings.mStickToFloorStepDown =
             -l_Up *
-            std::max(l_Backend.step_offset + l_Backend.skin_width,
+            std::max(p_Backend.step_offset + p_Backend.skin_width,
                      0.0f);
 
-        l_Backend.controller->ExtendedUpdate(
-            p_DeltaTime, p_World->physics_system.GetGravity(),
-            l_UpdateSettings,
+        l_Controller.ExtendedUpdate(
+            p_Backend.pending_time,
+            p_World->physics_system.GetGravity(), l_UpdateSettings,
             p_World->physics_system.GetDefaultBroadPhaseLayerFilter(
                 Layers::MOVING),
             p_World->physics_system.GetDefaultLayerFilter(
                 Layers::MOVING),
-            {}, {}, p_World->temp_allocator);
+            {}, {}, p_TempAllocator);
+
+        p_Backend.pending = false;
+        p_Backend.pending_delta = Math::Vector3(0.0f);
+        p_Backend.pending_time = 0.0f;
+
+        p_Backend.update_cost_us =
+            std::chrono::duration<float, std::micro>(
+                std::chrono::steady_clock::now() - l_Start)
+                .count();
+      }
+
+      void flush_capsule_controller(
+          WorldBackend *p_World,
+          CapsuleControllerBackendHandle p_Controller)
+      {
+        WorldBackend::CapsuleControllerBackend &l_Backend =
+            get_capsule_controller_backend(p_World, p_Controller);
+        if (!l_Backend.pending) {
+          return;
+        }
+        update_capsule_controller(p_World, l_Backend, false,
+                                  p_World->temp_allocator);
+      }
+
+      void update_capsule_controllers(WorldBackend *p_World)
+      {
+        LOW_PROFILE_CPU("Physics", "Update capsule controllers");
+        LOW_ASSERT(p_World, "Cannot update capsule controllers of "
+                            "null physics world");
+
+        struct ControllerUpdate
+        {
+          uint64_t id;
+          WorldBackend::CapsuleControllerBackend *backend;
+          bool reduced;
+        };
+
+        const CharacterUpdateSettings &l_Settings =
+            p_World->character_settings;
+        const uint64_t l_Frame = p_World->character_frame++;
+
+        std::vector<JPH::CharacterVirtual *> l_Characters;
+        l_Characters.reserve(p_World->capsule_controllers.size());
+        for (auto &i_Entry : p_World->capsule_controllers) {
+          l_Characters.push_back(i_Entry.second.controller.GetPtr());
+        }
+        p_World->character_grid.build(l_Characters,
+                                      l_Settings.cell_size);
+
+        // Cells get split into four colors by the parity of their
+        // coordinates. Cells of one color never neighbour each other
+        // so their characters can be updated at the same time.
+        std::unordered_map<uint64_t, std::vector<ControllerUpdate>>
+            l_CellUpdates;
+        uint32_t l_FullCount = 0u;
+        uint32_t l_ReducedCount = 0u;
+        uint32_t l_IdleCount = 0u;
+        const float l_FullRateDistanceSquared =
+            l_Settings.full_rate_distance *
+            l_Settings.full_rate_distance;
+
+        for (auto &i_Entry : p_World->capsule_controllers) {
+          WorldBackend::CapsuleControllerBackend &i_Backend =
+              i_Entry.second;
+          if (!i_Backend.pending) {
+            l_IdleCount++;
+            continue;
+          }
+
+          const JPH::RVec3 i_Position =
+              i_Backend.controller->GetPosition();
+          const bool i_Reduced =
+              l_Settings.use_focus &&
+              Math::VectorUtil::distance_squared(
+                  from_jolt_position(i_Position), l_Settings.focus) >
+                  l_FullRateDistanceSquared;
+          if (i_Reduced && l_Settings.reduced_rate_interval > 1u &&
+              ((l_Frame + i_Backend.stagger) %
+               l_Settings.reduced_rate_interval) != 0u) {
+            // Keeps collecting its moves until its turn comes
+            l_IdleCount++;
+            continue;
+          }
+
+          if (i_Reduced) {
+            l_ReducedCount++;
+          } else {
+            l_FullCount++;
+          }
+          l_CellUpdates[p_World->character_grid.get_cell_key(
+                            i_Position)]
+              .push_back({i_Entry.first, &i_Backend, i_Reduced});
+        }
+
+        std::array<std::vector<const std::vector<ControllerUpdate> *>,
+                   4u>
+            l_Colors;
+        for (auto &i_Cell : l_CellUpdates) {
+          if (p_World->deterministic) {
+            // The map does not keep an order, the controllers in a
+            // cell have to be updated in the same order every run
+            std::sort(i_Cell.second.begin(), i_Cell.second.end(),
+                      [](const ControllerUpdate &p_A,
+                         const ControllerUpdate &p_B) {
+                        return p_A.id < p_B.id;
+                      });
+          }
+          const uint32_t i_Color =
+              (static_cast<uint32_t>(
+                   CharacterGrid::get_cell_x(i_Cell.first)) &
+               1u) |
+              ((static_cast<uint32_t>(
+                    CharacterGrid::get_cell_z(i_Cell.first)) &
+                1u)
+               << 1u);
+          l_Colors[i_Color].push_back(&i_Cell.second);
+        }
+
+        for (const auto &i_Cells : l_Colors) {
+          if (i_Cells.empty()) {
+            continue;
+          }
+          Util::JobManager::Parallel::for_each(
+              static_cast<uint32_t>(i_Cells.size()), 1u,
+              [&](uint32_t p_Begin, uint32_t p_End) {
+                JPH::TempAllocator &l_TempAllocator =
+                    get_thread_temp_allocator();
+                for (uint32_t i = p_Begin; i < p_End; ++i) {
+                  for (const ControllerUpdate &i_Update :
+                       *i_Cells[i]) {
+                    update_capsule_controller(
+                        p_World, *i_Update.backend, i_Update.reduced,
+                        l_TempAllocator);
+                  }
+                }
+              });
+        }
+
+        // Characters outside of the update have to collide with the
+        // world only, the grid would point at stale cells otherwise
+        p_World->character_grid.clear();
+
+        if (p_World->recording) {
+          // Characters push the bodies they touch, for a replay
+          // those bodies count as changed from the outside
+          for (const auto &i_Cell : l_CellUpdates) {
+            for (const ControllerUpdate &i_Update : i_Cell.second) {
+              const JPH::CharacterVirtual &i_Controller =
+                  *i_Update.backend->controller;
+              for (const JPH::CharacterVirtual::Contact &i_Contact :
+                   i_Controller.GetActiveContacts()) {
+                if (!i_Contact.mBodyB.IsInvalid()) {
+                  p_World->touched_bodies.insert(
+                      i_Contact.mBodyB.GetIndexAndSequenceNumber());
+                }
+              }
+            }
+          }
+        }
+
+        float l_TotalCost = 0.0f;
+        float l_MaxCost = 0.0f;
+        for (const auto &i_Cell : l_CellUpdates) {
+          for (const ControllerUpdate &i_Update : i_Cell.second) {
+            l_TotalCost += i_Update.backend->update_cost_us;
+            l_MaxCost =
+                std::max(l_MaxCost, i_Update.backend->update_cost_us);
+          }
+        }
+        const uint32_t l_UpdatedCount = l_FullCount + l_ReducedCount;
+
+        LOW_PROFILE_COUNTER("Physics", "Characters full rate",
+                            l_FullCount);
+        LOW_PROFILE_COUNTER("Physics", "Characters reduced rate",
+                            l_ReducedCount);
+        LOW_PROFILE_COUNTER("Physics", "Characters idle",
+                            l_IdleCount);
+        LOW_PROFILE_COUNTER(
+            "Physics", "Character update avg (us)",
+            l_UpdatedCount ? l_TotalCost / l_UpdatedCount : 0.0f);
+        LOW_PROFILE_COUNTER("Physics", "Character update max (us)",
+                            l_MaxCost);
+      }
+
+      void set_character_update_settings(
+          WorldBackend *p_World,
+          const CharacterUpdateSettings &p_Settings)
+      {
+        LOW_ASSERT(p_World, "Cannot set character update settings on "
+                            "null physics world");
+        LOW_ASSERT(p_Settings.cell_size > 0.0f,
+                   "Character cell size has to be positive");
+        p_World->character_settings = p_Settings;
+      }
+
+      const CharacterUpdateSettings &
+      get_character_update_settings(WorldBackend *p_World)
+      {
+        LOW_ASSERT(p_World, "Cannot get character update settings "
+                            "of null physics world");
+        return p_World->character_settings;
+      }
+
+      float get_capsule_controller_update_cost(
+          WorldBackend *p_World,
+          CapsuleControllerBackendHandle p_Controller)
+      {
+        return get_capsule_controller_backend(p_World, p_Controller)
+            .update_cost_us;
       }
 
       bool is_capsule_controller_grounded(
@@ -1159,6 +1159,115 @@ namespace Low {
       }
 
       // LOW_CODEGEN:BEGIN:CUSTOM:NAMESPACE_AFTER_TYPE_CODE
+      void Body::set_enabled(bool p_Enabled)
+      {
+        _LOW_ASSERT(is_alive());
+        _LOW_ASSERT(get_world().is_alive());
+
+        set_body_enabled(BACKEND_WORLD(get_world()),
+                         BodyBackendHandle{get_backend_id()},
+                         p_Enabled);
+      }
+
+      void
+      Body::get_interpolated_transform(Math::Vector3 &p_Position,
+                                       Math::Quaternion &p_Rotation)
+      {
+        _LOW_ASSERT(is_alive());
+        _LOW_ASSERT(get_world().is_alive());
+
+        get_body_interpolated_transform(
+            BACKEND_WORLD(get_world()),
+            BodyBackendHandle{get_backend_id()}, p_Position,
+            p_Rotation);
+      }
+
+      void Body::set_layer(u32 p_Layer)
+      {
+        _LOW_ASSERT(is_alive());
+        _LOW_ASSERT(get_world().is_alive());
+
+        set_body_layer(BACKEND_WORLD(get_world()),
+                       BodyBackendHandle{get_backend_id()}, p_Layer);
+      }
+
+      u32 Body::get_layer()
+      {
+        _LOW_ASSERT(is_alive());
+        _LOW_ASSERT(get_world().is_alive());
+
+        return get_body_layer(BACKEND_WORLD(get_world()),
+                              BodyBackendHandle{get_backend_id()});
+      }
+
+      void Body::set_sensor(bool p_Sensor)
+      {
+        _LOW_ASSERT(is_alive());
+        _LOW_ASSERT(get_world().is_alive());
+
+        set_body_sensor(BACKEND_WORLD(get_world()),
+                        BodyBackendHandle{get_backend_id()},
+                        p_Sensor);
+      }
+
+      void Body::set_contact_events(bool p_Enabled)
+      {
+        _LOW_ASSERT(is_alive());
+        _LOW_ASSERT(get_world().is_alive());
+
+        set_body_contact_events(BACKEND_WORLD(get_world()),
+                                BodyBackendHandle{get_backend_id()},
+                                p_Enabled);
+      }
+
+      void Body::get_active(World p_World,
+                            Low::Util::List<Body> &p_Bodies)
+      {
+        _LOW_ASSERT(p_World.is_alive());
+
+        Low::Util::List<Low::Util::Handle> l_Handles;
+        get_active_bodies(BACKEND_WORLD(p_World), l_Handles);
+
+        p_Bodies.reserve(p_Bodies.size() + l_Handles.size());
+        for (Low::Util::Handle i_Handle : l_Handles) {
+          Body i_Body = i_Handle.get_id();
+          if (i_Body.is_alive()) {
+            p_Bodies.push_back(i_Body);
+          }
+        }
+      }
+
+      void Body::set_frozen(const Low::Util::List<Body> &p_Bodies,
+                            bool p_Frozen)
+      {
+        // Bodies are handed to their world in runs so a list that is
+        // grouped by world turns into one bulk call per world
+        Low::Util::List<BodyBackendHandle> l_Handles;
+        World l_World;
+        for (u32 i = 0u; i <= p_Bodies.size(); ++i) {
+          const bool i_End = i == p_Bodies.size();
+          if (!i_End && !p_Bodies[i].is_alive()) {
+            continue;
+          }
+
+          if (i_End || p_Bodies[i].get_world() != l_World) {
+            if (!l_Handles.empty() && l_World.is_alive()) {
+              set_bodies_frozen(BACKEND_WORLD(l_World),
+                                l_Handles.data(),
+                                static_cast<u32>(l_Handles.size()),
+                                p_Frozen);
+            }
+            l_Handles.clear();
+            if (i_End) {
+              break;
+            }
+            l_World = p_Bodies[i].get_world();
+          }
+
+          l_Handles.push_back(
+              BodyBackendHandle{p_Bodies[i].get_backend_id()});
+        }
+      }
       // LOW_CODEGEN::END::CUSTOM:NAMESPACE_AFTER_TYPE_CODE
 
     } // namespace Physics
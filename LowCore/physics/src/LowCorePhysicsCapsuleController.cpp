@@ -910,6 +910,30 @@ namespace Low {
       }
 
       // LOW_CODEGEN:BEGIN:CUSTOM:NAMESPACE_AFTER_TYPE_CODE
+      float CapsuleController::get_update_cost()
+      {
+        _LOW_ASSERT(is_alive());
+        _LOW_ASSERT(get_world().is_alive());
+
+        return get_capsule_controller_update_cost(
+            BACKEND_WORLD(get_world()),
+            CapsuleControllerBackendHandle{get_backend_id()});
+      }
+
+      void
+      CapsuleController::move_immediate(Low::Math::Vector3 p_Delta,
+                                        float p_DeltaTime)
+      {
+        _LOW_ASSERT(is_alive());
+        _LOW_ASSERT(get_world().is_alive());
+
+        const CapsuleControllerBackendHandle l_Handle{
+            get_backend_id()};
+        move_capsule_controller(BACKEND_WORLD(get_world()), l_Handle,
+                                p_Delta, p_DeltaTime);
+        flush_capsule_controller(BACKEND_WORLD(get_world()),
+                                 l_Handle);
+      }
       // LOW_CODEGEN::END::CUSTOM:NAMESPACE_AFTER_TYPE_CODE
 
     } // namespace Physics
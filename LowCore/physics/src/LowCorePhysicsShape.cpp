@@ -13,6 +13,7 @@
 
 // LOW_CODEGEN:BEGIN:CUSTOM:SOURCE_CODE
 #include "LowCorePhysicsBackend.h"
+#include "LowUtilFileIO.h"
 // LOW_CODEGEN::END::CUSTOM:SOURCE_CODE
 
 namespace Low {
@@ -799,6 +800,170 @@ namespace Low {
       }
 
       // LOW_CODEGEN:BEGIN:CUSTOM:NAMESPACE_AFTER_TYPE_CODE
+      Shape Shape::make_from_backend(World p_World,
+                                     uint64_t p_BackendId,
+                                     ShapeType p_Type)
+      {
+        if (p_BackendId == 0u) {
+          return Shape();
+        }
+
+        Shape l_Shape = Shape::make(p_World.get_name());
+        l_Shape.set_world(p_World);
+        l_Shape.set_backend_id(p_BackendId);
+        l_Shape.set_type(p_Type);
+        return l_Shape;
+      }
+
+      Shape
+      Shape::make_mesh(World p_World,
+                       const Util::List<Math::Vector3> &p_Vertices,
+                       const Util::List<u32> &p_Indices)
+      {
+        _LOW_ASSERT(p_World.is_alive());
+
+        const ShapeBackendHandle l_Handle = create_mesh_shape(
+            BACKEND_WORLD(p_World), p_Vertices.data(),
+            static_cast<u32>(p_Vertices.size()), p_Indices.data(),
+            static_cast<u32>(p_Indices.size()));
+        return make_from_backend(p_World, l_Handle.id,
+                                 ShapeType::Mesh);
+      }
+
+      Shape Shape::make_mesh(World p_World,
+                             const Util::Resource::Mesh &p_Mesh,
+                             const Math::Vector3 &p_Scale)
+      {
+        LOW_PROFILE_CPU("Physics", "Collect mesh shape triangles");
+
+        Util::List<Math::Vector3> l_Vertices;
+        Util::List<u32> l_Indices;
+
+        for (const Util::Resource::Submesh &i_Submesh :
+             p_Mesh.submeshes) {
+          for (const Util::Resource::MeshInfo &i_MeshInfo :
+               i_Submesh.meshInfos) {
+            const u32 i_BaseVertex =
+                static_cast<u32>(l_Vertices.size());
+
+            for (const Util::Resource::Vertex &i_Vertex :
+                 i_MeshInfo.vertices) {
+              const Math::Vector3 i_Position = Math::Vector3(
+                  i_Submesh.transform *
+                  Math::Vector4(i_Vertex.position, 1.0f));
+              l_Vertices.push_back(i_Position * p_Scale);
+            }
+
+            for (u32 i_Index : i_MeshInfo.indices) {
+              l_Indices.push_back(i_BaseVertex + i_Index);
+            }
+          }
+        }
+
+        return make_mesh(p_World, l_Vertices, l_Indices);
+      }
+
+      Shape
+      Shape::make_height_field(World p_World,
+                               const Util::List<float> &p_Samples,
+                               u32 p_SampleCount,
+                               const Math::Vector3 &p_Offset,
+                               const Math::Vector3 &p_Scale)
+      {
+        _LOW_ASSERT(p_World.is_alive());
+        LOW_ASSERT(p_Samples.size() ==
+                       static_cast<size_t>(p_SampleCount) *
+                           p_SampleCount,
+                   "Height field sample count does not match");
+
+        const ShapeBackendHandle l_Handle = create_height_field_shape(
+            BACKEND_WORLD(p_World), p_Samples.data(), p_SampleCount,
+            p_Offset, p_Scale);
+        return make_from_backend(p_World, l_Handle.id,
+                                 ShapeType::HeightField);
+      }
+
+      bool Shape::cook(Util::List<u8> &p_Data) const
+      {
+        _LOW_ASSERT(is_alive());
+
+        // The shape type is kept in front of the backend data since
+        // the backend does not know about it
+        Util::List<u8> l_BackendData;
+        if (!cook_shape(BACKEND_WORLD(get_world()),
+                        ShapeBackendHandle{get_backend_id()},
+                        l_BackendData)) {
+          return false;
+        }
+
+        p_Data.clear();
+        p_Data.reserve(l_BackendData.size() + 1u);
+        p_Data.push_back(static_cast<u8>(get_type()));
+        p_Data.insert(p_Data.end(), l_BackendData.begin(),
+                      l_BackendData.end());
+        return true;
+      }
+
+      Shape Shape::make_cooked(World p_World,
+                               const Util::List<u8> &p_Data)
+      {
+        _LOW_ASSERT(p_World.is_alive());
+
+        if (p_Data.size() < 2u ||
+            p_Data[0] > static_cast<u8>(ShapeType::HeightField)) {
+          return Shape();
+        }
+
+        const ShapeBackendHandle l_Handle = create_cooked_shape(
+            BACKEND_WORLD(p_World), p_Data.data() + 1u,
+            static_cast<u32>(p_Data.size() - 1u));
+        return make_from_backend(p_World, l_Handle.id,
+                                 static_cast<ShapeType>(p_Data[0]));
+      }
+
+      bool Shape::save_cooked(const Util::String &p_Path) const
+      {
+        Util::List<u8> l_Data;
+        if (!cook(l_Data)) {
+          return false;
+        }
+
+        Util::FileIO::File l_File = Util::FileIO::open(
+            p_Path.c_str(), Util::FileIO::FileMode::WRITE_BYTES);
+        if (!l_File.is_open()) {
+          LOW_LOG_ERROR << "Could not open '" << p_Path
+                        << "' to write cooked physics shape"
+                        << LOW_LOG_END;
+          return false;
+        }
+
+        const bool l_Success = Util::FileIO::write_bytes(
+            l_File, l_Data.data(), static_cast<u32>(l_Data.size()));
+        Util::FileIO::close(l_File);
+        return l_Success;
+      }
+
+      Shape Shape::load_cooked(World p_World,
+                               const Util::String &p_Path)
+      {
+        if (!Util::FileIO::file_exists_sync(p_Path.c_str())) {
+          return Shape();
+        }
+
+        Util::FileIO::File l_File = Util::FileIO::open(
+            p_Path.c_str(), Util::FileIO::FileMode::READ_BYTES);
+        if (!l_File.is_open()) {
+          return Shape();
+        }
+
+        Util::List<u8> l_Data;
+        l_Data.resize(Util::FileIO::size_sync(l_File));
+        Util::FileIO::read_sync(
+            l_File, reinterpret_cast<char *>(l_Data.data()));
+        Util::FileIO::close(l_File);
+
+        return make_cooked(p_World, l_Data);
+      }
       // LOW_CODEGEN::END::CUSTOM:NAMESPACE_AFTER_TYPE_CODE
 
     } // namespace Physics
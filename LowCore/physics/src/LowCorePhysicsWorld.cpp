@@ -108,7 +108,8 @@ namespace Low {
         ms_LivingInstances.push_back(l_Handle);
 
         // LOW_CODEGEN:BEGIN:CUSTOM:MAKE
-        l_Handle.set_world_ptr(create_world_backend());
+        l_Handle.set_world_ptr(
+            create_world_backend(get_project_collision_layers()));
         // LOW_CODEGEN::END::CUSTOM:MAKE
 
         return l_Handle;
@@ -319,6 +320,14 @@ namespace Low {
             l_ParameterInfo.handleType = 0;
             l_FunctionInfo.parameters.push_back(l_ParameterInfo);
           }
+          {
+            Low::Util::RTTI::ParameterInfo l_ParameterInfo;
+            l_ParameterInfo.name = N(p_LayerMask);
+            l_ParameterInfo.type =
+                Low::Util::RTTI::PropertyType::UINT32;
+            l_ParameterInfo.handleType = 0;
+            l_FunctionInfo.parameters.push_back(l_ParameterInfo);
+          }
           {
             Low::Util::RTTI::ParameterInfo l_ParameterInfo;
             l_ParameterInfo.name = N(p_Hit);
@@ -458,6 +467,14 @@ namespace Low {
             l_ParameterInfo.handleType = 0;
             l_FunctionInfo.parameters.push_back(l_ParameterInfo);
           }
+          {
+            Low::Util::RTTI::ParameterInfo l_ParameterInfo;
+            l_ParameterInfo.name = N(p_LayerMask);
+            l_ParameterInfo.type =
+                Low::Util::RTTI::PropertyType::UINT32;
+            l_ParameterInfo.handleType = 0;
+            l_FunctionInfo.parameters.push_back(l_ParameterInfo);
+          }
           {
             Low::Util::RTTI::ParameterInfo l_ParameterInfo;
             l_ParameterInfo.name = N(p_Hit);
@@ -499,6 +516,14 @@ namespace Low {
             l_ParameterInfo.handleType = 0;
             l_FunctionInfo.parameters.push_back(l_ParameterInfo);
           }
+          {
+            Low::Util::RTTI::ParameterInfo l_ParameterInfo;
+            l_ParameterInfo.name = N(p_LayerMask);
+            l_ParameterInfo.type =
+                Low::Util::RTTI::PropertyType::UINT32;
+            l_ParameterInfo.handleType = 0;
+            l_FunctionInfo.parameters.push_back(l_ParameterInfo);
+          }
           {
             Low::Util::RTTI::ParameterInfo l_ParameterInfo;
             l_ParameterInfo.name = N(p_Hit);
@@ -808,14 +833,14 @@ namespace Low {
 
       bool World::raycast(Low::Math::Vector3 p_Origin,
                           Low::Math::Vector3 p_Direction,
-                          float p_MaxDistance,
+                          float p_MaxDistance, uint32_t p_LayerMask,
                           Low::Core::Physics::QueryHit *p_Hit)
       {
         // LOW_CODEGEN:BEGIN:CUSTOM:FUNCTION_raycast
         BackendQueryHit l_BackendHit;
         const bool l_Result =
             raycast_world(BACKEND_WORLD(), p_Origin, p_Direction,
-                          p_MaxDistance, l_BackendHit);
+                          p_MaxDistance, p_LayerMask, l_BackendHit);
         if (l_Result && p_Hit) {
           *p_Hit = to_query_hit(l_BackendHit);
         }
@@ -861,13 +886,13 @@ namespace Low {
       }
 
       bool World::overlap_sphere(Low::Math::Vector3 p_Position,
-                                 float p_Radius,
+                                 float p_Radius, uint32_t p_LayerMask,
                                  Low::Core::Physics::QueryHit *p_Hit)
       {
         // LOW_CODEGEN:BEGIN:CUSTOM:FUNCTION_overlap_sphere
         BackendQueryHit l_BackendHit;
         const bool l_Result = overlap_sphere_world(
-            BACKEND_WORLD(), p_Position, p_Radius,
+            BACKEND_WORLD(), p_Position, p_Radius, p_LayerMask,
             p_Hit ? &l_BackendHit : nullptr);
         if (l_Result && p_Hit) {
           *p_Hit = to_query_hit(l_BackendHit);
@@ -879,13 +904,14 @@ namespace Low {
       bool World::overlap_box(Low::Math::Vector3 p_Position,
                               Low::Math::Vector3 p_HalfExtents,
                               Low::Math::Quaternion p_Rotation,
+                              uint32_t p_LayerMask,
                               Low::Core::Physics::QueryHit *p_Hit)
       {
         // LOW_CODEGEN:BEGIN:CUSTOM:FUNCTION_overlap_box
         BackendQueryHit l_BackendHit;
         const bool l_Result = overlap_box_world(
             BACKEND_WORLD(), p_Position, p_HalfExtents, p_Rotation,
-            p_Hit ? &l_BackendHit : nullptr);
+            p_LayerMask, p_Hit ? &l_BackendHit : nullptr);
         if (l_Result && p_Hit) {
           *p_Hit = to_query_hit(l_BackendHit);
         }
@@ -976,6 +1002,206 @@ namespace Low {
       }
 
       // LOW_CODEGEN:BEGIN:CUSTOM:NAMESPACE_AFTER_TYPE_CODE
+      void World::begin_body_batch()
+      {
+        _LOW_ASSERT(is_alive());
+        Low::Core::Physics::begin_body_batch(BACKEND_WORLD());
+      }
+
+      void World::end_body_batch()
+      {
+        _LOW_ASSERT(is_alive());
+        Low::Core::Physics::end_body_batch(BACKEND_WORLD());
+      }
+
+      void World::set_step_settings(float p_FixedDelta,
+                                    u32 p_CollisionSteps,
+                                    u32 p_MaxSteps)
+      {
+        _LOW_ASSERT(is_alive());
+        set_world_step_settings(BACKEND_WORLD(), p_FixedDelta,
+                                p_CollisionSteps, p_MaxSteps);
+      }
+
+      const Low::Util::List<ContactEvent> &World::get_contact_events()
+      {
+        _LOW_ASSERT(is_alive());
+        return Low::Core::Physics::get_contact_events(
+            BACKEND_WORLD());
+      }
+
+      const Low::Util::List<TriggerEvent> &World::get_trigger_events()
+      {
+        _LOW_ASSERT(is_alive());
+        return Low::Core::Physics::get_trigger_events(
+            BACKEND_WORLD());
+      }
+
+      static void append_query_hits(
+          const Low::Util::List<BackendQueryHit> &p_From,
+          Low::Util::List<QueryHit> &p_Hits)
+      {
+        p_Hits.reserve(p_Hits.size() + p_From.size());
+        for (const BackendQueryHit &i_Hit : p_From) {
+          p_Hits.push_back(to_query_hit(i_Hit));
+        }
+      }
+
+      void World::raycast_batch(
+          const Low::Util::List<RaycastRequest> &p_Requests,
+          QueryMode p_Mode, u32 p_MaxHits,
+          Low::Util::List<QueryResult> &p_Results,
+          Low::Util::List<QueryHit> &p_Hits)
+      {
+        _LOW_ASSERT(is_alive());
+        LOW_PROFILE_CPU("Physics", "Raycast batch");
+
+        Low::Util::List<BackendQueryHit> l_BackendHits;
+        const u32 l_FirstHit = static_cast<u32>(p_Hits.size());
+        const size_t l_FirstResult = p_Results.size();
+        raycast_world_batch(BACKEND_WORLD(), p_Requests.data(),
+                            static_cast<u32>(p_Requests.size()),
+                            p_Mode, p_MaxHits, p_Results,
+                            l_BackendHits);
+        for (size_t i = l_FirstResult; i < p_Results.size(); ++i) {
+          p_Results[i].first_hit += l_FirstHit;
+        }
+        append_query_hits(l_BackendHits, p_Hits);
+      }
+
+      void World::overlap_batch(
+          const Low::Util::List<OverlapRequest> &p_Requests,
+          QueryMode p_Mode, u32 p_MaxHits,
+          Low::Util::List<QueryResult> &p_Results,
+          Low::Util::List<QueryHit> &p_Hits)
+      {
+        _LOW_ASSERT(is_alive());
+        LOW_PROFILE_CPU("Physics", "Overlap batch");
+
+        Low::Util::List<BackendQueryHit> l_BackendHits;
+        const u32 l_FirstHit = static_cast<u32>(p_Hits.size());
+        const size_t l_FirstResult = p_Results.size();
+        overlap_world_batch(BACKEND_WORLD(), p_Requests.data(),
+                            static_cast<u32>(p_Requests.size()),
+                            p_Mode, p_MaxHits, p_Results,
+                            l_BackendHits);
+        for (size_t i = l_FirstResult; i < p_Results.size(); ++i) {
+          p_Results[i].first_hit += l_FirstHit;
+        }
+        append_query_hits(l_BackendHits, p_Hits);
+      }
+
+      u32 World::submit_raycast(const RaycastRequest &p_Request,
+                                QueryMode p_Mode)
+      {
+        _LOW_ASSERT(is_alive());
+        return submit_deferred_raycast(BACKEND_WORLD(), p_Request,
+                                       p_Mode);
+      }
+
+      u32 World::submit_overlap(const OverlapRequest &p_Request,
+                                QueryMode p_Mode)
+      {
+        _LOW_ASSERT(is_alive());
+        return submit_deferred_overlap(BACKEND_WORLD(), p_Request,
+                                       p_Mode);
+      }
+
+      void World::resolve_deferred_queries()
+      {
+        _LOW_ASSERT(is_alive());
+        Low::Core::Physics::resolve_deferred_queries(BACKEND_WORLD());
+      }
+
+      bool World::get_query_hits(u32 p_Ticket,
+                                 Low::Util::List<QueryHit> &p_Hits)
+      {
+        _LOW_ASSERT(is_alive());
+
+        QueryResult l_Result;
+        if (!get_deferred_query_result(BACKEND_WORLD(), p_Ticket,
+                                       l_Result)) {
+          return false;
+        }
+
+        const Low::Util::List<BackendQueryHit> &l_Hits =
+            get_deferred_query_hits(BACKEND_WORLD());
+        p_Hits.reserve(p_Hits.size() + l_Result.hit_count);
+        for (u32 i = 0u; i < l_Result.hit_count; ++i) {
+          p_Hits.push_back(
+              to_query_hit(l_Hits[l_Result.first_hit + i]));
+        }
+        return true;
+      }
+
+      void World::update_capsule_controllers()
+      {
+        _LOW_ASSERT(is_alive());
+        Low::Core::Physics::update_capsule_controllers(
+            BACKEND_WORLD());
+      }
+
+      void World::set_character_update_settings(
+          const CharacterUpdateSettings &p_Settings)
+      {
+        _LOW_ASSERT(is_alive());
+        Low::Core::Physics::set_character_update_settings(
+            BACKEND_WORLD(), p_Settings);
+      }
+
+      const CharacterUpdateSettings &
+      World::get_character_update_settings()
+      {
+        _LOW_ASSERT(is_alive());
+        return Low::Core::Physics::get_character_update_settings(
+            BACKEND_WORLD());
+      }
+
+      bool World::save_state(Low::Util::List<u8> &p_Data,
+                             bool p_ActiveBodiesOnly)
+      {
+        _LOW_ASSERT(is_alive());
+        return save_world_state(BACKEND_WORLD(), p_Data,
+                                p_ActiveBodiesOnly);
+      }
+
+      bool World::restore_state(const Low::Util::List<u8> &p_Data)
+      {
+        _LOW_ASSERT(is_alive());
+        return restore_world_state(BACKEND_WORLD(), p_Data);
+      }
+
+      u64 World::get_state_hash()
+      {
+        _LOW_ASSERT(is_alive());
+        return hash_world_state(BACKEND_WORLD());
+      }
+
+      void World::set_deterministic(bool p_Deterministic)
+      {
+        _LOW_ASSERT(is_alive());
+        set_world_deterministic(BACKEND_WORLD(), p_Deterministic);
+      }
+
+      void World::begin_recording()
+      {
+        _LOW_ASSERT(is_alive());
+        begin_world_recording(BACKEND_WORLD());
+      }
+
+      void World::end_recording(Recording &p_Recording)
+      {
+        _LOW_ASSERT(is_alive());
+        end_world_recording(BACKEND_WORLD(), p_Recording);
+      }
+
+      bool World::replay(const Recording &p_Recording,
+                         ReplayResult &p_Result)
+      {
+        _LOW_ASSERT(is_alive());
+        return replay_world_recording(BACKEND_WORLD(), p_Recording,
+                                      p_Result);
+      }
       // LOW_CODEGEN::END::CUSTOM:NAMESPACE_AFTER_TYPE_CODE
 
     } // namespace Physics
@@ -20,6 +20,8 @@ void register_lowcore();
 #include "LowCorePrefab.h"
 #include "LowCoreGameLoop.h"
 #include "LowCorePrefabInstance.h"
+#include "LowCoreQuery.h"
+#include "LowCoreEntityPool.h"
 #include "LowCoreCflatScripting.h"
 #include "LowCoreNavmeshAgent.h"
 #include "LowCoreGameMode.h"
@@ -454,6 +456,8 @@ namespace Low {
     void cleanup()
     {
       Input::cleanup();
+      EntityPool::cleanup();
+      Query::cleanup();
       cleanup_types();
       Scripting::cleanup_as();
       Scripting::cleanup();
@@ -12,6 +12,7 @@
 #include "LowUtilObserverManager.h"
 
 #include "LowCorePrefabInstance.h"
+#include "LowCoreQuery.h"
 // LOW_CODEGEN:BEGIN:CUSTOM:SOURCE_CODE
 #include "LowRenderer.h"
 // LOW_CODEGEN::END::CUSTOM:SOURCE_CODE
@@ -103,6 +104,9 @@ namespace Low {
           // LOW_CODEGEN::END::CUSTOM:DESTROY
         }
 
+        Low::Core::Query::notify_component_removed(get_entity(),
+                                                   ms_TypeId);
+
         broadcast_observable(OBSERVABLE_DESTROY);
 
         Low::Util::remove_unique_id(get_unique_id());
@@ -174,6 +178,16 @@ namespace Low {
         l_TypeInfo.get_living_count = &Camera::living_count;
         l_TypeInfo.component = true;
         l_TypeInfo.uiComponent = false;
+        l_TypeInfo.get_page =
+            [](u32 p_Index,
+               u32 &p_SlotIndex) -> Low::Util::Instances::Page * {
+          u32 l_PageIndex = 0;
+          if (!get_page_for_index(p_Index, l_PageIndex,
+                                  p_SlotIndex)) {
+            return nullptr;
+          }
+          return ms_Pages[l_PageIndex];
+        };
         {
           // Property: active
           Low::Util::RTTI::PropertyInfo l_PropertyInfo;
@@ -12,6 +12,7 @@
 #include "LowUtilObserverManager.h"
 
 #include "LowCorePrefabInstance.h"
+#include "LowCoreQuery.h"
 // LOW_CODEGEN:BEGIN:CUSTOM:SOURCE_CODE
 #include "LowCoreTransform.h"
 #include "LowCoreScene.h"
@@ -171,6 +172,9 @@ namespace Low {
           // LOW_CODEGEN::END::CUSTOM:DESTROY
         }
 
+        Low::Core::Query::notify_component_removed(get_entity(),
+                                                   ms_TypeId);
+
         broadcast_observable(OBSERVABLE_DESTROY);
 
         Low::Util::remove_unique_id(get_unique_id());
@@ -245,6 +249,16 @@ namespace Low {
             &CharacterController::living_count;
         l_TypeInfo.component = true;
         l_TypeInfo.uiComponent = false;
+        l_TypeInfo.get_page =
+            [](u32 p_Index,
+               u32 &p_SlotIndex) -> Low::Util::Instances::Page * {
+          u32 l_PageIndex = 0;
+          if (!get_page_for_index(p_Index, l_PageIndex,
+                                  p_SlotIndex)) {
+            return nullptr;
+          }
+          return ms_Pages[l_PageIndex];
+        };
         {
           // Property: center
           Low::Util::RTTI::PropertyInfo l_PropertyInfo;
@@ -1490,11 +1504,7 @@ namespace Low {
         // LOW_CODEGEN:BEGIN:CUSTOM:FUNCTION_rebuild
         _LOW_ASSERT(is_alive());
 
-        if (get_capsule_controller().is_alive()) {
-          get_capsule_controller().destroy();
-          set_capsule_controller(
-              Low::Core::Physics::CapsuleController());
-        }
+        release_capsule_controller();
 
         Entity l_Entity = get_entity();
         if (!l_Entity.is_alive() ||
@@ -1606,6 +1616,29 @@ namespace Low {
       }
 
       // LOW_CODEGEN:BEGIN:CUSTOM:NAMESPACE_AFTER_TYPE_CODE
+      void
+      CharacterController::move_immediate(Low::Math::Vector3 p_Delta)
+      {
+        _LOW_ASSERT(is_alive());
+
+        if (!get_capsule_controller().is_alive()) {
+          return;
+        }
+        get_capsule_controller().move_immediate(p_Delta,
+                                                LOW_DELTA_TIME);
+      }
+
+      void CharacterController::release_capsule_controller()
+      {
+        _LOW_ASSERT(is_alive());
+
+        if (get_capsule_controller().is_alive()) {
+          get_capsule_controller().destroy();
+          set_capsule_controller(
+              Low::Core::Physics::CapsuleController());
+        }
+        set_initialized(false);
+      }
       // LOW_CODEGEN::END::CUSTOM:NAMESPACE_AFTER_TYPE_CODE
 
     } // namespace Component
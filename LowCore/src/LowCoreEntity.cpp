@@ -16,6 +16,9 @@
 
 // LOW_CODEGEN:BEGIN:CUSTOM:SOURCE_CODE
 
+#include "LowCoreQuery.h"
+#include "LowCoreMeshRendererSystem.h"
+#include "LowCorePhysicsSystem.h"
 // LOW_CODEGEN::END::CUSTOM:SOURCE_CODE
 
 namespace Low {
@@ -60,6 +63,7 @@ namespace Low {
           Util::Map<uint16_t, Util::Handle>();
       new (ACCESSOR_TYPE_SOA_PTR(l_Handle, Entity, region, Region))
           Region();
+      ACCESSOR_TYPE_SOA(l_Handle, Entity, active, bool) = false;
       ACCESSOR_TYPE_SOA(l_Handle, Entity, name, Low::Util::Name) =
           Low::Util::Name(0u);
 
@@ -77,6 +81,7 @@ namespace Low {
                                     l_Handle.get_id());
 
       // LOW_CODEGEN:BEGIN:CUSTOM:MAKE
+      ACCESSOR_TYPE_SOA(l_Handle, Entity, active, bool) = true;
       // LOW_CODEGEN::END::CUSTOM:MAKE
 
       return l_Handle;
@@ -241,6 +246,34 @@ namespace Low {
         l_TypeInfo.properties[l_PropertyInfo.name] = l_PropertyInfo;
         // End property: region
       }
+      {
+        // Property: active
+        Low::Util::RTTI::PropertyInfo l_PropertyInfo;
+        l_PropertyInfo.name = N(active);
+        l_PropertyInfo.editorProperty = false;
+        l_PropertyInfo.dataOffset = offsetof(Entity::Data, active);
+        l_PropertyInfo.type = Low::Util::RTTI::PropertyType::BOOL;
+        l_PropertyInfo.handleType = 0;
+        l_PropertyInfo.get_return =
+            [](Low::Util::Handle p_Handle) -> void const * {
+          Entity l_Handle = p_Handle.get_id();
+          l_Handle.is_active();
+          return (void *)&ACCESSOR_TYPE_SOA(p_Handle, Entity, active,
+                                            bool);
+        };
+        l_PropertyInfo.set = [](Low::Util::Handle p_Handle,
+                                const void *p_Data) -> void {
+          Entity l_Handle = p_Handle.get_id();
+          l_Handle.set_active(*(bool *)p_Data);
+        };
+        l_PropertyInfo.get = [](Low::Util::Handle p_Handle,
+                                void *p_Data) {
+          Entity l_Handle = p_Handle.get_id();
+          *((bool *)p_Data) = l_Handle.is_active();
+        };
+        l_TypeInfo.properties[l_PropertyInfo.name] = l_PropertyInfo;
+        // End property: active
+      }
       {
         // Property: unique_id
         Low::Util::RTTI::PropertyInfo l_PropertyInfo;
@@ -794,6 +827,51 @@ namespace Low {
       broadcast_observable(N(region));
     }
 
+    bool Entity::is_active() const
+    {
+      _LOW_ASSERT(is_alive());
+
+      // LOW_CODEGEN:BEGIN:CUSTOM:GETTER_active
+
+      // LOW_CODEGEN::END::CUSTOM:GETTER_active
+
+      return TYPE_SOA(Entity, active, bool);
+    }
+    void Entity::toggle_active()
+    {
+      set_active(!is_active());
+    }
+
+    void Entity::set_active(bool p_Value)
+    {
+      _LOW_ASSERT(is_alive());
+
+      // LOW_CODEGEN:BEGIN:CUSTOM:PRESETTER_active
+
+      // LOW_CODEGEN::END::CUSTOM:PRESETTER_active
+
+      // Set new value
+      TYPE_SOA(Entity, active, bool) = p_Value;
+
+      // LOW_CODEGEN:BEGIN:CUSTOM:SETTER_active
+      System::MeshRenderer::set_entity_active(*this, p_Value);
+      System::Physics::set_entity_active(*this, p_Value);
+
+      Component::Transform l_Transform = get_transform();
+      if (l_Transform.is_alive()) {
+        for (auto it = l_Transform.get_children().begin();
+             it != l_Transform.get_children().end(); ++it) {
+          Component::Transform i_Child(*it);
+          if (i_Child.is_alive() && i_Child.get_entity().is_alive()) {
+            i_Child.get_entity().set_active(p_Value);
+          }
+        }
+      }
+      // LOW_CODEGEN::END::CUSTOM:SETTER_active
+
+      broadcast_observable(N(active));
+    }
+
     Low::Util::UniqueId Entity::get_unique_id() const
     {
       _LOW_ASSERT(is_alive());
@@ -890,6 +968,8 @@ namespace Low {
                                                     this);
 
       get_components()[p_Component.get_type()] = p_Component.get_id();
+
+      Query::notify_component_added(*this, p_Component.get_type());
       // LOW_CODEGEN::END::CUSTOM:FUNCTION_add_component
     }
 
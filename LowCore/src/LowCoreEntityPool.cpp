@@ -0,0 +1,297 @@
+#include "LowCoreEntityPool.h"
+
+#include "LowUtilAssert.h"
+#include "LowUtilLogger.h"
+#include "LowUtilProfiler.h"
+
+#include "LowCorePrefabInstance.h"
+#include "LowCoreTransform.h"
+
+namespace Low {
+  namespace Core {
+    namespace EntityPool {
+      struct Pool
+      {
+        Util::List<Entity> free;
+        // Entities that are handed out right now, only those can be
+        // released back into the pool
+        Util::UnorderedSet<u64> acquired;
+        Stats stats;
+      };
+
+      static Util::UnorderedMap<u64, Pool> g_Pools;
+      static Stats g_TotalStats;
+
+      static void record_stats()
+      {
+        LOW_PROFILE_COUNTER("EntityPool", "Active",
+                            g_TotalStats.active);
+        LOW_PROFILE_COUNTER("EntityPool", "Pooled",
+                            g_TotalStats.pooled);
+        LOW_PROFILE_COUNTER("EntityPool", "Created",
+                            g_TotalStats.created);
+        LOW_PROFILE_COUNTER("EntityPool", "Reused",
+                            g_TotalStats.reused);
+      }
+
+      static void collect_children(Entity p_Entity,
+                                   Util::List<Entity> &p_Children)
+      {
+        Component::Transform l_Transform = p_Entity.get_transform();
+        if (!l_Transform.is_alive()) {
+          return;
+        }
+
+        for (auto it = l_Transform.get_children().begin();
+             it != l_Transform.get_children().end(); ++it) {
+          Component::Transform i_Child(*it);
+          if (i_Child.is_alive() && i_Child.get_entity().is_alive()) {
+            p_Children.push_back(i_Child.get_entity());
+          }
+        }
+      }
+
+      static void move_to_region(Entity p_Entity, Region p_Region)
+      {
+        if (p_Entity.get_region() != p_Region) {
+          p_Region.add_entity(p_Entity);
+        }
+
+        Util::List<Entity> l_Children;
+        collect_children(p_Entity, l_Children);
+        for (Entity i_Child : l_Children) {
+          move_to_region(i_Child, p_Region);
+        }
+      }
+
+      // Only writes back the editor properties that differ from the
+      // prefab. Like PrefabInstance::update_from_prefab the transform
+      // of the root is left alone since it gets placed by the caller.
+      static void reset_components(Entity p_Entity, bool p_Root)
+      {
+        if (!p_Entity.has_component(
+                Component::PrefabInstance::type_id())) {
+          return;
+        }
+
+        Component::PrefabInstance l_Instance = p_Entity.get_component(
+            Component::PrefabInstance::type_id());
+        Prefab l_Prefab = l_Instance.get_prefab();
+        if (!l_Prefab.is_alive()) {
+          return;
+        }
+
+        for (auto cit = l_Prefab.get_components().begin();
+             cit != l_Prefab.get_components().end(); ++cit) {
+          if (!p_Entity.has_component(cit->first) ||
+              (p_Root &&
+               cit->first == Component::Transform::type_id())) {
+            continue;
+          }
+
+          Util::Handle i_Component =
+              p_Entity.get_component(cit->first);
+          Util::RTTI::TypeInfo &i_TypeInfo =
+              Util::Handle::get_type_info(cit->first);
+
+          for (auto pit = i_TypeInfo.properties.begin();
+               pit != i_TypeInfo.properties.end(); ++pit) {
+            if (!pit->second.editorProperty ||
+                pit->second.type == Util::RTTI::PropertyType::SHAPE) {
+              continue;
+            }
+
+            auto i_Value = cit->second.find(pit->first);
+            if (i_Value == cit->second.end() ||
+                l_Prefab.compare_property(i_Component, pit->first)) {
+              continue;
+            }
+
+            pit->second.set(i_Component, &i_Value->second.m_Bool);
+            l_Instance.override(cit->first, pit->first, false);
+          }
+        }
+      }
+
+      static void reset_from_prefab(Entity p_Entity, bool p_Root)
+      {
+        reset_components(p_Entity, p_Root);
+
+        Util::List<Entity> l_Children;
+        collect_children(p_Entity, l_Children);
+        for (Entity i_Child : l_Children) {
+          reset_from_prefab(i_Child, false);
+        }
+      }
+
+      static void destroy_hierarchy(Entity p_Entity)
+      {
+        Util::List<Entity> l_Children;
+        collect_children(p_Entity, l_Children);
+        for (Entity i_Child : l_Children) {
+          destroy_hierarchy(i_Child);
+        }
+        p_Entity.destroy();
+      }
+
+      static Prefab get_prefab(Entity p_Entity)
+      {
+        if (!p_Entity.has_component(
+                Component::PrefabInstance::type_id())) {
+          return Util::Handle::DEAD;
+        }
+
+        Component::PrefabInstance l_Instance = p_Entity.get_component(
+            Component::PrefabInstance::type_id());
+        return l_Instance.get_prefab();
+      }
+
+      void warm_up(Prefab p_Prefab, Region p_Region, u32 p_Count)
+      {
+        LOW_PROFILE_CPU("Core", "EntityPool::warm_up");
+
+        LOW_ASSERT(p_Prefab.is_alive(),
+                   "Cannot warm up pool for dead prefab");
+
+        Pool &l_Pool = g_Pools[p_Prefab.get_id()];
+
+        Util::List<Entity> l_Entities;
+        p_Prefab.spawn_batch(p_Region, p_Count, nullptr, nullptr,
+                             l_Entities);
+
+        l_Pool.free.reserve(l_Pool.free.size() + l_Entities.size());
+        for (Entity i_Entity : l_Entities) {
+          i_Entity.set_active(false);
+          l_Pool.free.push_back(i_Entity);
+        }
+
+        const u32 l_Count = static_cast<u32>(l_Entities.size());
+        l_Pool.stats.created += l_Count;
+        l_Pool.stats.pooled += l_Count;
+        g_TotalStats.created += l_Count;
+        g_TotalStats.pooled += l_Count;
+
+        record_stats();
+      }
+
+      Entity acquire(Prefab p_Prefab, Region p_Region)
+      {
+        LOW_PROFILE_CPU("Core", "EntityPool::acquire");
+
+        LOW_ASSERT(p_Prefab.is_alive(),
+                   "Cannot acquire entity from dead prefab");
+
+        Pool &l_Pool = g_Pools[p_Prefab.get_id()];
+
+        Entity l_Entity;
+        while (!l_Pool.free.empty()) {
+          Entity i_Entity = l_Pool.free.back();
+          l_Pool.free.pop_back();
+          l_Pool.stats.pooled--;
+          g_TotalStats.pooled--;
+
+          if (i_Entity.is_alive()) {
+            l_Entity = i_Entity;
+            break;
+          }
+        }
+
+        if (l_Entity.is_alive()) {
+          move_to_region(l_Entity, p_Region);
+          reset_from_prefab(l_Entity, true);
+          l_Entity.set_active(true);
+
+          l_Pool.stats.reused++;
+          g_TotalStats.reused++;
+        } else {
+          l_Entity = p_Prefab.spawn(p_Region);
+
+          l_Pool.stats.created++;
+          g_TotalStats.created++;
+        }
+
+        l_Pool.acquired.insert(l_Entity.get_id());
+        l_Pool.stats.active++;
+        g_TotalStats.active++;
+
+        record_stats();
+
+        return l_Entity;
+      }
+
+      void release(Entity p_Entity)
+      {
+        LOW_PROFILE_CPU("Core", "EntityPool::release");
+
+        LOW_ASSERT(p_Entity.is_alive(), "Cannot release dead entity");
+
+        Prefab l_Prefab = get_prefab(p_Entity);
+        auto l_Pos = g_Pools.find(l_Prefab.get_id());
+
+        // Entities that were spawned some other way or that already
+        // went back to the pool would throw off the stats
+        if (!l_Prefab.is_alive() || l_Pos == g_Pools.end() ||
+            l_Pos->second.acquired.erase(p_Entity.get_id()) == 0u) {
+          LOW_LOG_WARN << "Tried to release entity '"
+                       << p_Entity.get_name()
+                       << "' that was not acquired from a pool"
+                       << LOW_LOG_END;
+          return;
+        }
+
+        p_Entity.set_active(false);
+
+        Pool &l_Pool = l_Pos->second;
+        l_Pool.free.push_back(p_Entity);
+
+        l_Pool.stats.active--;
+        l_Pool.stats.pooled++;
+        g_TotalStats.active--;
+        g_TotalStats.pooled++;
+
+        record_stats();
+      }
+
+      Stats get_stats(Prefab p_Prefab)
+      {
+        auto l_Pos = g_Pools.find(p_Prefab.get_id());
+        if (l_Pos == g_Pools.end()) {
+          return Stats();
+        }
+        return l_Pos->second.stats;
+      }
+
+      Stats get_total_stats()
+      {
+        return g_TotalStats;
+      }
+
+      void clear(Prefab p_Prefab)
+      {
+        auto l_Pos = g_Pools.find(p_Prefab.get_id());
+        if (l_Pos == g_Pools.end()) {
+          return;
+        }
+
+        Pool &l_Pool = l_Pos->second;
+        for (Entity i_Entity : l_Pool.free) {
+          if (i_Entity.is_alive()) {
+            destroy_hierarchy(i_Entity);
+          }
+        }
+
+        g_TotalStats.pooled -= l_Pool.stats.pooled;
+        l_Pool.stats.pooled = 0u;
+        l_Pool.free.clear();
+
+        record_stats();
+      }
+
+      void cleanup()
+      {
+        g_Pools.clear();
+        g_TotalStats = Stats();
+      }
+    } // namespace EntityPool
+  }   // namespace Core
+} // namespace Low
@@ -15,6 +15,7 @@
 
 #include "LowCoreMeshRenderer.h"
 #include "LowCoreTransform.h"
+#include "LowCoreQuery.h"
 #include "LowCoreTaskScheduler.h"
 #include "LowCoreAnimator.h"
 #include "LowCoreAnimationClip.h"
@@ -34,92 +35,34 @@ namespace Low {
   namespace Core {
     namespace System {
       namespace MeshRenderer {
-        static Util::List<Math::Matrix4x4> g_LocalPoseScratch;
         static Util::List<Math::Matrix4x4> g_GlobalPoseScratch;
 
-        static Math::Vector3 sample_vector_keys(
-            const Util::List<Renderer::BinSerial::VecKey> &p_Keys,
-            const float p_Time, const Math::Vector3 p_Default)
+        static void release_animator(Component::Animator p_Animator)
         {
-          if (p_Keys.empty()) {
-            return p_Default;
+          if (p_Animator.get_render_object().is_alive()) {
+            p_Animator.get_render_object().destroy();
           }
-          if (p_Keys.size() == 1u || p_Time <= p_Keys[0].time) {
-            return p_Keys[0].value;
+          if (p_Animator.get_pose().is_alive()) {
+            // TODO: make poses reusable at some point
+            p_Animator.get_pose().destroy();
           }
-
-          for (u32 i = 0u; i < p_Keys.size() - 1u; ++i) {
-            const Renderer::BinSerial::VecKey &i_Current = p_Keys[i];
-            const Renderer::BinSerial::VecKey &i_Next =
-                p_Keys[i + 1u];
-
-            if (p_Time <= i_Next.time) {
-              const float i_Duration = i_Next.time - i_Current.time;
-              if (i_Duration <= 0.0f) {
-                return i_Current.value;
-              }
-
-              const float i_Factor =
-                  (p_Time - i_Current.time) / i_Duration;
-              return glm::mix(i_Current.value, i_Next.value,
-                              i_Factor);
-            }
+          if (p_Animator.get_skinning_instance().is_alive()) {
+            // TODO: Potentially reuse skinning instances across
+            // entities
+            p_Animator.get_skinning_instance().destroy();
           }
 
-          return p_Keys[p_Keys.size() - 1u].value;
-        }
-
-        static Math::Quaternion sample_quat_keys(
-            const Util::List<Renderer::BinSerial::QuatKey> &p_Keys,
-            const float p_Time, const Math::Quaternion p_Default)
-        {
-          if (p_Keys.empty()) {
-            return p_Default;
-          }
-          if (p_Keys.size() == 1u || p_Time <= p_Keys[0].time) {
-            return glm::normalize(p_Keys[0].value);
-          }
-
-          for (u32 i = 0u; i < p_Keys.size() - 1u; ++i) {
-            const Renderer::BinSerial::QuatKey &i_Current = p_Keys[i];
-            const Renderer::BinSerial::QuatKey &i_Next =
-                p_Keys[i + 1u];
-
-            if (p_Time <= i_Next.time) {
-              const float i_Duration = i_Next.time - i_Current.time;
-              if (i_Duration <= 0.0f) {
-                return glm::normalize(i_Current.value);
-              }
-
-              const float i_Factor =
-                  (p_Time - i_Current.time) / i_Duration;
-              return glm::normalize(glm::slerp(
-                  i_Current.value, i_Next.value, i_Factor));
-            }
-          }
-
-          return glm::normalize(p_Keys[p_Keys.size() - 1u].value);
-        }
-
-        static void extract_transform_components(
-            const Math::Matrix4x4 &p_Transform,
-            Math::Vector3 &p_Position, Math::Quaternion &p_Rotation,
-            Math::Vector3 &p_Scale)
-        {
-          Math::Vector3 l_Skew;
-          Math::Vector4 l_Perspective;
-          glm::decompose(p_Transform, p_Scale, p_Rotation, p_Position,
-                         l_Skew, l_Perspective);
-          p_Rotation = glm::normalize(p_Rotation);
+          p_Animator.set_skeleton(Util::Handle::DEAD);
+          p_Animator.set_animation_progress(0);
         }
 
         static void
         tick_animator(const float p_Delta, Util::EngineState p_State,
+                      Entity p_Entity,
+                      Component::Transform p_Transform,
                       Component::MeshRenderer p_MeshRenderer)
         {
-          Entity l_Entity = p_MeshRenderer.get_entity();
-
-          Component::Transform l_Transform = l_Entity.get_transform();
+          Entity l_Entity = p_Entity;
 
           Component::Animator l_Animator =
               l_Entity.get_component(Component::Animator::type_id());
@@ -129,21 +72,7 @@ namespace Low {
           }
 
           if (p_MeshRenderer.is_dirty()) {
-            if (l_Animator.get_render_object().is_alive()) {
-              l_Animator.get_render_object().destroy();
-            }
-            if (l_Animator.get_pose().is_alive()) {
-              // TODO: make poses reusable at some point
-              l_Animator.get_pose().destroy();
-            }
-            if (l_Animator.get_skinning_instance().is_alive()) {
-              // TODO: Potentially reuse skinning instances across
-              // entities
-              l_Animator.get_skinning_instance().destroy();
-            }
-
-            l_Animator.set_skeleton(Util::Handle::DEAD);
-            l_Animator.set_animation_progress(0);
+            release_animator(l_Animator);
           }
 
           p_MeshRenderer.set_dirty(false);
@@ -196,7 +125,7 @@ namespace Low {
 
           l_RenderObject.set_material(l_Material);
           l_RenderObject.set_world_transform(
-              l_Transform.get_world_matrix());
+              p_Transform.get_world_matrix());
 
           if (!l_Animator.get_skeleton().is_alive()) {
             return;
@@ -271,77 +200,12 @@ namespace Low {
                         l_Duration);
           l_Animator.set_animation_progress(l_NewProgress);
 
-          Util::List<Renderer::SkeletonBone> &l_Bones =
-              l_Skeleton.get_bones();
-          const u32 l_BoneCount = (u32)l_Bones.size();
-
-          Util::List<Math::Matrix4x4> &l_PoseMatrices =
-              l_SkinningPose.get_matrices();
-          if (l_PoseMatrices.size() != l_BoneCount) {
-            l_PoseMatrices.resize(l_BoneCount);
-          }
-
-          Util::List<Math::Matrix4x4> &l_LocalPose =
-              g_LocalPoseScratch;
-          l_LocalPose.resize(l_BoneCount);
-          for (u32 i = 0u; i < l_BoneCount; ++i) {
-            l_LocalPose[i] = l_Bones[i].local_bind_transform;
-          }
-
-          for (const Renderer::AnimationChannel &i_Channel :
-               l_RendererClip.get_channels()) {
-            if (i_Channel.bone_index >= l_BoneCount) {
-              continue;
-            }
-
-            Math::Vector3 i_DefaultPos(0.f);
-            Math::Quaternion i_DefaultRot(1.f, 0.f, 0.f, 0.f);
-            Math::Vector3 i_DefaultScale(1.f);
-            if (i_Channel.positions.empty() ||
-                i_Channel.rotations.empty() ||
-                i_Channel.scales.empty()) {
-              extract_transform_components(
-                  l_Bones[i_Channel.bone_index].local_bind_transform,
-                  i_DefaultPos, i_DefaultRot, i_DefaultScale);
-            }
-
-            const Math::Vector3 i_Pos = sample_vector_keys(
-                i_Channel.positions, l_NewProgress, i_DefaultPos);
-            const Math::Quaternion i_Rot = sample_quat_keys(
-                i_Channel.rotations, l_NewProgress, i_DefaultRot);
-            const Math::Vector3 i_Scale = sample_vector_keys(
-                i_Channel.scales, l_NewProgress, i_DefaultScale);
-
-            l_LocalPose[i_Channel.bone_index] =
-                glm::translate(Math::Matrix4x4(1.f), i_Pos) *
-                glm::mat4_cast(i_Rot) *
-                glm::scale(Math::Matrix4x4(1.f), i_Scale);
-          }
-
-          Util::List<Math::Matrix4x4> &l_GlobalPose =
-              g_GlobalPoseScratch;
-          l_GlobalPose.resize(l_BoneCount);
-          for (u32 i = 0u; i < l_BoneCount; ++i) {
-            if (l_Bones[i].parent_index < 0) {
-              l_GlobalPose[i] = l_LocalPose[i];
-            } else {
-              l_GlobalPose[i] =
-                  l_GlobalPose[(u32)l_Bones[i].parent_index] *
-                  l_LocalPose[i];
-            }
-            l_PoseMatrices[i] =
-                l_GlobalPose[i] * l_Bones[i].inverse_bind_matrix;
-          }
-
-          l_SkinningPose.mark_dirty();
+          l_Pose.sample_clip(l_Clip, l_NewProgress, true);
         }
 
-        static void
-        late_tick_animator(Component::MeshRenderer p_MeshRenderer)
+        static void late_tick_animator(Component::Animator p_Animator)
         {
-          Entity l_Entity = p_MeshRenderer.get_entity();
-          Component::Animator l_Animator =
-              l_Entity.get_component(Component::Animator::type_id());
+          Component::Animator l_Animator = p_Animator;
 
           Renderer::SkeletalRenderObject l_RenderObject =
               l_Animator.get_render_object();
@@ -394,13 +258,10 @@ namespace Low {
         }
 
         static void
-        tick_mesh_renderer(const float p_Delta,
+        tick_mesh_renderer(const float p_Delta, Entity p_Entity,
+                           Component::Transform p_Transform,
                            Component::MeshRenderer p_MeshRenderer)
         {
-          Entity l_Entity = p_MeshRenderer.get_entity();
-
-          Component::Transform l_Transform = l_Entity.get_transform();
-
           if (p_MeshRenderer.is_dirty()) {
             if (p_MeshRenderer.get_render_object().is_alive()) {
               p_MeshRenderer.get_render_object().destroy();
@@ -416,7 +277,7 @@ namespace Low {
                     Renderer::get_global_renderscene(),
                     p_MeshRenderer.get_mesh()));
             p_MeshRenderer.get_render_object().set_object_id(
-                l_Entity.get_index());
+                p_Entity.get_index());
           }
 
           Renderer::RenderObject l_RenderObject =
@@ -435,53 +296,87 @@ namespace Low {
 
           l_RenderObject.set_material(l_Material);
           l_RenderObject.set_world_transform(
-              l_Transform.get_world_matrix());
+              p_Transform.get_world_matrix());
         }
 
         void tick(float p_Delta, Util::EngineState p_State)
         {
-          Component::MeshRenderer *l_MeshRenderers =
-              Component::MeshRenderer::living_instances();
-
-          for (uint32_t i = 0u;
-               i < Component::MeshRenderer::living_count(); ++i) {
-            Component::MeshRenderer i_MeshRenderer =
-                l_MeshRenderers[i];
-
-            Entity i_Entity = i_MeshRenderer.get_entity();
-
-            if (i_MeshRenderer.get_mesh().is_alive() &&
-                i_MeshRenderer.get_mesh().get_type() ==
-                    Renderer::MeshType::SKELETAL &&
-                i_Entity.has_component(
-                    Component::Animator::type_id())) {
-              tick_animator(p_Delta, p_State, i_MeshRenderer);
-            } else {
-              tick_mesh_renderer(p_Delta, i_MeshRenderer);
-            }
-          }
+          LOW_PROFILE_CPU("Core", "MeshRendererSystem::TICK");
+
+          Query::for_each_chunk<Component::Transform,
+                                Component::MeshRenderer>(
+              [p_Delta, p_State](
+                  const Query::Chunk<Component::Transform,
+                                     Component::MeshRenderer>
+                      &p_Chunk) {
+                Component::Transform *l_Transforms =
+                    p_Chunk.get<Component::Transform>();
+                Component::MeshRenderer *l_MeshRenderers =
+                    p_Chunk.get<Component::MeshRenderer>();
+
+                for (u32 i = 0u; i < p_Chunk.count; ++i) {
+                  Entity i_Entity = p_Chunk.entities[i];
+                  if (!i_Entity.is_active()) {
+                    continue;
+                  }
+                  Component::MeshRenderer i_MeshRenderer =
+                      l_MeshRenderers[i];
+
+                  if (i_MeshRenderer.get_mesh().is_alive() &&
+                      i_MeshRenderer.get_mesh().get_type() ==
+                          Renderer::MeshType::SKELETAL &&
+                      i_Entity.has_component(
+                          Component::Animator::type_id())) {
+                    tick_animator(p_Delta, p_State, i_Entity,
+                                  l_Transforms[i], i_MeshRenderer);
+                  } else {
+                    tick_mesh_renderer(p_Delta, i_Entity,
+                                       l_Transforms[i],
+                                       i_MeshRenderer);
+                  }
+                }
+              });
         }
 
         void late_tick(float p_Delta, Util::EngineState p_State)
         {
-          Component::MeshRenderer *l_MeshRenderers =
-              Component::MeshRenderer::living_instances();
-
-          for (uint32_t i = 0u;
-               i < Component::MeshRenderer::living_count(); ++i) {
-            Component::MeshRenderer i_MeshRenderer =
-                l_MeshRenderers[i];
-
-            Entity i_Entity = i_MeshRenderer.get_entity();
-
-            if (i_MeshRenderer.get_mesh().is_alive() &&
-                i_MeshRenderer.get_mesh().get_type() ==
-                    Renderer::MeshType::SKELETAL &&
-                i_Entity.has_component(
-                    Component::Animator::type_id())) {
-              late_tick_animator(i_MeshRenderer);
-            }
+          LOW_PROFILE_CPU("Core", "MeshRendererSystem::LATE_TICK");
+
+          Query::for_each<Component::MeshRenderer, Component::Animator>(
+              [](Entity p_Entity,
+                 Component::MeshRenderer p_MeshRenderer,
+                 Component::Animator p_Animator) {
+                if (p_Entity.is_active() &&
+                    p_MeshRenderer.get_mesh().is_alive() &&
+                    p_MeshRenderer.get_mesh().get_type() ==
+                        Renderer::MeshType::SKELETAL) {
+                  late_tick_animator(p_Animator);
+                }
+              });
+        }
+
+        void set_entity_active(Entity p_Entity, bool p_Active)
+        {
+          if (p_Active || !p_Entity.has_component(
+                              Component::MeshRenderer::type_id())) {
+            return;
+          }
+
+          Component::MeshRenderer l_MeshRenderer =
+              p_Entity.get_component(
+                  Component::MeshRenderer::type_id());
+
+          if (l_MeshRenderer.get_render_object().is_alive()) {
+            l_MeshRenderer.get_render_object().destroy();
+          }
+
+          if (p_Entity.has_component(
+                  Component::Animator::type_id())) {
+            release_animator(p_Entity.get_component(
+                Component::Animator::type_id()));
           }
+
+          l_MeshRenderer.set_dirty(true);
         }
       } // namespace MeshRenderer
     } // namespace System
@@ -0,0 +1,286 @@
+#include "LowCoreNavigation.h"
+
+#include "LowCoreEntity.h"
+#include "LowCoreNavigationSource.h"
+#include "LowCoreNavigationWorld.h"
+#include "LowCoreRegion.h"
+#include "LowCoreScene.h"
+
+#include "LowUtil.h"
+#include "LowUtilAssert.h"
+#include "LowUtilFileIO.h"
+#include "LowUtilHashing.h"
+#include "LowUtilLogger.h"
+#include "LowUtilProfiler.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace Low {
+  namespace Core {
+    namespace Navigation {
+      static World get_region_world(Region p_Region)
+      {
+        if (!p_Region.is_alive()) {
+          return World();
+        }
+
+        Scene l_Scene = p_Region.get_scene();
+        if (!l_Scene.is_alive()) {
+          return World();
+        }
+
+        return l_Scene.get_navigation_world();
+      }
+
+      // Collects the tiles touched by the static sources of the
+      // scene together with the regions those sources live in
+      static void collect_baked_tile_owners(
+          Scene p_Scene, float p_TileWorldSize,
+          Low::Util::UnorderedMap<uint64_t,
+                                  Low::Util::List<uint64_t>>
+              &p_TileOwners,
+          Low::Util::List<TileCoord> &p_Coords, float &p_MinY,
+          float &p_MaxY)
+      {
+        for (uint32_t i = 0u; i < Source::living_count(); ++i) {
+          Source i_Source = Source::living_instances()[i];
+          if (!i_Source.is_alive() || i_Source.is_dynamic()) {
+            continue;
+          }
+
+          Entity i_Entity = i_Source.get_entity();
+          if (!i_Entity.is_alive()) {
+            continue;
+          }
+
+          Region i_Region = i_Entity.get_region();
+          if (!i_Region.is_alive() ||
+              i_Region.get_scene().get_id() != p_Scene.get_id()) {
+            continue;
+          }
+
+          Bounds i_Bounds;
+          if (!get_source_bounds(i_Source, &i_Bounds)) {
+            continue;
+          }
+          p_MinY = std::min(p_MinY, i_Bounds.min.y);
+          p_MaxY = std::max(p_MaxY, i_Bounds.max.y);
+
+          const uint64_t i_Owner = i_Region.get_unique_id();
+          const TileRange i_Range =
+              tile_range_for_bounds(i_Bounds, p_TileWorldSize);
+          for (int x = i_Range.minimum.x; x <= i_Range.maximum.x;
+               ++x) {
+            for (int z = i_Range.minimum.z; z <= i_Range.maximum.z;
+                 ++z) {
+              const TileCoord i_Coord{x, z};
+              Low::Util::List<uint64_t> &i_Owners =
+                  p_TileOwners[i_Coord.get_key()];
+              if (i_Owners.empty()) {
+                p_Coords.push_back(i_Coord);
+              }
+              if (std::find(i_Owners.begin(), i_Owners.end(),
+                            i_Owner) == i_Owners.end()) {
+                i_Owners.push_back(i_Owner);
+              }
+            }
+          }
+        }
+      }
+
+      static bool read_baked_navmesh(const Low::Util::String &p_Path,
+                                     Low::Util::List<uint8_t> &p_Data)
+      {
+        if (!Util::FileIO::file_exists_sync(p_Path.c_str())) {
+          return false;
+        }
+
+        Util::FileIO::File l_File = Util::FileIO::open(
+            p_Path.c_str(), Util::FileIO::FileMode::READ_BYTES);
+        if (!l_File.is_open()) {
+          return false;
+        }
+
+        p_Data.resize(Util::FileIO::size_sync(l_File));
+        Util::FileIO::read_sync(
+            l_File, reinterpret_cast<char *>(p_Data.data()));
+        Util::FileIO::close(l_File);
+        return true;
+      }
+
+      Low::Util::String get_baked_navmesh_path(Scene p_Scene)
+      {
+        Low::Util::String l_Path =
+            Util::get_project().dataPath + "/assets/scenes/";
+        l_Path += Util::hash_to_string(p_Scene.get_unique_id());
+        l_Path += ".navmesh";
+        return l_Path;
+      }
+
+      bool bake_navmesh(Scene p_Scene)
+      {
+        LOW_PROFILE_CPU("Core", "Navigation::bake_navmesh");
+
+        LOW_ASSERT(p_Scene.is_alive(),
+                   "Cannot bake navmesh of dead scene");
+        World l_World = p_Scene.get_navigation_world();
+        LOW_ASSERT(
+            l_World.is_alive(),
+            "Cannot bake navmesh of scene without navigation world");
+
+        const BuildSettings l_Settings = get_build_settings(l_World);
+
+        Low::Util::UnorderedMap<uint64_t, Low::Util::List<uint64_t>>
+            l_TileOwners;
+        Low::Util::List<TileCoord> l_Coords;
+        float l_MinY = std::numeric_limits<float>::max();
+        float l_MaxY = std::numeric_limits<float>::lowest();
+        collect_baked_tile_owners(p_Scene,
+                                  get_tile_world_size(l_Settings),
+                                  l_TileOwners, l_Coords, l_MinY,
+                                  l_MaxY);
+        if (l_Coords.empty()) {
+          LOW_LOG_WARN << "Scene '" << p_Scene.get_name()
+                       << "' has no static navigation sources to bake"
+                       << LOW_LOG_END;
+          return false;
+        }
+
+        // Everything gets built from scratch so tiles that dynamic
+        // sources touched at runtime do not end up in the bake
+        clear_baked_tiles(l_World);
+        clear_tile_registry(l_World);
+
+        // Leaves room for agents standing on the highest geometry
+        l_MaxY += l_Settings.agent_height;
+
+        uint32_t l_BuiltCount = 0u;
+        for (const TileCoord &i_Coord : l_Coords) {
+          ensure_tile(l_World, i_Coord, l_MinY, l_MaxY);
+
+          BuildGeometry i_Geometry;
+          if (collect_tile_build_geometry(l_World, i_Coord,
+                                          &i_Geometry, false) &&
+              build_tile_from_geometry(l_World, i_Coord,
+                                       i_Geometry)) {
+            ++l_BuiltCount;
+          } else {
+            set_tile_state(l_World, i_Coord, TileState::Failed);
+          }
+        }
+
+        Low::Util::List<uint8_t> l_Data;
+        save_baked_tiles(l_World, l_TileOwners, l_Data);
+
+        const Low::Util::String l_Path =
+            get_baked_navmesh_path(p_Scene);
+        Util::FileIO::File l_File = Util::FileIO::open(
+            l_Path.c_str(), Util::FileIO::FileMode::WRITE_BYTES);
+        if (!l_File.is_open()) {
+          LOW_LOG_ERROR << "Could not open '" << l_Path
+                        << "' to write baked navmesh" << LOW_LOG_END;
+          return false;
+        }
+        const bool l_Written =
+            Util::FileIO::write_array(l_File, l_Data);
+        Util::FileIO::close(l_File);
+        if (!l_Written) {
+          LOW_LOG_ERROR << "Could not write baked navmesh '" << l_Path
+                        << "'" << LOW_LOG_END;
+          return false;
+        }
+
+        // The baked tiles are in the navmesh already, this only lets
+        // the world know which regions they belong to
+        set_baked_tiles(l_World, l_Data);
+        for (auto it = p_Scene.get_regions().begin();
+             it != p_Scene.get_regions().end(); ++it) {
+          Region i_Region =
+              Util::find_handle_by_unique_id(*it).get_id();
+          if (i_Region.is_alive() && i_Region.is_loaded()) {
+            stream_in_baked_tiles(l_World, i_Region.get_unique_id());
+          }
+        }
+
+        // Dynamic sources were left out, their tiles get rebuilt
+        for (uint32_t i = 0u; i < Source::living_count(); ++i) {
+          Source i_Source = Source::living_instances()[i];
+          if (i_Source.is_alive() && i_Source.is_dynamic()) {
+            mark_source_dirty(i_Source);
+          }
+        }
+
+        LOW_LOG_INFO << "Baked " << l_BuiltCount << " of "
+                     << static_cast<uint32_t>(l_Coords.size())
+                     << " navigation tiles of scene '"
+                     << p_Scene.get_name() << "'" << LOW_LOG_END;
+        return l_BuiltCount == l_Coords.size();
+      }
+
+      bool load_baked_navmesh(Scene p_Scene)
+      {
+        LOW_PROFILE_CPU("Core", "Navigation::load_baked_navmesh");
+
+        LOW_ASSERT(p_Scene.is_alive(),
+                   "Cannot load baked navmesh of dead scene");
+        World l_World = p_Scene.get_navigation_world();
+        if (!l_World.is_alive()) {
+          return false;
+        }
+
+        const Low::Util::String l_Path =
+            get_baked_navmesh_path(p_Scene);
+        Low::Util::List<uint8_t> l_Data;
+        if (!read_baked_navmesh(l_Path, l_Data)) {
+          return false;
+        }
+
+        if (!set_baked_tiles(l_World, l_Data)) {
+          // Tiles get built at runtime until the scene is baked
+          // again
+          LOW_LOG_WARN << "Baked navmesh '" << l_Path
+                       << "' is outdated, ignoring it" << LOW_LOG_END;
+          clear_baked_tiles(l_World);
+          return false;
+        }
+
+        return true;
+      }
+
+      void unload_baked_navmesh(Scene p_Scene)
+      {
+        if (!p_Scene.is_alive()) {
+          return;
+        }
+
+        World l_World = p_Scene.get_navigation_world();
+        if (l_World.is_alive()) {
+          clear_baked_tiles(l_World);
+        }
+      }
+
+      uint32_t stream_in_region(Region p_Region)
+      {
+        World l_World = get_region_world(p_Region);
+        if (!l_World.is_alive()) {
+          return 0u;
+        }
+
+        return stream_in_baked_tiles(l_World,
+                                     p_Region.get_unique_id());
+      }
+
+      uint32_t stream_out_region(Region p_Region)
+      {
+        World l_World = get_region_world(p_Region);
+        if (!l_World.is_alive()) {
+          return 0u;
+        }
+
+        return stream_out_baked_tiles(l_World,
+                                      p_Region.get_unique_id());
+      }
+    } // namespace Navigation
+  }   // namespace Core
+} // namespace Low
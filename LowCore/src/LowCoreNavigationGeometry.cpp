@@ -28,14 +28,11 @@ namespace Low {
       static bool g_NavmeshDebugRenderingEnabled = false;
       static bool g_TileDebugRenderingEnabled = false;
       static bool g_InvokerDebugRenderingEnabled = false;
-      static std::vector<u64> g_SourcesBeingMarkedDirty;
+      static Low::Util::UnorderedSet<u64> g_SourcesBeingMarkedDirty;
 
       bool is_source_being_marked_dirty(Source p_Source)
       {
-        const u64 l_SourceId = p_Source.get_id();
-        return std::find(g_SourcesBeingMarkedDirty.begin(),
-                         g_SourcesBeingMarkedDirty.end(),
-                         l_SourceId) !=
+        return g_SourcesBeingMarkedDirty.find(p_Source.get_id()) !=
                g_SourcesBeingMarkedDirty.end();
       }
 
@@ -46,15 +43,12 @@ namespace Low {
         SourceDirtyGuard(Source p_Source)
             : source_id(p_Source.get_id())
         {
-          g_SourcesBeingMarkedDirty.push_back(source_id);
+          g_SourcesBeingMarkedDirty.insert(source_id);
         }
 
         ~SourceDirtyGuard()
         {
-          g_SourcesBeingMarkedDirty.erase(
-              std::remove(g_SourcesBeingMarkedDirty.begin(),
-                          g_SourcesBeingMarkedDirty.end(), source_id),
-              g_SourcesBeingMarkedDirty.end());
+          g_SourcesBeingMarkedDirty.erase(source_id);
         }
       };
 
@@ -821,27 +815,40 @@ namespace Low {
           return false;
         }
 
-        static bool source_belongs_to_world(Source p_Source,
-                                            World p_World)
+        static World get_source_world(Source p_Source)
         {
-          if (!p_Source.is_alive() || !p_World.is_alive()) {
-            return false;
+          if (!p_Source.is_alive()) {
+            return World();
           }
 
           Entity l_Entity = p_Source.get_entity();
           if (!l_Entity.is_alive()) {
-            return false;
+            return World();
           }
 
           Region l_Region = l_Entity.get_region();
           if (!l_Region.is_alive()) {
-            return false;
+            return World();
           }
 
           Scene l_Scene = l_Region.get_scene();
-          return l_Scene.is_alive() &&
-                 l_Scene.get_navigation_world().get_id() ==
-                     p_World.get_id();
+          if (!l_Scene.is_alive()) {
+            return World();
+          }
+
+          return l_Scene.get_navigation_world();
+        }
+
+        static bool source_belongs_to_world(Source p_Source,
+                                            World p_World)
+        {
+          if (!p_World.is_alive()) {
+            return false;
+          }
+
+          World l_World = get_source_world(p_Source);
+          return l_World.is_alive() &&
+                 l_World.get_id() == p_World.get_id();
         }
 
         struct InvokerInfo
@@ -865,12 +872,15 @@ namespace Low {
         struct WorldInvokerTileCache
         {
           uint64_t world_id = 0ull;
-          Low::Util::List<InvokerTileCacheEntry> entries;
+          // Keyed by the unique id of the invoker
+          Low::Util::UnorderedMap<uint64_t, InvokerTileCacheEntry>
+              entries;
           bool eviction_requested = false;
           uint32_t ticks_since_eviction = 0u;
         };
 
-        static Low::Util::List<WorldInvokerTileCache>
+        static Low::Util::UnorderedMap<uint64_t,
+                                       WorldInvokerTileCache>
             g_InvokerTileCaches;
 
         static bool tile_ranges_equal(const TileRange &p_A,
@@ -884,17 +894,10 @@ namespace Low {
         get_world_invoker_tile_cache(World p_World)
         {
           const uint64_t l_WorldId = p_World.get_id();
-          for (WorldInvokerTileCache &i_Cache :
-               g_InvokerTileCaches) {
-            if (i_Cache.world_id == l_WorldId) {
-              return &i_Cache;
-            }
-          }
-
-          WorldInvokerTileCache l_Cache;
+          WorldInvokerTileCache &l_Cache =
+              g_InvokerTileCaches[l_WorldId];
           l_Cache.world_id = l_WorldId;
-          g_InvokerTileCaches.push_back(l_Cache);
-          return &g_InvokerTileCaches.back();
+          return &l_Cache;
         }
 
         static InvokerTileCacheEntry *find_invoker_cache_entry(
@@ -904,13 +907,11 @@ namespace Low {
             return nullptr;
           }
 
-          for (InvokerTileCacheEntry &i_Entry :
-               p_Cache->entries) {
-            if (i_Entry.invoker_id == p_InvokerId) {
-              return &i_Entry;
-            }
+          auto l_Pos = p_Cache->entries.find(p_InvokerId);
+          if (l_Pos == p_Cache->entries.end()) {
+            return nullptr;
           }
-          return nullptr;
+          return &l_Pos->second;
         }
 
         static void begin_invoker_cache_update(
@@ -920,9 +921,8 @@ namespace Low {
             return;
           }
 
-          for (InvokerTileCacheEntry &i_Entry :
-               p_Cache->entries) {
-            i_Entry.touched = false;
+          for (auto &i_Entry : p_Cache->entries) {
+            i_Entry.second.touched = false;
           }
         }
 
@@ -935,7 +935,7 @@ namespace Low {
 
           for (auto it = p_Cache->entries.begin();
                it != p_Cache->entries.end();) {
-            if (!it->touched) {
+            if (!it->second.touched) {
               p_Cache->eviction_requested = true;
               it = p_Cache->entries.erase(it);
             } else {
@@ -1204,6 +1204,195 @@ namespace Low {
                                       true);
           }
         }
+        // Sources keep their triangles in world space until their
+        // transform, collider or settings change, all of which go
+        // through mark_source_dirty. Each world also keeps a grid
+        // of the tiles the bounds of its sources touch, so
+        // gathering the geometry of a tile only looks at the sources
+        // that can contribute to it.
+        struct SourceCache
+        {
+          BuildGeometry geometry;
+          bool geometry_valid = false;
+          bool registered = false;
+          uint64_t world_id = 0ull;
+          TileRange range;
+        };
+
+        struct WorldSourceGrid
+        {
+          float tile_world_size = 0.0f;
+          Low::Util::UnorderedMap<uint64_t, Low::Util::List<uint64_t>>
+              cells;
+        };
+
+        static Low::Util::UnorderedMap<uint64_t, SourceCache>
+            g_SourceCaches;
+        static Low::Util::UnorderedMap<uint64_t, WorldSourceGrid>
+            g_SourceGrids;
+        // Sources that could not be sorted into a grid yet, mostly
+        // because their entity was not part of a scene at the time
+        static Low::Util::UnorderedSet<uint64_t>
+            g_UnregisteredSources;
+
+        static void unregister_source(uint64_t p_SourceId,
+                                      SourceCache &p_Cache)
+        {
+          if (!p_Cache.registered) {
+            return;
+          }
+          p_Cache.registered = false;
+
+          auto l_Grid = g_SourceGrids.find(p_Cache.world_id);
+          if (l_Grid == g_SourceGrids.end()) {
+            return;
+          }
+
+          for (int x = p_Cache.range.minimum.x;
+               x <= p_Cache.range.maximum.x; ++x) {
+            for (int z = p_Cache.range.minimum.z;
+                 z <= p_Cache.range.maximum.z; ++z) {
+              const TileCoord i_Coord{x, z};
+              auto i_Cell =
+                  l_Grid->second.cells.find(i_Coord.get_key());
+              if (i_Cell == l_Grid->second.cells.end()) {
+                continue;
+              }
+
+              Low::Util::List<uint64_t> &i_Sources = i_Cell->second;
+              i_Sources.erase(std::remove(i_Sources.begin(),
+                                          i_Sources.end(),
+                                          p_SourceId),
+                              i_Sources.end());
+              if (i_Sources.empty()) {
+                l_Grid->second.cells.erase(i_Cell);
+              }
+            }
+          }
+        }
+
+        static WorldSourceGrid &get_world_source_grid(World p_World)
+        {
+          const float l_TileWorldSize =
+              get_tile_world_size(get_build_settings(p_World));
+          WorldSourceGrid &l_Grid = g_SourceGrids[p_World.get_id()];
+          if (l_Grid.tile_world_size == l_TileWorldSize) {
+            return l_Grid;
+          }
+
+          // The tiles changed size, all sources of the world have to
+          // be sorted in again
+          for (auto &i_Entry : g_SourceCaches) {
+            if (i_Entry.second.registered &&
+                i_Entry.second.world_id == p_World.get_id()) {
+              i_Entry.second.registered = false;
+              g_UnregisteredSources.insert(i_Entry.first);
+            }
+          }
+          l_Grid.cells.clear();
+          l_Grid.tile_world_size = l_TileWorldSize;
+          return l_Grid;
+        }
+
+        static void register_source(Source p_Source, World p_World,
+                                    const Bounds &p_Bounds)
+        {
+          const uint64_t l_SourceId = p_Source.get_id();
+          SourceCache &l_Cache = g_SourceCaches[l_SourceId];
+          unregister_source(l_SourceId, l_Cache);
+
+          WorldSourceGrid &l_Grid = get_world_source_grid(p_World);
+          l_Cache.world_id = p_World.get_id();
+          l_Cache.range =
+              tile_range_for_bounds(p_Bounds, l_Grid.tile_world_size);
+          for (int x = l_Cache.range.minimum.x;
+               x <= l_Cache.range.maximum.x; ++x) {
+            for (int z = l_Cache.range.minimum.z;
+                 z <= l_Cache.range.maximum.z; ++z) {
+              const TileCoord i_Coord{x, z};
+              l_Grid.cells[i_Coord.get_key()].push_back(l_SourceId);
+            }
+          }
+          l_Cache.registered = true;
+          g_UnregisteredSources.erase(l_SourceId);
+        }
+
+        static void register_pending_sources()
+        {
+          if (g_UnregisteredSources.empty()) {
+            return;
+          }
+
+          const Low::Util::List<uint64_t> l_Pending(
+              g_UnregisteredSources.begin(),
+              g_UnregisteredSources.end());
+          for (uint64_t i_SourceId : l_Pending) {
+            Source i_Source = i_SourceId;
+            World i_World = get_source_world(i_Source);
+            if (!i_Source.is_alive()) {
+              g_UnregisteredSources.erase(i_SourceId);
+              continue;
+            }
+            if (!i_World.is_alive()) {
+              continue;
+            }
+
+            // Sources without a collider stay pending so they get
+            // picked up once one gets added
+            Bounds i_Bounds;
+            if (!get_source_bounds(i_Source, &i_Bounds)) {
+              continue;
+            }
+            register_source(i_Source, i_World, i_Bounds);
+          }
+        }
+
+        static bool append_cached_source_geometry(
+            BuildGeometry &p_Geometry, Source p_Source)
+        {
+          SourceCache &l_Cache = g_SourceCaches[p_Source.get_id()];
+          if (!l_Cache.geometry_valid) {
+            l_Cache.geometry.vertices.clear();
+            l_Cache.geometry.indices.clear();
+            l_Cache.geometry.triangle_area_types.clear();
+            l_Cache.geometry.bounds = Bounds();
+            append_source_geometry(l_Cache.geometry, p_Source);
+            l_Cache.geometry_valid = true;
+          }
+
+          const BuildGeometry &l_Source = l_Cache.geometry;
+          if (l_Source.indices.empty()) {
+            return false;
+          }
+
+          const uint32_t l_BaseIndex =
+              static_cast<uint32_t>(p_Geometry.vertices.size());
+          p_Geometry.vertices.insert(p_Geometry.vertices.end(),
+                                     l_Source.vertices.begin(),
+                                     l_Source.vertices.end());
+          p_Geometry.indices.reserve(p_Geometry.indices.size() +
+                                     l_Source.indices.size());
+          for (uint32_t i_Index : l_Source.indices) {
+            p_Geometry.indices.push_back(l_BaseIndex + i_Index);
+          }
+          p_Geometry.triangle_area_types.insert(
+              p_Geometry.triangle_area_types.end(),
+              l_Source.triangle_area_types.begin(),
+              l_Source.triangle_area_types.end());
+          return true;
+        }
+
+      void forget_source(Source p_Source)
+      {
+        const uint64_t l_SourceId = p_Source.get_id();
+        auto l_Pos = g_SourceCaches.find(l_SourceId);
+        if (l_Pos != g_SourceCaches.end()) {
+          unregister_source(l_SourceId, l_Pos->second);
+          g_SourceCaches.erase(l_Pos);
+        }
+        g_UnregisteredSources.erase(l_SourceId);
+      }
+
       bool refresh_source_bounds(Source p_Source)
       {
         if (!p_Source.is_alive()) {
@@ -1242,6 +1431,10 @@ namespace Low {
           return false;
         }
 
+        const uint64_t l_SourceId = p_Source.get_id();
+        SourceCache &l_Cache = g_SourceCaches[l_SourceId];
+        l_Cache.geometry_valid = false;
+
         p_Source.set_tile_dirty(true);
         if (is_source_being_marked_dirty(p_Source)) {
           return false;
@@ -1249,23 +1442,10 @@ namespace Low {
 
         SourceDirtyGuard l_DirtyGuard(p_Source);
 
-        Entity l_Entity = p_Source.get_entity();
-        if (!l_Entity.is_alive()) {
-          return false;
-        }
-
-        Region l_Region = l_Entity.get_region();
-        if (!l_Region.is_alive()) {
-          return false;
-        }
-
-        Scene l_Scene = l_Region.get_scene();
-        if (!l_Scene.is_alive()) {
-          return false;
-        }
-
-        World l_World = l_Scene.get_navigation_world();
+        World l_World = get_source_world(p_Source);
         if (!l_World.is_alive()) {
+          unregister_source(l_SourceId, l_Cache);
+          g_UnregisteredSources.insert(l_SourceId);
           return false;
         }
 
@@ -1281,6 +1461,11 @@ namespace Low {
             for (int z = l_Range.minimum.z; z <= l_Range.maximum.z;
                  ++z) {
               const TileCoord i_Coord{x, z};
+              // Static sources are part of the baked tiles already
+              if (!p_Source.is_dynamic() &&
+                  is_baked_tile(l_World, i_Coord)) {
+                continue;
+              }
               ensure_tile(l_World, i_Coord, p_Bounds.min.y,
                           p_Bounds.max.y);
               set_tile_state(l_World, i_Coord, TileState::Dirty);
@@ -1298,8 +1483,11 @@ namespace Low {
           dirty_bounds(l_NewBounds);
           p_Source.set_bounds(l_NewBounds);
           p_Source.set_bounds_valid(true);
+          register_source(p_Source, l_World, l_NewBounds);
         } else {
           p_Source.set_bounds_valid(false);
+          unregister_source(l_SourceId, l_Cache);
+          g_UnregisteredSources.insert(l_SourceId);
         }
 
         return l_DirtiedTile;
@@ -1377,10 +1565,9 @@ namespace Low {
                                    l_RemovalRange) ||
                 l_CacheEntry->removal_radius != l_RemovalRadius;
           } else {
-            InvokerTileCacheEntry l_NewEntry;
-            l_NewEntry.invoker_id = i_Invoker.get_unique_id();
-            l_Cache->entries.push_back(l_NewEntry);
-            l_CacheEntry = &l_Cache->entries.back();
+            l_CacheEntry =
+                &l_Cache->entries[i_Invoker.get_unique_id()];
+            l_CacheEntry->invoker_id = i_Invoker.get_unique_id();
           }
 
           l_CacheEntry->generation_range = l_GenerationRange;
@@ -1411,7 +1598,9 @@ namespace Low {
 
               ensure_tile(p_World, i_Coord, p_MinY, p_MaxY,
                           &i_Tile);
-              if (!l_HadTile || i_Tile.state == TileState::Empty) {
+              // Baked tiles come in with their regions
+              if ((!l_HadTile || i_Tile.state == TileState::Empty) &&
+                  !is_baked_tile(p_World, i_Coord)) {
                 set_tile_state(p_World, i_Coord,
                                TileState::Dirty);
                 ++l_DirtiedTileCount;
@@ -1444,7 +1633,9 @@ namespace Low {
             break;
           }
 
-          if (tile_inside_any_invoker_removal_radius(i_Tile,
+          // Baked tiles leave with their regions instead
+          if (is_baked_tile(p_World, i_Tile.coord) ||
+              tile_inside_any_invoker_removal_radius(i_Tile,
                                                      l_Invokers)) {
             continue;
           }
@@ -1502,9 +1693,16 @@ namespace Low {
         {
           TileCoord coord;
           float priority = 0.0f;
+          uint64_t dirty_sequence = 0u;
         };
 
+        // The priority is the ring of tiles around the nearest
+        // invoker, so within a ring the tile that has been dirty for
+        // the longest goes first
+        const float l_TileWorldSize =
+            get_tile_world_size(get_build_settings(p_World));
         Low::Util::List<QueueCandidate> l_Candidates;
+        l_Candidates.reserve(l_Tiles.size());
         for (const Tile &i_Tile : l_Tiles) {
           if (i_Tile.state != TileState::Dirty) {
             continue;
@@ -1512,25 +1710,35 @@ namespace Low {
 
           QueueCandidate l_Candidate;
           l_Candidate.coord = i_Tile.coord;
-          l_Candidate.priority =
-              nearest_invoker_distance_squared(i_Tile, l_Invokers);
+          l_Candidate.priority = std::floor(
+              std::sqrt(nearest_invoker_distance_squared(
+                  i_Tile, l_Invokers)) /
+              l_TileWorldSize);
+          l_Candidate.dirty_sequence = i_Tile.dirty_sequence;
           l_Candidates.push_back(l_Candidate);
         }
 
-        std::sort(l_Candidates.begin(), l_Candidates.end(),
-                  [](const QueueCandidate &p_A,
-                     const QueueCandidate &p_B) {
-                    return p_A.priority < p_B.priority;
-                  });
-
-        uint32_t l_QueuedCount = 0u;
-        for (const QueueCandidate &i_Candidate : l_Candidates) {
-          if (p_MaxTilesToQueue > 0u &&
-              l_QueuedCount >= p_MaxTilesToQueue) {
-            break;
+        const auto l_Before = [](const QueueCandidate &p_A,
+                                 const QueueCandidate &p_B) {
+          if (p_A.priority != p_B.priority) {
+            return p_A.priority < p_B.priority;
           }
+          return p_A.dirty_sequence < p_B.dirty_sequence;
+        };
+
+        // Only the tiles that make it into the queue this tick have
+        // to be in order
+        auto l_End = l_Candidates.end();
+        if (p_MaxTilesToQueue > 0u &&
+            p_MaxTilesToQueue < l_Candidates.size()) {
+          l_End = l_Candidates.begin() + p_MaxTilesToQueue;
+        }
+        std::partial_sort(l_Candidates.begin(), l_End,
+                          l_Candidates.end(), l_Before);
 
-          if (queue_tile(p_World, i_Candidate.coord)) {
+        uint32_t l_QueuedCount = 0u;
+        for (auto it = l_Candidates.begin(); it != l_End; ++it) {
+          if (queue_tile(p_World, it->coord, it->priority)) {
             ++l_QueuedCount;
           }
         }
@@ -1550,8 +1758,8 @@ namespace Low {
         p_Geometry->bounds = Bounds();
 
         for (uint32_t i = 0u; i < Source::living_count(); ++i) {
-          append_source_geometry(*p_Geometry,
-                                 Source::living_instances()[i]);
+          append_cached_source_geometry(
+              *p_Geometry, Source::living_instances()[i]);
         }
 
         recompute_bounds(*p_Geometry);
@@ -1569,7 +1777,7 @@ namespace Low {
 
       bool collect_build_geometry_for_world_bounds(
           World p_World, const Bounds &p_Bounds,
-          BuildGeometry *p_Geometry)
+          BuildGeometry *p_Geometry, bool p_IncludeDynamicSources)
       {
         if (!p_Geometry) {
           return false;
@@ -1580,20 +1788,55 @@ namespace Low {
         p_Geometry->triangle_area_types.clear();
         p_Geometry->bounds = p_Bounds;
 
-        for (uint32_t i = 0u; i < Source::living_count(); ++i) {
-          Source i_Source = Source::living_instances()[i];
-          if (p_World.is_alive() &&
-              !source_belongs_to_world(i_Source, p_World)) {
-            continue;
+        auto append_overlapping = [&](Source p_Source) {
+          if (!p_IncludeDynamicSources && p_Source.is_alive() &&
+              p_Source.is_dynamic()) {
+            return;
           }
 
-          Bounds i_SourceBounds;
-          if (!get_source_bounds(i_Source, &i_SourceBounds) ||
-              !bounds_overlap(p_Bounds, i_SourceBounds)) {
-            continue;
+          Bounds l_SourceBounds;
+          if (get_source_bounds(p_Source, &l_SourceBounds) &&
+              bounds_overlap(p_Bounds, l_SourceBounds)) {
+            append_cached_source_geometry(*p_Geometry, p_Source);
+          }
+        };
+
+        if (p_World.is_alive()) {
+          WorldSourceGrid &l_Grid = get_world_source_grid(p_World);
+          register_pending_sources();
+
+          // Sources that span several tiles show up in several cells
+          Low::Util::List<uint64_t> l_Candidates;
+          const TileRange l_Range =
+              tile_range_for_bounds(p_Bounds, l_Grid.tile_world_size);
+          for (int x = l_Range.minimum.x; x <= l_Range.maximum.x;
+               ++x) {
+            for (int z = l_Range.minimum.z; z <= l_Range.maximum.z;
+                 ++z) {
+              const TileCoord i_Coord{x, z};
+              auto i_Cell = l_Grid.cells.find(i_Coord.get_key());
+              if (i_Cell != l_Grid.cells.end()) {
+                l_Candidates.insert(l_Candidates.end(),
+                                    i_Cell->second.begin(),
+                                    i_Cell->second.end());
+              }
+            }
           }
+          std::sort(l_Candidates.begin(), l_Candidates.end());
+          l_Candidates.erase(
+              std::unique(l_Candidates.begin(), l_Candidates.end()),
+              l_Candidates.end());
 
-          append_source_geometry(*p_Geometry, i_Source);
+          for (uint64_t i_SourceId : l_Candidates) {
+            Source i_Source = i_SourceId;
+            if (source_belongs_to_world(i_Source, p_World)) {
+              append_overlapping(i_Source);
+            }
+          }
+        } else {
+          for (uint32_t i = 0u; i < Source::living_count(); ++i) {
+            append_overlapping(Source::living_instances()[i]);
+          }
         }
 
         if (p_Geometry->vertices.empty() ||
@@ -1605,9 +1848,12 @@ namespace Low {
         return true;
       }
 
-      bool build_tile(World p_World, TileCoord p_Coord)
+      bool collect_tile_build_geometry(World p_World,
+                                       TileCoord p_Coord,
+                                       BuildGeometry *p_Geometry,
+                                       bool p_IncludeDynamicSources)
       {
-        if (!p_World.is_alive()) {
+        if (!p_World.is_alive() || !p_Geometry) {
           return false;
         }
 
@@ -1625,9 +1871,20 @@ namespace Low {
         const Bounds l_BuildBounds =
             expand_bounds(l_Tile.bounds, l_BorderPadding);
 
+        return collect_build_geometry_for_world_bounds(
+            p_World, l_BuildBounds, p_Geometry,
+            p_IncludeDynamicSources);
+      }
+
+      bool build_tile(World p_World, TileCoord p_Coord)
+      {
+        if (!p_World.is_alive()) {
+          return false;
+        }
+
         BuildGeometry l_Geometry;
-        if (!collect_build_geometry_for_world_bounds(
-                p_World, l_BuildBounds, &l_Geometry)) {
+        if (!collect_tile_build_geometry(p_World, p_Coord,
+                                         &l_Geometry)) {
           set_tile_state(p_World, p_Coord, TileState::Failed);
           return false;
         }
@@ -1,12 +1,22 @@
 #include "LowCoreNavigationSystem.h"
 
 #include "LowCoreNavigation.h"
+#include "LowCoreNavmeshAgent.h"
+#include "LowCoreRegion.h"
 #include "LowCoreScene.h"
+#include "LowCoreTransform.h"
+
+#include "LowRenderer.h"
+
+#include "LowMathVectorUtil.h"
 
 #include "LowUtil.h"
 #include "LowUtilConfig.h"
+#include "LowUtilJobManager.h"
 #include "LowUtilProfiler.h"
 
+#include <algorithm>
+
 namespace Low {
   namespace Core {
     namespace System {
@@ -30,10 +40,24 @@ namespace Low {
               setting_name("max_y"), 1000.0f);
         }
 
+        // Tiles build on the job workers, this only limits how many
+        // builds get started per tick
         static uint32_t get_max_tiles_per_tick()
         {
           return Low::Util::get_project().settings.get_u32(
-              setting_name("max_tiles_per_tick"), 1u);
+              setting_name("max_tiles_per_tick"), 4u);
+        }
+
+        static uint32_t get_max_running_tile_builds()
+        {
+          return Low::Util::get_project().settings.get_u32(
+              setting_name("max_running_tile_builds"), 0u);
+        }
+
+        static float get_tile_build_budget_ms()
+        {
+          return Low::Util::get_project().settings.get_float(
+              setting_name("tile_build_budget_ms"), 2.0f);
         }
 
         static uint32_t get_max_dirty_tiles_queued_per_tick()
@@ -42,6 +66,13 @@ namespace Low {
               setting_name("max_dirty_tiles_queued_per_tick"), 8u);
         }
 
+        // Shared among all running path searches of a world
+        static uint32_t get_path_iterations_per_tick()
+        {
+          return Low::Util::get_project().settings.get_u32(
+              setting_name("path_iterations_per_tick"), 1024u);
+        }
+
         static uint32_t get_eviction_interval_ticks()
         {
           return Low::Util::get_project().settings.get_u32(
@@ -54,6 +85,343 @@ namespace Low {
               setting_name("max_evictions_per_tick"), 8u);
         }
 
+        static uint32_t get_crowd_max_target_requests_per_tick()
+        {
+          return Low::Util::get_project().settings.get_u32(
+              setting_name("crowd_max_target_requests_per_tick"),
+              16u);
+        }
+
+        // Agents farther away from the game camera only write their
+        // transform back every crowd_reduced_interval ticks and use
+        // the cheap steering. Agents beyond the freeze distance or in
+        // inactive regions leave the crowd. Zero turns a level off.
+        static float get_crowd_reduced_distance()
+        {
+          return Low::Util::get_project().settings.get_float(
+              setting_name("crowd_reduced_distance"), 40.0f);
+        }
+
+        static float get_crowd_freeze_distance()
+        {
+          return Low::Util::get_project().settings.get_float(
+              setting_name("crowd_freeze_distance"), 120.0f);
+        }
+
+        static uint32_t get_crowd_reduced_interval()
+        {
+          return std::max(Low::Util::get_project().settings.get_u32(
+                              setting_name("crowd_reduced_interval"),
+                              4u),
+                          1u);
+        }
+
+        struct AgentBinding
+        {
+          Low::Core::Navigation::World world;
+          int crowd_agent = -1;
+          Low::Core::Navigation::CrowdAgentParams params;
+          Math::Vector3 target = Math::Vector3(0.0f);
+          bool has_target = false;
+        };
+
+        struct AgentUpdate
+        {
+          Component::Transform transform;
+          Low::Core::Navigation::World world;
+          int crowd_agent = -1;
+          Math::Vector3 offset;
+          Math::Vector3 position;
+          Math::Matrix4x4 parent_matrix;
+          bool has_parent = false;
+          bool inactive = false;
+          Low::Core::Navigation::CrowdAgentLod lod;
+          Low::Core::Navigation::CrowdAgentLod previous_lod;
+          bool write_back = false;
+          Math::Vector3 local_position;
+        };
+
+        // Crowd agents of the navmesh agent components, stored by
+        // component handle id
+        static Util::UnorderedMap<u64, AgentBinding> g_Agents;
+        static Util::List<AgentUpdate> g_AgentUpdates;
+        static u64 g_CrowdFrame = 0u;
+        // Frozen agents only rejoin once they are clearly back in
+        // range, so they do not flip in and out of the crowd
+        static const float g_ThawDistanceFactor = 0.9f;
+
+        static Low::Core::Navigation::World
+        get_agent_world(Entity p_Entity)
+        {
+          Region l_Region = p_Entity.get_region();
+          if (!l_Region.is_alive()) {
+            return Util::Handle::DEAD;
+          }
+          Scene l_Scene = l_Region.get_scene();
+          if (!l_Scene.is_alive()) {
+            return Util::Handle::DEAD;
+          }
+          return l_Scene.get_navigation_world();
+        }
+
+        static void reset_agents()
+        {
+          for (auto &i_Entry : g_Agents) {
+            if (i_Entry.second.crowd_agent >= 0) {
+              Low::Core::Navigation::remove_crowd_agent(
+                  i_Entry.second.world, i_Entry.second.crowd_agent);
+            }
+
+            Component::NavmeshAgent i_Agent = i_Entry.first;
+            if (i_Agent.is_alive()) {
+              i_Agent.set_agent_index(-1);
+            }
+          }
+          g_Agents.clear();
+          g_AgentUpdates.clear();
+        }
+
+        void set_agent_target(Component::NavmeshAgent p_Agent,
+                              const Math::Vector3 &p_Target)
+        {
+          AgentBinding &l_Binding = g_Agents[p_Agent.get_id()];
+          l_Binding.target = p_Target;
+          l_Binding.has_target = true;
+
+          if (l_Binding.crowd_agent >= 0 &&
+              l_Binding.world.is_alive()) {
+            Low::Core::Navigation::set_crowd_agent_target(
+                l_Binding.world, l_Binding.crowd_agent, p_Target);
+          }
+        }
+
+        void remove_agent(Component::NavmeshAgent p_Agent)
+        {
+          auto l_Pos = g_Agents.find(p_Agent.get_id());
+          if (l_Pos == g_Agents.end()) {
+            return;
+          }
+
+          if (l_Pos->second.crowd_agent >= 0) {
+            Low::Core::Navigation::remove_crowd_agent(
+                l_Pos->second.world, l_Pos->second.crowd_agent);
+          }
+          g_Agents.erase(l_Pos);
+        }
+
+        // Puts new agents into the crowd of their world and collects
+        // what the parallel passes below need from the transforms,
+        // which cannot be read from the workers
+        static void gather_agents()
+        {
+          g_AgentUpdates.clear();
+
+          for (uint32_t i = 0u;
+               i < Component::NavmeshAgent::living_count(); ++i) {
+            Component::NavmeshAgent i_Agent =
+                Component::NavmeshAgent::living_instances()[i];
+            Entity i_Entity = i_Agent.get_entity();
+            if (!i_Entity.is_alive()) {
+              continue;
+            }
+            Component::Transform i_Transform =
+                i_Entity.get_transform();
+            Low::Core::Navigation::World i_World =
+                get_agent_world(i_Entity);
+            if (!i_Transform.is_alive() || !i_World.is_alive()) {
+              continue;
+            }
+
+            Low::Core::Navigation::CrowdAgentParams i_Params;
+            i_Params.radius = i_Agent.get_radius();
+            i_Params.height = i_Agent.get_height();
+            i_Params.max_speed = i_Agent.get_speed();
+
+            AgentUpdate i_Update;
+            i_Update.transform = i_Transform;
+            i_Update.world = i_World;
+            i_Update.offset = i_Agent.get_offset();
+            i_Update.position =
+                i_Transform.get_world_position() + i_Update.offset;
+
+            AgentBinding &i_Binding = g_Agents[i_Agent.get_id()];
+            if (i_Binding.crowd_agent < 0 ||
+                i_Binding.world != i_World) {
+              if (i_Binding.crowd_agent >= 0) {
+                Low::Core::Navigation::remove_crowd_agent(
+                    i_Binding.world, i_Binding.crowd_agent);
+              }
+              i_Binding.world = i_World;
+              i_Binding.params = i_Params;
+              i_Binding.crowd_agent =
+                  Low::Core::Navigation::add_crowd_agent(
+                      i_World, i_Update.position, i_Params);
+              i_Agent.set_agent_index(i_Binding.crowd_agent);
+
+              if (i_Binding.has_target) {
+                Low::Core::Navigation::set_crowd_agent_target(
+                    i_World, i_Binding.crowd_agent,
+                    i_Binding.target);
+              }
+            } else if (i_Binding.params.radius != i_Params.radius ||
+                       i_Binding.params.height != i_Params.height ||
+                       i_Binding.params.max_speed !=
+                           i_Params.max_speed) {
+              i_Binding.params = i_Params;
+              Low::Core::Navigation::set_crowd_agent_params(
+                  i_World, i_Binding.crowd_agent, i_Params);
+            }
+            i_Update.crowd_agent = i_Binding.crowd_agent;
+
+            Component::Transform i_Parent = i_Transform.get_parent();
+            if (i_Parent.is_alive()) {
+              i_Update.has_parent = true;
+              i_Update.parent_matrix = i_Parent.get_world_matrix();
+            }
+
+            Region i_Region = i_Entity.get_region();
+            i_Update.inactive =
+                !i_Entity.is_active() || !i_Region.is_loaded();
+
+            g_AgentUpdates.push_back(i_Update);
+          }
+        }
+
+        static void update_agent_lods()
+        {
+          const float l_ReducedDistance =
+              get_crowd_reduced_distance();
+          const float l_FreezeDistance = get_crowd_freeze_distance();
+          const float l_ThawDistance =
+              l_FreezeDistance * g_ThawDistanceFactor;
+          const Math::Vector3 l_Focus =
+              Renderer::get_game_renderview().get_camera_position();
+
+          Low::Util::JobManager::Parallel::for_each(
+              static_cast<uint32_t>(g_AgentUpdates.size()), 256u,
+              [&](uint32_t p_Begin, uint32_t p_End) {
+                for (uint32_t i = p_Begin; i < p_End; ++i) {
+                  AgentUpdate &i_Update = g_AgentUpdates[i];
+
+                  Low::Core::Navigation::CrowdAgentState i_State;
+                  Low::Core::Navigation::get_crowd_agent_state(
+                      i_Update.world, i_Update.crowd_agent,
+                      &i_State);
+                  i_Update.previous_lod = i_State.lod;
+
+                  const float i_DistanceSquared =
+                      Math::VectorUtil::distance_squared(
+                          i_Update.position, l_Focus);
+                  const float i_FreezeDistance =
+                      i_State.lod ==
+                              Low::Core::Navigation::CrowdAgentLod::
+                                  Frozen
+                          ? l_ThawDistance
+                          : l_FreezeDistance;
+
+                  if (i_Update.inactive ||
+                      (l_FreezeDistance > 0.0f &&
+                       i_DistanceSquared >
+                           i_FreezeDistance * i_FreezeDistance)) {
+                    i_Update.lod =
+                        Low::Core::Navigation::CrowdAgentLod::Frozen;
+                  } else if (l_ReducedDistance > 0.0f &&
+                             i_DistanceSquared >
+                                 l_ReducedDistance *
+                                     l_ReducedDistance) {
+                    i_Update.lod =
+                        Low::Core::Navigation::CrowdAgentLod::Reduced;
+                  } else {
+                    i_Update.lod =
+                        Low::Core::Navigation::CrowdAgentLod::Full;
+                  }
+                }
+              });
+
+          uint32_t l_FrozenCount = 0u;
+          for (AgentUpdate &i_Update : g_AgentUpdates) {
+            if (i_Update.lod ==
+                Low::Core::Navigation::CrowdAgentLod::Frozen) {
+              ++l_FrozenCount;
+            }
+            if (i_Update.lod == i_Update.previous_lod) {
+              continue;
+            }
+
+            // The entity might have been moved while its agent was
+            // out of the crowd
+            if (i_Update.previous_lod ==
+                Low::Core::Navigation::CrowdAgentLod::Frozen) {
+              Low::Core::Navigation::set_crowd_agent_position(
+                  i_Update.world, i_Update.crowd_agent,
+                  i_Update.position);
+            }
+            Low::Core::Navigation::set_crowd_agent_lod(
+                i_Update.world, i_Update.crowd_agent, i_Update.lod);
+          }
+
+          LOW_PROFILE_COUNTER("Navigation", "Frozen crowd agents",
+                              l_FrozenCount);
+        }
+
+        static void write_back_agents()
+        {
+          const uint32_t l_ReducedInterval =
+              get_crowd_reduced_interval();
+
+          // Converting the crowd positions into the local space of
+          // the parents only reads, writing the transforms happens
+          // on this thread afterwards
+          Low::Util::JobManager::Parallel::for_each(
+              static_cast<uint32_t>(g_AgentUpdates.size()), 256u,
+              [&](uint32_t p_Begin, uint32_t p_End) {
+                for (uint32_t i = p_Begin; i < p_End; ++i) {
+                  AgentUpdate &i_Update = g_AgentUpdates[i];
+
+                  // Reduced agents are staggered so they do not all
+                  // write back in the same tick
+                  i_Update.write_back =
+                      i_Update.lod ==
+                          Low::Core::Navigation::CrowdAgentLod::
+                              Full ||
+                      (i_Update.lod ==
+                           Low::Core::Navigation::CrowdAgentLod::
+                               Reduced &&
+                       (g_CrowdFrame + i_Update.crowd_agent) %
+                               l_ReducedInterval ==
+                           0u);
+                  if (!i_Update.write_back) {
+                    continue;
+                  }
+
+                  Low::Core::Navigation::CrowdAgentState i_State;
+                  if (!Low::Core::Navigation::get_crowd_agent_state(
+                          i_Update.world, i_Update.crowd_agent,
+                          &i_State) ||
+                      !i_State.on_navmesh) {
+                    i_Update.write_back = false;
+                    continue;
+                  }
+
+                  i_Update.local_position =
+                      i_State.position - i_Update.offset;
+                  if (i_Update.has_parent) {
+                    const Math::Vector4 i_Local =
+                        glm::inverse(i_Update.parent_matrix) *
+                        Math::Vector4(i_Update.local_position, 1.0f);
+                    i_Update.local_position = Math::Vector3(
+                        i_Local.x, i_Local.y, i_Local.z);
+                  }
+                }
+              });
+
+          for (AgentUpdate &i_Update : g_AgentUpdates) {
+            if (i_Update.write_back) {
+              i_Update.transform.position(i_Update.local_position);
+            }
+          }
+        }
+
         void tick(float p_Delta, Util::EngineState p_State)
         {
           if (p_State != Util::EngineState::PLAYING) {
@@ -65,12 +433,18 @@ namespace Low {
           const float l_MinY = get_runtime_min_y();
           const float l_MaxY = get_runtime_max_y();
           const uint32_t l_MaxTilesPerTick = get_max_tiles_per_tick();
+          const uint32_t l_MaxRunningTileBuilds =
+              get_max_running_tile_builds();
+          const float l_TileBuildBudgetMs =
+              get_tile_build_budget_ms();
           const uint32_t l_MaxDirtyTilesQueuedPerTick =
               get_max_dirty_tiles_queued_per_tick();
           const uint32_t l_EvictionIntervalTicks =
               get_eviction_interval_ticks();
           const uint32_t l_MaxEvictionsPerTick =
               get_max_evictions_per_tick();
+          const uint32_t l_PathIterationsPerTick =
+              get_path_iterations_per_tick();
 
           for (uint32_t i = 0u; i < Scene::living_count(); ++i) {
             Scene i_Scene = Scene::living_instances()[i];
@@ -94,8 +468,44 @@ namespace Low {
             Low::Core::Navigation::queue_dirty_tiles(
                 i_World, l_MaxDirtyTilesQueuedPerTick);
             Low::Core::Navigation::update_tile_builds(
-                i_World, l_MaxTilesPerTick);
+                i_World, l_MaxTilesPerTick, l_TileBuildBudgetMs,
+                l_MaxRunningTileBuilds);
+            Low::Core::Navigation::update_obstacles(i_World);
+            Low::Core::Navigation::update_path_requests(
+                i_World, l_PathIterationsPerTick);
+          }
+
+          // Agents only move while playing
+          if (p_State != Util::EngineState::PLAYING) {
+            if (!g_Agents.empty()) {
+              reset_agents();
+            }
+            return;
           }
+
+          LOW_PROFILE_CPU("Core", "NavigationSystem::CROWD");
+
+          ++g_CrowdFrame;
+          gather_agents();
+          update_agent_lods();
+
+          const uint32_t l_MaxTargetRequests =
+              get_crowd_max_target_requests_per_tick();
+          for (uint32_t i = 0u; i < Scene::living_count(); ++i) {
+            Scene i_Scene = Scene::living_instances()[i];
+            if (!i_Scene.is_alive() || !i_Scene.is_loaded()) {
+              continue;
+            }
+
+            Low::Core::Navigation::World i_World =
+                i_Scene.get_navigation_world();
+            if (i_World.is_alive()) {
+              Low::Core::Navigation::update_crowd(
+                  i_World, p_Delta, l_MaxTargetRequests);
+            }
+          }
+
+          write_back_agents();
         }
       } // namespace Navigation
     } // namespace System
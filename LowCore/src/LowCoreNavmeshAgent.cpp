@@ -12,8 +12,9 @@
 #include "LowUtilObserverManager.h"
 
 #include "LowCorePrefabInstance.h"
+#include "LowCoreQuery.h"
 #include "LowCoreTransform.h"
-#include "LowCoreNavmeshSystem.h"
+#include "LowCoreNavigationSystem.h"
 
 // LOW_CODEGEN:BEGIN:CUSTOM:SOURCE_CODE
 
@@ -102,9 +103,13 @@ namespace Low {
         {
           // LOW_CODEGEN:BEGIN:CUSTOM:DESTROY
 
+          System::Navigation::remove_agent(get_id());
           // LOW_CODEGEN::END::CUSTOM:DESTROY
         }
 
+        Low::Core::Query::notify_component_removed(get_entity(),
+                                                   ms_TypeId);
+
         broadcast_observable(OBSERVABLE_DESTROY);
 
         Low::Util::remove_unique_id(get_unique_id());
@@ -176,6 +181,16 @@ namespace Low {
         l_TypeInfo.get_living_count = &NavmeshAgent::living_count;
         l_TypeInfo.component = true;
         l_TypeInfo.uiComponent = false;
+        l_TypeInfo.get_page =
+            [](u32 p_Index,
+               u32 &p_SlotIndex) -> Low::Util::Instances::Page * {
+          u32 l_PageIndex = 0;
+          if (!get_page_for_index(p_Index, l_PageIndex,
+                                  p_SlotIndex)) {
+            return nullptr;
+          }
+          return ms_Pages[l_PageIndex];
+        };
         {
           // Property: speed
           Low::Util::RTTI::PropertyInfo l_PropertyInfo;
@@ -922,8 +937,8 @@ namespace Low {
       {
         // LOW_CODEGEN:BEGIN:CUSTOM:FUNCTION_set_target_position
 
-        System::Navmesh::set_agent_target_position(get_id(),
-                                                   p_TargetPosition);
+        System::Navigation::set_agent_target(get_id(),
+                                             p_TargetPosition);
         // LOW_CODEGEN::END::CUSTOM:FUNCTION_set_target_position
       }
 
@@ -3,9 +3,276 @@
 #include "LowCore.h"
 #include "LowCoreScene.h"
 
+#include "LowUtil.h"
+#include "LowUtilAssert.h"
+#include "LowUtilFileIO.h"
+#include "LowUtilLogger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
 namespace Low {
   namespace Core {
     namespace Physics {
+      static Util::Name layer_setting_name(u32 p_Layer,
+                                           const char *p_Name)
+      {
+        Util::String l_FullName = "physics/layers/";
+        l_FullName += std::to_string(p_Layer).c_str();
+        l_FullName += "/";
+        l_FullName += p_Name;
+        return LOW_NAME(l_FullName.c_str());
+      }
+
+      static Util::Name layer_count_setting_name()
+      {
+        return LOW_NAME("physics/layer_count");
+      }
+
+      static u32 layer_bit(u32 p_Layer)
+      {
+        return 1u << p_Layer;
+      }
+
+      static const u32 g_RecordingMagic = 0x5250504Cu; // LPPR
+      static const u32 g_RecordingVersion = 1u;
+
+      struct RecordingReader
+      {
+        const Util::List<u8> &data;
+        size_t offset = 0u;
+        bool failed = false;
+
+        bool read(void *p_Target, size_t p_Size)
+        {
+          if (failed || offset + p_Size > data.size()) {
+            failed = true;
+            return false;
+          }
+          if (p_Size > 0u) {
+            memcpy(p_Target, data.data() + offset, p_Size);
+          }
+          offset += p_Size;
+          return true;
+        }
+
+        template <typename T> T read_value()
+        {
+          T l_Value{};
+          read(&l_Value, sizeof(T));
+          return l_Value;
+        }
+
+        void read_list(Util::List<u8> &p_List)
+        {
+          const u32 l_Size = read_value<u32>();
+          if (failed || offset + l_Size > data.size()) {
+            failed = true;
+            return;
+          }
+          p_List.resize(l_Size);
+          read(p_List.data(), l_Size);
+        }
+      };
+
+      CollisionLayerSettings get_default_collision_layers()
+      {
+        CollisionLayerSettings l_Settings;
+        l_Settings.layer_count = 4u;
+
+        CollisionLayer &l_Static = l_Settings.layers[0];
+        l_Static.name = N(Static);
+        l_Static.group = BroadPhaseGroup::Static;
+        l_Static.collision_mask =
+            ALL_COLLISION_LAYERS & ~layer_bit(0u);
+
+        CollisionLayer &l_Moving = l_Settings.layers[1];
+        l_Moving.name = N(Moving);
+        l_Moving.group = BroadPhaseGroup::Dynamic;
+
+        CollisionLayer &l_Sensor = l_Settings.layers[2];
+        l_Sensor.name = N(Sensor);
+        l_Sensor.group = BroadPhaseGroup::Sensor;
+        l_Sensor.collision_mask = layer_bit(1u);
+
+        CollisionLayer &l_Debris = l_Settings.layers[3];
+        l_Debris.name = N(Debris);
+        l_Debris.group = BroadPhaseGroup::Debris;
+        l_Debris.collision_mask = layer_bit(0u) | layer_bit(1u);
+
+        return l_Settings;
+      }
+
+      CollisionLayerSettings get_project_collision_layers()
+      {
+        const Util::ConfigSettings &l_ProjectSettings =
+            Util::get_project().settings;
+
+        const u32 l_LayerCount = std::min(
+            l_ProjectSettings.get_u32(layer_count_setting_name(), 0u),
+            COLLISION_LAYER_COUNT);
+        if (l_LayerCount < 2u) {
+          // Static and moving bodies need their layers
+          return get_default_collision_layers();
+        }
+
+        CollisionLayerSettings l_Settings;
+        l_Settings.layer_count = l_LayerCount;
+        for (u32 i = 0u; i < l_LayerCount; ++i) {
+          CollisionLayer &i_Layer = l_Settings.layers[i];
+
+          const Util::Name i_NameSetting =
+              layer_setting_name(i, "name");
+          if (l_ProjectSettings.has(i_NameSetting)) {
+            const Util::Variant &i_Name =
+                l_ProjectSettings.get_checked(i_NameSetting);
+            i_Layer.name =
+                i_Name.m_Type == Util::VariantType::Name
+                    ? i_Name.as_name()
+                    : LOW_NAME(i_Name.as_string().c_str());
+          }
+
+          const u32 i_Group = l_ProjectSettings.get_u32(
+              layer_setting_name(i, "group"),
+              static_cast<u32>(BroadPhaseGroup::Dynamic));
+          LOW_ASSERT(i_Group <
+                         static_cast<u32>(BroadPhaseGroup::Count),
+                     "Invalid broad phase group for collision layer");
+          i_Layer.group = static_cast<BroadPhaseGroup>(i_Group);
+
+          i_Layer.collision_mask = l_ProjectSettings.get_u32(
+              layer_setting_name(i, "mask"), ALL_COLLISION_LAYERS);
+        }
+
+        return l_Settings;
+      }
+
+      bool save_project_collision_layers(
+          const CollisionLayerSettings &p_Settings)
+      {
+        Util::ConfigSettings &l_ProjectSettings =
+            Util::get_project_settings();
+
+        l_ProjectSettings.set_u32(layer_count_setting_name(),
+                                  p_Settings.layer_count);
+        for (u32 i = 0u; i < p_Settings.layer_count; ++i) {
+          const CollisionLayer &i_Layer = p_Settings.layers[i];
+          l_ProjectSettings.set(layer_setting_name(i, "name"),
+                                Util::Variant(i_Layer.name));
+          l_ProjectSettings.set_u32(
+              layer_setting_name(i, "group"),
+              static_cast<u32>(i_Layer.group));
+          l_ProjectSettings.set_u32(layer_setting_name(i, "mask"),
+                                    i_Layer.collision_mask);
+        }
+
+        return Util::save_project_settings();
+      }
+
+      u32
+      find_collision_layer(const CollisionLayerSettings &p_Settings,
+                           Util::Name p_Name)
+      {
+        for (u32 i = 0u; i < p_Settings.layer_count; ++i) {
+          if (p_Settings.layers[i].name == p_Name) {
+            return i;
+          }
+        }
+        return COLLISION_LAYER_COUNT;
+      }
+
+      bool save_recording(const Recording &p_Recording,
+                          const Util::String &p_Path)
+      {
+        Util::FileIO::File l_File = Util::FileIO::open(
+            p_Path.c_str(), Util::FileIO::FileMode::WRITE_BYTES);
+        if (!l_File.is_open()) {
+          LOW_LOG_ERROR << "Could not open '" << p_Path
+                        << "' to write physics recording"
+                        << LOW_LOG_END;
+          return false;
+        }
+
+        bool l_Success =
+            Util::FileIO::write_value(l_File, g_RecordingMagic) &&
+            Util::FileIO::write_value(l_File, g_RecordingVersion) &&
+            Util::FileIO::write_value(l_File,
+                                      p_Recording.fixed_delta) &&
+            Util::FileIO::write_value(l_File,
+                                      p_Recording.collision_steps) &&
+            Util::FileIO::write_value(
+                l_File,
+                static_cast<u32>(p_Recording.initial_state.size())) &&
+            Util::FileIO::write_array(l_File,
+                                      p_Recording.initial_state) &&
+            Util::FileIO::write_value(
+                l_File, static_cast<u32>(p_Recording.frames.size()));
+
+        for (auto it = p_Recording.frames.begin();
+             l_Success && it != p_Recording.frames.end(); ++it) {
+          l_Success =
+              Util::FileIO::write_value(l_File, it->hash) &&
+              Util::FileIO::write_value(
+                  l_File, static_cast<u32>(it->input.size())) &&
+              Util::FileIO::write_array(l_File, it->input);
+        }
+
+        Util::FileIO::close(l_File);
+        return l_Success;
+      }
+
+      bool load_recording(const Util::String &p_Path,
+                          Recording &p_Recording)
+      {
+        if (!Util::FileIO::file_exists_sync(p_Path.c_str())) {
+          return false;
+        }
+
+        Util::FileIO::File l_File = Util::FileIO::open(
+            p_Path.c_str(), Util::FileIO::FileMode::READ_BYTES);
+        if (!l_File.is_open()) {
+          return false;
+        }
+
+        Util::List<u8> l_Data;
+        l_Data.resize(Util::FileIO::size_sync(l_File));
+        Util::FileIO::read_sync(
+            l_File, reinterpret_cast<char *>(l_Data.data()));
+        Util::FileIO::close(l_File);
+
+        RecordingReader l_Reader{l_Data};
+        if (l_Reader.read_value<u32>() != g_RecordingMagic ||
+            l_Reader.read_value<u32>() != g_RecordingVersion) {
+          LOW_LOG_WARN << "'" << p_Path
+                       << "' is not a physics recording"
+                       << LOW_LOG_END;
+          return false;
+        }
+
+        Recording l_Recording;
+        l_Recording.fixed_delta = l_Reader.read_value<float>();
+        l_Recording.collision_steps = l_Reader.read_value<u32>();
+        l_Reader.read_list(l_Recording.initial_state);
+
+        const u32 l_FrameCount = l_Reader.read_value<u32>();
+        for (u32 i = 0u; i < l_FrameCount && !l_Reader.failed; ++i) {
+          RecordingFrame i_Frame;
+          i_Frame.hash = l_Reader.read_value<u64>();
+          l_Reader.read_list(i_Frame.input);
+          l_Recording.frames.push_back(std::move(i_Frame));
+        }
+
+        if (l_Reader.failed) {
+          LOW_LOG_WARN << "Physics recording '" << p_Path
+                       << "' is truncated" << LOW_LOG_END;
+          return false;
+        }
+
+        p_Recording = std::move(l_Recording);
+        return true;
+      }
+
       bool raycast(const Math::Vector3 &p_Origin,
                    const Math::Vector3 &p_Direction,
                    float p_MaxDistance, QueryHit *p_Hit)
@@ -14,7 +281,7 @@ namespace Low {
         World l_World = l_Scene.get_physics_world();
 
         return l_World.raycast(p_Origin, p_Direction, p_MaxDistance,
-                               p_Hit);
+                               ALL_COLLISION_LAYERS, p_Hit);
       }
     } // namespace Physics
   } // namespace Core
@@ -8,7 +8,11 @@
 #include "LowCoreTransform.h"
 #include "LowCoreCharacterController.h"
 
+#include "LowRenderer.h"
+
 #include "LowMath.h"
+#include "LowMathVectorUtil.h"
+#include "LowUtilContainers.h"
 #include "LowUtilProfiler.h"
 
 namespace Low {
@@ -55,10 +59,14 @@ namespace Low {
             return;
           }
 
-          const Low::Math::Quaternion l_WorldRotation =
-              p_Body.get_rotation();
+          // The simulation runs at a fixed rate, presenting the
+          // interpolated transform keeps motion smooth in between
+          Low::Math::Vector3 l_BodyPosition;
+          Low::Math::Quaternion l_WorldRotation;
+          p_Body.get_interpolated_transform(l_BodyPosition,
+                                            l_WorldRotation);
           const Low::Math::Vector3 l_WorldPosition =
-              p_Body.get_position() - (l_WorldRotation * p_Center);
+              l_BodyPosition - (l_WorldRotation * p_Center);
 
           Component::Transform l_Parent = p_Transform.get_parent();
           if (l_Parent.is_alive()) {
@@ -115,8 +123,86 @@ namespace Low {
           return false;
         }
 
+        // Set when entering play mode since transforms may have been
+        // moved in the editor without the colliders being rebuilt
+        static bool g_SyncAllTransforms = true;
+
+        // Static colliders and kinematic bodies only follow their
+        // transform if it has been moved this frame. The world
+        // updated flag gets reset by the transform system at the
+        // start of every frame.
+        static bool
+        should_sync_from_transform(Component::Transform p_Transform)
+        {
+          return g_SyncAllTransforms ||
+                 p_Transform.is_world_dirty() ||
+                 p_Transform.is_world_updated();
+        }
+
+        static bool is_static_collider_entity(Entity p_Entity)
+        {
+          return p_Entity.is_alive() && p_Entity.is_active() &&
+                 !p_Entity.has_component(
+                     Component::Rigidbody::type_id());
+        }
+
+        static LodSettings g_LodSettings;
+        static u64 g_LodFrame = 0u;
+        // Regions whose bodies are frozen because they are too far
+        // away, stored by handle id
+        static Util::Set<u64> g_FrozenRegions;
+        // Far bodies that got frozen on their own. A few of them are
+        // checked every frame to see if they came back into range.
+        static Util::List<Low::Core::Physics::Body> g_FrozenBodies;
+        static Util::Set<u64> g_FrozenBodyIds;
+        static u32 g_FrozenBodyCursor = 0u;
+        static Util::List<Low::Core::Physics::Body> g_ActiveBodies;
+        static Util::List<Low::Core::Physics::Body> g_BodyScratch;
+        static const u32 g_FrozenBodyChecksPerFrame = 64u;
+        // Bodies only get woken up again once they are clearly back
+        // in range, so they do not flip between frozen and awake
+        static const float g_ThawDistanceFactor = 0.9f;
+
+        static Low::Math::Vector3 get_lod_focus()
+        {
+          if (g_LodSettings.use_focus) {
+            return g_LodSettings.focus;
+          }
+          return Renderer::get_game_renderview()
+              .get_camera_position();
+        }
+
+        static bool is_in_frozen_region(Entity p_Entity)
+        {
+          return !g_FrozenRegions.empty() &&
+                 g_FrozenRegions.find(
+                     p_Entity.get_region().get_id()) !=
+                     g_FrozenRegions.end();
+        }
+
+        static bool is_region_out_of_range(
+            Core::Region p_Region, const Low::Math::Vector3 &p_Focus)
+        {
+          if (g_LodSettings.region_freeze_distance <= 0.0f ||
+              !p_Region.is_loaded() ||
+              !p_Region.is_streaming_enabled()) {
+            return false;
+          }
+
+          // Measured on the ground plane like region streaming
+          Low::Math::Vector3 l_Difference =
+              p_Region.get_streaming_position() - p_Focus;
+          l_Difference.y = 0.0f;
+          return Low::Math::VectorUtil::magnitude_squared(
+                     l_Difference) >
+                 g_LodSettings.region_freeze_distance *
+                     g_LodSettings.region_freeze_distance;
+        }
+
         static void sync_static_colliders_to_physics()
         {
+          u32 l_SyncedCount = 0u;
+
           for (u32 i = 0u; i < Component::BoxCollider::living_count();
                ++i) {
             Component::BoxCollider i_Collider =
@@ -127,16 +213,22 @@ namespace Low {
             }
 
             Entity i_Entity = i_Collider.get_entity();
-            if (!i_Entity.is_alive() ||
-                i_Entity.has_component(
-                    Component::Rigidbody::type_id())) {
+            if (!is_static_collider_entity(i_Entity)) {
+              continue;
+            }
+
+            Component::Transform i_Transform =
+                i_Entity.get_transform();
+            if (!i_Transform.is_alive() ||
+                !should_sync_from_transform(i_Transform)) {
               continue;
             }
 
             set_body_from_transform(i_Collider.get_static_body(),
-                                    i_Entity.get_transform(),
+                                    i_Transform,
                                     get_box_center(i_Collider),
                                     i_Collider.get_rotation());
+            l_SyncedCount++;
           }
 
           for (u32 i = 0u;
@@ -149,15 +241,21 @@ namespace Low {
             }
 
             Entity i_Entity = i_Collider.get_entity();
-            if (!i_Entity.is_alive() ||
-                i_Entity.has_component(
-                    Component::Rigidbody::type_id())) {
+            if (!is_static_collider_entity(i_Entity)) {
+              continue;
+            }
+
+            Component::Transform i_Transform =
+                i_Entity.get_transform();
+            if (!i_Transform.is_alive() ||
+                !should_sync_from_transform(i_Transform)) {
               continue;
             }
 
             set_body_from_transform(i_Collider.get_static_body(),
-                                    i_Entity.get_transform(),
+                                    i_Transform,
                                     get_sphere_center(i_Collider));
+            l_SyncedCount++;
           }
 
           for (u32 i = 0u;
@@ -171,20 +269,31 @@ namespace Low {
             }
 
             Entity i_Entity = i_Collider.get_entity();
-            if (!i_Entity.is_alive() ||
-                i_Entity.has_component(
-                    Component::Rigidbody::type_id())) {
+            if (!is_static_collider_entity(i_Entity)) {
+              continue;
+            }
+
+            Component::Transform i_Transform =
+                i_Entity.get_transform();
+            if (!i_Transform.is_alive() ||
+                !should_sync_from_transform(i_Transform)) {
               continue;
             }
 
             set_body_from_transform(i_Collider.get_static_body(),
-                                    i_Entity.get_transform(),
+                                    i_Transform,
                                     Low::Math::Vector3(0.0f));
+            l_SyncedCount++;
           }
+
+          LOW_PROFILE_COUNTER("Physics", "Synced static colliders",
+                              l_SyncedCount);
         }
 
         static void sync_rigidbodies_to_physics()
         {
+          u32 l_SyncedCount = 0u;
+
           for (u32 i = 0u; i < Component::Rigidbody::living_count();
                ++i) {
             Component::Rigidbody i_Rigidbody =
@@ -197,44 +306,294 @@ namespace Low {
             }
 
             Entity i_Entity = i_Rigidbody.get_entity();
-            if (!i_Entity.is_alive()) {
+            if (!i_Entity.is_alive() || !i_Entity.is_active() ||
+                is_in_frozen_region(i_Entity)) {
+              continue;
+            }
+
+            Component::Transform i_Transform =
+                i_Entity.get_transform();
+            if (!i_Transform.is_alive() ||
+                !should_sync_from_transform(i_Transform)) {
               continue;
             }
 
             Low::Math::Vector3 l_Center(0.0f);
             get_rigidbody_center(i_Entity, l_Center);
             set_body_from_transform(i_Rigidbody.get_body(),
-                                    i_Entity.get_transform(),
+                                    i_Transform, l_Center);
+            l_SyncedCount++;
+          }
+
+          LOW_PROFILE_COUNTER("Physics", "Synced kinematic bodies",
+                              l_SyncedCount);
+        }
+
+        static Component::Rigidbody
+        get_dynamic_rigidbody(Low::Core::Physics::Body p_Body)
+        {
+          Component::Rigidbody l_Rigidbody =
+              p_Body.get_owner().get_id();
+          if (!l_Rigidbody.is_alive() ||
+              l_Rigidbody.get_body() != p_Body ||
+              l_Rigidbody.get_motion_type() !=
+                  Low::Core::Physics::BodyMotionType::DYNAMIC) {
+            return Component::Rigidbody();
+          }
+          return l_Rigidbody;
+        }
+
+        static void
+        write_body_to_transform(Entity p_Entity,
+                                Low::Core::Physics::Body p_Body)
+        {
+          Low::Math::Vector3 l_Center(0.0f);
+          get_rigidbody_center(p_Entity, l_Center);
+          write_transform_from_body(p_Entity.get_transform(), p_Body,
                                     l_Center);
+        }
+
+        static void freeze_far_body(Low::Core::Physics::Body p_Body)
+        {
+          g_BodyScratch.push_back(p_Body);
+          if (g_FrozenBodyIds.insert(p_Body.get_id()).second) {
+            g_FrozenBodies.push_back(p_Body);
           }
         }
 
-        static void write_dynamic_bodies_to_transforms()
+        // Only the bodies Jolt reports as active can have moved, all
+        // other dynamic bodies are asleep and keep their transform
+        static void
+        write_dynamic_bodies_to_transforms(
+            const Low::Math::Vector3 &p_Focus)
         {
+          Util::List<Low::Core::Physics::Body> &l_ActiveBodies =
+              g_ActiveBodies;
+          l_ActiveBodies.clear();
+          g_BodyScratch.clear();
+
+          for (u32 i = 0u; i < Scene::living_count(); ++i) {
+            Scene i_Scene = Scene::living_instances()[i];
+            Low::Core::Physics::World i_PhysicsWorld =
+                i_Scene.get_physics_world();
+            if (i_Scene.is_loaded() && i_PhysicsWorld.is_alive()) {
+              Low::Core::Physics::Body::get_active(i_PhysicsWorld,
+                                                   l_ActiveBodies);
+            }
+          }
+
+          const float l_FreezeDistance =
+              g_LodSettings.freeze_distance;
+          const float l_ReducedDistance =
+              g_LodSettings.reduced_distance;
+          const u32 l_ReducedInterval =
+              std::max(g_LodSettings.reduced_interval, 1u);
+
+          u32 l_WrittenCount = 0u;
+          for (Low::Core::Physics::Body i_Body : l_ActiveBodies) {
+            Component::Rigidbody i_Rigidbody =
+                get_dynamic_rigidbody(i_Body);
+            if (!i_Rigidbody.is_alive()) {
+              continue;
+            }
+
+            Entity i_Entity = i_Rigidbody.get_entity();
+            if (!i_Entity.is_alive() || !i_Entity.is_active()) {
+              continue;
+            }
+
+            const float i_DistanceSquared =
+                Low::Math::VectorUtil::distance_squared(
+                    i_Body.get_position(), p_Focus);
+
+            if (l_FreezeDistance > 0.0f &&
+                i_DistanceSquared >
+                    l_FreezeDistance * l_FreezeDistance) {
+              // The transform catches up once more so the frozen
+              // body is shown where it stopped
+              freeze_far_body(i_Body);
+            } else if (l_ReducedDistance > 0.0f &&
+                       i_DistanceSquared >
+                           l_ReducedDistance * l_ReducedDistance &&
+                       (g_LodFrame + i_Body.get_index()) %
+                               l_ReducedInterval !=
+                           0u) {
+              continue;
+            }
+
+            write_body_to_transform(i_Entity, i_Body);
+            l_WrittenCount++;
+          }
+
+          Low::Core::Physics::Body::set_frozen(g_BodyScratch, true);
+
+          LOW_PROFILE_COUNTER("Physics", "Active bodies",
+                              l_ActiveBodies.size());
+          LOW_PROFILE_COUNTER("Physics", "Written back bodies",
+                              l_WrittenCount);
+        }
+
+        static void
+        thaw_near_bodies(const Low::Math::Vector3 &p_Focus)
+        {
+          g_BodyScratch.clear();
+
+          const float l_ThawDistance =
+              g_LodSettings.freeze_distance * g_ThawDistanceFactor;
+          const bool l_ThawAll =
+              g_LodSettings.freeze_distance <= 0.0f;
+
+          u32 l_Checks = 0u;
+          while (!g_FrozenBodies.empty() &&
+                 (l_ThawAll ||
+                  l_Checks < g_FrozenBodyChecksPerFrame)) {
+            l_Checks++;
+            if (g_FrozenBodyCursor >= g_FrozenBodies.size()) {
+              g_FrozenBodyCursor = 0u;
+            }
+
+            Low::Core::Physics::Body i_Body =
+                g_FrozenBodies[g_FrozenBodyCursor];
+            bool i_Remove = !i_Body.is_alive();
+            if (!i_Remove &&
+                (l_ThawAll ||
+                 Low::Math::VectorUtil::distance_squared(
+                     i_Body.get_position(), p_Focus) <
+                     l_ThawDistance * l_ThawDistance)) {
+              g_BodyScratch.push_back(i_Body);
+              i_Remove = true;
+            }
+
+            if (i_Remove) {
+              g_FrozenBodyIds.erase(i_Body.get_id());
+              g_FrozenBodies[g_FrozenBodyCursor] =
+                  g_FrozenBodies.back();
+              g_FrozenBodies.pop_back();
+            } else {
+              g_FrozenBodyCursor++;
+            }
+          }
+
+          Low::Core::Physics::Body::set_frozen(g_BodyScratch, false);
+
+          LOW_PROFILE_COUNTER("Physics", "Frozen far bodies",
+                              g_FrozenBodies.size());
+        }
+
+        // Regions that move out of range get all of their bodies
+        // frozen in one go, the ones that come back in range get
+        // woken up the same way
+        static void
+        update_region_lod(const Low::Math::Vector3 &p_Focus)
+        {
+          Util::Set<u64> l_ChangedRegions;
+          for (u32 i = 0u; i < Core::Region::living_count(); ++i) {
+            Core::Region i_Region =
+                Core::Region::living_instances()[i];
+            const bool i_Frozen =
+                is_region_out_of_range(i_Region, p_Focus);
+            const bool i_WasFrozen =
+                g_FrozenRegions.find(i_Region.get_id()) !=
+                g_FrozenRegions.end();
+            if (i_Frozen == i_WasFrozen) {
+              continue;
+            }
+
+            if (i_Frozen) {
+              g_FrozenRegions.insert(i_Region.get_id());
+            } else {
+              g_FrozenRegions.erase(i_Region.get_id());
+            }
+            l_ChangedRegions.insert(i_Region.get_id());
+          }
+
+          // Regions that got removed from the scene cannot report
+          // their change anymore
+          for (auto it = g_FrozenRegions.begin();
+               it != g_FrozenRegions.end();) {
+            if (!Core::Region(*it).is_alive()) {
+              it = g_FrozenRegions.erase(it);
+            } else {
+              ++it;
+            }
+          }
+
+          LOW_PROFILE_COUNTER("Physics", "Frozen regions",
+                              g_FrozenRegions.size());
+
+          if (l_ChangedRegions.empty()) {
+            return;
+          }
+
+          Util::List<Low::Core::Physics::Body> l_Frozen;
+          Util::List<Low::Core::Physics::Body> l_Thawed;
           for (u32 i = 0u; i < Component::Rigidbody::living_count();
                ++i) {
             Component::Rigidbody i_Rigidbody =
                 Component::Rigidbody::living_instances()[i];
             if (!i_Rigidbody.is_alive() ||
-                !i_Rigidbody.get_body().is_alive() ||
-                i_Rigidbody.get_motion_type() !=
-                    Low::Core::Physics::BodyMotionType::DYNAMIC) {
+                !i_Rigidbody.get_body().is_alive()) {
               continue;
             }
 
             Entity i_Entity = i_Rigidbody.get_entity();
-            if (!i_Entity.is_alive()) {
+            if (!i_Entity.is_alive() ||
+                l_ChangedRegions.find(
+                    i_Entity.get_region().get_id()) ==
+                    l_ChangedRegions.end()) {
               continue;
             }
 
-            Low::Math::Vector3 l_Center(0.0f);
-            get_rigidbody_center(i_Entity, l_Center);
-            write_transform_from_body(i_Entity.get_transform(),
-                                      i_Rigidbody.get_body(),
-                                      l_Center);
+            if (!is_in_frozen_region(i_Entity)) {
+              l_Thawed.push_back(i_Rigidbody.get_body());
+              continue;
+            }
+
+            l_Frozen.push_back(i_Rigidbody.get_body());
+          }
+
+          Low::Core::Physics::Body::set_frozen(l_Frozen, true);
+          Low::Core::Physics::Body::set_frozen(l_Thawed, false);
+
+          // Kinematic bodies were not synced while they were frozen
+          if (!l_Thawed.empty()) {
+            g_SyncAllTransforms = true;
           }
         }
 
+        static void reset_lod()
+        {
+          if (g_FrozenRegions.empty() && g_FrozenBodies.empty()) {
+            return;
+          }
+
+          Util::List<Low::Core::Physics::Body> l_Thawed;
+          for (u32 i = 0u; i < Component::Rigidbody::living_count();
+               ++i) {
+            Component::Rigidbody i_Rigidbody =
+                Component::Rigidbody::living_instances()[i];
+            if (!i_Rigidbody.is_alive() ||
+                !i_Rigidbody.get_body().is_alive()) {
+              continue;
+            }
+
+            Entity i_Entity = i_Rigidbody.get_entity();
+            if ((i_Entity.is_alive() &&
+                 is_in_frozen_region(i_Entity)) ||
+                g_FrozenBodyIds.find(
+                    i_Rigidbody.get_body().get_id()) !=
+                    g_FrozenBodyIds.end()) {
+              l_Thawed.push_back(i_Rigidbody.get_body());
+            }
+          }
+          Low::Core::Physics::Body::set_frozen(l_Thawed, false);
+
+          g_FrozenRegions.clear();
+          g_FrozenBodies.clear();
+          g_FrozenBodyIds.clear();
+          g_FrozenBodyCursor = 0u;
+        }
+
         static void write_character_controller_positions_to_transforms()
         {
           for (u32 i = 0u;
@@ -247,7 +606,7 @@ namespace Low {
             }
 
             Entity i_Entity = i_Controller.get_entity();
-            if (!i_Entity.is_alive()) {
+            if (!i_Entity.is_alive() || !i_Entity.is_active()) {
               continue;
             }
 
@@ -276,7 +635,88 @@ namespace Low {
           }
         }
 
-        static void simulate_loaded_worlds(float p_Delta)
+        static void set_body_enabled(Low::Core::Physics::Body p_Body,
+                                     bool p_Enabled)
+        {
+          if (p_Body.is_alive()) {
+            p_Body.set_enabled(p_Enabled);
+          }
+        }
+
+        void set_entity_active(Entity p_Entity, bool p_Active)
+        {
+          if (p_Entity.has_component(
+                  Component::Rigidbody::type_id())) {
+            Component::Rigidbody l_Rigidbody =
+                p_Entity.get_component(
+                    Component::Rigidbody::type_id());
+            Low::Core::Physics::Body l_Body = l_Rigidbody.get_body();
+            if (l_Body.is_alive() && !p_Active) {
+              l_Body.set_linear_velocity(Low::Math::Vector3(0.0f));
+              l_Body.set_angular_velocity(Low::Math::Vector3(0.0f));
+            }
+            set_body_enabled(l_Body, p_Active);
+
+            // Dynamic bodies are not synced from their transform, so
+            // they have to pick up where the entity is now
+            if (l_Body.is_alive() && p_Active) {
+              Low::Math::Vector3 l_Center(0.0f);
+              get_rigidbody_center(p_Entity, l_Center);
+              set_body_from_transform(
+                  l_Body, p_Entity.get_transform(), l_Center);
+            }
+          }
+          if (p_Entity.has_component(
+                  Component::BoxCollider::type_id())) {
+            Component::BoxCollider l_Collider =
+                p_Entity.get_component(
+                    Component::BoxCollider::type_id());
+            set_body_enabled(l_Collider.get_static_body(), p_Active);
+          }
+          if (p_Entity.has_component(
+                  Component::SphereCollider::type_id())) {
+            Component::SphereCollider l_Collider =
+                p_Entity.get_component(
+                    Component::SphereCollider::type_id());
+            set_body_enabled(l_Collider.get_static_body(), p_Active);
+          }
+          if (p_Entity.has_component(
+                  Component::ConvexHullCollider::type_id())) {
+            Component::ConvexHullCollider l_Collider =
+                p_Entity.get_component(
+                    Component::ConvexHullCollider::type_id());
+            set_body_enabled(l_Collider.get_static_body(), p_Active);
+          }
+          if (p_Entity.has_component(
+                  Component::CharacterController::type_id())) {
+            Component::CharacterController l_Controller =
+                p_Entity.get_component(
+                    Component::CharacterController::type_id());
+            // Capsule controllers cannot be taken out of the
+            // simulation, so inactive characters do not keep one. It
+            // gets created again where the entity is now.
+            if (!p_Active) {
+              l_Controller.release_capsule_controller();
+            } else if (!l_Controller.get_capsule_controller()
+                            .is_alive() &&
+                       !l_Controller.is_dirty()) {
+              l_Controller.rebuild();
+            }
+          }
+        }
+
+        // Rebuilding creates a fresh body that is part of the
+        // simulation, so inactive entities have to disable it again
+        static void disable_if_inactive(Entity p_Entity)
+        {
+          if (p_Entity.is_alive() && !p_Entity.is_active()) {
+            set_entity_active(p_Entity, false);
+          }
+        }
+
+        static void
+        simulate_loaded_worlds(float p_Delta,
+                               const Low::Math::Vector3 &p_Focus)
         {
           for (u32 i = 0u; i < Scene::living_count(); ++i) {
             Scene i_Scene = Scene::living_instances()[i];
@@ -287,20 +727,72 @@ namespace Low {
             Low::Core::Physics::World l_PhysicsWorld =
                 i_Scene.get_physics_world();
             if (l_PhysicsWorld.is_alive()) {
+              // Controllers far away from the focus get updated at a
+              // reduced rate
+              Low::Core::Physics::CharacterUpdateSettings
+                  l_CharacterSettings =
+                      l_PhysicsWorld.get_character_update_settings();
+              l_CharacterSettings.use_focus = true;
+              l_CharacterSettings.focus = p_Focus;
+              l_PhysicsWorld.set_character_update_settings(
+                  l_CharacterSettings);
+
+              l_PhysicsWorld.update_capsule_controllers();
               l_PhysicsWorld.simulate(p_Delta);
             }
           }
         }
 
+        static void begin_body_batches()
+        {
+          for (u32 i = 0u; i < Scene::living_count(); ++i) {
+            Low::Core::Physics::World i_PhysicsWorld =
+                Scene::living_instances()[i].get_physics_world();
+            if (i_PhysicsWorld.is_alive()) {
+              i_PhysicsWorld.begin_body_batch();
+            }
+          }
+        }
+
+        static void end_body_batches()
+        {
+          for (u32 i = 0u; i < Scene::living_count(); ++i) {
+            Low::Core::Physics::World i_PhysicsWorld =
+                Scene::living_instances()[i].get_physics_world();
+            if (i_PhysicsWorld.is_alive()) {
+              i_PhysicsWorld.end_body_batch();
+            }
+          }
+        }
+
+        // Queries submitted during the frame are run together so
+        // gameplay code can read their hits on the next frame
+        static void resolve_deferred_queries()
+        {
+          for (u32 i = 0u; i < Scene::living_count(); ++i) {
+            Low::Core::Physics::World i_PhysicsWorld =
+                Scene::living_instances()[i].get_physics_world();
+            if (i_PhysicsWorld.is_alive()) {
+              i_PhysicsWorld.resolve_deferred_queries();
+            }
+          }
+        }
+
         void tick(float p_Delta, Util::EngineState p_State)
         {
           LOW_PROFILE_CPU("Core", "PhysicsSystem::TICK");
 
+          // Loading a region marks all of its colliders dirty at
+          // once, batching lets the physics worlds add their bodies
+          // in bulk instead of one by one
+          begin_body_batches();
+
           for (Component::BoxCollider i_Collider :
                Component::BoxCollider::ms_Dirty) {
             if (i_Collider.is_alive()) {
               i_Collider.rebuild();
               i_Collider.set_dirty(false);
+              disable_if_inactive(i_Collider.get_entity());
             }
           }
           Component::BoxCollider::ms_Dirty.clear();
@@ -310,6 +802,7 @@ namespace Low {
             if (i_Collider.is_alive()) {
               i_Collider.rebuild();
               i_Collider.set_dirty(false);
+              disable_if_inactive(i_Collider.get_entity());
             }
           }
           Component::SphereCollider::ms_Dirty.clear();
@@ -319,6 +812,7 @@ namespace Low {
             if (i_Collider.is_alive()) {
               i_Collider.rebuild();
               i_Collider.set_dirty(false);
+              disable_if_inactive(i_Collider.get_entity());
             }
           }
           Component::ConvexHullCollider::ms_Dirty.clear();
@@ -326,35 +820,75 @@ namespace Low {
           for (Component::CharacterController i_CController :
                Component::CharacterController::ms_Dirty) {
             if (i_CController.is_alive()) {
-              i_CController.rebuild();
+              // Inactive characters get their capsule controller
+              // once they are activated
+              Entity i_Entity = i_CController.get_entity();
+              if (!i_Entity.is_alive() || i_Entity.is_active()) {
+                i_CController.rebuild();
+              }
               i_CController.set_dirty(false);
             }
           }
           Component::CharacterController::ms_Dirty.clear();
 
+          g_BodyScratch.clear();
           for (Component::Rigidbody i_Rigidbody :
                Component::Rigidbody::ms_Dirty) {
             if (i_Rigidbody.is_alive()) {
               i_Rigidbody.rebuild();
               i_Rigidbody.set_dirty(false);
+              disable_if_inactive(i_Rigidbody.get_entity());
+
+              // Rebuilt bodies start out awake
+              Entity i_Entity = i_Rigidbody.get_entity();
+              if (i_Entity.is_alive() &&
+                  is_in_frozen_region(i_Entity)) {
+                g_BodyScratch.push_back(i_Rigidbody.get_body());
+              }
             }
           }
           Component::Rigidbody::ms_Dirty.clear();
+
+          end_body_batches();
+
+          Low::Core::Physics::Body::set_frozen(g_BodyScratch, true);
         }
 
         void late_tick(float p_Delta, Util::EngineState p_State)
         {
           if (p_State != Util::EngineState::PLAYING) {
+            g_SyncAllTransforms = true;
+            reset_lod();
+            resolve_deferred_queries();
             return;
           }
 
           LOW_PROFILE_CPU("Core", "PhysicsSystem::LATETICK");
 
+          const Low::Math::Vector3 l_Focus = get_lod_focus();
+          update_region_lod(l_Focus);
+
           sync_static_colliders_to_physics();
           sync_rigidbodies_to_physics();
-          simulate_loaded_worlds(p_Delta);
-          write_dynamic_bodies_to_transforms();
+          g_SyncAllTransforms = false;
+
+          simulate_loaded_worlds(p_Delta, l_Focus);
+          write_dynamic_bodies_to_transforms(l_Focus);
+          thaw_near_bodies(l_Focus);
           write_character_controller_positions_to_transforms();
+          resolve_deferred_queries();
+
+          g_LodFrame++;
+        }
+
+        void set_lod_settings(const LodSettings &p_Settings)
+        {
+          g_LodSettings = p_Settings;
+        }
+
+        const LodSettings &get_lod_settings()
+        {
+          return g_LodSettings;
         }
 
       } // namespace Physics
@@ -58,6 +58,207 @@ namespace Low {
         populate_component(p_Prefab, it->second);
       }
     }
+
+    // A spawn template is a flattened version of a prefab hierarchy.
+    // Component types, property setters and property values are
+    // resolved once so spawning does not have to look anything up by
+    // name anymore. Nodes are stored depth first so parents always
+    // come before their children.
+    struct PrefabSpawnProperty
+    {
+      void (*set)(Util::Handle, const void *);
+      Util::Variant value;
+      Math::Shape shape;
+      bool isShape;
+    };
+
+    struct PrefabSpawnComponent
+    {
+      Util::Handle (*make_component)(Util::Handle);
+      Util::List<PrefabSpawnProperty> properties;
+    };
+
+    struct PrefabSpawnNode
+    {
+      Prefab prefab;
+      Util::Name instanceName;
+      u32 parentIndex;
+      Util::List<PrefabSpawnComponent> components;
+    };
+
+    struct PrefabSpawnTemplate
+    {
+      Util::List<PrefabSpawnNode> nodes;
+    };
+
+    static Util::UnorderedMap<u64, PrefabSpawnTemplate>
+        g_SpawnTemplates;
+
+    static bool compile_shape_property(
+        Util::Map<Util::Name, Util::Variant> &p_Values,
+        Util::Name p_PropertyName, Math::Shape &p_Shape)
+    {
+      Util::String l_BaseName = p_PropertyName.c_str();
+      l_BaseName += "__";
+
+      auto l_TypePos =
+          p_Values.find(LOW_NAME((l_BaseName + "type").c_str()));
+      if (l_TypePos == p_Values.end()) {
+        return false;
+      }
+
+      Util::Name l_ShapeTypeName = l_TypePos->second;
+
+      if (l_ShapeTypeName == N(BOX)) {
+        l_BaseName += "box_";
+        p_Shape.type = Math::ShapeType::BOX;
+        p_Shape.box.position =
+            p_Values[LOW_NAME((l_BaseName + "position").c_str())];
+        p_Shape.box.rotation =
+            p_Values[LOW_NAME((l_BaseName + "rotation").c_str())];
+        p_Shape.box.halfExtents =
+            p_Values[LOW_NAME((l_BaseName + "halfextents").c_str())];
+      } else {
+        LOW_ASSERT(false, "Unknown shape type while creating "
+                          "entity from prefab");
+        return false;
+      }
+      return true;
+    }
+
+    static void compile_spawn_node(PrefabSpawnTemplate &p_Template,
+                                   Prefab p_Prefab, u32 p_ParentIndex)
+    {
+      PrefabSpawnNode l_Node;
+      l_Node.prefab = p_Prefab;
+      l_Node.parentIndex = p_ParentIndex;
+
+      Util::String l_Name = p_Prefab.get_name().c_str();
+      l_Name += " (Instance)";
+      l_Node.instanceName = LOW_NAME(l_Name.c_str());
+
+      for (auto cit = p_Prefab.get_components().begin();
+           cit != p_Prefab.get_components().end(); ++cit) {
+        Util::RTTI::TypeInfo &i_TypeInfo =
+            Util::Handle::get_type_info(cit->first);
+
+        PrefabSpawnComponent i_Component;
+        i_Component.make_component = i_TypeInfo.make_component;
+
+        for (auto pit = i_TypeInfo.properties.begin();
+             pit != i_TypeInfo.properties.end(); ++pit) {
+          if (!pit->second.editorProperty) {
+            continue;
+          }
+
+          PrefabSpawnProperty i_Property;
+          i_Property.set = pit->second.set;
+          i_Property.isShape =
+              pit->second.type == Util::RTTI::PropertyType::SHAPE;
+
+          if (i_Property.isShape) {
+            if (!compile_shape_property(cit->second, pit->first,
+                                        i_Property.shape)) {
+              continue;
+            }
+          } else {
+            auto i_PropPos = cit->second.find(pit->first);
+            if (i_PropPos == cit->second.end()) {
+              continue;
+            }
+            i_Property.value = i_PropPos->second;
+          }
+
+          i_Component.properties.push_back(i_Property);
+        }
+
+        l_Node.components.push_back(i_Component);
+      }
+
+      const u32 l_Index = static_cast<u32>(p_Template.nodes.size());
+      p_Template.nodes.push_back(l_Node);
+
+      for (auto it = p_Prefab.get_children().begin();
+           it != p_Prefab.get_children().end(); ++it) {
+        compile_spawn_node(p_Template, it->get_id(), l_Index);
+      }
+    }
+
+    static PrefabSpawnTemplate &get_spawn_template(Prefab p_Prefab)
+    {
+      auto l_Pos = g_SpawnTemplates.find(p_Prefab.get_id());
+      if (l_Pos != g_SpawnTemplates.end()) {
+        return l_Pos->second;
+      }
+
+      LOW_PROFILE_CPU("Core", "Prefab::compile_spawn_template");
+
+      PrefabSpawnTemplate &l_Template =
+          g_SpawnTemplates[p_Prefab.get_id()];
+      compile_spawn_node(l_Template, p_Prefab, LOW_UINT32_MAX);
+      return l_Template;
+    }
+
+    static Entity
+    spawn_from_template(PrefabSpawnTemplate &p_Template,
+                        Region p_Region, const Math::Vector3 *p_Position,
+                        const Math::Quaternion *p_Rotation,
+                        Util::List<Entity> &p_Spawned)
+    {
+      p_Spawned.clear();
+
+      for (u32 i = 0u; i < p_Template.nodes.size(); ++i) {
+        PrefabSpawnNode &i_Node = p_Template.nodes[i];
+        Entity i_Entity = Entity::make(i_Node.instanceName, p_Region);
+
+        for (PrefabSpawnComponent &i_Component : i_Node.components) {
+          Util::Handle i_Handle =
+              i_Component.make_component(i_Entity);
+
+          for (PrefabSpawnProperty &i_Property :
+               i_Component.properties) {
+            if (i_Property.isShape) {
+              i_Property.set(i_Handle, &i_Property.shape);
+            } else {
+              i_Property.set(i_Handle, &i_Property.value.m_Bool);
+            }
+          }
+        }
+
+        // The root transform is set before the prefab instance exists
+        // so the setters skip the comparison against the prefab, the
+        // override is recorded directly below instead
+        const bool i_IsRoot = i_Node.parentIndex == LOW_UINT32_MAX;
+        if (i_IsRoot && p_Position) {
+          i_Entity.get_transform().position(*p_Position);
+        }
+        if (i_IsRoot && p_Rotation) {
+          i_Entity.get_transform().rotation(*p_Rotation);
+        }
+
+        Component::PrefabInstance i_PrefabInstance =
+            Component::PrefabInstance::make(i_Entity);
+        i_PrefabInstance.set_prefab(i_Node.prefab);
+
+        if (i_IsRoot && p_Position) {
+          i_PrefabInstance.override(Component::Transform::type_id(),
+                                    N(position), true);
+        }
+        if (i_IsRoot && p_Rotation) {
+          i_PrefabInstance.override(Component::Transform::type_id(),
+                                    N(rotation), true);
+        }
+
+        if (!i_IsRoot) {
+          i_Entity.get_transform().set_parent(
+              p_Spawned[i_Node.parentIndex].get_transform().get_id());
+        }
+
+        p_Spawned.push_back(i_Entity);
+      }
+
+      return p_Spawned[0];
+    }
     // LOW_CODEGEN::END::CUSTOM:NAMESPACE_CODE
 
     u16 Prefab::ms_TypeId = 0;
@@ -132,7 +333,7 @@ namespace Low {
 
       {
         // LOW_CODEGEN:BEGIN:CUSTOM:DESTROY
-
+        invalidate_spawn_templates();
         // LOW_CODEGEN::END::CUSTOM:DESTROY
       }
 
@@ -653,6 +854,7 @@ namespace Low {
       if (l_Parent.is_alive()) {
         l_Handle.set_parent(p_Creator.get_id());
         l_Parent.get_children().push_back(l_Handle);
+        invalidate_spawn_templates();
       }
 
       if (p_Node["components"]) {
@@ -775,7 +977,7 @@ namespace Low {
       TYPE_SOA(Prefab, children, Util::List<Util::Handle>) = p_Value;
 
       // LOW_CODEGEN:BEGIN:CUSTOM:SETTER_children
-
+      invalidate_spawn_templates();
       // LOW_CODEGEN::END::CUSTOM:SETTER_children
 
       broadcast_observable(N(children));
@@ -814,7 +1016,7 @@ namespace Low {
           p_Value;
 
       // LOW_CODEGEN:BEGIN:CUSTOM:SETTER_components
-
+      invalidate_spawn_templates();
       // LOW_CODEGEN::END::CUSTOM:SETTER_components
 
       broadcast_observable(N(components));
@@ -870,7 +1072,7 @@ namespace Low {
       TYPE_SOA(Prefab, name, Low::Util::Name) = p_Value;
 
       // LOW_CODEGEN:BEGIN:CUSTOM:SETTER_name
-
+      invalidate_spawn_templates();
       // LOW_CODEGEN::END::CUSTOM:SETTER_name
 
       broadcast_observable(N(name));
@@ -894,6 +1096,9 @@ namespace Low {
         i_Prefab.set_parent(l_Prefab);
         l_Prefab.get_children().push_back(i_Prefab);
       }
+      // Children are added to the list in place, which skips the
+      // setter that would drop cached templates
+      invalidate_spawn_templates();
 
       if (!p_Entity.has_component(
               Component::PrefabInstance::type_id())) {
@@ -912,75 +1117,9 @@ namespace Low {
     Entity Prefab::spawn(Region p_Region)
     {
       // LOW_CODEGEN:BEGIN:CUSTOM:FUNCTION_spawn
-
-      Util::String l_Name = get_name().c_str();
-      l_Name += " (Instance)";
-      Entity l_Entity =
-          Entity::make(LOW_NAME(l_Name.c_str()), p_Region);
-
-      for (auto cit = get_components().begin();
-           cit != get_components().end(); ++cit) {
-        Util::RTTI::TypeInfo &i_TypeInfo =
-            Util::Handle::get_type_info(cit->first);
-        Util::Handle i_Component =
-            i_TypeInfo.make_component(l_Entity);
-
-        for (auto pit = i_TypeInfo.properties.begin();
-             pit != i_TypeInfo.properties.end(); ++pit) {
-          if (!pit->second.editorProperty) {
-            continue;
-          }
-          auto i_PropPos = cit->second.find(pit->first);
-          if (pit->second.type == Util::RTTI::PropertyType::SHAPE) {
-            Util::String i_BaseName = pit->first.c_str();
-            i_BaseName += "__";
-            if (cit->second.find(
-                    LOW_NAME((i_BaseName + "type").c_str())) ==
-                cit->second.end()) {
-              continue;
-            }
-
-            Util::Name i_ShapeTypeName =
-                cit->second[LOW_NAME((i_BaseName + "type").c_str())];
-            Math::Shape i_Shape;
-
-            if (i_ShapeTypeName == N(BOX)) {
-              i_BaseName += "box_";
-              i_Shape.type = Math::ShapeType::BOX;
-              i_Shape.box.position = cit->second[LOW_NAME(
-                  (i_BaseName + "position").c_str())];
-              i_Shape.box.rotation = cit->second[LOW_NAME(
-                  (i_BaseName + "rotation").c_str())];
-              i_Shape.box.halfExtents = cit->second[LOW_NAME(
-                  (i_BaseName + "halfextents").c_str())];
-
-            } else {
-              LOW_ASSERT(false, "Unknown shape type while creating "
-                                "entity from prefab");
-            }
-
-            i_TypeInfo.properties[pit->first].set(i_Component,
-                                                  &i_Shape);
-          } else if (i_PropPos != cit->second.end()) {
-            i_TypeInfo.properties[pit->first].set(
-                i_Component, &i_PropPos->second.m_Bool);
-          }
-        }
-      }
-
-      Component::PrefabInstance l_PrefabInstance =
-          Component::PrefabInstance::make(l_Entity);
-      l_PrefabInstance.set_prefab(*this);
-
-      for (auto cit = get_children().begin();
-           cit != get_children().end(); ++cit) {
-        Prefab i_Prefab = cit->get_id();
-        Entity i_Entity = i_Prefab.spawn(p_Region);
-        i_Entity.get_transform().set_parent(
-            l_Entity.get_transform().get_id());
-      }
-
-      return l_Entity;
+      Util::List<Entity> l_Spawned;
+      return spawn_from_template(get_spawn_template(*this), p_Region,
+                                 nullptr, nullptr, l_Spawned);
       // LOW_CODEGEN::END::CUSTOM:FUNCTION_spawn
     }
 
@@ -1025,6 +1164,7 @@ namespace Low {
         get_components()[p_Component.get_type()][it->first] =
             it->second;
       }
+      invalidate_spawn_templates();
 
       for (auto it =
                Component::PrefabInstance::ms_LivingInstances.begin();
@@ -1114,6 +1254,35 @@ namespace Low {
 
     // LOW_CODEGEN:BEGIN:CUSTOM:NAMESPACE_AFTER_TYPE_CODE
 
+    void Prefab::spawn_batch(Region p_Region, u32 p_Count,
+                             const Math::Vector3 *p_Positions,
+                             const Math::Quaternion *p_Rotations,
+                             Util::List<Entity> &p_Entities)
+    {
+      LOW_PROFILE_CPU("Core", "Prefab::spawn_batch");
+
+      PrefabSpawnTemplate &l_Template = get_spawn_template(*this);
+
+      p_Entities.reserve(p_Entities.size() + p_Count);
+
+      Util::List<Entity> l_Spawned;
+      l_Spawned.reserve(l_Template.nodes.size());
+
+      for (u32 i = 0u; i < p_Count; ++i) {
+        p_Entities.push_back(spawn_from_template(
+            l_Template, p_Region,
+            p_Positions ? &p_Positions[i] : nullptr,
+            p_Rotations ? &p_Rotations[i] : nullptr, l_Spawned));
+      }
+    }
+
+    void Prefab::invalidate_spawn_templates()
+    {
+      // Templates contain the whole hierarchy below their prefab so a
+      // change to any prefab can affect multiple templates
+      g_SpawnTemplates.clear();
+    }
+
     // LOW_CODEGEN::END::CUSTOM:NAMESPACE_AFTER_TYPE_CODE
 
   } // namespace Core
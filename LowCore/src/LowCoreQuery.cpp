@@ -0,0 +1,221 @@
+#include "LowCoreQuery.h"
+
+#include "LowUtilAssert.h"
+#include "LowUtilProfiler.h"
+
+#include <algorithm>
+
+namespace Low {
+  namespace Core {
+    namespace Query {
+      struct QueryStorage
+      {
+        Util::List<u16> componentTypes;
+        Util::List<Entity> entities;
+        Util::List<Util::List<u64>> columns;
+        Util::UnorderedMap<u64, u32> rows;
+      };
+
+      static Util::List<QueryStorage> g_Queries;
+      static Util::UnorderedMap<u16, Util::List<QueryId>>
+          g_QueriesByComponentType;
+
+      static bool matches(QueryStorage &p_Query, Entity p_Entity)
+      {
+        for (u16 i_ComponentType : p_Query.componentTypes) {
+          if (!p_Entity.has_component(i_ComponentType)) {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      static void append_row(QueryStorage &p_Query, Entity p_Entity)
+      {
+        const u32 l_Row = static_cast<u32>(p_Query.entities.size());
+
+        p_Query.entities.push_back(p_Entity);
+        for (u32 i = 0u; i < p_Query.componentTypes.size(); ++i) {
+          p_Query.columns[i].push_back(
+              p_Entity.get_component(p_Query.componentTypes[i]));
+        }
+        p_Query.rows[p_Entity.get_id()] = l_Row;
+      }
+
+      static void remove_row(QueryStorage &p_Query, const u32 p_Row)
+      {
+        const u32 l_LastRow =
+            static_cast<u32>(p_Query.entities.size()) - 1u;
+
+        p_Query.rows.erase(p_Query.entities[p_Row].get_id());
+
+        if (p_Row != l_LastRow) {
+          p_Query.entities[p_Row] = p_Query.entities[l_LastRow];
+          for (Util::List<u64> &i_Column : p_Query.columns) {
+            i_Column[p_Row] = i_Column[l_LastRow];
+          }
+          p_Query.rows[p_Query.entities[p_Row].get_id()] = p_Row;
+        }
+
+        p_Query.entities.pop_back();
+        for (Util::List<u64> &i_Column : p_Query.columns) {
+          i_Column.pop_back();
+        }
+      }
+
+      static void build(QueryStorage &p_Query)
+      {
+        LOW_PROFILE_CPU("Core", "Query::build");
+
+        // Start from the component type with the fewest living
+        // instances to keep the number of candidates low
+        u16 l_DriverType = p_Query.componentTypes[0];
+        u32 l_DriverCount = LOW_UINT32_MAX;
+        for (u16 i_ComponentType : p_Query.componentTypes) {
+          const u32 i_Count =
+              Util::Handle::get_type_info(i_ComponentType)
+                  .get_living_count();
+          if (i_Count < l_DriverCount) {
+            l_DriverType = i_ComponentType;
+            l_DriverCount = i_Count;
+          }
+        }
+
+        Util::RTTI::TypeInfo &l_DriverTypeInfo =
+            Util::Handle::get_type_info(l_DriverType);
+        Util::Handle *l_DriverInstances =
+            l_DriverTypeInfo.get_living_instances();
+
+        Util::List<Entity> l_Entities;
+        l_Entities.reserve(l_DriverCount);
+        for (u32 i = 0u; i < l_DriverCount; ++i) {
+          Entity i_Entity;
+          l_DriverTypeInfo.properties[N(entity)].get(
+              l_DriverInstances[i], &i_Entity);
+
+          if (i_Entity.is_alive() && matches(p_Query, i_Entity)) {
+            l_Entities.push_back(i_Entity);
+          }
+        }
+
+        // Rows are laid out in the slot order of the first component
+        // type so walking the table also walks its pages in order
+        const u16 l_PrimaryType = p_Query.componentTypes[0];
+        std::sort(l_Entities.begin(), l_Entities.end(),
+                  [l_PrimaryType](Entity p_A, Entity p_B) {
+                    return Util::Handle(
+                               p_A.get_component(l_PrimaryType))
+                               .get_index() <
+                           Util::Handle(
+                               p_B.get_component(l_PrimaryType))
+                               .get_index();
+                  });
+
+        p_Query.entities.reserve(l_Entities.size());
+        for (Util::List<u64> &i_Column : p_Query.columns) {
+          i_Column.reserve(l_Entities.size());
+        }
+        for (Entity i_Entity : l_Entities) {
+          append_row(p_Query, i_Entity);
+        }
+      }
+
+      QueryId register_query(const u16 *p_ComponentTypes,
+                             u32 p_ComponentTypeCount)
+      {
+        LOW_ASSERT(p_ComponentTypeCount > 0u,
+                   "A query requires at least one component type");
+
+        for (u32 i = 0u; i < g_Queries.size(); ++i) {
+          Util::List<u16> &i_ComponentTypes =
+              g_Queries[i].componentTypes;
+          if (i_ComponentTypes.size() == p_ComponentTypeCount &&
+              std::equal(i_ComponentTypes.begin(),
+                         i_ComponentTypes.end(), p_ComponentTypes)) {
+            return i;
+          }
+        }
+
+        const QueryId l_Id = static_cast<QueryId>(g_Queries.size());
+        g_Queries.push_back(QueryStorage());
+        QueryStorage &l_Query = g_Queries.back();
+
+        for (u32 i = 0u; i < p_ComponentTypeCount; ++i) {
+          LOW_ASSERT(Util::Handle::get_type_info(p_ComponentTypes[i])
+                         .component,
+                     "Queries can only be made over component types");
+          l_Query.componentTypes.push_back(p_ComponentTypes[i]);
+          g_QueriesByComponentType[p_ComponentTypes[i]].push_back(
+              l_Id);
+        }
+        l_Query.columns.resize(p_ComponentTypeCount);
+
+        build(l_Query);
+
+        return l_Id;
+      }
+
+      u32 get_row_count(QueryId p_Query)
+      {
+        _LOW_ASSERT(p_Query < g_Queries.size());
+        return static_cast<u32>(g_Queries[p_Query].entities.size());
+      }
+
+      Entity *get_entities(QueryId p_Query)
+      {
+        _LOW_ASSERT(p_Query < g_Queries.size());
+        return g_Queries[p_Query].entities.data();
+      }
+
+      u64 *get_column(QueryId p_Query, u32 p_Column)
+      {
+        _LOW_ASSERT(p_Query < g_Queries.size());
+        _LOW_ASSERT(p_Column < g_Queries[p_Query].columns.size());
+        return g_Queries[p_Query].columns[p_Column].data();
+      }
+
+      void notify_component_added(Entity p_Entity,
+                                  u16 p_ComponentType)
+      {
+        auto l_It = g_QueriesByComponentType.find(p_ComponentType);
+        if (l_It == g_QueriesByComponentType.end()) {
+          return;
+        }
+
+        for (QueryId i_QueryId : l_It->second) {
+          QueryStorage &i_Query = g_Queries[i_QueryId];
+          if (i_Query.rows.find(p_Entity.get_id()) !=
+              i_Query.rows.end()) {
+            continue;
+          }
+          if (matches(i_Query, p_Entity)) {
+            append_row(i_Query, p_Entity);
+          }
+        }
+      }
+
+      void notify_component_removed(Entity p_Entity,
+                                    u16 p_ComponentType)
+      {
+        auto l_It = g_QueriesByComponentType.find(p_ComponentType);
+        if (l_It == g_QueriesByComponentType.end()) {
+          return;
+        }
+
+        for (QueryId i_QueryId : l_It->second) {
+          QueryStorage &i_Query = g_Queries[i_QueryId];
+          auto i_RowIt = i_Query.rows.find(p_Entity.get_id());
+          if (i_RowIt != i_Query.rows.end()) {
+            remove_row(i_Query, i_RowIt->second);
+          }
+        }
+      }
+
+      void cleanup()
+      {
+        g_Queries.clear();
+        g_QueriesByComponentType.clear();
+      }
+    } // namespace Query
+  }   // namespace Core
+} // namespace Low
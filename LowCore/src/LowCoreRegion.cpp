@@ -15,6 +15,7 @@
 #include "LowUtilFileIO.h"
 
 // LOW_CODEGEN:BEGIN:CUSTOM:SOURCE_CODE
+#include "LowCoreNavigation.h"
 #include "LowUtilAssetManager.h"
 #include "LowUtilJobManager.h"
 // LOW_CODEGEN::END::CUSTOM:SOURCE_CODE
@@ -1030,6 +1031,10 @@ namespace Low {
 
       set_loaded(true);
 
+      // Baked navmesh tiles come in before the entities so their
+      // static navigation sources do not dirty them again
+      Navigation::stream_in_region(*this);
+
       Util::String l_Path =
           Util::get_project().dataPath + "/assets/regions/";
       l_Path += Util::hash_to_string(get_unique_id());
@@ -1046,6 +1051,8 @@ namespace Low {
       for (auto [i_EKey, i_EValue] : l_EntitiesNode) {
         Entity::deserialize(i_EValue, *this);
       }
+
+      Util::resolve_all_handle_references();
       // LOW_CODEGEN::END::CUSTOM:FUNCTION_load_entities
     }
 
@@ -1059,12 +1066,28 @@ namespace Low {
 
       set_loaded(false);
 
+      // The bodies of the region get removed from the physics world
+      // in bulk once all entities are gone
+      Physics::World l_PhysicsWorld;
+      if (get_scene().is_alive()) {
+        l_PhysicsWorld = get_scene().get_physics_world();
+      }
+      if (l_PhysicsWorld.is_alive()) {
+        l_PhysicsWorld.begin_body_batch();
+      }
+
       while (!get_entities().empty()) {
         Entity i_Entity =
             Util::find_handle_by_unique_id(*get_entities().begin())
                 .get_id();
         i_Entity.destroy();
       }
+
+      if (l_PhysicsWorld.is_alive()) {
+        l_PhysicsWorld.end_body_batch();
+      }
+
+      Navigation::stream_out_region(*this);
       // LOW_CODEGEN::END::CUSTOM:FUNCTION_unload_entities
     }
 
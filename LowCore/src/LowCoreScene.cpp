@@ -805,6 +805,8 @@ namespace Low {
           i_Region.unload_entities();
         }
       }
+
+      Navigation::unload_baked_navmesh(*this);
       // LOW_CODEGEN::END::CUSTOM:FUNCTION_unload
     }
 
@@ -812,6 +814,11 @@ namespace Low {
     {
       // LOW_CODEGEN:BEGIN:CUSTOM:FUNCTION__load
 
+      // Regions stream in their baked navmesh tiles while loading
+      if (get_navigation_world().is_alive()) {
+        Navigation::load_baked_navmesh(*this);
+      }
+
       for (auto it = get_regions().begin(); it != get_regions().end();
            ++it) {
         Region i_Region =
@@ -820,6 +827,8 @@ namespace Low {
           i_Region.load_entities();
         }
       }
+      Util::resolve_all_handle_references();
+
       LOW_LOG_DEBUG << "Scene '" << get_name() << "' loaded"
                     << LOW_LOG_END;
       set_loaded(true);
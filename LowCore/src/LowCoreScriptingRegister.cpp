@@ -314,8 +314,9 @@ namespace Low {
           Low::Math::Vector3 p_Direction, float p_MaxDistance,
           Low::Core::Physics::QueryHit &p_Hit)
       {
-        return p_World.raycast(p_Origin, p_Direction, p_MaxDistance,
-                               &p_Hit);
+        return p_World.raycast(
+            p_Origin, p_Direction, p_MaxDistance,
+            Low::Core::Physics::ALL_COLLISION_LAYERS, &p_Hit);
       }
 
       static bool physics_world_sphere_cast(
@@ -345,7 +346,9 @@ namespace Low {
           Low::Math::Vector3 p_Position, float p_Radius,
           Low::Core::Physics::QueryHit &p_Hit)
       {
-        return p_World.overlap_sphere(p_Position, p_Radius, &p_Hit);
+        return p_World.overlap_sphere(
+            p_Position, p_Radius,
+            Low::Core::Physics::ALL_COLLISION_LAYERS, &p_Hit);
       }
 
       static bool physics_world_overlap_box(
@@ -355,8 +358,9 @@ namespace Low {
           Low::Math::Quaternion p_Rotation,
           Low::Core::Physics::QueryHit &p_Hit)
       {
-        return p_World.overlap_box(p_Position, p_HalfExtents,
-                                   p_Rotation, &p_Hit);
+        return p_World.overlap_box(
+            p_Position, p_HalfExtents, p_Rotation,
+            Low::Core::Physics::ALL_COLLISION_LAYERS, &p_Hit);
       }
 
       static void expose_physics(asIScriptEngine *p_Engine)
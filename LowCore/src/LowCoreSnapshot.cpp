@@ -0,0 +1,1039 @@
+#include "LowCoreSnapshot.h"
+
+#include "LowUtilAssert.h"
+#include "LowUtilLogger.h"
+#include "LowUtilProfiler.h"
+#include "LowUtilSerialization.h"
+
+#include "LowCoreEntity.h"
+#include "LowCoreRegion.h"
+#include "LowCoreTransform.h"
+
+#include <algorithm>
+#include <string.h>
+#include <type_traits>
+#include <variant>
+
+#define LOW_CORE_SNAPSHOT_MAGIC 0x504E534Cu // LSNP
+#define LOW_CORE_SNAPSHOT_VERSION 2u
+
+namespace Low {
+  namespace Core {
+    namespace Snapshot {
+      enum class NodeTag : u8
+      {
+        NONE,
+        BOOL,
+        FLOAT,
+        U64,
+        I64,
+        STRING,
+        SEQUENCE,
+        DICTIONARY
+      };
+
+      struct Header
+      {
+        u32 magic;
+        u32 version;
+        u32 entityCount;
+        u32 typeCount;
+        u64 stringTableOffset;
+      };
+
+      struct Writer
+      {
+        Util::List<u8> &data;
+
+        void write_bytes(const void *p_Data, const size_t p_Size)
+        {
+          const size_t l_Offset = data.size();
+          data.resize(l_Offset + p_Size);
+          memcpy(data.data() + l_Offset, p_Data, p_Size);
+        }
+
+        template <typename T> void write(const T &p_Value)
+        {
+          write_bytes(&p_Value, sizeof(T));
+        }
+
+        void write_string(const Util::String &p_String)
+        {
+          const u32 l_Length = static_cast<u32>(p_String.size());
+          write(l_Length);
+          write_bytes(p_String.c_str(), l_Length);
+        }
+      };
+
+      struct Reader
+      {
+        const u8 *data;
+        size_t size;
+        size_t offset;
+        bool valid;
+
+        bool read_bytes(void *p_Data, const size_t p_Size)
+        {
+          if (!valid || offset + p_Size > size) {
+            valid = false;
+            memset(p_Data, 0, p_Size);
+            return false;
+          }
+          memcpy(p_Data, data + offset, p_Size);
+          offset += p_Size;
+          return true;
+        }
+
+        template <typename T> T read()
+        {
+          T l_Value;
+          read_bytes(&l_Value, sizeof(T));
+          return l_Value;
+        }
+
+        Util::String read_string()
+        {
+          const u32 l_Length = read<u32>();
+          if (!valid || offset + l_Length > size) {
+            valid = false;
+            return Util::String();
+          }
+          Util::String l_String(
+              reinterpret_cast<const char *>(data + offset),
+              l_Length);
+          offset += l_Length;
+          return l_String;
+        }
+
+        // Counts are checked against the remaining bytes so broken
+        // data cannot make us allocate huge lists
+        u32 read_count(const size_t p_ElementSize)
+        {
+          const u32 l_Count = read<u32>();
+          if (valid && l_Count * p_ElementSize > size - offset) {
+            valid = false;
+            return 0u;
+          }
+          return l_Count;
+        }
+      };
+
+      struct StringTable
+      {
+        Util::List<Util::String> strings;
+        Util::UnorderedMap<Util::String, u32> indices;
+
+        u32 get_index(const Util::String &p_String)
+        {
+          auto l_Pos = indices.find(p_String);
+          if (l_Pos != indices.end()) {
+            return l_Pos->second;
+          }
+          const u32 l_Index = static_cast<u32>(strings.size());
+          strings.push_back(p_String);
+          indices[p_String] = l_Index;
+          return l_Index;
+        }
+      };
+
+      struct TypeSection
+      {
+        Util::List<Util::Handle> components;
+        Util::List<u32> entities;
+      };
+
+      // Neighbouring slots of one page. Every property of a type
+      // keeps the values of all slots of a page next to each other,
+      // so a run is a single block of memory per property.
+      struct PageRun
+      {
+        Util::Instances::Page *page;
+        u32 slot;
+        u32 first;
+        u32 count;
+
+        u8 *get_data(const Util::RTTI::PropertyInfo &p_Property,
+                     const u32 p_Size) const
+        {
+          return page->buffer + p_Property.dataOffset * page->size +
+                 slot * p_Size;
+        }
+      };
+
+      // Largest value that gets written into a property column
+      static const u32 g_MaxValueSize = sizeof(Math::Shape) > 16u
+                                            ? sizeof(Math::Shape)
+                                            : 16u;
+
+      // Size of a property value in the page buffers of its type.
+      // Zero for values that cannot be copied as plain bytes.
+      static u32 get_raw_size(const u32 p_PropertyType)
+      {
+        switch (p_PropertyType) {
+        case Util::RTTI::PropertyType::COLORRGB:
+          return sizeof(Math::ColorRGB);
+        case Util::RTTI::PropertyType::COLOR:
+          return sizeof(Math::Color);
+        case Util::RTTI::PropertyType::VECTOR2:
+          return sizeof(Math::Vector2);
+        case Util::RTTI::PropertyType::VECTOR3:
+          return sizeof(Math::Vector3);
+        case Util::RTTI::PropertyType::VECTOR4:
+          return sizeof(Math::Vector4);
+        case Util::RTTI::PropertyType::QUATERNION:
+          return sizeof(Math::Quaternion);
+        case Util::RTTI::PropertyType::FLOAT:
+          return sizeof(float);
+        case Util::RTTI::PropertyType::UINT8:
+        case Util::RTTI::PropertyType::BOOL:
+        case Util::RTTI::PropertyType::ENUM:
+          return sizeof(u8);
+        case Util::RTTI::PropertyType::UINT16:
+          return sizeof(u16);
+        case Util::RTTI::PropertyType::UINT32:
+          return sizeof(u32);
+        case Util::RTTI::PropertyType::INT:
+          return sizeof(int);
+        case Util::RTTI::PropertyType::UINT64:
+          return sizeof(u64);
+        case Util::RTTI::PropertyType::SHAPE:
+          return sizeof(Math::Shape);
+        default:
+          return 0u;
+        }
+      }
+
+      // Bytes per value in a property column of the snapshot. Names
+      // and strings are indices into the string table, handles are
+      // stored as their unique id followed by their raw id.
+      static u32 get_column_stride(const u32 p_PropertyType)
+      {
+        switch (p_PropertyType) {
+        case Util::RTTI::PropertyType::NAME:
+        case Util::RTTI::PropertyType::STRING:
+          return sizeof(u32);
+        case Util::RTTI::PropertyType::HANDLE:
+          return sizeof(u64) * 2u;
+        default:
+          return get_raw_size(p_PropertyType);
+        }
+      }
+
+      // Dirty flags are not restored. They are raised on every
+      // restored component instead so that the systems rebuild
+      // whatever they derive from the component data.
+      static bool
+      is_dirty_flag(const Util::RTTI::PropertyInfo &p_Property)
+      {
+        return p_Property.type == Util::RTTI::PropertyType::BOOL &&
+               (p_Property.name == N(dirty) ||
+                p_Property.name == N(world_dirty));
+      }
+
+      static bool
+      is_column_property(const Util::RTTI::PropertyInfo &p_Property)
+      {
+        if (p_Property.name == N(entity) ||
+            p_Property.name == N(unique_id) || !p_Property.set ||
+            is_dirty_flag(p_Property)) {
+          return false;
+        }
+        return get_column_stride(p_Property.type) > 0u;
+      }
+
+      // UINT64 properties only hold handle ids if the type keeps the
+      // unique id of the referenced object next to them, like the
+      // parent and parent_uid of a transform. All other UINT64
+      // values are copied as they are.
+      static bool is_handle_id_property(
+          Util::RTTI::TypeInfo &p_TypeInfo,
+          const Util::RTTI::PropertyInfo &p_Property)
+      {
+        if (p_Property.type != Util::RTTI::PropertyType::UINT64) {
+          return false;
+        }
+        Util::String l_UidName = p_Property.name.c_str();
+        l_UidName += "_uid";
+        return p_TypeInfo.properties.find(LOW_NAME(
+                   l_UidName.c_str())) != p_TypeInfo.properties.end();
+      }
+
+      // Container properties cannot be written into columns. Types
+      // that have them get a node with just those properties stored
+      // with every instance. The containers of transforms are left
+      // out since they are rebuilt from the restored parents.
+      static bool has_container_properties(const u16 p_TypeId)
+      {
+        if (p_TypeId == Component::Transform::type_id()) {
+          return false;
+        }
+
+        Util::RTTI::TypeInfo &l_TypeInfo =
+            Util::Handle::get_type_info(p_TypeId);
+        for (auto it = l_TypeInfo.properties.begin();
+             it != l_TypeInfo.properties.end(); ++it) {
+          if (it->second.type == Util::RTTI::PropertyType::UNKNOWN) {
+            return true;
+          }
+        }
+        return false;
+      }
+
+      // Runs stay empty for types without page access, their columns
+      // go through the property getters and setters instead
+      static void
+      collect_page_runs(Util::RTTI::TypeInfo &p_TypeInfo,
+                        const Util::List<Util::Handle> &p_Handles,
+                        Util::List<PageRun> &p_Runs)
+      {
+        p_Runs.clear();
+        if (!p_TypeInfo.get_page) {
+          return;
+        }
+
+        const u32 l_Count = static_cast<u32>(p_Handles.size());
+        for (u32 i = 0u; i < l_Count;) {
+          PageRun i_Run;
+          i_Run.page = p_TypeInfo.get_page(p_Handles[i].get_index(),
+                                           i_Run.slot);
+          LOW_ASSERT(i_Run.page, "Component without page");
+          i_Run.first = i;
+          i_Run.count = 1u;
+
+          const u32 i_Index = p_Handles[i].get_index();
+          while (i + i_Run.count < l_Count &&
+                 i_Run.slot + i_Run.count < i_Run.page->size &&
+                 p_Handles[i + i_Run.count].get_index() ==
+                     i_Index + i_Run.count) {
+            ++i_Run.count;
+          }
+
+          p_Runs.push_back(i_Run);
+          i += i_Run.count;
+        }
+      }
+
+
+      static Util::UniqueId get_unique_id(Util::Handle p_Handle)
+      {
+        if (p_Handle.get_id() == Util::Handle::DEAD ||
+            !Util::Handle::is_registered_type(p_Handle.get_type())) {
+          return 0ull;
+        }
+
+        Util::RTTI::TypeInfo &l_TypeInfo =
+            Util::Handle::get_type_info(p_Handle.get_type());
+        if (!l_TypeInfo.is_alive(p_Handle)) {
+          return 0ull;
+        }
+
+        auto l_Pos = l_TypeInfo.properties.find(N(unique_id));
+        if (l_Pos == l_TypeInfo.properties.end()) {
+          return 0ull;
+        }
+
+        Util::UniqueId l_UniqueId = 0ull;
+        l_Pos->second.get(p_Handle, &l_UniqueId);
+        return l_UniqueId;
+      }
+
+      static void write_node(Writer &p_Writer,
+                             const Util::Serial::Node &p_Node)
+      {
+        if (const Util::Serial::Node::Scalar *l_Scalar =
+                std::get_if<Util::Serial::Node::Scalar>(
+                    &p_Node.data)) {
+          // The tags of the scalar types follow the order of the
+          // alternatives in the scalar variant
+          p_Writer.write(
+              static_cast<u8>(static_cast<u8>(NodeTag::BOOL) +
+                              l_Scalar->value.index()));
+          std::visit(
+              [&p_Writer](const auto &p_Value) {
+                using T = std::decay_t<decltype(p_Value)>;
+                if constexpr (std::is_same_v<T, Util::String>) {
+                  p_Writer.write_string(p_Value);
+                } else {
+                  p_Writer.write(p_Value);
+                }
+              },
+              l_Scalar->value);
+        } else if (const Util::Serial::Node::Seq *l_Seq =
+                       p_Node.as_seq()) {
+          p_Writer.write(static_cast<u8>(NodeTag::SEQUENCE));
+          p_Writer.write(static_cast<u32>(l_Seq->size()));
+          for (const Util::Serial::Node &i_Node : *l_Seq) {
+            write_node(p_Writer, i_Node);
+          }
+        } else if (const Util::Serial::Node::Dict *l_Dict =
+                       p_Node.as_map()) {
+          p_Writer.write(static_cast<u8>(NodeTag::DICTIONARY));
+          p_Writer.write(static_cast<u32>(l_Dict->size()));
+          for (auto it = l_Dict->begin(); it != l_Dict->end(); ++it) {
+            p_Writer.write_string(it->first);
+            write_node(p_Writer, it->second);
+          }
+        } else {
+          p_Writer.write(static_cast<u8>(NodeTag::NONE));
+        }
+      }
+
+      template <typename T>
+      static void set_scalar(Util::Serial::Node &p_Node, T p_Value)
+      {
+        Util::Serial::Node::Scalar l_Scalar;
+        l_Scalar.value = p_Value;
+        p_Node.data = l_Scalar;
+      }
+
+      static void read_node(Reader &p_Reader,
+                            Util::Serial::Node &p_Node)
+      {
+        const NodeTag l_Tag =
+            static_cast<NodeTag>(p_Reader.read<u8>());
+
+        switch (l_Tag) {
+        case NodeTag::BOOL:
+          set_scalar(p_Node, p_Reader.read<bool>());
+          break;
+        case NodeTag::FLOAT:
+          set_scalar(p_Node, p_Reader.read<float>());
+          break;
+        case NodeTag::U64:
+          set_scalar(p_Node, p_Reader.read<u64>());
+          break;
+        case NodeTag::I64:
+          set_scalar(p_Node, p_Reader.read<i64>());
+          break;
+        case NodeTag::STRING:
+          set_scalar(p_Node, p_Reader.read_string());
+          break;
+        case NodeTag::SEQUENCE: {
+          Util::Serial::Node::Seq l_Seq;
+          l_Seq.resize(p_Reader.read_count(sizeof(u8)));
+          for (u32 i = 0u; i < l_Seq.size() && p_Reader.valid; ++i) {
+            read_node(p_Reader, l_Seq[i]);
+          }
+          p_Node.data = std::move(l_Seq);
+          break;
+        }
+        case NodeTag::DICTIONARY: {
+          Util::Serial::Node::Dict l_Dict;
+          const u32 l_Count = p_Reader.read_count(sizeof(u32));
+          for (u32 i = 0u; i < l_Count && p_Reader.valid; ++i) {
+            Util::String i_Key = p_Reader.read_string();
+            read_node(p_Reader, l_Dict[i_Key]);
+          }
+          p_Node.data = std::move(l_Dict);
+          break;
+        }
+        case NodeTag::NONE:
+          p_Node.data = std::monostate();
+          break;
+        default:
+          p_Reader.valid = false;
+          break;
+        }
+      }
+
+      static void collect_entities(Scene p_Scene,
+                                   Util::List<Entity> &p_Entities)
+      {
+        for (auto rit = p_Scene.get_regions().begin();
+             rit != p_Scene.get_regions().end(); ++rit) {
+          Region i_Region =
+              Util::find_handle_by_unique_id(*rit).get_id();
+          if (!i_Region.is_alive()) {
+            continue;
+          }
+
+          for (auto eit = i_Region.get_entities().begin();
+               eit != i_Region.get_entities().end(); ++eit) {
+            Entity i_Entity =
+                Util::find_handle_by_unique_id(*eit).get_id();
+            if (i_Entity.is_alive()) {
+              p_Entities.push_back(i_Entity);
+            }
+          }
+        }
+      }
+
+      static void destroy_entities(Scene p_Scene)
+      {
+        Util::List<Entity> l_Entities;
+        collect_entities(p_Scene, l_Entities);
+
+        for (Entity i_Entity : l_Entities) {
+          if (i_Entity.is_alive()) {
+            i_Entity.destroy();
+          }
+        }
+      }
+
+      // Components of a section are written in slot order so that
+      // neighbouring slots end up next to each other in the columns
+      static void sort_by_slot(TypeSection &p_Section)
+      {
+        Util::List<std::pair<u32, u32>> l_Order;
+        l_Order.reserve(p_Section.components.size());
+        for (u32 i = 0u; i < p_Section.components.size(); ++i) {
+          l_Order.push_back(
+              std::make_pair(p_Section.components[i].get_index(), i));
+        }
+        std::sort(l_Order.begin(), l_Order.end());
+
+        TypeSection l_Sorted;
+        l_Sorted.components.reserve(l_Order.size());
+        l_Sorted.entities.reserve(l_Order.size());
+        for (const std::pair<u32, u32> &i_Entry : l_Order) {
+          l_Sorted.components.push_back(
+              p_Section.components[i_Entry.second]);
+          l_Sorted.entities.push_back(
+              p_Section.entities[i_Entry.second]);
+        }
+        p_Section = std::move(l_Sorted);
+      }
+
+      // Drops the entries of a serialized component that are already
+      // covered by the property columns
+      static void strip_column_properties(
+          Util::Serial::Node &p_Node,
+          const Util::List<Util::RTTI::PropertyInfo *> &p_Columns)
+      {
+        Util::Serial::Node::Dict *l_Dict =
+            std::get_if<Util::Serial::Node::Dict>(&p_Node.data);
+        if (!l_Dict) {
+          return;
+        }
+        for (Util::RTTI::PropertyInfo *i_Property : p_Columns) {
+          l_Dict->erase(Util::String(i_Property->name.c_str()));
+        }
+      }
+
+      static void
+      remap_handle_id(u8 *p_Value,
+                      const Util::UnorderedMap<u64, u64> &p_HandleMap)
+      {
+        u64 l_Id;
+        memcpy(&l_Id, p_Value, sizeof(u64));
+        auto l_Pos = p_HandleMap.find(l_Id);
+        if (l_Pos != p_HandleMap.end()) {
+          memcpy(p_Value, &l_Pos->second, sizeof(u64));
+        }
+      }
+
+      static void
+      write_column(Writer &p_Writer, StringTable &p_Strings,
+                   Util::RTTI::PropertyInfo &p_Property,
+                   const Util::List<Util::Handle> &p_Handles,
+                   const Util::List<PageRun> &p_Runs)
+      {
+        switch (p_Property.type) {
+        case Util::RTTI::PropertyType::NAME:
+          for (Util::Handle i_Handle : p_Handles) {
+            Util::Name i_Name;
+            p_Property.get(i_Handle, &i_Name);
+            p_Writer.write(p_Strings.get_index(i_Name.c_str()));
+          }
+          break;
+        case Util::RTTI::PropertyType::STRING:
+          for (Util::Handle i_Handle : p_Handles) {
+            Util::String i_String;
+            p_Property.get(i_Handle, &i_String);
+            p_Writer.write(p_Strings.get_index(i_String));
+          }
+          break;
+        case Util::RTTI::PropertyType::HANDLE:
+          for (Util::Handle i_Handle : p_Handles) {
+            Util::Handle i_Value;
+            p_Property.get(i_Handle, &i_Value);
+            p_Writer.write(get_unique_id(i_Value));
+            p_Writer.write(i_Value.get_id());
+          }
+          break;
+        default: {
+          const u32 l_Size = get_raw_size(p_Property.type);
+          const size_t l_Offset = p_Writer.data.size();
+          p_Writer.data.resize(l_Offset + l_Size * p_Handles.size());
+          u8 *l_Target = p_Writer.data.data() + l_Offset;
+
+          if (!p_Runs.empty()) {
+            for (const PageRun &i_Run : p_Runs) {
+              memcpy(l_Target + i_Run.first * l_Size,
+                     i_Run.get_data(p_Property, l_Size),
+                     i_Run.count * l_Size);
+            }
+            break;
+          }
+
+          alignas(16) u8 l_Value[g_MaxValueSize];
+          for (Util::Handle i_Handle : p_Handles) {
+            p_Property.get(i_Handle, l_Value);
+            memcpy(l_Target, l_Value, l_Size);
+            l_Target += l_Size;
+          }
+          break;
+        }
+        }
+      }
+
+      // Plain values are copied straight into the page buffers of
+      // the restored components. Names, strings and handles go
+      // through their setters since those keep name tables and
+      // resource references up to date.
+      static void
+      read_column(Reader &p_Reader,
+                  const Util::List<Util::String> &p_Strings,
+                  Util::RTTI::PropertyInfo &p_Property,
+                  const bool p_HandleIds,
+                  const Util::List<Util::Handle> &p_Handles,
+                  const Util::List<PageRun> &p_Runs,
+                  const Util::UnorderedMap<u64, u64> &p_HandleMap)
+      {
+        switch (p_Property.type) {
+        case Util::RTTI::PropertyType::NAME:
+        case Util::RTTI::PropertyType::STRING:
+          for (Util::Handle i_Handle : p_Handles) {
+            const u32 i_Index = p_Reader.read<u32>();
+            if (i_Index >= p_Strings.size()) {
+              p_Reader.valid = false;
+              return;
+            }
+            if (p_Property.type == Util::RTTI::PropertyType::NAME) {
+              Util::Name i_Name =
+                  LOW_NAME(p_Strings[i_Index].c_str());
+              p_Property.set(i_Handle, &i_Name);
+            } else {
+              p_Property.set(i_Handle, &p_Strings[i_Index]);
+            }
+          }
+          break;
+        case Util::RTTI::PropertyType::HANDLE:
+          for (Util::Handle i_Handle : p_Handles) {
+            const u64 i_UniqueId = p_Reader.read<u64>();
+            const u64 i_Id = p_Reader.read<u64>();
+            // Objects without a unique id (like loaded resources)
+            // outlive the snapshot and keep their handle
+            Util::Handle i_Value =
+                i_UniqueId
+                    ? Util::find_handle_by_unique_id(i_UniqueId)
+                    : Util::Handle(i_Id);
+            p_Property.set(i_Handle, &i_Value);
+          }
+          break;
+        default: {
+          const u32 l_Size = get_raw_size(p_Property.type);
+          const size_t l_ColumnSize = l_Size * p_Handles.size();
+          if (!p_Reader.valid ||
+              p_Reader.offset + l_ColumnSize > p_Reader.size) {
+            p_Reader.valid = false;
+            return;
+          }
+          const u8 *l_Source = p_Reader.data + p_Reader.offset;
+          p_Reader.offset += l_ColumnSize;
+
+          // Handle ids go through the setter since setting them
+          // usually links the two objects (like adding a transform
+          // to the children of its parent)
+          if (!p_Runs.empty() && !p_HandleIds) {
+            for (const PageRun &i_Run : p_Runs) {
+              memcpy(i_Run.get_data(p_Property, l_Size),
+                     l_Source + i_Run.first * l_Size,
+                     i_Run.count * l_Size);
+            }
+            break;
+          }
+
+          alignas(16) u8 l_Value[g_MaxValueSize];
+          for (u32 i = 0u; i < p_Handles.size(); ++i) {
+            memcpy(l_Value, l_Source + i * l_Size, l_Size);
+            if (p_HandleIds) {
+              remap_handle_id(l_Value, p_HandleMap);
+            }
+            p_Property.set(p_Handles[i], l_Value);
+          }
+          break;
+        }
+        }
+      }
+
+      void capture(Scene p_Scene, Util::List<u8> &p_Data)
+      {
+        LOW_PROFILE_CPU("Core", "Snapshot::capture");
+
+        LOW_ASSERT(p_Scene.is_alive(),
+                   "Cannot capture snapshot of dead scene");
+
+        Util::List<Entity> l_Entities;
+        collect_entities(p_Scene, l_Entities);
+
+        Util::Map<u16, TypeSection> l_Sections;
+        for (u32 i = 0u; i < l_Entities.size(); ++i) {
+          Util::Map<uint16_t, Util::Handle> &i_Components =
+              l_Entities[i].get_components();
+          for (auto it = i_Components.begin();
+               it != i_Components.end(); ++it) {
+            Util::RTTI::TypeInfo &i_TypeInfo =
+                Util::Handle::get_type_info(it->first);
+            if (!i_TypeInfo.is_alive(it->second)) {
+              continue;
+            }
+            TypeSection &i_Section = l_Sections[it->first];
+            i_Section.components.push_back(it->second);
+            i_Section.entities.push_back(i);
+          }
+        }
+
+        p_Data.clear();
+        Writer l_Writer{p_Data};
+        StringTable l_Strings;
+
+        Header l_Header;
+        l_Header.magic = LOW_CORE_SNAPSHOT_MAGIC;
+        l_Header.version = LOW_CORE_SNAPSHOT_VERSION;
+        l_Header.entityCount = static_cast<u32>(l_Entities.size());
+        l_Header.typeCount = static_cast<u32>(l_Sections.size());
+        l_Header.stringTableOffset = 0ull;
+        l_Writer.write(l_Header);
+
+        for (Entity i_Entity : l_Entities) {
+          l_Writer.write(i_Entity.get_id());
+        }
+        for (Entity i_Entity : l_Entities) {
+          l_Writer.write(i_Entity.get_unique_id());
+        }
+        for (Entity i_Entity : l_Entities) {
+          l_Writer.write(get_unique_id(i_Entity.get_region()));
+        }
+        for (Entity i_Entity : l_Entities) {
+          l_Writer.write(
+              l_Strings.get_index(i_Entity.get_name().c_str()));
+        }
+        for (Entity i_Entity : l_Entities) {
+          l_Writer.write(static_cast<u8>(i_Entity.is_active()));
+        }
+
+        Util::List<PageRun> l_Runs;
+        for (auto sit = l_Sections.begin(); sit != l_Sections.end();
+             ++sit) {
+          const u16 i_TypeId = sit->first;
+          TypeSection &i_Section = sit->second;
+          Util::RTTI::TypeInfo &i_TypeInfo =
+              Util::Handle::get_type_info(i_TypeId);
+
+          sort_by_slot(i_Section);
+          collect_page_runs(i_TypeInfo, i_Section.components, l_Runs);
+
+          Util::List<Util::RTTI::PropertyInfo *> i_Columns;
+          for (auto pit = i_TypeInfo.properties.begin();
+               pit != i_TypeInfo.properties.end(); ++pit) {
+            if (is_column_property(pit->second)) {
+              i_Columns.push_back(&pit->second);
+            }
+          }
+
+          const bool i_HasNodes = has_container_properties(i_TypeId);
+
+          l_Writer.write(l_Strings.get_index(
+              (Util::String)Util::Handle::identifier(i_TypeId)));
+          l_Writer.write(
+              static_cast<u32>(i_Section.components.size()));
+          l_Writer.write(static_cast<u8>(i_HasNodes));
+          l_Writer.write(static_cast<u32>(i_Columns.size()));
+          for (Util::RTTI::PropertyInfo *i_Property : i_Columns) {
+            l_Writer.write(
+                l_Strings.get_index(i_Property->name.c_str()));
+            l_Writer.write(static_cast<u8>(i_Property->type));
+          }
+
+          l_Writer.write_bytes(i_Section.entities.data(),
+                               i_Section.entities.size() *
+                                   sizeof(u32));
+          for (Util::Handle i_Handle : i_Section.components) {
+            l_Writer.write(i_Handle.get_id());
+          }
+          for (Util::Handle i_Handle : i_Section.components) {
+            l_Writer.write(get_unique_id(i_Handle));
+          }
+
+          // There is no way to serialize a single property, so the
+          // whole component gets serialized and everything that is
+          // already part of the columns is dropped again
+          if (i_HasNodes) {
+            for (Util::Handle i_Handle : i_Section.components) {
+              Util::Serial::Node i_Node;
+              i_TypeInfo.serialize(i_Handle, i_Node);
+              strip_column_properties(i_Node, i_Columns);
+              write_node(l_Writer, i_Node);
+            }
+          }
+
+          for (Util::RTTI::PropertyInfo *i_Property : i_Columns) {
+            write_column(l_Writer, l_Strings, *i_Property,
+                         i_Section.components, l_Runs);
+          }
+        }
+
+        l_Header.stringTableOffset = p_Data.size();
+        memcpy(p_Data.data(), &l_Header, sizeof(Header));
+
+        l_Writer.write(static_cast<u32>(l_Strings.strings.size()));
+        for (const Util::String &i_String : l_Strings.strings) {
+          l_Writer.write_string(i_String);
+        }
+      }
+
+      bool restore(Scene p_Scene, const Util::List<u8> &p_Data)
+      {
+        LOW_PROFILE_CPU("Core", "Snapshot::restore");
+
+        LOW_ASSERT(p_Scene.is_alive(),
+                   "Cannot restore snapshot into dead scene");
+
+        Reader l_Reader{p_Data.data(), p_Data.size(), 0u, true};
+
+        Header l_Header = l_Reader.read<Header>();
+        if (!l_Reader.valid ||
+            l_Header.magic != LOW_CORE_SNAPSHOT_MAGIC) {
+          LOW_LOG_ERROR << "Snapshot data is invalid" << LOW_LOG_END;
+          return false;
+        }
+        if (l_Header.version != LOW_CORE_SNAPSHOT_VERSION) {
+          LOW_LOG_ERROR << "Snapshot version " << l_Header.version
+                        << " is not supported" << LOW_LOG_END;
+          return false;
+        }
+
+        Util::List<Util::String> l_Strings;
+        {
+          Reader l_StringReader{p_Data.data(), p_Data.size(),
+                                l_Header.stringTableOffset, true};
+          l_Strings.resize(l_StringReader.read_count(sizeof(u32)));
+          for (Util::String &i_String : l_Strings) {
+            i_String = l_StringReader.read_string();
+          }
+          if (!l_StringReader.valid) {
+            LOW_LOG_ERROR << "Snapshot string table is invalid"
+                          << LOW_LOG_END;
+            return false;
+          }
+          l_Reader.size = l_Header.stringTableOffset;
+        }
+
+        const u32 l_EntityCount = l_Header.entityCount;
+        if (l_EntityCount * (sizeof(u64) * 3u + sizeof(u32) +
+                             sizeof(u8)) >
+            l_Reader.size - l_Reader.offset) {
+          LOW_LOG_ERROR << "Snapshot entity table is invalid"
+                        << LOW_LOG_END;
+          return false;
+        }
+
+        destroy_entities(p_Scene);
+
+        Util::UnorderedMap<u64, u64> l_HandleMap;
+        l_HandleMap.reserve(l_EntityCount);
+
+        Util::List<u64> l_OldIds(l_EntityCount);
+        Util::List<u64> l_UniqueIds(l_EntityCount);
+        Util::List<u64> l_RegionIds(l_EntityCount);
+        l_Reader.read_bytes(l_OldIds.data(),
+                            l_EntityCount * sizeof(u64));
+        l_Reader.read_bytes(l_UniqueIds.data(),
+                            l_EntityCount * sizeof(u64));
+        l_Reader.read_bytes(l_RegionIds.data(),
+                            l_EntityCount * sizeof(u64));
+
+        Util::List<Entity> l_Entities;
+        l_Entities.reserve(l_EntityCount);
+        for (u32 i = 0u; i < l_EntityCount; ++i) {
+          const u32 i_NameIndex = l_Reader.read<u32>();
+          if (i_NameIndex >= l_Strings.size()) {
+            l_Reader.valid = false;
+            break;
+          }
+
+          Entity i_Entity = Entity::make(
+              LOW_NAME(l_Strings[i_NameIndex].c_str()),
+              l_UniqueIds[i]);
+
+          Region i_Region =
+              Util::find_handle_by_unique_id(l_RegionIds[i]).get_id();
+          if (i_Region.is_alive()) {
+            i_Region.add_entity(i_Entity);
+          }
+
+          l_HandleMap[l_OldIds[i]] = i_Entity.get_id();
+          l_Entities.push_back(i_Entity);
+        }
+
+        Util::List<u8> l_Active(l_Entities.size());
+        l_Reader.read_bytes(l_Active.data(), l_Active.size());
+
+        struct RestoredSection
+        {
+          u16 typeId;
+          size_t columnOffset;
+          Util::List<Util::String> columnNames;
+          Util::List<u8> columnTypes;
+          Util::List<Util::Handle> components;
+          Util::List<PageRun> runs;
+        };
+
+        // All components are created before any of the properties
+        // are set so that references between them can be resolved
+        Util::List<RestoredSection> l_Sections(l_Header.typeCount);
+        for (u32 i = 0u; i < l_Header.typeCount && l_Reader.valid;
+             ++i) {
+          RestoredSection &i_Section = l_Sections[i];
+
+          const u32 i_TypeIndex = l_Reader.read<u32>();
+          const u32 i_Count = l_Reader.read_count(sizeof(u64) * 2u);
+          const bool i_HasNodes = l_Reader.read<u8>() != 0u;
+          const u32 i_ColumnCount =
+              l_Reader.read_count(sizeof(u32) + sizeof(u8));
+          if (!l_Reader.valid || i_TypeIndex >= l_Strings.size()) {
+            l_Reader.valid = false;
+            break;
+          }
+
+          i_Section.typeId =
+              Util::Handle::type_id(Util::TypeIdentifier::from_string(
+                  l_Strings[i_TypeIndex]));
+          if (!Util::Handle::get_type_info(i_Section.typeId)
+                   .component) {
+            LOW_LOG_ERROR << "Snapshot contains unknown component "
+                             "type "
+                          << l_Strings[i_TypeIndex] << LOW_LOG_END;
+            l_Reader.valid = false;
+            break;
+          }
+          Util::RTTI::TypeInfo &i_TypeInfo =
+              Util::Handle::get_type_info(i_Section.typeId);
+
+          for (u32 j = 0u; j < i_ColumnCount; ++j) {
+            const u32 i_NameIndex = l_Reader.read<u32>();
+            i_Section.columnTypes.push_back(l_Reader.read<u8>());
+            i_Section.columnNames.push_back(
+                i_NameIndex < l_Strings.size()
+                    ? l_Strings[i_NameIndex]
+                    : Util::String());
+          }
+
+          Util::List<u32> i_EntityIndices(i_Count);
+          Util::List<u64> i_OldIds(i_Count);
+          Util::List<u64> i_UniqueIds(i_Count);
+          l_Reader.read_bytes(i_EntityIndices.data(),
+                              i_Count * sizeof(u32));
+          l_Reader.read_bytes(i_OldIds.data(), i_Count * sizeof(u64));
+          l_Reader.read_bytes(i_UniqueIds.data(),
+                              i_Count * sizeof(u64));
+
+          i_Section.components.reserve(i_Count);
+          Util::Serial::Node i_Node;
+          for (u32 j = 0u; j < i_Count && l_Reader.valid; ++j) {
+            if (i_EntityIndices[j] >= l_Entities.size()) {
+              l_Reader.valid = false;
+              break;
+            }
+
+            if (i_HasNodes) {
+              read_node(l_Reader, i_Node);
+            } else {
+              i_Node = Util::Serial::Node();
+              i_Node["unique_id"] = i_UniqueIds[j];
+            }
+
+            Util::Handle i_Component = i_TypeInfo.deserialize(
+                i_Node, l_Entities[i_EntityIndices[j]]);
+            l_HandleMap[i_OldIds[j]] = i_Component.get_id();
+            i_Section.components.push_back(i_Component);
+          }
+
+          // Skip the property columns for now, they are read in the
+          // second pass
+          i_Section.columnOffset = l_Reader.offset;
+          for (u8 i_Type : i_Section.columnTypes) {
+            l_Reader.offset += get_column_stride(i_Type) * i_Count;
+          }
+          if (l_Reader.offset > l_Reader.size) {
+            l_Reader.valid = false;
+          }
+        }
+
+        for (u32 i = 0u; i < l_Sections.size() && l_Reader.valid;
+             ++i) {
+          RestoredSection &i_Section = l_Sections[i];
+          Util::RTTI::TypeInfo &i_TypeInfo =
+              Util::Handle::get_type_info(i_Section.typeId);
+
+          // Components of one section were created in the order of
+          // their old slots, which usually gives them neighbouring
+          // slots again
+          collect_page_runs(i_TypeInfo, i_Section.components,
+                            i_Section.runs);
+
+          l_Reader.offset = i_Section.columnOffset;
+          for (u32 j = 0u; j < i_Section.columnTypes.size(); ++j) {
+            const u8 i_ColumnType = i_Section.columnTypes[j];
+            const size_t i_ColumnSize =
+                get_column_stride(i_ColumnType) *
+                i_Section.components.size();
+
+            // Columns that do not match the current layout of the
+            // type are skipped
+            auto i_Pos = i_TypeInfo.properties.find(
+                LOW_NAME(i_Section.columnNames[j].c_str()));
+            if (i_Pos == i_TypeInfo.properties.end() ||
+                i_Pos->second.type != i_ColumnType ||
+                !is_column_property(i_Pos->second)) {
+              l_Reader.offset += i_ColumnSize;
+              continue;
+            }
+
+            read_column(l_Reader, l_Strings, i_Pos->second,
+                        is_handle_id_property(i_TypeInfo,
+                                              i_Pos->second),
+                        i_Section.components, i_Section.runs,
+                        l_HandleMap);
+          }
+        }
+
+        // Raw copies skip the setters, so the systems have to be told
+        // to rebuild everything they derive from the restored data
+        for (RestoredSection &i_Section : l_Sections) {
+          if (i_Section.components.empty()) {
+            continue;
+          }
+          Util::RTTI::TypeInfo &i_TypeInfo =
+              Util::Handle::get_type_info(i_Section.typeId);
+          for (auto pit = i_TypeInfo.properties.begin();
+               pit != i_TypeInfo.properties.end(); ++pit) {
+            if (!is_dirty_flag(pit->second) || !pit->second.set) {
+              continue;
+            }
+            const bool i_Dirty = true;
+            for (Util::Handle i_Handle : i_Section.components) {
+              pit->second.set(i_Handle, &i_Dirty);
+            }
+          }
+        }
+
+        for (u32 i = 0u; i < l_Entities.size(); ++i) {
+          if (!l_Active[i]) {
+            l_Entities[i].set_active(false);
+          }
+        }
+
+        if (!l_Reader.valid) {
+          LOW_LOG_ERROR << "Snapshot data is corrupted, the scene "
+                           "was only partially restored"
+                        << LOW_LOG_END;
+          return false;
+        }
+
+        return true;
+      }
+    } // namespace Snapshot
+  }   // namespace Core
+} // namespace Low
@@ -203,8 +203,9 @@ namespace Low {
                                    LOW_EDITOR_ICON_ROUTE)) {
           for (const Core::Navigation::Tile &i_Tile : l_Tiles) {
             ImGui::TextDisabled(
-                "(%d, %d)  %s", i_Tile.coord.x, i_Tile.coord.z,
-                get_tile_state_label(i_Tile.state));
+                "(%d, %d)  %s  %.2f ms", i_Tile.coord.x,
+                i_Tile.coord.z, get_tile_state_label(i_Tile.state),
+                i_Tile.last_build_ms);
           }
         }
       }
@@ -313,6 +313,36 @@ namespace Low {
         ImGui::PopStyleColor(3);
       }
 
+      ImGui::Spacing();
+      if (!l_Frame.counters.empty() &&
+          Gui::CollapsibleHeader("Counters", ICON_LC_GAUGE,
+                                 l_Theme.success)) {
+        if (ImGui::BeginTable(
+                "ProfilerCounters", 3,
+                ImGuiTableFlags_RowBg |
+                    ImGuiTableFlags_BordersInnerV |
+                    ImGuiTableFlags_SizingStretchProp)) {
+          ImGui::TableSetupColumn(
+              "Group", ImGuiTableColumnFlags_WidthFixed, 72.0f);
+          ImGui::TableSetupColumn("Counter");
+          ImGui::TableSetupColumn(
+              "Value", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+          ImGui::TableHeadersRow();
+
+          for (auto &i_Counter : l_Frame.counters) {
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::TextUnformatted(i_Counter.group.c_str());
+            ImGui::TableSetColumnIndex(1);
+            ImGui::TextUnformatted(i_Counter.name.c_str());
+            ImGui::TableSetColumnIndex(2);
+            ImGui::Text("%.0f", i_Counter.value);
+          }
+
+          ImGui::EndTable();
+        }
+      }
+
       ImGui::Spacing();
       if (Gui::CollapsibleHeader("Timeline", ICON_LC_PANEL_TOP,
                                  l_Theme.info)) {
@@ -0,0 +1,100 @@
+#include "LowUtil.h"
+#include "LowUtilContainers.h"
+#include "LowUtilLogger.h"
+#include "LowUtilName.h"
+
+#include "LowRenderer.h"
+
+#include "LowCore.h"
+#include "LowCoreNavigation.h"
+#include "LowCoreRegion.h"
+#include "LowCoreScene.h"
+
+#include <iostream>
+#include <stdlib.h>
+
+// Bakes the navmesh of a scene without starting the editor or the
+// game loop. Run it from the project directory:
+//
+//   lownavbake <scene name>
+//
+// All regions of the scene get loaded, including the streamed ones,
+// so the bake covers the whole scene.
+
+void *operator new[](size_t size, const char *pName, int flags,
+                     unsigned debugFlags, const char *file, int line)
+{
+  return malloc(size);
+}
+
+void *operator new[](size_t size, size_t alignment,
+                     size_t alignmentOffset, const char *pName,
+                     int flags, unsigned debugFlags, const char *file,
+                     int line)
+{
+  return malloc(size);
+}
+
+static void load_all_regions(Low::Core::Scene p_Scene)
+{
+  using namespace Low;
+
+  p_Scene.load();
+
+  for (auto it = p_Scene.get_regions().begin();
+       it != p_Scene.get_regions().end(); ++it) {
+    Core::Region i_Region =
+        Util::find_handle_by_unique_id(*it).get_id();
+    if (i_Region.is_alive() && !i_Region.is_loaded()) {
+      i_Region.load_entities();
+    }
+  }
+  Util::resolve_all_handle_references();
+}
+
+static int bake(const Low::Util::String &p_SceneName)
+{
+  using namespace Low;
+
+  Core::Scene l_Scene =
+      Core::Scene::find_by_name(LOW_NAME(p_SceneName.c_str()));
+  if (!l_Scene.is_alive()) {
+    LOW_LOG_ERROR << "Could not find scene '" << p_SceneName << "'"
+                  << LOW_LOG_END;
+    return 1;
+  }
+
+  load_all_regions(l_Scene);
+
+  if (!Core::Navigation::bake_navmesh(l_Scene)) {
+    LOW_LOG_ERROR << "Baking the navmesh of scene '" << p_SceneName
+                  << "' failed" << LOW_LOG_END;
+    return 1;
+  }
+
+  LOW_LOG_INFO << "Wrote "
+               << Core::Navigation::get_baked_navmesh_path(l_Scene)
+               << LOW_LOG_END;
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc < 2) {
+    std::cerr << "Usage: lownavbake <scene name>" << std::endl;
+    return 2;
+  }
+
+  Low::Util::set_main_window_initially_hidden(true);
+  Low::Util::initialize();
+  Low::Renderer::initialize();
+  Low::Core::initialize();
+
+  const int l_Result = bake(argv[1]);
+
+  Low::Core::cleanup();
+  Low::Renderer::cleanup();
+  Low::Util::cleanup();
+
+  return l_Result;
+}
@@ -45,14 +45,96 @@ namespace Low {
         float time;
         Math::Quaternion value;
       };
+
+      // Follows the file header of compressed clips
+      struct AnimCompressedClipHeader
+      {
+        u32 frame_count;
+        float frame_duration;
+        u32 curve_count;
+        u32 constant_count;
+        u32 segment_count;
+        u32 segment_data_size;
+      };
     } // namespace BinSerial
 
-    struct AnimationChannel
+#define LOW_RENDERER_ANIMATION_CLIP_VERSION_RAW 1u
+#define LOW_RENDERER_ANIMATION_CLIP_VERSION_COMPRESSED 2u
+
+// Frames covered by one segment of a compressed clip. Neighbouring
+// segments share their boundary frame.
+#define LOW_RENDERER_ANIMATION_SEGMENT_FRAMES 16u
+
+    // Where the keys of one channel live in the packed arrays of
+    // its clip
+    struct AnimationTrack
+    {
+      u32 bone_index;
+      u32 position_offset;
+      u32 position_count;
+      u32 rotation_offset;
+      u32 rotation_count;
+      u32 scale_offset;
+      u32 scale_count;
+    };
+
+    enum class AnimationCurveTarget : u32
+    {
+      POSITION,
+      ROTATION,
+      SCALE
+    };
+
+    // One component of a bone in a compressed clip. Constant curves
+    // keep their value, rotations as x, y, z, w. Animated positions
+    // and scales keep the range their keys got quantized to.
+    struct AnimationCurve
     {
       u32 bone_index;
-      Util::List<BinSerial::VecKey> positions;
-      Util::List<BinSerial::QuatKey> rotations;
-      Util::List<BinSerial::VecKey> scales;
+      AnimationCurveTarget target;
+      Math::Vector4 value;
+      Math::Vector3 range_min;
+      Math::Vector3 range_extent;
+    };
+
+    // Animated curves are resampled to evenly spaced frames and
+    // split into segments. Each segment is one block of bytes that
+    // holds the reduced and quantized keys of all animated curves:
+    //
+    //   u32 key count of the segment
+    //   u8  key count per animated curve
+    //   u8  frame of every key relative to the segment start
+    //   u16 x 3 value of every key
+    struct CompressedAnimationTracks
+    {
+      u32 frame_count = 0u;
+      float frame_duration = 0.0f;
+      // Constant curves come before the animated ones
+      u32 constant_count = 0u;
+      Util::List<AnimationCurve> curves;
+      Util::List<u32> segment_offsets;
+      Util::List<u8> segment_data;
+
+      void clear();
+    };
+
+    // The keys of all channels of a clip packed into one array per
+    // component. Times are kept apart from the values so looking up
+    // a key only walks over times.
+    struct AnimationTracks
+    {
+      Util::List<AnimationTrack> tracks;
+      Util::List<float> position_times;
+      Util::List<Math::Vector3> position_values;
+      Util::List<float> rotation_times;
+      Util::List<Math::Quaternion> rotation_values;
+      Util::List<float> scale_times;
+      Util::List<Math::Vector3> scale_values;
+
+      CompressedAnimationTracks compressed;
+
+      bool is_compressed() const;
+      void clear();
     };
     // LOW_CODEGEN::END::CUSTOM:NAMESPACE_CODE
 
@@ -65,7 +147,7 @@ namespace Low {
         Low::Renderer::AnimationClipState state;
         Low::Renderer::AnimationClipResource resource;
         Low::Renderer::Skeleton skeleton;
-        Util::List<AnimationChannel> channels;
+        AnimationTracks tracks;
         float duration;
         float ticks_per_second;
         Low::Util::Set<u64> references;
@@ -198,7 +280,7 @@ namespace Low {
       Low::Renderer::Skeleton get_skeleton() const;
       void set_skeleton(Low::Renderer::Skeleton p_Value);
 
-      Util::List<AnimationChannel> &get_channels() const;
+      AnimationTracks &get_tracks() const;
 
       float get_duration() const;
       void set_duration(float p_Value);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "LowRenderer2Api.h"
+
+#include "LowMath.h"
+#include "LowUtilContainers.h"
+
+#include "LowRendererAnimationClip.h"
+
+namespace Low {
+  namespace Renderer {
+    namespace AnimationCompression {
+      // Errors are measured per bone in its parent space. Rotation
+      // errors are angles in radians.
+      struct Settings
+      {
+        float position_error = 0.0005f;
+        float rotation_error = 0.0005f;
+        float scale_error = 0.0005f;
+      };
+
+      struct Report
+      {
+        u64 raw_size = 0ull;
+        u64 compressed_size = 0ull;
+        u32 raw_key_count = 0u;
+        u32 compressed_key_count = 0u;
+        // Curves that match the bind pose and were left out
+        u32 identity_curve_count = 0u;
+        u32 constant_curve_count = 0u;
+        u32 animated_curve_count = 0u;
+        float max_position_error = 0.0f;
+        float max_rotation_error = 0.0f;
+        float max_scale_error = 0.0f;
+      };
+
+      // Compresses the raw tracks of a clip. Curves that stay at the
+      // local bind transform of their bone are dropped since the
+      // sampler falls back to the bind pose for them.
+      LOW_RENDERER2_API bool
+      compress(const AnimationTracks &p_Source, float p_Duration,
+               const Util::List<Math::Matrix4x4>
+                   &p_LocalBindTransforms,
+               const Settings &p_Settings,
+               CompressedAnimationTracks &p_OutTracks,
+               Report &p_OutReport);
+
+      // Writes the value of every curve at p_Time into p_OutValues.
+      // Rotations are written as x, y, z, w.
+      LOW_RENDERER2_API void
+      sample(const CompressedAnimationTracks &p_Tracks, float p_Time,
+             Util::List<Math::Vector4> &p_OutValues);
+    } // namespace AnimationCompression
+  }   // namespace Renderer
+} // namespace Low
@@ -20,6 +20,9 @@ namespace Low {
       Util::Name name;
       i32 parent_index;
       Math::Matrix4x4 local_bind_transform;
+      Math::Vector3 local_bind_position;
+      Math::Quaternion local_bind_rotation;
+      Math::Vector3 local_bind_scale;
       Math::Matrix4x4 global_bind_transform;
       Math::Matrix4x4 inverse_bind_matrix;
     };
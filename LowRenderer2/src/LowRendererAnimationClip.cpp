@@ -20,6 +20,32 @@
 namespace Low {
   namespace Renderer {
     // LOW_CODEGEN:BEGIN:CUSTOM:NAMESPACE_CODE
+    void AnimationTracks::clear()
+    {
+      tracks.clear();
+      position_times.clear();
+      position_values.clear();
+      rotation_times.clear();
+      rotation_values.clear();
+      scale_times.clear();
+      scale_values.clear();
+      compressed.clear();
+    }
+
+    bool AnimationTracks::is_compressed() const
+    {
+      return compressed.frame_count > 0u;
+    }
+
+    void CompressedAnimationTracks::clear()
+    {
+      frame_count = 0u;
+      frame_duration = 0.0f;
+      constant_count = 0u;
+      curves.clear();
+      segment_offsets.clear();
+      segment_data.clear();
+    }
     // LOW_CODEGEN::END::CUSTOM:NAMESPACE_CODE
 
     u16 AnimationClip::ms_TypeId = 0;
@@ -65,9 +91,8 @@ namespace Low {
       new (ACCESSOR_TYPE_SOA_PTR(l_Handle, AnimationClip, skeleton,
                                  Low::Renderer::Skeleton))
           Low::Renderer::Skeleton();
-      new (ACCESSOR_TYPE_SOA_PTR(l_Handle, AnimationClip, channels,
-                                 Util::List<AnimationChannel>))
-          Util::List<AnimationChannel>();
+      new (ACCESSOR_TYPE_SOA_PTR(l_Handle, AnimationClip, tracks,
+                                 AnimationTracks)) AnimationTracks();
       ACCESSOR_TYPE_SOA(l_Handle, AnimationClip, duration, float) =
           0.0f;
       ACCESSOR_TYPE_SOA(l_Handle, AnimationClip, ticks_per_second,
@@ -277,32 +302,30 @@ namespace Low {
         // End property: skeleton
       }
       {
-        // Property: channels
+        // Property: tracks
         Low::Util::RTTI::PropertyInfo l_PropertyInfo;
-        l_PropertyInfo.name = N(channels);
+        l_PropertyInfo.name = N(tracks);
         l_PropertyInfo.editorProperty = false;
         l_PropertyInfo.dataOffset =
-            offsetof(AnimationClip::Data, channels);
+            offsetof(AnimationClip::Data, tracks);
         l_PropertyInfo.type = Low::Util::RTTI::PropertyType::UNKNOWN;
         l_PropertyInfo.handleType = 0;
         l_PropertyInfo.get_return =
             [](Low::Util::Handle p_Handle) -> void const * {
           AnimationClip l_Handle = p_Handle.get_id();
-          l_Handle.get_channels();
-          return (void *)&ACCESSOR_TYPE_SOA(
-              p_Handle, AnimationClip, channels,
-              Util::List<AnimationChannel>);
+          l_Handle.get_tracks();
+          return (void *)&ACCESSOR_TYPE_SOA(p_Handle, AnimationClip,
+                                            tracks, AnimationTracks);
         };
         l_PropertyInfo.set = [](Low::Util::Handle p_Handle,
                                 const void *p_Data) -> void {};
         l_PropertyInfo.get = [](Low::Util::Handle p_Handle,
                                 void *p_Data) {
           AnimationClip l_Handle = p_Handle.get_id();
-          *((Util::List<AnimationChannel> *)p_Data) =
-              l_Handle.get_channels();
+          *((AnimationTracks *)p_Data) = l_Handle.get_tracks();
         };
         l_TypeInfo.properties[l_PropertyInfo.name] = l_PropertyInfo;
-        // End property: channels
+        // End property: tracks
       }
       {
         // Property: duration
@@ -893,15 +916,14 @@ namespace Low {
       broadcast_observable(N(skeleton));
     }
 
-    Util::List<AnimationChannel> &AnimationClip::get_channels() const
+    AnimationTracks &AnimationClip::get_tracks() const
     {
       _LOW_ASSERT(is_alive());
 
-      // LOW_CODEGEN:BEGIN:CUSTOM:GETTER_channels
-      // LOW_CODEGEN::END::CUSTOM:GETTER_channels
+      // LOW_CODEGEN:BEGIN:CUSTOM:GETTER_tracks
+      // LOW_CODEGEN::END::CUSTOM:GETTER_tracks
 
-      return TYPE_SOA(AnimationClip, channels,
-                      Util::List<AnimationChannel>);
+      return TYPE_SOA(AnimationClip, tracks, AnimationTracks);
     }
 
     float AnimationClip::get_duration() const
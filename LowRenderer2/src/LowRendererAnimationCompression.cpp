@@ -0,0 +1,746 @@
+#include "LowRendererAnimationCompression.h"
+
+#include "LowUtilAssert.h"
+#include "LowUtilProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <glm/gtx/matrix_decompose.hpp>
+
+namespace Low {
+  namespace Renderer {
+    namespace AnimationCompression {
+      // Every key value is stored as three u16
+      static const u32 g_KeyValueSize = 3u * sizeof(u16);
+
+      // The three smallest components of a unit quaternion lie
+      // within +-1/sqrt(2), each of them gets 15 bits and the index
+      // of the dropped one the remaining bits of the 48
+      static const float g_QuatComponentRange = 0.70710678f;
+      static const u32 g_QuatComponentBits = 15u;
+      static const u64 g_QuatComponentMax =
+          (1ull << g_QuatComponentBits) - 1ull;
+
+      static const float g_VectorComponentMax = 65535.0f;
+
+      // Keeps pathological key spacing from blowing up the frame
+      // count of a clip
+      static const u32 g_MaxFrameCount = 1u << 16u;
+
+      struct SourceCurve
+      {
+        AnimationCurve curve;
+        // The curve resampled at every frame of the clip
+        Util::List<Math::Vector4> frames;
+        // What the sampler gets back for every frame once quantized
+        Util::List<Math::Vector4> decoded;
+        Util::List<u16> quantized;
+      };
+
+      static Math::Vector4
+      to_vector(const Math::Quaternion &p_Rotation)
+      {
+        return Math::Vector4(p_Rotation.x, p_Rotation.y, p_Rotation.z,
+                             p_Rotation.w);
+      }
+
+      static void encode_quaternion(Math::Vector4 p_Rotation,
+                                    u16 *p_Out)
+      {
+        u32 l_Largest = 0u;
+        for (u32 i = 1u; i < 4u; ++i) {
+          if (std::abs(p_Rotation[i]) >
+              std::abs(p_Rotation[l_Largest])) {
+            l_Largest = i;
+          }
+        }
+
+        // q and -q are the same rotation so the dropped component
+        // can always be restored as positive
+        if (p_Rotation[l_Largest] < 0.0f) {
+          p_Rotation = -p_Rotation;
+        }
+
+        u64 l_Bits = static_cast<u64>(l_Largest);
+        for (u32 i = 0u; i < 4u; ++i) {
+          if (i == l_Largest) {
+            continue;
+          }
+          const float i_Normalized = std::clamp(
+              (p_Rotation[i] + g_QuatComponentRange) /
+                  (2.0f * g_QuatComponentRange),
+              0.0f, 1.0f);
+          l_Bits = (l_Bits << g_QuatComponentBits) |
+                   static_cast<u64>(std::lround(
+                       i_Normalized *
+                       static_cast<float>(g_QuatComponentMax)));
+        }
+
+        p_Out[0] = static_cast<u16>(l_Bits & 0xFFFFull);
+        p_Out[1] = static_cast<u16>((l_Bits >> 16u) & 0xFFFFull);
+        p_Out[2] = static_cast<u16>((l_Bits >> 32u) & 0xFFFFull);
+      }
+
+      static Math::Vector4 decode_quaternion(const u16 *p_In)
+      {
+        u64 l_Bits = static_cast<u64>(p_In[0]) |
+                     (static_cast<u64>(p_In[1]) << 16u) |
+                     (static_cast<u64>(p_In[2]) << 32u);
+        const u32 l_Largest = static_cast<u32>(
+            (l_Bits >> (3u * g_QuatComponentBits)) & 3ull);
+
+        Math::Vector4 l_Rotation(0.0f);
+        float l_SquaredSum = 0.0f;
+        // Components were pushed in ascending order so the last one
+        // sits in the lowest bits
+        for (i32 i = 3; i >= 0; --i) {
+          if (static_cast<u32>(i) == l_Largest) {
+            continue;
+          }
+          const float i_Normalized =
+              static_cast<float>(l_Bits & g_QuatComponentMax) /
+              static_cast<float>(g_QuatComponentMax);
+          l_Bits >>= g_QuatComponentBits;
+
+          l_Rotation[i] = i_Normalized * 2.0f * g_QuatComponentRange -
+                          g_QuatComponentRange;
+          l_SquaredSum += l_Rotation[i] * l_Rotation[i];
+        }
+        l_Rotation[l_Largest] =
+            std::sqrt(std::max(0.0f, 1.0f - l_SquaredSum));
+
+        return l_Rotation;
+      }
+
+      static void encode_vector(const Math::Vector4 &p_Value,
+                                const AnimationCurve &p_Curve,
+                                u16 *p_Out)
+      {
+        for (u32 i = 0u; i < 3u; ++i) {
+          float i_Normalized = 0.0f;
+          if (p_Curve.range_extent[i] > LOW_MATH_EPSILON) {
+            i_Normalized = std::clamp(
+                (p_Value[i] - p_Curve.range_min[i]) /
+                    p_Curve.range_extent[i],
+                0.0f, 1.0f);
+          }
+          p_Out[i] = static_cast<u16>(
+              std::lround(i_Normalized * g_VectorComponentMax));
+        }
+      }
+
+      static Math::Vector4
+      decode_vector(const u16 *p_In, const AnimationCurve &p_Curve)
+      {
+        Math::Vector4 l_Value(0.0f);
+        for (u32 i = 0u; i < 3u; ++i) {
+          l_Value[i] = p_Curve.range_min[i] +
+                       (static_cast<float>(p_In[i]) /
+                        g_VectorComponentMax) *
+                           p_Curve.range_extent[i];
+        }
+        return l_Value;
+      }
+
+      static void encode_key(const Math::Vector4 &p_Value,
+                             const AnimationCurve &p_Curve,
+                             u16 *p_Out)
+      {
+        if (p_Curve.target == AnimationCurveTarget::ROTATION) {
+          encode_quaternion(p_Value, p_Out);
+        } else {
+          encode_vector(p_Value, p_Curve, p_Out);
+        }
+      }
+
+      static Math::Vector4 decode_key(const u8 *p_Data,
+                                      const AnimationCurve &p_Curve)
+      {
+        // Segment blocks are byte packed
+        u16 l_Quantized[3];
+        memcpy(l_Quantized, p_Data, g_KeyValueSize);
+
+        if (p_Curve.target == AnimationCurveTarget::ROTATION) {
+          return decode_quaternion(l_Quantized);
+        }
+        return decode_vector(l_Quantized, p_Curve);
+      }
+
+      static Math::Vector4 interpolate(AnimationCurveTarget p_Target,
+                                       const Math::Vector4 &p_A,
+                                       Math::Vector4 p_B,
+                                       float p_Factor)
+      {
+        if (p_Target != AnimationCurveTarget::ROTATION) {
+          return glm::mix(p_A, p_B, p_Factor);
+        }
+
+        if (glm::dot(p_A, p_B) < 0.0f) {
+          p_B = -p_B;
+        }
+        return glm::normalize(glm::mix(p_A, p_B, p_Factor));
+      }
+
+      static float measure_error(AnimationCurveTarget p_Target,
+                                 const Math::Vector4 &p_A,
+                                 const Math::Vector4 &p_B)
+      {
+        if (p_Target != AnimationCurveTarget::ROTATION) {
+          return glm::length(Math::Vector3(p_A) - Math::Vector3(p_B));
+        }
+
+        const float l_Dot =
+            std::min(1.0f, std::abs(glm::dot(p_A, p_B)));
+        return 2.0f * std::acos(l_Dot);
+      }
+
+      static float get_tolerance(AnimationCurveTarget p_Target,
+                                 const Settings &p_Settings)
+      {
+        switch (p_Target) {
+        case AnimationCurveTarget::POSITION:
+          return p_Settings.position_error;
+        case AnimationCurveTarget::ROTATION:
+          return p_Settings.rotation_error;
+        default:
+          return p_Settings.scale_error;
+        }
+      }
+
+      static void track_error(Report &p_Report,
+                              AnimationCurveTarget p_Target,
+                              float p_Error)
+      {
+        switch (p_Target) {
+        case AnimationCurveTarget::POSITION:
+          p_Report.max_position_error =
+              std::max(p_Report.max_position_error, p_Error);
+          break;
+        case AnimationCurveTarget::ROTATION:
+          p_Report.max_rotation_error =
+              std::max(p_Report.max_rotation_error, p_Error);
+          break;
+        default:
+          p_Report.max_scale_error =
+              std::max(p_Report.max_scale_error, p_Error);
+          break;
+        }
+      }
+
+      // Returns the last key at or before p_Time
+      static u32 find_source_key(const float *p_Times, u32 p_Count,
+                                 float p_Time)
+      {
+        const float *l_Upper =
+            std::upper_bound(p_Times, p_Times + p_Count, p_Time);
+        return l_Upper == p_Times
+                   ? 0u
+                   : static_cast<u32>(l_Upper - p_Times) - 1u;
+      }
+
+      static Math::Vector4
+      sample_source_vector(const float *p_Times,
+                           const Math::Vector3 *p_Values, u32 p_Count,
+                           float p_Time)
+      {
+        if (p_Count == 1u || p_Time <= p_Times[0]) {
+          return Math::Vector4(p_Values[0], 0.0f);
+        }
+
+        const u32 l_Key = find_source_key(p_Times, p_Count, p_Time);
+        if (l_Key + 1u >= p_Count) {
+          return Math::Vector4(p_Values[p_Count - 1u], 0.0f);
+        }
+
+        const float l_Duration = p_Times[l_Key + 1u] - p_Times[l_Key];
+        if (l_Duration <= LOW_MATH_EPSILON) {
+          return Math::Vector4(p_Values[l_Key], 0.0f);
+        }
+
+        const float l_Factor = (p_Time - p_Times[l_Key]) / l_Duration;
+        return Math::Vector4(glm::mix(p_Values[l_Key],
+                                      p_Values[l_Key + 1u], l_Factor),
+                             0.0f);
+      }
+
+      static Math::Vector4
+      sample_source_rotation(const float *p_Times,
+                             const Math::Quaternion *p_Values,
+                             u32 p_Count, float p_Time)
+      {
+        if (p_Count == 1u || p_Time <= p_Times[0]) {
+          return to_vector(p_Values[0]);
+        }
+
+        const u32 l_Key = find_source_key(p_Times, p_Count, p_Time);
+        if (l_Key + 1u >= p_Count) {
+          return to_vector(p_Values[p_Count - 1u]);
+        }
+
+        const float l_Duration = p_Times[l_Key + 1u] - p_Times[l_Key];
+        if (l_Duration <= LOW_MATH_EPSILON) {
+          return to_vector(p_Values[l_Key]);
+        }
+
+        const float l_Factor = (p_Time - p_Times[l_Key]) / l_Duration;
+        return to_vector(glm::normalize(glm::slerp(
+            p_Values[l_Key], p_Values[l_Key + 1u], l_Factor)));
+      }
+
+      static void find_smallest_gap(const float *p_Times, u32 p_Count,
+                                    float &p_Gap)
+      {
+        for (u32 i = 1u; i < p_Count; ++i) {
+          const float i_Gap = p_Times[i] - p_Times[i - 1u];
+          if (i_Gap > LOW_MATH_EPSILON) {
+            p_Gap = std::min(p_Gap, i_Gap);
+          }
+        }
+      }
+
+      static u32 get_frame_count(const AnimationTracks &p_Source,
+                                 float p_Duration)
+      {
+        if (p_Duration <= LOW_MATH_EPSILON) {
+          return 1u;
+        }
+
+        float l_Gap = p_Duration;
+        for (const AnimationTrack &i_Track : p_Source.tracks) {
+          find_smallest_gap(
+              p_Source.position_times.data() +
+                  i_Track.position_offset,
+              i_Track.position_count, l_Gap);
+          find_smallest_gap(
+              p_Source.rotation_times.data() +
+                  i_Track.rotation_offset,
+              i_Track.rotation_count, l_Gap);
+          find_smallest_gap(
+              p_Source.scale_times.data() + i_Track.scale_offset,
+              i_Track.scale_count, l_Gap);
+        }
+
+        const float l_Intervals = std::round(p_Duration / l_Gap);
+        return std::clamp(static_cast<u32>(l_Intervals), 1u,
+                          g_MaxFrameCount - 1u) +
+               1u;
+      }
+
+      static void decompose_bind_transforms(
+          const Util::List<Math::Matrix4x4> &p_Transforms,
+          Util::List<Math::Vector4> &p_OutValues)
+      {
+        p_OutValues.resize(p_Transforms.size() * 3u);
+        for (u32 i = 0u; i < p_Transforms.size(); ++i) {
+          Math::Vector3 i_Position(0.0f);
+          Math::Quaternion i_Rotation(1.0f, 0.0f, 0.0f, 0.0f);
+          Math::Vector3 i_Scale(1.0f);
+          Math::Vector3 i_Skew;
+          Math::Vector4 i_Perspective;
+          glm::decompose(p_Transforms[i], i_Scale, i_Rotation,
+                         i_Position, i_Skew, i_Perspective);
+
+          p_OutValues[i * 3u] = Math::Vector4(i_Position, 0.0f);
+          p_OutValues[i * 3u + 1u] =
+              to_vector(glm::normalize(i_Rotation));
+          p_OutValues[i * 3u + 2u] = Math::Vector4(i_Scale, 0.0f);
+        }
+      }
+
+      static void resample_curve(const AnimationTracks &p_Source,
+                                 const AnimationTrack &p_Track,
+                                 u32 p_FrameCount,
+                                 float p_FrameDuration,
+                                 float p_Duration,
+                                 SourceCurve &p_Curve)
+      {
+        p_Curve.frames.resize(p_FrameCount);
+        for (u32 i = 0u; i < p_FrameCount; ++i) {
+          const float i_Time =
+              std::min(i * p_FrameDuration, p_Duration);
+
+          switch (p_Curve.curve.target) {
+          case AnimationCurveTarget::POSITION:
+            p_Curve.frames[i] = sample_source_vector(
+                &p_Source.position_times[p_Track.position_offset],
+                &p_Source.position_values[p_Track.position_offset],
+                p_Track.position_count, i_Time);
+            break;
+          case AnimationCurveTarget::ROTATION:
+            p_Curve.frames[i] = sample_source_rotation(
+                &p_Source.rotation_times[p_Track.rotation_offset],
+                &p_Source.rotation_values[p_Track.rotation_offset],
+                p_Track.rotation_count, i_Time);
+            break;
+          default:
+            p_Curve.frames[i] = sample_source_vector(
+                &p_Source.scale_times[p_Track.scale_offset],
+                &p_Source.scale_values[p_Track.scale_offset],
+                p_Track.scale_count, i_Time);
+            break;
+          }
+        }
+      }
+
+      static float max_error_to(const SourceCurve &p_Curve,
+                                const Math::Vector4 &p_Value)
+      {
+        float l_Error = 0.0f;
+        for (const Math::Vector4 &i_Frame : p_Curve.frames) {
+          l_Error = std::max(l_Error,
+                             measure_error(p_Curve.curve.target,
+                                           i_Frame, p_Value));
+        }
+        return l_Error;
+      }
+
+      static void quantize_curve(SourceCurve &p_Curve)
+      {
+        AnimationCurve &l_Curve = p_Curve.curve;
+        l_Curve.range_min = Math::Vector3(0.0f);
+        l_Curve.range_extent = Math::Vector3(0.0f);
+
+        if (l_Curve.target != AnimationCurveTarget::ROTATION) {
+          Math::Vector3 l_Min(p_Curve.frames[0]);
+          Math::Vector3 l_Max(p_Curve.frames[0]);
+          for (const Math::Vector4 &i_Frame : p_Curve.frames) {
+            l_Min = glm::min(l_Min, Math::Vector3(i_Frame));
+            l_Max = glm::max(l_Max, Math::Vector3(i_Frame));
+          }
+          l_Curve.range_min = l_Min;
+          l_Curve.range_extent = l_Max - l_Min;
+        }
+
+        const u32 l_FrameCount =
+            static_cast<u32>(p_Curve.frames.size());
+        p_Curve.quantized.resize(l_FrameCount * 3u);
+        p_Curve.decoded.resize(l_FrameCount);
+        for (u32 i = 0u; i < l_FrameCount; ++i) {
+          u16 *i_Quantized = &p_Curve.quantized[i * 3u];
+          encode_key(p_Curve.frames[i], l_Curve, i_Quantized);
+          p_Curve.decoded[i] = decode_key(
+              reinterpret_cast<const u8 *>(i_Quantized), l_Curve);
+        }
+      }
+
+      static bool span_within_tolerance(const SourceCurve &p_Curve,
+                                        u32 p_First, u32 p_Last,
+                                        float p_Tolerance)
+      {
+        const float l_Span = static_cast<float>(p_Last - p_First);
+        for (u32 i = p_First + 1u; i < p_Last; ++i) {
+          const Math::Vector4 i_Value = interpolate(
+              p_Curve.curve.target, p_Curve.decoded[p_First],
+              p_Curve.decoded[p_Last],
+              static_cast<float>(i - p_First) / l_Span);
+          if (measure_error(p_Curve.curve.target, i_Value,
+                            p_Curve.frames[i]) > p_Tolerance) {
+            return false;
+          }
+        }
+        return true;
+      }
+
+      // Keeps the first and last frame of the segment and, going
+      // forward from the last kept key, the farthest frame that
+      // still interpolates everything in between within tolerance
+      static void reduce_keys(const SourceCurve &p_Curve,
+                              u32 p_SegmentStart, u32 p_SegmentEnd,
+                              float p_Tolerance,
+                              Util::List<u8> &p_OutFrames)
+      {
+        p_OutFrames.push_back(0u);
+
+        u32 l_Key = p_SegmentStart;
+        while (l_Key < p_SegmentEnd) {
+          u32 l_Next = l_Key + 1u;
+          for (u32 i = p_SegmentEnd; i > l_Key + 1u; --i) {
+            if (span_within_tolerance(p_Curve, l_Key, i,
+                                      p_Tolerance)) {
+              l_Next = i;
+              break;
+            }
+          }
+
+          p_OutFrames.push_back(
+              static_cast<u8>(l_Next - p_SegmentStart));
+          l_Key = l_Next;
+        }
+      }
+
+      static void append_bytes(Util::List<u8> &p_Data,
+                               const void *p_Source, u32 p_Size)
+      {
+        const u8 *l_Bytes = static_cast<const u8 *>(p_Source);
+        p_Data.insert(p_Data.end(), l_Bytes, l_Bytes + p_Size);
+      }
+
+      static void
+      write_segments(const Util::List<SourceCurve> &p_Animated,
+                     const Settings &p_Settings,
+                     CompressedAnimationTracks &p_OutTracks,
+                     Report &p_OutReport)
+      {
+        if (p_Animated.empty()) {
+          return;
+        }
+
+        const u32 l_SegmentCount =
+            (p_OutTracks.frame_count - 2u) /
+                LOW_RENDERER_ANIMATION_SEGMENT_FRAMES +
+            1u;
+        p_OutTracks.segment_offsets.resize(l_SegmentCount);
+
+        Util::List<u8> l_Counts;
+        Util::List<u8> l_Frames;
+        Util::List<u16> l_Values;
+        for (u32 i = 0u; i < l_SegmentCount; ++i) {
+          const u32 i_Start =
+              i * LOW_RENDERER_ANIMATION_SEGMENT_FRAMES;
+          const u32 i_End = std::min(
+              i_Start + LOW_RENDERER_ANIMATION_SEGMENT_FRAMES,
+              p_OutTracks.frame_count - 1u);
+
+          l_Counts.clear();
+          l_Frames.clear();
+          l_Values.clear();
+          for (const SourceCurve &i_Curve : p_Animated) {
+            const u32 i_FirstKey = static_cast<u32>(l_Frames.size());
+            reduce_keys(i_Curve, i_Start, i_End,
+                        get_tolerance(i_Curve.curve.target,
+                                      p_Settings),
+                        l_Frames);
+            l_Counts.push_back(static_cast<u8>(l_Frames.size() -
+                                               i_FirstKey));
+
+            for (u32 j = i_FirstKey; j < l_Frames.size(); ++j) {
+              const u16 *j_Quantized =
+                  &i_Curve.quantized[(i_Start + l_Frames[j]) * 3u];
+              l_Values.insert(l_Values.end(), j_Quantized,
+                              j_Quantized + 3u);
+            }
+          }
+
+          const u32 i_KeyCount = static_cast<u32>(l_Frames.size());
+          p_OutReport.compressed_key_count += i_KeyCount;
+
+          Util::List<u8> &l_Data = p_OutTracks.segment_data;
+          p_OutTracks.segment_offsets[i] =
+              static_cast<u32>(l_Data.size());
+          append_bytes(l_Data, &i_KeyCount, sizeof(i_KeyCount));
+          append_bytes(l_Data, l_Counts.data(),
+                       static_cast<u32>(l_Counts.size()));
+          append_bytes(l_Data, l_Frames.data(), i_KeyCount);
+          append_bytes(l_Data, l_Values.data(),
+                       i_KeyCount * g_KeyValueSize);
+        }
+      }
+
+      static void measure_compressed_error(
+          const CompressedAnimationTracks &p_Tracks,
+          const Util::List<SourceCurve> &p_Curves,
+          Report &p_OutReport)
+      {
+        Util::List<Math::Vector4> l_Values;
+        for (u32 i = 0u; i < p_Tracks.frame_count; ++i) {
+          sample(p_Tracks, i * p_Tracks.frame_duration, l_Values);
+          for (u32 j = 0u; j < p_Curves.size(); ++j) {
+            const AnimationCurveTarget j_Target =
+                p_Curves[j].curve.target;
+            track_error(p_OutReport, j_Target,
+                        measure_error(j_Target, l_Values[j],
+                                      p_Curves[j].frames[i]));
+          }
+        }
+      }
+
+      bool compress(const AnimationTracks &p_Source, float p_Duration,
+                    const Util::List<Math::Matrix4x4>
+                        &p_LocalBindTransforms,
+                    const Settings &p_Settings,
+                    CompressedAnimationTracks &p_OutTracks,
+                    Report &p_OutReport)
+      {
+        LOW_PROFILE_CPU("Renderer", "AnimationCompression::compress");
+
+        LOW_ASSERT(!p_Source.is_compressed(),
+                   "Animation tracks are compressed already");
+
+        p_OutTracks.clear();
+        p_OutReport = Report();
+
+        const u32 l_FrameCount =
+            get_frame_count(p_Source, p_Duration);
+        p_OutTracks.frame_count = l_FrameCount;
+        p_OutTracks.frame_duration =
+            l_FrameCount > 1u ? p_Duration / (l_FrameCount - 1u)
+                              : 0.0f;
+
+        Util::List<Math::Vector4> l_BindValues;
+        decompose_bind_transforms(p_LocalBindTransforms,
+                                  l_BindValues);
+
+        Util::List<SourceCurve> l_Constant;
+        Util::List<SourceCurve> l_Animated;
+        for (const AnimationTrack &i_Track : p_Source.tracks) {
+          const u32 i_KeyCounts[3] = {i_Track.position_count,
+                                      i_Track.rotation_count,
+                                      i_Track.scale_count};
+          p_OutReport.raw_key_count +=
+              i_KeyCounts[0] + i_KeyCounts[1] + i_KeyCounts[2];
+
+          for (u32 j = 0u; j < 3u; ++j) {
+            if (i_KeyCounts[j] == 0u) {
+              continue;
+            }
+
+            SourceCurve j_Curve;
+            j_Curve.curve.bone_index = i_Track.bone_index;
+            j_Curve.curve.target =
+                static_cast<AnimationCurveTarget>(j);
+            j_Curve.curve.value = Math::Vector4(0.0f);
+            j_Curve.curve.range_min = Math::Vector3(0.0f);
+            j_Curve.curve.range_extent = Math::Vector3(0.0f);
+            resample_curve(p_Source, i_Track, l_FrameCount,
+                           p_OutTracks.frame_duration, p_Duration,
+                           j_Curve);
+
+            const AnimationCurveTarget j_Target =
+                j_Curve.curve.target;
+            const float j_Tolerance =
+                get_tolerance(j_Target, p_Settings);
+
+            const u32 j_BindIndex = i_Track.bone_index * 3u + j;
+            if (j_BindIndex < l_BindValues.size()) {
+              const float j_BindError =
+                  max_error_to(j_Curve, l_BindValues[j_BindIndex]);
+              if (j_BindError <= j_Tolerance) {
+                track_error(p_OutReport, j_Target, j_BindError);
+                p_OutReport.identity_curve_count++;
+                continue;
+              }
+            }
+
+            if (max_error_to(j_Curve, j_Curve.frames[0]) <=
+                j_Tolerance) {
+              j_Curve.curve.value = j_Curve.frames[0];
+              l_Constant.push_back(std::move(j_Curve));
+              continue;
+            }
+
+            quantize_curve(j_Curve);
+            l_Animated.push_back(std::move(j_Curve));
+          }
+        }
+
+        p_OutTracks.constant_count =
+            static_cast<u32>(l_Constant.size());
+        p_OutReport.constant_curve_count = p_OutTracks.constant_count;
+        p_OutReport.animated_curve_count =
+            static_cast<u32>(l_Animated.size());
+        p_OutReport.compressed_key_count = p_OutTracks.constant_count;
+
+        // Constant and animated curves keep their resampled frames
+        // in the order of the compressed curves to measure the error
+        Util::List<SourceCurve> l_Curves = std::move(l_Constant);
+        l_Curves.insert(l_Curves.end(), l_Animated.begin(),
+                        l_Animated.end());
+        for (const SourceCurve &i_Curve : l_Curves) {
+          p_OutTracks.curves.push_back(i_Curve.curve);
+        }
+
+        write_segments(l_Animated, p_Settings, p_OutTracks,
+                       p_OutReport);
+        measure_compressed_error(p_OutTracks, l_Curves, p_OutReport);
+
+        p_OutReport.raw_size =
+            sizeof(BinSerial::AnimClipFileHeader) +
+            p_Source.tracks.size() *
+                sizeof(BinSerial::AnimChannelHeader) +
+            p_Source.position_times.size() *
+                sizeof(BinSerial::VecKey) +
+            p_Source.rotation_times.size() *
+                sizeof(BinSerial::QuatKey) +
+            p_Source.scale_times.size() * sizeof(BinSerial::VecKey);
+        p_OutReport.compressed_size =
+            sizeof(BinSerial::AnimClipFileHeader) +
+            sizeof(BinSerial::AnimCompressedClipHeader) +
+            p_OutTracks.curves.size() * sizeof(AnimationCurve) +
+            p_OutTracks.segment_offsets.size() * sizeof(u32) +
+            p_OutTracks.segment_data.size();
+
+        return true;
+      }
+
+      void sample(const CompressedAnimationTracks &p_Tracks,
+                  float p_Time,
+                  Util::List<Math::Vector4> &p_OutValues)
+      {
+        const u32 l_CurveCount =
+            static_cast<u32>(p_Tracks.curves.size());
+        p_OutValues.resize(l_CurveCount);
+        for (u32 i = 0u; i < p_Tracks.constant_count; ++i) {
+          p_OutValues[i] = p_Tracks.curves[i].value;
+        }
+
+        if (p_Tracks.segment_offsets.empty()) {
+          return;
+        }
+
+        const float l_Frame =
+            std::clamp(p_Time / p_Tracks.frame_duration, 0.0f,
+                       static_cast<float>(p_Tracks.frame_count - 1u));
+        const u32 l_Segment = std::min(
+            static_cast<u32>(l_Frame) /
+                LOW_RENDERER_ANIMATION_SEGMENT_FRAMES,
+            static_cast<u32>(p_Tracks.segment_offsets.size()) - 1u);
+        const float l_SegmentFrame =
+            l_Frame - static_cast<float>(
+                          l_Segment *
+                          LOW_RENDERER_ANIMATION_SEGMENT_FRAMES);
+
+        // Everything this sample needs lives in one block
+        const u8 *l_Block = p_Tracks.segment_data.data() +
+                            p_Tracks.segment_offsets[l_Segment];
+        u32 l_KeyCount = 0u;
+        memcpy(&l_KeyCount, l_Block, sizeof(l_KeyCount));
+
+        const u32 l_AnimatedCount =
+            l_CurveCount - p_Tracks.constant_count;
+        const u8 *l_Counts = l_Block + sizeof(l_KeyCount);
+        const u8 *l_Frames = l_Counts + l_AnimatedCount;
+        const u8 *l_Values = l_Frames + l_KeyCount;
+
+        for (u32 i = 0u; i < l_AnimatedCount; ++i) {
+          const AnimationCurve &i_Curve =
+              p_Tracks.curves[p_Tracks.constant_count + i];
+          const u32 i_Count = l_Counts[i];
+
+          u32 i_Key = 0u;
+          while (i_Key + 2u < i_Count &&
+                 l_Frames[i_Key + 1u] <= l_SegmentFrame) {
+            ++i_Key;
+          }
+
+          const float i_Start = l_Frames[i_Key];
+          const float i_End = l_Frames[i_Key + 1u];
+          const float i_Factor = std::clamp(
+              (l_SegmentFrame - i_Start) / (i_End - i_Start), 0.0f,
+              1.0f);
+
+          p_OutValues[p_Tracks.constant_count + i] = interpolate(
+              i_Curve.target,
+              decode_key(l_Values + i_Key * g_KeyValueSize, i_Curve),
+              decode_key(l_Values + (i_Key + 1u) * g_KeyValueSize,
+                         i_Curve),
+              i_Factor);
+
+          l_Frames += i_Count;
+          l_Values += i_Count * g_KeyValueSize;
+        }
+      }
+    } // namespace AnimationCompression
+  }   // namespace Renderer
+} // namespace Low
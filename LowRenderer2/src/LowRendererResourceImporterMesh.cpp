@@ -9,6 +9,7 @@
 #include "LowRendererAnimationClip.h"
 #include "LowRendererResourceImporter.h"
 #include "LowRendererAnimationClip.h"
+#include "LowRendererAnimationCompression.h"
 
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
@@ -1201,75 +1202,110 @@ namespace Low {
         return true;
       }
 
-      static bool import_animation_clip(
+      static void build_animation_tracks(
           const MeshImport::AnimationClipImportData &p_Clip,
-          const Util::String &p_ImportPath,
-          const Util::String &p_OutputPath,
-          const u64 p_SkeletonUniqueId)
+          AnimationTracks &p_OutTracks)
       {
-        const u64 l_AnimationClipId = Util::generate_unique_id();
-
-        BinSerial::AnimClipFileHeader l_Header;
-        memset(&l_Header, 0, sizeof(l_Header));
-        memcpy(l_Header.magic, "LOWANIMCLIP", 11);
-        l_Header.version = 1u;
-        l_Header.duration = static_cast<float>(p_Clip.duration);
-        l_Header.ticks_per_second =
-            static_cast<float>(p_Clip.ticksPerSecond);
-        l_Header.channel_count = 0;
-
-        Util::List<BinSerial::AnimChannelHeader> l_ChannelHeaders;
-        Util::List<BinSerial::VecKey> l_Positions;
-        Util::List<BinSerial::QuatKey> l_Rotations;
-        Util::List<BinSerial::VecKey> l_Scales;
+        p_OutTracks.clear();
 
         for (u32 i = 0u; i < p_Clip.channels.size(); ++i) {
-
           if (!p_Clip.channels[i].targetsSkeletonBone) {
             continue;
           }
 
-          l_Header.channel_count++;
-
           const MeshImport::AnimationClipImportChannel &i_Channel =
               p_Clip.channels[i];
 
-          BinSerial::AnimChannelHeader i_ChannelHeader;
-          i_ChannelHeader.bone_index = i_Channel.boneIndex;
-          i_ChannelHeader.position_count = 0;
-          i_ChannelHeader.rotation_count = 0;
-          i_ChannelHeader.scale_count = 0;
+          AnimationTrack i_Track;
+          i_Track.bone_index = i_Channel.boneIndex;
+          i_Track.position_offset =
+              static_cast<u32>(p_OutTracks.position_times.size());
+          i_Track.position_count =
+              static_cast<u32>(i_Channel.positions.size());
+          i_Track.rotation_offset =
+              static_cast<u32>(p_OutTracks.rotation_times.size());
+          i_Track.rotation_count =
+              static_cast<u32>(i_Channel.rotations.size());
+          i_Track.scale_offset =
+              static_cast<u32>(p_OutTracks.scale_times.size());
+          i_Track.scale_count =
+              static_cast<u32>(i_Channel.scales.size());
 
           for (const MeshImport::AnimationVectorKey &i_Key :
                i_Channel.positions) {
-            BinSerial::VecKey i_SerialKey;
-            i_SerialKey.time = i_Key.time;
-            i_SerialKey.value = i_Key.value;
-
-            l_Positions.push_back(i_SerialKey);
-            i_ChannelHeader.position_count++;
+            p_OutTracks.position_times.push_back(
+                static_cast<float>(i_Key.time));
+            p_OutTracks.position_values.push_back(i_Key.value);
           }
           for (const MeshImport::AnimationRotationKey &i_Key :
                i_Channel.rotations) {
-            BinSerial::QuatKey i_SerialKey;
-            i_SerialKey.time = i_Key.time;
-            i_SerialKey.value = i_Key.value;
-
-            l_Rotations.push_back(i_SerialKey);
-            i_ChannelHeader.rotation_count++;
+            p_OutTracks.rotation_times.push_back(
+                static_cast<float>(i_Key.time));
+            p_OutTracks.rotation_values.push_back(
+                glm::normalize(i_Key.value));
           }
           for (const MeshImport::AnimationVectorKey &i_Key :
                i_Channel.scales) {
-            BinSerial::VecKey i_SerialKey;
-            i_SerialKey.time = i_Key.time;
-            i_SerialKey.value = i_Key.value;
-
-            l_Scales.push_back(i_SerialKey);
-            i_ChannelHeader.scale_count++;
+            p_OutTracks.scale_times.push_back(
+                static_cast<float>(i_Key.time));
+            p_OutTracks.scale_values.push_back(i_Key.value);
           }
 
-          l_ChannelHeaders.push_back(i_ChannelHeader);
+          p_OutTracks.tracks.push_back(i_Track);
         }
+      }
+
+      static bool import_animation_clip(
+          const MeshImport::AnimationClipImportData &p_Clip,
+          const MeshImport::SkeletonImportData &p_SkeletonData,
+          const Util::String &p_ImportPath,
+          const Util::String &p_OutputPath,
+          const u64 p_SkeletonUniqueId)
+      {
+        const u64 l_AnimationClipId = Util::generate_unique_id();
+
+        AnimationTracks l_SourceTracks;
+        build_animation_tracks(p_Clip, l_SourceTracks);
+
+        Util::List<Math::Matrix4x4> l_LocalBindTransforms;
+        l_LocalBindTransforms.resize(p_SkeletonData.bones.size());
+        for (u32 i = 0u; i < p_SkeletonData.bones.size(); ++i) {
+          l_LocalBindTransforms[i] =
+              p_SkeletonData.bones[i].localBindTransform;
+        }
+
+        const AnimationCompression::Settings l_Settings;
+        CompressedAnimationTracks l_Tracks;
+        AnimationCompression::Report l_Report;
+        LOWR_IMP_ASSERT_RETURN(
+            AnimationCompression::compress(
+                l_SourceTracks, static_cast<float>(p_Clip.duration),
+                l_LocalBindTransforms, l_Settings, l_Tracks,
+                l_Report),
+            "Failed to compress animation clip.");
+
+        BinSerial::AnimClipFileHeader l_Header;
+        memset(&l_Header, 0, sizeof(l_Header));
+        memcpy(l_Header.magic, "LOWANIMCLIP", 11);
+        l_Header.version =
+            LOW_RENDERER_ANIMATION_CLIP_VERSION_COMPRESSED;
+        l_Header.duration = static_cast<float>(p_Clip.duration);
+        l_Header.ticks_per_second =
+            static_cast<float>(p_Clip.ticksPerSecond);
+        l_Header.channel_count =
+            static_cast<u32>(l_SourceTracks.tracks.size());
+
+        BinSerial::AnimCompressedClipHeader l_CompressedHeader;
+        l_CompressedHeader.frame_count = l_Tracks.frame_count;
+        l_CompressedHeader.frame_duration = l_Tracks.frame_duration;
+        l_CompressedHeader.curve_count =
+            static_cast<u32>(l_Tracks.curves.size());
+        l_CompressedHeader.constant_count = l_Tracks.constant_count;
+        l_CompressedHeader.segment_count =
+            static_cast<u32>(l_Tracks.segment_offsets.size());
+        l_CompressedHeader.segment_data_size =
+            static_cast<u32>(l_Tracks.segment_data.size());
+
         const Util::String l_BaseAssetPath =
             Util::get_project().assetCachePath + "/" +
             Util::hash_to_string(l_AnimationClipId);
@@ -1291,15 +1327,17 @@ namespace Low {
                                                l_DataFile, l_Header);
         l_WriteSuccess =
             l_WriteSuccess &&
-            Util::FileIO::write_array(l_DataFile, l_ChannelHeaders);
+            Util::FileIO::write_value(l_DataFile, l_CompressedHeader);
         l_WriteSuccess =
             l_WriteSuccess &&
-            Util::FileIO::write_array(l_DataFile, l_Positions);
+            Util::FileIO::write_array(l_DataFile, l_Tracks.curves);
+        l_WriteSuccess = l_WriteSuccess &&
+                         Util::FileIO::write_array(
+                             l_DataFile, l_Tracks.segment_offsets);
         l_WriteSuccess =
             l_WriteSuccess &&
-            Util::FileIO::write_array(l_DataFile, l_Rotations);
-        l_WriteSuccess = l_WriteSuccess && Util::FileIO::write_array(
-                                               l_DataFile, l_Scales);
+            Util::FileIO::write_array(l_DataFile,
+                                      l_Tracks.segment_data);
 
         Util::FileIO::close(l_DataFile);
 
@@ -1307,6 +1345,19 @@ namespace Low {
             l_WriteSuccess,
             "Failed to write animation clip binary data.");
 
+        LOW_LOG_INFO << "Compressed animation clip '" << p_Clip.name
+                     << "' from " << l_Report.raw_size << " to "
+                     << l_Report.compressed_size << " bytes ("
+                     << l_Report.compressed_key_count << " of "
+                     << l_Report.raw_key_count << " keys, "
+                     << l_Report.identity_curve_count
+                     << " identity, " << l_Report.constant_curve_count
+                     << " constant, " << l_Report.animated_curve_count
+                     << " animated curves), max error position "
+                     << l_Report.max_position_error << " rotation "
+                     << l_Report.max_rotation_error << " scale "
+                     << l_Report.max_scale_error << LOW_LOG_END;
+
         Util::Serial::Node l_ResourceNode;
         l_ResourceNode["version"] = 1;
         l_ResourceNode["source_file"] = p_ImportPath;
@@ -1318,6 +1369,27 @@ namespace Low {
         // l_ResourceNode["ticks_per_second"] = p_Clip.ticksPerSecond;
         // l_ResourceNode["channel_count"] = l_Header.channel_count;
 
+        Util::Serial::Node &l_CompressionNode =
+            l_ResourceNode["compression"];
+        l_CompressionNode["raw_size"] = l_Report.raw_size;
+        l_CompressionNode["compressed_size"] =
+            l_Report.compressed_size;
+        l_CompressionNode["raw_keys"] = l_Report.raw_key_count;
+        l_CompressionNode["compressed_keys"] =
+            l_Report.compressed_key_count;
+        l_CompressionNode["identity_curves"] =
+            l_Report.identity_curve_count;
+        l_CompressionNode["constant_curves"] =
+            l_Report.constant_curve_count;
+        l_CompressionNode["animated_curves"] =
+            l_Report.animated_curve_count;
+        l_CompressionNode["max_position_error"] =
+            l_Report.max_position_error;
+        l_CompressionNode["max_rotation_error"] =
+            l_Report.max_rotation_error;
+        l_CompressionNode["max_scale_error"] =
+            l_Report.max_scale_error;
+
         Util::Serial::write_yaml_file(l_ResourcePath.c_str(),
                                       l_ResourceNode);
 
@@ -1393,7 +1465,8 @@ namespace Low {
           for (u32 i = 0u; i < l_AnimationClips.size(); ++i) {
             LOWR_IMP_ASSERT_RETURN(
                 import_animation_clip(l_AnimationClips[i],
-                                      p_ImportPath, p_OutputPath,
+                                      l_SkeletonData, p_ImportPath,
+                                      p_OutputPath,
                                       l_SkeletonUniqueId),
                 "Failed to import animation clip.");
           }
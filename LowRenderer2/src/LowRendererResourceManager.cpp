@@ -41,6 +41,7 @@
 #include <cstring>
 #include <iostream>
 #include <vulkan/vulkan_core.h>
+#include <glm/gtx/matrix_decompose.hpp>
 
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_STATIC
@@ -260,6 +261,17 @@ namespace Low {
                   i_Bone.local_bind_transform =
                       i_BoneNode["local_bind_transform"]
                           .as<Math::Matrix4x4>();
+                  // Sampling starts out from the bind pose every
+                  // time, so it only gets decomposed once
+                  Math::Vector3 i_Skew;
+                  Math::Vector4 i_Perspective;
+                  glm::decompose(i_Bone.local_bind_transform,
+                                 i_Bone.local_bind_scale,
+                                 i_Bone.local_bind_rotation,
+                                 i_Bone.local_bind_position, i_Skew,
+                                 i_Perspective);
+                  i_Bone.local_bind_rotation =
+                      glm::normalize(i_Bone.local_bind_rotation);
                   i_Bone.global_bind_transform =
                       i_BoneNode["global_bind_transform"]
                           .as<Math::Matrix4x4>();
@@ -419,7 +431,46 @@ namespace Low {
               LOW_ASSERT(memcmp(l_Header.magic, "LOWANIMCLIP", 11) ==
                              0,
                          "Invalid animation clip file magic.");
-              LOW_ASSERT(l_Header.version == 1,
+              l_Clip.set_duration(l_Header.duration);
+              l_Clip.set_ticks_per_second(l_Header.ticks_per_second);
+
+              AnimationTracks &l_Tracks = l_Clip.get_tracks();
+              l_Tracks.clear();
+
+              if (l_Header.version ==
+                  LOW_RENDERER_ANIMATION_CLIP_VERSION_COMPRESSED) {
+                BinSerial::AnimCompressedClipHeader l_ClipInfo;
+                l_Read(&l_ClipInfo, sizeof(l_ClipInfo));
+
+                CompressedAnimationTracks &l_Compressed =
+                    l_Tracks.compressed;
+                l_Compressed.frame_count = l_ClipInfo.frame_count;
+                l_Compressed.frame_duration =
+                    l_ClipInfo.frame_duration;
+                l_Compressed.constant_count =
+                    l_ClipInfo.constant_count;
+
+                // Curves, offsets and segments are read as they are
+                // since sampling works on the compressed data
+                l_Compressed.curves.resize(l_ClipInfo.curve_count);
+                l_Read(l_Compressed.curves.data(),
+                       sizeof(AnimationCurve) *
+                           l_ClipInfo.curve_count);
+                l_Compressed.segment_offsets.resize(
+                    l_ClipInfo.segment_count);
+                l_Read(l_Compressed.segment_offsets.data(),
+                       sizeof(u32) * l_ClipInfo.segment_count);
+                l_Compressed.segment_data.resize(
+                    l_ClipInfo.segment_data_size);
+                l_Read(l_Compressed.segment_data.data(),
+                       l_ClipInfo.segment_data_size);
+
+                l_Clip.set_state(AnimationClipState::LOADED);
+                return;
+              }
+
+              LOW_ASSERT(l_Header.version ==
+                             LOW_RENDERER_ANIMATION_CLIP_VERSION_RAW,
                          "Unsupported animation clip file version.");
 
               Util::List<BinSerial::AnimChannelHeader>
@@ -431,52 +482,68 @@ namespace Low {
                            l_Header.channel_count);
               }
 
-              l_Clip.set_duration(l_Header.duration);
-              l_Clip.set_ticks_per_second(l_Header.ticks_per_second);
-              l_Clip.get_channels().clear();
-              l_Clip.get_channels().resize(l_Header.channel_count);
+              l_Tracks.tracks.resize(l_Header.channel_count);
 
+              u32 l_PositionCount = 0u;
+              u32 l_RotationCount = 0u;
+              u32 l_ScaleCount = 0u;
               for (u32 i = 0u; i < l_Header.channel_count; ++i) {
-                AnimationChannel &i_Channel =
-                    l_Clip.get_channels()[i];
-                i_Channel.bone_index = l_ChannelHeaders[i].bone_index;
-                i_Channel.positions.resize(
-                    l_ChannelHeaders[i].position_count);
-                i_Channel.rotations.resize(
-                    l_ChannelHeaders[i].rotation_count);
-                i_Channel.scales.resize(
-                    l_ChannelHeaders[i].scale_count);
+                const BinSerial::AnimChannelHeader &i_Header =
+                    l_ChannelHeaders[i];
+                AnimationTrack &i_Track = l_Tracks.tracks[i];
+                i_Track.bone_index = i_Header.bone_index;
+                i_Track.position_offset = l_PositionCount;
+                i_Track.position_count = i_Header.position_count;
+                i_Track.rotation_offset = l_RotationCount;
+                i_Track.rotation_count = i_Header.rotation_count;
+                i_Track.scale_offset = l_ScaleCount;
+                i_Track.scale_count = i_Header.scale_count;
+
+                l_PositionCount += i_Header.position_count;
+                l_RotationCount += i_Header.rotation_count;
+                l_ScaleCount += i_Header.scale_count;
               }
 
-              for (u32 i = 0u; i < l_Header.channel_count; ++i) {
-                AnimationChannel &i_Channel =
-                    l_Clip.get_channels()[i];
-                if (!i_Channel.positions.empty()) {
-                  l_Read(i_Channel.positions.data(),
-                         sizeof(BinSerial::VecKey) *
-                             i_Channel.positions.size());
+              // The file stores the keys of all channels one
+              // component after the other, so each component is read
+              // in one go and split into times and values
+              Util::List<BinSerial::VecKey> l_VecKeys;
+              auto l_ReadVecKeys = [&](u32 p_Count,
+                                       Util::List<float> &p_Times,
+                                       Util::List<Math::Vector3>
+                                           &p_Values) {
+                l_VecKeys.resize(p_Count);
+                if (p_Count > 0u) {
+                  l_Read(l_VecKeys.data(),
+                         sizeof(BinSerial::VecKey) * p_Count);
                 }
-              }
-
-              for (u32 i = 0u; i < l_Header.channel_count; ++i) {
-                AnimationChannel &i_Channel =
-                    l_Clip.get_channels()[i];
-                if (!i_Channel.rotations.empty()) {
-                  l_Read(i_Channel.rotations.data(),
-                         sizeof(BinSerial::QuatKey) *
-                             i_Channel.rotations.size());
+                p_Times.resize(p_Count);
+                p_Values.resize(p_Count);
+                for (u32 i = 0u; i < p_Count; ++i) {
+                  p_Times[i] = l_VecKeys[i].time;
+                  p_Values[i] = l_VecKeys[i].value;
                 }
-              }
+              };
 
-              for (u32 i = 0u; i < l_Header.channel_count; ++i) {
-                AnimationChannel &i_Channel =
-                    l_Clip.get_channels()[i];
-                if (!i_Channel.scales.empty()) {
-                  l_Read(i_Channel.scales.data(),
-                         sizeof(BinSerial::VecKey) *
-                             i_Channel.scales.size());
-                }
+              l_ReadVecKeys(l_PositionCount, l_Tracks.position_times,
+                            l_Tracks.position_values);
+
+              Util::List<BinSerial::QuatKey> l_QuatKeys;
+              l_QuatKeys.resize(l_RotationCount);
+              if (l_RotationCount > 0u) {
+                l_Read(l_QuatKeys.data(),
+                       sizeof(BinSerial::QuatKey) * l_RotationCount);
               }
+              l_Tracks.rotation_times.resize(l_RotationCount);
+              l_Tracks.rotation_values.resize(l_RotationCount);
+              for (u32 i = 0u; i < l_RotationCount; ++i) {
+                l_Tracks.rotation_times[i] = l_QuatKeys[i].time;
+                l_Tracks.rotation_values[i] =
+                    glm::normalize(l_QuatKeys[i].value);
+              }
+
+              l_ReadVecKeys(l_ScaleCount, l_Tracks.scale_times,
+                            l_Tracks.scale_values);
 
               l_Clip.set_state(AnimationClipState::LOADED);
             });
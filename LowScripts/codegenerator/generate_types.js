@@ -838,6 +838,7 @@ function generate_source(p_Type) {
   t += empty();
   if (p_Type.component) {
     t += include(`LowCorePrefabInstance.h`);
+    t += include(`LowCoreQuery.h`);
   }
   if (p_Type.source_imports) {
     for (const i_Include of p_Type.source_imports) {
@@ -1100,6 +1101,12 @@ function generate_source(p_Type) {
   t += line(l_DestroyEndMarker);
   t += line("}");
   t += empty();
+  if (p_Type.component) {
+    t += line(
+      `Low::Core::Query::notify_component_removed(get_entity(), ms_TypeId);`,
+    );
+    t += empty();
+  }
   t += line(`broadcast_observable(OBSERVABLE_DESTROY);`);
   t += empty();
   if (p_Type.unique_id) {
@@ -1246,6 +1253,17 @@ function generate_source(p_Type) {
   if (p_Type.component) {
     t += line(`l_TypeInfo.component = true;`);
     t += line(`l_TypeInfo.uiComponent = false;`);
+    t += line(
+      `l_TypeInfo.get_page = [](u32 p_Index, u32 &p_SlotIndex) -> Low::Util::Instances::Page * {`,
+    );
+    t += line(`u32 l_PageIndex = 0;`);
+    t += line(
+      `if (!get_page_for_index(p_Index, l_PageIndex, p_SlotIndex)) {`,
+    );
+    t += line(`return nullptr;`);
+    t += line(`}`);
+    t += line(`return ms_Pages[l_PageIndex];`);
+    t += line(`};`);
   } else if (p_Type.ui_component) {
     t += line(`l_TypeInfo.component = false;`);
     t += line(`l_TypeInfo.uiComponent = true;`);
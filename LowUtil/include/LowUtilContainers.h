@@ -5,6 +5,7 @@
 #include <EASTL/array.h>
 #include <EASTL/map.h>
 #include <EASTL/unordered_map.h>
+#include <EASTL/unordered_set.h>
 #include <EASTL/optional.h>
 #include <EASTL/stack.h>
 #include <EASTL/queue.h>
@@ -38,6 +39,8 @@ namespace Low {
     using UnorderedMap = eastl::unordered_map<K, V>;
 
     template <typename T> using Set = eastl::set<T, eastl::less<T>>;
+    template <typename T>
+    using UnorderedSet = eastl::unordered_set<T>;
 
     template <typename T> using Stack = eastl::stack<T>;
     template <typename T> using Queue = eastl::queue<T>;
@@ -55,6 +55,12 @@ namespace Low {
         Handle p_Referencer, const Name p_PropertyName,
         const Name p_ReferencedName);
 
+    // Sets all pending references whose targets are available by now
+    // and drops the ones whose referencer has been destroyed. Call it
+    // after loading a batch of objects. The per frame tick only
+    // handles references whose targets showed up.
+    void LOW_EXPORT resolve_all_handle_references();
+
     struct TypeIdentifier
     {
       Name module;
@@ -226,6 +232,9 @@ namespace Low {
         LivingInstancesGetter get_living_instances;
         u32 (*get_living_count)();
         void (*notify)(Handle, Handle, Name);
+        // Page and slot that hold the data of the instance with the
+        // given index. Only set for component types.
+        Instances::Page *(*get_page)(u32, u32 &) = nullptr;
       };
 
       struct EnumEntryInfo
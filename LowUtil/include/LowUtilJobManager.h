@@ -129,6 +129,8 @@ namespace Low {
         LOW_EXPORT void initialize(u32 p_NumWorkers = 2);
         LOW_EXPORT void cleanup();
 
+        LOW_EXPORT u32 get_worker_count();
+
         LOW_EXPORT JobHandle
         schedule(String p_Label,
                  Function<void(Function<void(float)>)> p_Work,
@@ -140,6 +142,39 @@ namespace Low {
 
       } // namespace Background
 
+      namespace Parallel {
+
+        // Passing 0 workers takes the cores that are left after the
+        // main thread, the IO thread and the background workers, but
+        // at least one. Has to be initialized after Background.
+        LOW_EXPORT void initialize(u32 p_NumWorkers = 0);
+        LOW_EXPORT void cleanup();
+
+        LOW_EXPORT u32 get_worker_count();
+
+        // Splits [0, p_Count) into ranges of at most p_BatchSize
+        // elements and runs them on the parallel workers. The calling
+        // thread works on ranges as well and only returns once all of
+        // them have been processed.
+        LOW_EXPORT void for_each(u32 p_Count, u32 p_BatchSize,
+                                 Function<void(u32, u32)> p_Work);
+
+        // Hands a single piece of work to the parallel workers and
+        // returns right away. Used by systems that bring their own
+        // scheduling on top of the workers.
+        LOW_EXPORT void submit(Function<void()> p_Work);
+
+        typedef void (*TaskFunction)(void *);
+
+        // Like submit but without allocating or locking. The task
+        // goes into a fixed size lock free queue that the workers
+        // drain before they pick up other parallel work. If the
+        // queue is full the task runs on the calling thread.
+        LOW_EXPORT void submit_task(TaskFunction p_Function,
+                                    void *p_Data);
+
+      } // namespace Parallel
+
       namespace Tracking {
 
         enum class JobType
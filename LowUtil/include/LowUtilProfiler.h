@@ -18,6 +18,10 @@
   Low::Util::Profiler::Scope LOW_PROFILE_TOKEN_PASTE(               \
       l_LowProfileScope, __LINE__)(_grp, _name)
 
+#define LOW_PROFILE_COUNTER(_grp, _name, _value)                    \
+  Low::Util::Profiler::record_counter(_grp, _name,                  \
+                                      static_cast<double>(_value))
+
 namespace Low {
   namespace Util {
     namespace Profiler {
@@ -31,11 +35,19 @@ namespace Low {
         float durationMs;
       };
 
+      struct LOW_EXPORT CounterSample
+      {
+        String group;
+        String name;
+        double value;
+      };
+
       struct LOW_EXPORT Frame
       {
         uint64_t index;
         float durationMs;
         List<ScopeSample> samples;
+        List<CounterSample> counters;
       };
 
       struct LOW_EXPORT Scope
@@ -57,6 +69,12 @@ namespace Low {
 
       LOW_EXPORT void evaluate_memory_allocation();
 
+      // Counters keep their last recorded value and get captured
+      // with every frame
+      LOW_EXPORT void record_counter(const char *p_Group,
+                                     const char *p_Name,
+                                     double p_Value);
+
       LOW_EXPORT void flip();
 
       LOW_EXPORT void set_enabled(bool p_Enabled);
@@ -56,139 +56,239 @@ namespace Low {
       Name
     };
 
+    // Resolvers are kept in a pool and reference each other by
+    // index. Resolvers that wait for the same unique id are chained
+    // through next so registering that id only wakes up the ones
+    // that are actually waiting on it.
     struct HandleReferenceResolver
     {
       Handle referencer;
       Name property;
       HandleReferenceResolverType type;
-      union
-      {
-        u64 uid;
-        Name name;
-      };
-      RTTI::TypeInfo typeInfo;
-      RTTI::TypeInfo referencedTypeInfo;
-
-      HandleReferenceResolver(const HandleReferenceResolver &p_Other)
-          : referencer(p_Other.referencer),
-            property(p_Other.property), type(p_Other.type),
-            typeInfo(p_Other.typeInfo),
-            referencedTypeInfo(p_Other.referencedTypeInfo)
-      {
-        copy_union_value(p_Other);
+      u64 uid;
+      Name name;
+      u32 next;
+    };
+
+    List<HandleReferenceResolver> g_ReferenceResolvers;
+    List<u32> g_FreeReferenceResolvers;
+    UnorderedMap<UniqueId, u32> g_WaitingReferenceResolvers;
+    List<u32> g_ReadyReferenceResolvers;
+    List<u32> g_NameReferenceResolvers;
+
+    static u32 create_reference_resolver(
+        Handle p_Referencer, const Name p_PropertyName,
+        HandleReferenceResolverType p_Type)
+    {
+      u32 l_Index;
+      if (!g_FreeReferenceResolvers.empty()) {
+        l_Index = g_FreeReferenceResolvers.back();
+        g_FreeReferenceResolvers.pop_back();
+      } else {
+        l_Index = static_cast<u32>(g_ReferenceResolvers.size());
+        g_ReferenceResolvers.emplace_back();
       }
 
-      HandleReferenceResolver &
-      operator=(const HandleReferenceResolver &p_Other)
-      {
-        if (this != &p_Other) {
-          referencer = p_Other.referencer;
-          property = p_Other.property;
-          type = p_Other.type;
-          typeInfo = p_Other.typeInfo;
-          referencedTypeInfo = p_Other.referencedTypeInfo;
-          copy_union_value(p_Other);
-        }
+      HandleReferenceResolver &l_Resolver =
+          g_ReferenceResolvers[l_Index];
+      l_Resolver.referencer = p_Referencer;
+      l_Resolver.property = p_PropertyName;
+      l_Resolver.type = p_Type;
+      l_Resolver.uid = 0ull;
+      l_Resolver.name = Name(0u);
+      l_Resolver.next = LOW_UINT32_MAX;
+
+      return l_Index;
+    }
 
-        return *this;
+    static void wait_for_unique_id(const u32 p_Index)
+    {
+      HandleReferenceResolver &l_Resolver =
+          g_ReferenceResolvers[p_Index];
+
+      auto l_Pos = g_WaitingReferenceResolvers.find(l_Resolver.uid);
+      if (l_Pos == g_WaitingReferenceResolvers.end()) {
+        l_Resolver.next = LOW_UINT32_MAX;
+        g_WaitingReferenceResolvers[l_Resolver.uid] = p_Index;
+      } else {
+        l_Resolver.next = l_Pos->second;
+        l_Pos->second = p_Index;
       }
+    }
 
-      HandleReferenceResolver(Handle p_Referencer,
-                              Name p_PropertyName,
-                              HandleReferenceResolverType p_Type,
-                              u64 p_Uid)
-          : referencer(p_Referencer), property(p_PropertyName),
-            type(p_Type)
-      {
-        uid = p_Uid;
-        fill();
+    static bool
+    is_referencer_alive(const HandleReferenceResolver &p_Resolver)
+    {
+      if (!Handle::is_registered_type(
+              p_Resolver.referencer.get_type())) {
+        return false;
       }
+      return Handle::get_type_info(p_Resolver.referencer.get_type())
+          .is_alive(p_Resolver.referencer);
+    }
 
-      HandleReferenceResolver(Handle p_Referencer,
-                              Name p_PropertyName,
-                              HandleReferenceResolverType p_Type,
-                              Name p_Name)
-          : referencer(p_Referencer), property(p_PropertyName),
-            type(p_Type)
-      {
-        name = p_Name;
-        fill();
+    // Returns true if the resolver is done, either because the
+    // reference has been set or because the referencer is gone
+    static bool try_resolve(const HandleReferenceResolver &p_Resolver)
+    {
+      if (!is_referencer_alive(p_Resolver)) {
+        return true;
       }
 
-      void fill()
-      {
+      RTTI::TypeInfo &l_TypeInfo =
+          Handle::get_type_info(p_Resolver.referencer.get_type());
 
-        typeInfo = Handle::get_type_info(referencer.get_type());
-        referencedTypeInfo = Handle::get_type_info(
-            typeInfo.properties[property].handleType);
+      RTTI::PropertyInfo &l_PropertyInfo =
+          l_TypeInfo.properties[p_Resolver.property];
+      RTTI::TypeInfo &l_ReferencedTypeInfo =
+          Handle::get_type_info(l_PropertyInfo.handleType);
+
+      Handle l_Handle = Handle::DEAD;
+      if (p_Resolver.type == HandleReferenceResolverType::Uid) {
+        l_Handle = find_handle_by_unique_id(p_Resolver.uid);
+      } else if (p_Resolver.type ==
+                 HandleReferenceResolverType::Name) {
+        l_Handle = l_ReferencedTypeInfo.find_by_name(p_Resolver.name);
+      } else {
+        LOW_ASSERT(false, "Unsupported resolver type");
       }
 
-    private:
-      void copy_union_value(const HandleReferenceResolver &p_Other)
-      {
-        if (type == HandleReferenceResolverType::Uid) {
-          uid = p_Other.uid;
-        } else {
-          name = p_Other.name;
-        }
+      if (!l_ReferencedTypeInfo.is_alive(l_Handle)) {
+        return false;
       }
-    };
 
-    List<HandleReferenceResolver> g_ActiveReferenceResolvers;
+      l_PropertyInfo.set(p_Resolver.referencer, &l_Handle);
+      LOW_LOG_DEBUG << "Resolved reference successfully."
+                    << LOW_LOG_END;
+      return true;
+    }
 
     void
     resolve_handle_reference_by_unique_id(Handle p_Referencer,
                                           const Name p_PropertyName,
                                           const u64 p_UniqueId)
     {
-      g_ActiveReferenceResolvers.emplace_back(
+      const u32 l_Index = create_reference_resolver(
           p_Referencer, p_PropertyName,
-          HandleReferenceResolverType::Uid, p_UniqueId);
+          HandleReferenceResolverType::Uid);
+      g_ReferenceResolvers[l_Index].uid = p_UniqueId;
+
+      if (g_UniqueIdRegistry.find(p_UniqueId) !=
+          g_UniqueIdRegistry.end()) {
+        g_ReadyReferenceResolvers.push_back(l_Index);
+      } else {
+        wait_for_unique_id(l_Index);
+      }
     }
 
     void resolve_handle_reference_by_name(Handle p_Referencer,
                                           const Name p_PropertyName,
                                           const Name p_ReferencedName)
     {
-      g_ActiveReferenceResolvers.emplace_back(
+      const u32 l_Index = create_reference_resolver(
           p_Referencer, p_PropertyName,
-          HandleReferenceResolverType::Name, p_ReferencedName);
+          HandleReferenceResolverType::Name);
+      g_ReferenceResolvers[l_Index].name = p_ReferencedName;
+
+      g_NameReferenceResolvers.push_back(l_Index);
     }
 
-    void tick_handle_reference_resolvers(const float p_Delta)
+    static void resolve_ready_references()
     {
-      for (auto it = g_ActiveReferenceResolvers.begin();
-           it != g_ActiveReferenceResolvers.end();) {
-        HandleReferenceResolver &i_Resolver = *it;
-        if (!i_Resolver.typeInfo.is_alive(i_Resolver.referencer)) {
-          it = g_ActiveReferenceResolvers.erase(it);
-          continue;
-        }
+      if (g_ReadyReferenceResolvers.empty()) {
+        return;
+      }
 
-        Handle i_Handle = Handle::DEAD;
+      // Setting a reference can queue up new resolvers so we work on
+      // a copy of the ready list
+      List<u32> l_Ready;
+      l_Ready.swap(g_ReadyReferenceResolvers);
+
+      for (u32 i_Index : l_Ready) {
+        const HandleReferenceResolver i_Resolver =
+            g_ReferenceResolvers[i_Index];
+        // The unique id is registered already so it will not
+        // notify the resolver again
+        if (!try_resolve(i_Resolver)) {
+          LOW_LOG_WARN << "Could not resolve reference to unique id "
+                       << i_Resolver.uid
+                       << ", the referenced object is not alive"
+                       << LOW_LOG_END;
+        }
+        g_FreeReferenceResolvers.push_back(i_Index);
+      }
+    }
 
-        if (i_Resolver.type == HandleReferenceResolverType::Uid) {
-          i_Handle = find_handle_by_unique_id(i_Resolver.uid);
-        } else if (i_Resolver.type ==
-                   HandleReferenceResolverType::Name) {
-          i_Handle = i_Resolver.referencedTypeInfo.find_by_name(
-              i_Resolver.name);
+    // There is no notification when a name becomes available so
+    // name references still get polled
+    static void resolve_name_references()
+    {
+      for (u32 i = 0u; i < g_NameReferenceResolvers.size();) {
+        const u32 i_Index = g_NameReferenceResolvers[i];
+        const HandleReferenceResolver i_Resolver =
+            g_ReferenceResolvers[i_Index];
+        if (try_resolve(i_Resolver)) {
+          g_FreeReferenceResolvers.push_back(i_Index);
+          g_NameReferenceResolvers[i] =
+              g_NameReferenceResolvers.back();
+          g_NameReferenceResolvers.pop_back();
         } else {
-          LOW_ASSERT(false, "Unsupported resolver type");
+          ++i;
+        }
+      }
+    }
+
+    // Unique ids that never get registered would otherwise keep
+    // their resolvers around forever, even after the object that
+    // waited for them has been destroyed. This walks every waiting
+    // resolver, so it only runs after bulk loads and not per tick.
+    static void purge_dead_waiting_references()
+    {
+      for (auto it = g_WaitingReferenceResolvers.begin();
+           it != g_WaitingReferenceResolvers.end();) {
+        u32 i_Head = LOW_UINT32_MAX;
+        u32 i_Tail = LOW_UINT32_MAX;
+        for (u32 i_Index = it->second; i_Index != LOW_UINT32_MAX;) {
+          HandleReferenceResolver &i_Resolver =
+              g_ReferenceResolvers[i_Index];
+          const u32 i_Next = i_Resolver.next;
+
+          if (!is_referencer_alive(i_Resolver)) {
+            g_FreeReferenceResolvers.push_back(i_Index);
+          } else {
+            i_Resolver.next = LOW_UINT32_MAX;
+            if (i_Tail == LOW_UINT32_MAX) {
+              i_Head = i_Index;
+            } else {
+              g_ReferenceResolvers[i_Tail].next = i_Index;
+            }
+            i_Tail = i_Index;
+          }
+          i_Index = i_Next;
         }
 
-        if (i_Resolver.referencedTypeInfo.is_alive(i_Handle)) {
-          i_Resolver.typeInfo.properties[i_Resolver.property].set(
-              i_Resolver.referencer, &i_Handle);
-          LOW_LOG_DEBUG << "Resolved reference successfully."
-                        << LOW_LOG_END;
-          it = g_ActiveReferenceResolvers.erase(it);
+        if (i_Head == LOW_UINT32_MAX) {
+          it = g_WaitingReferenceResolvers.erase(it);
         } else {
+          it->second = i_Head;
           ++it;
         }
       }
     }
 
+    void resolve_all_handle_references()
+    {
+      resolve_ready_references();
+      resolve_name_references();
+      purge_dead_waiting_references();
+    }
+
+    void tick_handle_reference_resolvers(const float p_Delta)
+    {
+      resolve_ready_references();
+      resolve_name_references();
+    }
+
     void register_enum_info(u16 p_EnumId, RTTI::EnumInfo &p_EnumInfo)
     {
       LOW_ASSERT(
@@ -389,6 +489,15 @@ namespace Low {
                  "UniqueId collision");
 
       g_UniqueIdRegistry[p_UniqueId] = p_Handle;
+
+      auto l_Pos = g_WaitingReferenceResolvers.find(p_UniqueId);
+      if (l_Pos != g_WaitingReferenceResolvers.end()) {
+        for (u32 i = l_Pos->second; i != LOW_UINT32_MAX;
+             i = g_ReferenceResolvers[i].next) {
+          g_ReadyReferenceResolvers.push_back(i);
+        }
+        g_WaitingReferenceResolvers.erase(l_Pos);
+      }
     }
 
     void remove_unique_id(UniqueId p_UniqueId)
@@ -5,6 +5,7 @@
 #include "LowUtilSerialization.h"
 #include "LowMath.h"
 
+#include <algorithm>
 #include <fstream>
 #include <string>
 #include <chrono>
@@ -99,10 +100,12 @@ namespace Low {
         g_DefaultThreadPool = new ThreadPool(4);
         IO::initialize();
         Background::initialize();
+        Parallel::initialize();
       }
 
       void cleanup()
       {
+        Parallel::cleanup();
         Background::cleanup();
         IO::cleanup();
         delete g_DefaultThreadPool;
@@ -655,6 +658,11 @@ namespace Low {
           g_Workers.clear();
         }
 
+        u32 get_worker_count()
+        {
+          return static_cast<u32>(g_Workers.size());
+        }
+
         JobHandle
         schedule(String p_Label,
                  Function<void(Function<void(float)>)> p_Work,
@@ -728,6 +736,300 @@ namespace Low {
 
       } // namespace Background
 
+      // -----------------------------------------------------------------------
+      // Parallel Workers
+      // -----------------------------------------------------------------------
+
+      namespace Parallel {
+
+        struct ParallelJob
+        {
+          Function<void(u32, u32)> work;
+          u32 count = 0;
+          u32 batchSize = 1;
+          std::atomic<u32> next{0};
+          std::atomic<u32> finished{0};
+        };
+
+        static Deque<SharedPtr<ParallelJob>> g_Jobs;
+        static std::mutex g_Mutex;
+        static std::condition_variable g_Condition;
+        static std::mutex g_DoneMutex;
+        static std::condition_variable g_DoneCondition;
+        static bool g_Stop = false;
+        static List<std::thread> g_Workers;
+
+        // Bounded lock free queue for submit_task. Every cell carries
+        // a sequence number that tells producers and consumers whose
+        // turn it is, so neither side needs a lock or an allocation.
+        struct Task
+        {
+          std::atomic<size_t> sequence;
+          TaskFunction function;
+          void *data;
+        };
+
+        static const size_t g_TaskCapacity = 4096u;
+        static Task g_Tasks[g_TaskCapacity];
+        static std::atomic<size_t> g_TaskEnqueuePos{0};
+        static std::atomic<size_t> g_TaskDequeuePos{0};
+        // Producers only take the mutex to wake up sleeping workers
+        static std::atomic<u32> g_SleepingWorkers{0};
+
+        static bool push_task(TaskFunction p_Function, void *p_Data)
+        {
+          size_t l_Pos =
+              g_TaskEnqueuePos.load(std::memory_order_relaxed);
+          while (true) {
+            Task &l_Task = g_Tasks[l_Pos & (g_TaskCapacity - 1u)];
+            const size_t l_Sequence =
+                l_Task.sequence.load(std::memory_order_acquire);
+            const intptr_t l_Diff =
+                (intptr_t)l_Sequence - (intptr_t)l_Pos;
+            if (l_Diff == 0) {
+              if (g_TaskEnqueuePos.compare_exchange_weak(
+                      l_Pos, l_Pos + 1u, std::memory_order_relaxed)) {
+                l_Task.function = p_Function;
+                l_Task.data = p_Data;
+                l_Task.sequence.store(l_Pos + 1u,
+                                      std::memory_order_release);
+                return true;
+              }
+            } else if (l_Diff < 0) {
+              return false;
+            } else {
+              l_Pos =
+                  g_TaskEnqueuePos.load(std::memory_order_relaxed);
+            }
+          }
+        }
+
+        static bool pop_task(TaskFunction &p_Function, void *&p_Data)
+        {
+          size_t l_Pos =
+              g_TaskDequeuePos.load(std::memory_order_relaxed);
+          while (true) {
+            Task &l_Task = g_Tasks[l_Pos & (g_TaskCapacity - 1u)];
+            const size_t l_Sequence =
+                l_Task.sequence.load(std::memory_order_acquire);
+            const intptr_t l_Diff =
+                (intptr_t)l_Sequence - (intptr_t)(l_Pos + 1u);
+            if (l_Diff == 0) {
+              if (g_TaskDequeuePos.compare_exchange_weak(
+                      l_Pos, l_Pos + 1u, std::memory_order_relaxed)) {
+                p_Function = l_Task.function;
+                p_Data = l_Task.data;
+                l_Task.sequence.store(l_Pos + g_TaskCapacity,
+                                      std::memory_order_release);
+                return true;
+              }
+            } else if (l_Diff < 0) {
+              return false;
+            } else {
+              l_Pos =
+                  g_TaskDequeuePos.load(std::memory_order_relaxed);
+            }
+          }
+        }
+
+        static bool has_tasks()
+        {
+          return g_TaskDequeuePos.load(std::memory_order_acquire) !=
+                 g_TaskEnqueuePos.load(std::memory_order_acquire);
+        }
+
+        static void run_batches(ParallelJob &p_Job)
+        {
+          while (true) {
+            const u32 l_Begin = p_Job.next.fetch_add(
+                p_Job.batchSize, std::memory_order_relaxed);
+            if (l_Begin >= p_Job.count) {
+              return;
+            }
+            const u32 l_End =
+                std::min(l_Begin + p_Job.batchSize, p_Job.count);
+
+            p_Job.work(l_Begin, l_End);
+
+            const u32 l_Finished =
+                p_Job.finished.fetch_add(l_End - l_Begin,
+                                         std::memory_order_acq_rel) +
+                (l_End - l_Begin);
+            if (l_Finished == p_Job.count) {
+              std::unique_lock<std::mutex> l_Lock(g_DoneMutex);
+              g_DoneCondition.notify_all();
+            }
+          }
+        }
+
+        static void worker_func()
+        {
+          while (true) {
+            TaskFunction l_Function;
+            void *l_Data;
+            if (pop_task(l_Function, l_Data)) {
+              l_Function(l_Data);
+              continue;
+            }
+
+            SharedPtr<ParallelJob> l_Job;
+            {
+              std::unique_lock<std::mutex> l_Lock(g_Mutex);
+              // Pairs with the fence in submit_task, either the
+              // producer sees this worker sleeping or the worker sees
+              // the new task
+              g_SleepingWorkers.fetch_add(1u);
+              std::atomic_thread_fence(std::memory_order_seq_cst);
+              g_Condition.wait(l_Lock, [] {
+                return g_Stop || !g_Jobs.empty() || has_tasks();
+              });
+              g_SleepingWorkers.fetch_sub(1u);
+              if (g_Stop && g_Jobs.empty() && !has_tasks()) {
+                return;
+              }
+              if (g_Jobs.empty()) {
+                continue;
+              }
+
+              l_Job = g_Jobs.front();
+              if (l_Job->next.load(std::memory_order_relaxed) >=
+                  l_Job->count) {
+                g_Jobs.pop_front();
+                continue;
+              }
+            }
+
+            run_batches(*l_Job);
+          }
+        }
+
+        void initialize(u32 p_NumWorkers)
+        {
+          if (p_NumWorkers == 0) {
+            // The main thread, the IO thread and the background
+            // workers keep their cores. The default pool runs the
+            // jobs it gets on the calling thread, so its threads do
+            // not need one.
+            const u32 l_Cores =
+                std::max(1u, std::thread::hardware_concurrency());
+            const u32 l_Reserved =
+                2u + Background::get_worker_count();
+            p_NumWorkers =
+                l_Cores > l_Reserved ? l_Cores - l_Reserved : 1u;
+          }
+
+          for (size_t i = 0u; i < g_TaskCapacity; ++i) {
+            g_Tasks[i].sequence.store(i, std::memory_order_relaxed);
+          }
+          g_TaskEnqueuePos.store(0u, std::memory_order_relaxed);
+          g_TaskDequeuePos.store(0u, std::memory_order_relaxed);
+
+          g_Stop = false;
+          for (u32 i = 0; i < p_NumWorkers; ++i) {
+            String i_Name = "Parallel Worker ";
+            i_Name += std::to_string(i + 1).c_str();
+
+            g_Workers.emplace_back([i_Name] {
+              Log::set_current_thread_name(i_Name.c_str());
+              worker_func();
+            });
+            set_thread_name(g_Workers[i], i_Name.c_str());
+          }
+        }
+
+        void cleanup()
+        {
+          {
+            std::unique_lock<std::mutex> l_Lock(g_Mutex);
+            g_Stop = true;
+          }
+          g_Condition.notify_all();
+          for (std::thread &i_Worker : g_Workers) {
+            i_Worker.join();
+          }
+          g_Workers.clear();
+          g_Jobs.clear();
+        }
+
+        u32 get_worker_count()
+        {
+          return static_cast<u32>(g_Workers.size());
+        }
+
+        void for_each(u32 p_Count, u32 p_BatchSize,
+                      Function<void(u32, u32)> p_Work)
+        {
+          if (p_Count == 0) {
+            return;
+          }
+          p_BatchSize = std::max(p_BatchSize, 1u);
+
+          // Not worth waking anyone up for a single batch
+          if (g_Workers.empty() || p_Count <= p_BatchSize) {
+            p_Work(0, p_Count);
+            return;
+          }
+
+          SharedPtr<ParallelJob> l_Job = make_shared<ParallelJob>();
+          l_Job->work = std::move(p_Work);
+          l_Job->count = p_Count;
+          l_Job->batchSize = p_BatchSize;
+
+          {
+            std::unique_lock<std::mutex> l_Lock(g_Mutex);
+            g_Jobs.push_back(l_Job);
+          }
+          g_Condition.notify_all();
+
+          run_batches(*l_Job);
+
+          std::unique_lock<std::mutex> l_Lock(g_DoneMutex);
+          g_DoneCondition.wait(l_Lock, [&l_Job] {
+            return l_Job->finished.load(std::memory_order_acquire) ==
+                   l_Job->count;
+          });
+        }
+
+        void submit(Function<void()> p_Work)
+        {
+          if (g_Workers.empty()) {
+            p_Work();
+            return;
+          }
+
+          SharedPtr<ParallelJob> l_Job = make_shared<ParallelJob>();
+          l_Job->work = [p_Work](u32, u32) { p_Work(); };
+          l_Job->count = 1;
+          l_Job->batchSize = 1;
+
+          {
+            std::unique_lock<std::mutex> l_Lock(g_Mutex);
+            g_Jobs.push_back(l_Job);
+          }
+          g_Condition.notify_one();
+        }
+
+        void submit_task(TaskFunction p_Function, void *p_Data)
+        {
+          // Running the task right away is always correct, so a full
+          // queue does not need to wait for a free cell
+          if (g_Workers.empty() || !push_task(p_Function, p_Data)) {
+            p_Function(p_Data);
+            return;
+          }
+
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          if (g_SleepingWorkers.load(std::memory_order_relaxed) >
+              0u) {
+            {
+              std::unique_lock<std::mutex> l_Lock(g_Mutex);
+            }
+            g_Condition.notify_one();
+          }
+        }
+
+      } // namespace Parallel
+
       namespace Tracking {
 
         bool is_enabled()
@@ -24,6 +24,7 @@ namespace Low {
 
       List<TrackedMemoryAllocation> g_TrackedMemoryAllocations;
       List<ScopeSample> g_CurrentFrameSamples;
+      List<CounterSample> g_CurrentFrameCounters;
       List<Frame> g_Frames;
       std::mutex g_Mutex;
       std::atomic<bool> g_Enabled = true;
@@ -134,6 +135,29 @@ namespace Low {
                    "Not all tracked memory allocations were free'd");
       }
 
+      void record_counter(const char *p_Group, const char *p_Name,
+                          double p_Value)
+      {
+        if (!g_Enabled.load()) {
+          return;
+        }
+
+        std::lock_guard<std::mutex> l_Lock(g_Mutex);
+        for (CounterSample &i_Counter : g_CurrentFrameCounters) {
+          if (i_Counter.group == p_Group &&
+              i_Counter.name == p_Name) {
+            i_Counter.value = p_Value;
+            return;
+          }
+        }
+
+        CounterSample l_Counter;
+        l_Counter.group = p_Group;
+        l_Counter.name = p_Name;
+        l_Counter.value = p_Value;
+        g_CurrentFrameCounters.push_back(l_Counter);
+      }
+
       void flip()
       {
         if (!g_Enabled.load()) {
@@ -153,6 +177,7 @@ namespace Low {
         l_Frame.index = g_FrameIndex++;
         l_Frame.durationMs = ns_to_ms(l_Now - g_FrameStart.load());
         l_Frame.samples.swap(g_CurrentFrameSamples);
+        l_Frame.counters = g_CurrentFrameCounters;
 
         g_Frames.push_back(l_Frame);
         if (g_Frames.size() > PROFILE_FRAME_COUNT) {
@@ -169,6 +194,7 @@ namespace Low {
 
         if (!g_Enabled.load()) {
           g_CurrentFrameSamples.clear();
+          g_CurrentFrameCounters.clear();
           g_FrameStart = 0;
         } else if (g_FrameStart.load() == 0) {
           g_FrameStart = now_ns();
@@ -184,6 +210,7 @@ namespace Low {
       {
         std::lock_guard<std::mutex> l_Lock(g_Mutex);
         g_CurrentFrameSamples.clear();
+        g_CurrentFrameCounters.clear();
         g_Frames.clear();
         g_FrameIndex = 0;
         g_FrameStart = now_ns();